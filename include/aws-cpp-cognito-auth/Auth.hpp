@@ -26,15 +26,52 @@
 #define __AWS_CPP_COGNITO_AUTH_H
 
 
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include "aws/core/auth/AWSCredentialsProvider.h"
 
+#include "Clients.hpp"
+#include "Device.hpp"
 #include "Exception.hpp"
+#include "Options.hpp"
+#include "Result.hpp"
+
+
+namespace Aws {
+	namespace CognitoIdentityProvider {
+		namespace Model {
+			class AdminInitiateAuthRequest;
+			class AdminInitiateAuthResult;
+			class ConfirmDeviceRequest;
+			class InitiateAuthRequest;
+			class InitiateAuthResult;
+			class RespondToAuthChallengeRequest;
+			class RespondToAuthChallengeResult;
+			class UpdateDeviceStatusRequest;
+		} // namespace Model
+	} // namespace CognitoIdentityProvider
+
+	namespace CognitoIdentity {
+		namespace Model {
+			class GetIdRequest;
+			class GetCredentialsForIdentityRequest;
+			class GetCredentialsForIdentityResult;
+		} // namespace Model
+	} // namespace CognitoIdentity
+} // namespace Aws
 
 
 namespace awsx {
 
+	class HmacSha256Key;
+	class LatencyTracker;
+	class Srp;
+
 	class CognitoTokens {
 	protected:
 		std::string m_accessToken;
@@ -43,6 +80,11 @@ namespace awsx {
 		int m_expiresIn;
 
 	public:
+		CognitoTokens()
+			: m_expiresIn( 0 )
+		{
+		}
+
 		CognitoTokens( const std::string & accessToken,
 			const std::string & idToken,
 			const std::string & refreshToken,
@@ -58,57 +100,525 @@ namespace awsx {
 		{
 			return m_accessToken;
 		}
+		const std::string & GetAccessToken() const
+		{
+			return m_accessToken;
+		}
 		std::string & GetIdToken()
 		{
 			return m_idToken;
 		}
+		const std::string & GetIdToken() const
+		{
+			return m_idToken;
+		}
 		std::string & GetRefreshToken()
 		{
 			return m_refreshToken;
 		}
-		int GetExpiresIn()
+		const std::string & GetRefreshToken() const
+		{
+			return m_refreshToken;
+		}
+		int GetExpiresIn() const
 		{
 			return m_expiresIn;
 		}
 	};
 
+	// A user pool login in progress. While the pool asks for another
+	// challenge (NEW_PASSWORD_REQUIRED, SMS_MFA, SOFTWARE_TOKEN_MFA, ...)
+	// it carries the Session and challenge parameters, so the answer goes
+	// straight to RespondToAuthChallenge without a new InitiateAuth or SRP
+	// round. The pool's Session expires after a few minutes.
+	class CognitoAuthSession {
+	public:
+		enum class State {
+			ChallengeRequired,
+			Authenticated
+		};
+
+	protected:
+		State m_state;
+
+		std::string m_userPoolId;
+		std::string m_username;
+
+		std::string m_challengeName;
+		std::string m_session;
+		std::map<std::string, std::string> m_challengeParameters;
+
+		CognitoTokens m_tokens;
+
+		friend class CognitoAuth;
+
+		CognitoAuthSession(
+			const std::string & userPoolId, const std::string & username )
+			: m_state( State::ChallengeRequired )
+			, m_userPoolId( userPoolId )
+			, m_username( username )
+		{
+		}
+
+	public:
+		CognitoAuthSession()
+			: m_state( State::ChallengeRequired )
+		{
+		}
+
+		State GetState() const
+		{
+			return m_state;
+		}
+
+		bool IsAuthenticated() const
+		{
+			return m_state == State::Authenticated;
+		}
+
+		const std::string & GetUserPoolId() const
+		{
+			return m_userPoolId;
+		}
+
+		// as passed to the login, also the device store key
+		const std::string & GetUsername() const
+		{
+			return m_username;
+		}
+
+		// e.g. "SMS_MFA", empty once authenticated
+		const std::string & GetChallengeName() const
+		{
+			return m_challengeName;
+		}
+
+		const std::string & GetSession() const
+		{
+			return m_session;
+		}
+
+		// e.g. CODE_DELIVERY_DESTINATION for SMS_MFA, requiredAttributes for
+		// NEW_PASSWORD_REQUIRED
+		const std::map<std::string, std::string> & GetChallengeParameters()
+			const
+		{
+			return m_challengeParameters;
+		}
+
+		// Throws while a challenge is pending.
+		CognitoTokens GetTokens() const;
+	};
+
+	// AWS credentials of an identity pool identity.
+	struct IdentityCredentials {
+		std::string identityId;
+		Aws::Auth::AWSCredentials credentials;
+
+		// Credentials.Expiration of the GetCredentialsForIdentity response
+		std::chrono::system_clock::time_point expiration;
+	};
+
+	// What one login yields: the user pool tokens, e.g. for APIs behind a
+	// user pool authorizer, and the identity pool credentials.
+	struct CognitoLogin {
+		CognitoTokens tokens;
+		IdentityCredentials identity;
+	};
+
 	class CognitoAuth {
 	protected:
 		std::string m_clientId;
 		std::string m_regionId;
 
-		template <class TException, typename TResult>
-		void ThrowIf( TResult & result )
-		{
-			if ( !result.IsSuccess() ) {
-				throw TException(
-					std::string( result.GetError().GetExceptionName().c_str() )
-					+ ": " + result.GetError().GetMessage().c_str() );
-			}
-		}
+		CognitoAuthOptions m_options;
+
+		std::shared_ptr<CognitoTransport> m_transport;
+
+		std::shared_ptr<HmacSha256Key> m_secretHash;
+
+		std::shared_ptr<LatencyTracker> m_getIdLatency;
+		std::shared_ptr<LatencyTracker> m_getCredentialsLatency;
+
+		// with lazyStart, the SRP state of the first login, computed while
+		// the transport is set up
+		mutable std::mutex m_firstSrpMutex;
+		mutable std::future<std::shared_ptr<Srp>> m_firstSrp;
+
+		std::string LoginProvider( const std::string & userPoolId ) const;
+
+		// Confirms and stores the device the pool handed out with the
+		// tokens. Failures only cost the next login its shortcut.
+		void RememberDevice( const std::string & userPoolId,
+			const std::string & username,
+			const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeResult & challengeResult,
+			std::chrono::steady_clock::time_point deadline );
+
+		// deviceDropped: a stale device was just forgotten, the retry goes
+		// without one
+		AuthResult<CognitoAuthSession> SrpAuthInternal(
+			const std::string & username,
+			const std::string & userPoolId,
+			const std::string & password,
+			std::chrono::steady_clock::time_point deadline,
+			bool deviceDropped );
+
+		AuthResult<CognitoAuthSession> PasswordAuthInternal(
+			const std::string & username,
+			const std::string & userPoolId,
+			const std::string & password,
+			std::chrono::steady_clock::time_point deadline );
 
-		CognitoTokens AuthenticateWithUserPoolInternal(
-			Aws::Client::ClientConfiguration & clientConfig,
+		AuthResult<CognitoAuthSession> AuthenticateWithUserPoolInternal(
 			const std::string & username,
 			const std::string & userPoolId,
-			const std::string & password );
+			const std::string & password,
+			std::chrono::steady_clock::time_point deadline );
+
+		// Second SRP round of a remembered device, answering DEVICE_SRP_AUTH.
+		// Sets forgotten when the pool rejected the device and it was
+		// dropped; the password was fine, the login can start over.
+		AuthResult<Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeResult>
+		DeviceSrpInternal( const std::string & userPoolId,
+			const std::string & username,
+			const DeviceCredentials & device,
+			const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeResult & challengeResult,
+			std::chrono::steady_clock::time_point deadline,
+			bool & forgotten );
+
+		// Moves the session on to the tokens or the next challenge.
+		template <typename TResult>
+		void Advance( CognitoAuthSession & session, const TResult & result );
+
+		// Skips GetId when the identity id is known.
+		AuthResult<IdentityCredentials> CredentialsInternal(
+			const std::string & idToken,
+			const std::string & userPoolId,
+			const std::string & identityPoolId,
+			const std::string & identityId,
+			std::chrono::steady_clock::time_point deadline );
 
 	public:
-		CognitoAuth(
-			const std::string & regionId, const std::string & clientId )
-			: m_regionId( regionId )
-			, m_clientId( clientId )
-		{
-		}
+		// With warmup set the constructor calls Warmup(), so with the SDK
+		// transport Aws::InitAPI must already have been called. With
+		// lazyStart it returns at once and the transport warms itself.
+		CognitoAuth( const std::string & regionId,
+			const std::string & clientId,
+			bool warmup = false );
+
+		CognitoAuth( const std::string & regionId,
+			const std::string & clientId,
+			const CognitoAuthOptions & options );
+
+		// Uses a transport shared with other CognitoAuth instances of the
+		// same region, e.g. one per app client. The transport should come
+		// from MakeTransport() with compatible options.
+		CognitoAuth( const std::string & regionId,
+			const std::string & clientId,
+			std::shared_ptr<CognitoTransport> transport,
+			const CognitoAuthOptions & options );
+
+		// SDK client configuration the options call for.
+		static Aws::Client::ClientConfiguration MakeClientConfig(
+			const std::string & regionId, const CognitoAuthOptions & options );
+
+		// Transport of the kind the options select.
+		static std::shared_ptr<CognitoTransport> MakeTransport(
+			const std::string & regionId, const CognitoAuthOptions & options );
+
+		// Opens the connections to cognito-idp and cognito-identity and
+		// prepares the SRP group and crypto state ahead of the first login.
+		void Warmup();
+
+		// Keeps the warmed connections open while the service is idle.
+		void StartKeepAlive( std::chrono::seconds interval );
+		void StopKeepAlive();
 
 		Aws::Auth::AWSCredentials Authenticate( const std::string & username,
 			const std::string & password,
 			const std::string & userPoolId,
 			const std::string & identityPoolId );
 
+		// Throw when the pool asks for a challenge the login cannot answer
+		// itself; BeginAuthentication() hands such challenges back instead.
 		CognitoTokens AuthenticateWithUserPool( const std::string & username,
 			const std::string & password,
 			const std::string & userPoolId );
+
+		// Authenticate(), AuthenticateWithUserPool() and BeginAuthentication()
+		// without exceptions: a rejected password, throttling or a timeout
+		// come back as an AuthError, cheap enough for a flood of bad logins.
+		// They still throw for failures outside the login, e.g. of a
+		// DeviceKeyStore or out of memory.
+		AuthResult<Aws::Auth::AWSCredentials> TryAuthenticate(
+			const std::string & username,
+			const std::string & password,
+			const std::string & userPoolId,
+			const std::string & identityPoolId );
+
+		AuthResult<CognitoTokens> TryAuthenticateWithUserPool(
+			const std::string & username,
+			const std::string & password,
+			const std::string & userPoolId );
+
+		AuthResult<CognitoAuthSession> TryBeginAuthentication(
+			const std::string & username,
+			const std::string & password,
+			const std::string & userPoolId );
+
+		// Runs the login of the strategy up to the tokens or the first
+		// challenge that needs the user.
+		CognitoAuthSession BeginAuthentication( const std::string & username,
+			const std::string & password,
+			const std::string & userPoolId );
+
+		// Answers the pending challenge; USERNAME and SECRET_HASH are added.
+		// On success the session holds the tokens or the next challenge, on
+		// error it throws and the session is left as it was, so e.g. a
+		// mistyped code can be answered again. When the pool then rejects
+		// the remembered device it asked for, the device is forgotten and
+		// DeviceForgottenException tells the caller to start over. Not
+		// available with AuthStrategy::AdminUserPassword.
+		void RespondToChallenge( CognitoAuthSession & session,
+			const std::map<std::string, std::string> & responses );
+
+		// NEW_PASSWORD_REQUIRED, with values for the attributes the challenge
+		// lists as required (without the "userAttributes." prefix).
+		void RespondWithNewPassword( CognitoAuthSession & session,
+			const std::string & newPassword,
+			const std::map<std::string, std::string> & attributes
+			= std::map<std::string, std::string>() );
+
+		// SMS_MFA or SOFTWARE_TOKEN_MFA.
+		void RespondWithMfaCode(
+			CognitoAuthSession & session, const std::string & code );
+
+		// AWS credentials for an authenticated session.
+		Aws::Auth::AWSCredentials Authenticate(
+			const CognitoAuthSession & session,
+			const std::string & identityPoolId );
+
+		AuthResult<Aws::Auth::AWSCredentials> TryAuthenticate(
+			const CognitoAuthSession & session,
+			const std::string & identityPoolId );
+
+		// Tokens, identity id and credentials from a single login.
+		CognitoLogin Login( const std::string & username,
+			const std::string & password,
+			const std::string & userPoolId,
+			const std::string & identityPoolId );
+
+		AuthResult<CognitoLogin> TryLogin( const std::string & username,
+			const std::string & password,
+			const std::string & userPoolId,
+			const std::string & identityPoolId );
+
+		// New credentials for the id token of an earlier login, without
+		// another SRP handshake, for as long as the token is valid. With
+		// the identity id of that login the GetId call is skipped too.
+		IdentityCredentials GetIdentityCredentials( const std::string & idToken,
+			const std::string & userPoolId,
+			const std::string & identityPoolId,
+			const std::string & identityId = std::string() );
+
+		AuthResult<IdentityCredentials> TryGetIdentityCredentials(
+			const std::string & idToken,
+			const std::string & userPoolId,
+			const std::string & identityPoolId,
+			const std::string & identityId = std::string() );
+
+		// New access and id tokens from a refresh token (REFRESH_TOKEN_AUTH).
+		// The username is only needed with a client secret or a remembered
+		// device; with a secret it must be the pool's user name (the
+		// cognito:username claim), not an alias. The refresh token is carried
+		// over unless the pool rotated it.
+		CognitoTokens RefreshWithUserPool( const std::string & username,
+			const std::string & refreshToken,
+			const std::string & userPoolId );
+
+		// Steps of the login flow, for callers that drive the round trips
+		// themselves. BeginSrp() and MakePasswordVerifierRequest() do the
+		// CPU heavy SRP math, the rest only build requests and results.
+
+		std::shared_ptr<CognitoTransport> GetTransport() const
+		{
+			return m_transport;
+		}
+
+		AuthStrategy GetStrategy() const
+		{
+			return m_options.strategy;
+		}
+
+		const CognitoAuthOptions & GetOptions() const
+		{
+			return m_options;
+		}
+
+		// The negative cache around a login: whether the password is
+		// blocked, with the error to fail with, and how the login ended,
+		// error null on success. Without a cache they do nothing.
+		bool IsRejected( const std::string & userPoolId,
+			const std::string & username,
+			const std::string & password,
+			AuthError & error ) const;
+
+		void RecordLogin( const std::string & userPoolId,
+			const std::string & username,
+			const std::string & password,
+			const AuthError * error ) const;
+
+		// With a loginTimeout the transports send every call once, and the
+		// login resends retryable failures itself while its budget lasts:
+		// whether the failed attempt (counted from zero) gets another one,
+		// and when to send it.
+		bool RetryBefore( std::chrono::steady_clock::time_point deadline,
+			long attempt,
+			bool retryable,
+			std::chrono::steady_clock::time_point & at ) const;
+
+		// Deadline of a login starting now, time_point::max() without a
+		// loginTimeout.
+		std::chrono::steady_clock::time_point LoginDeadline() const;
+
+		// Second attempt delay of a hedged call starting now: the latency
+		// percentile of recent successful calls, at least minDelay.
+		std::chrono::microseconds HedgeDelay( HedgedApi api ) const;
+
+		// Latency of a successful hedged call, first attempt to outcome.
+		void RecordHedgedLatency(
+			HedgedApi api, std::chrono::microseconds latency ) const;
+
+		// The deviceKeyStore around a login; false and no-ops without one.
+		bool LoadDevice( const std::string & userPoolId,
+			const std::string & username,
+			DeviceCredentials & device ) const;
+
+		void ForgetDevice( const std::string & userPoolId,
+			const std::string & username ) const;
+
+		void SaveDevice( const std::string & userPoolId,
+			const std::string & username,
+			const DeviceCredentials & device ) const;
+
+		// Confirms the device the pool handed out with the tokens, and
+		// fills in the secrets to save once it is confirmed (and, when the
+		// pool needs that, marked remembered). Returns false when there is
+		// no device or no deviceKeyStore. Generates the device verifier,
+		// CPU heavy like the SRP math.
+		bool MakeConfirmDeviceRequest(
+			const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeResult & challengeResult,
+			Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest &
+				request,
+			DeviceCredentials & device ) const;
+
+		// Marks the device remembered, for a ConfirmDevice result with
+		// UserConfirmationNecessary.
+		Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusRequest
+		MakeRememberDeviceRequest(
+			const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeResult & challengeResult ) const;
+
+		// The error of a failed call, sorted as the login does; takes the
+		// text out of error.
+		static AuthError MakeError(
+			Aws::Client::AWSError<
+				Aws::CognitoIdentityProvider::CognitoIdentityProviderErrors> &&
+				error );
+
+		static AuthError MakeError( Aws::Client::AWSError<
+			Aws::CognitoIdentity::CognitoIdentityErrors> && error );
+
+		// Base64 HMAC-SHA256 of username + client id keyed with the client
+		// secret, empty without a secret.
+		std::string SecretHash( const std::string & username ) const;
+
+		std::shared_ptr<Srp> BeginSrp() const;
+
+		Aws::CognitoIdentityProvider::Model::InitiateAuthRequest
+		MakeInitiateAuthRequest( const Srp & srp,
+			const std::string & username,
+			const DeviceCredentials * device = nullptr ) const;
+
+		Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeRequest
+		MakePasswordVerifierRequest( Srp & srp,
+			const std::string & username,
+			const std::string & userPoolId,
+			const std::string & password,
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthResult &
+				authResult,
+			const DeviceCredentials * device = nullptr ) const;
+
+		// Answers DEVICE_SRP_AUTH with a fresh SRP A of the device.
+		Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeRequest
+		MakeDeviceSrpRequest( const Srp & srp,
+			const DeviceCredentials & device,
+			const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeResult & challengeResult ) const;
+
+		// Answers DEVICE_PASSWORD_VERIFIER, srp must be the one passed to
+		// MakeDeviceSrpRequest().
+		Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeRequest
+		MakeDevicePasswordVerifierRequest( Srp & srp,
+			const DeviceCredentials & device,
+			const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeResult & challengeResult ) const;
+
+		// Throws when the pool answered with another challenge.
+		CognitoTokens MakeTokens(
+			const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeResult & challengeResult ) const;
+
+		// Answers the session's challenge.
+		Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeRequest
+		MakeChallengeResponseRequest( const CognitoAuthSession & session,
+			const std::map<std::string, std::string> & responses ) const;
+
+		// AuthStrategy::UserPassword: a single InitiateAuth, no SRP.
+		Aws::CognitoIdentityProvider::Model::InitiateAuthRequest
+		MakePasswordAuthRequest( const std::string & username,
+			const std::string & password ) const;
+
+		// AuthStrategy::AdminUserPassword: a single AdminInitiateAuth.
+		Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest
+		MakeAdminPasswordAuthRequest( const std::string & username,
+			const std::string & userPoolId,
+			const std::string & password ) const;
+
+		Aws::CognitoIdentityProvider::Model::InitiateAuthRequest
+		MakeRefreshRequest( const std::string & refreshToken,
+			const std::string & username,
+			const DeviceCredentials * device = nullptr ) const;
+
+		// Throw when the pool answered with a challenge instead of tokens.
+		CognitoTokens MakeTokens(
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthResult &
+				authResult ) const;
+
+		CognitoTokens MakeTokens( const Aws::CognitoIdentityProvider::Model::
+				AdminInitiateAuthResult & authResult ) const;
+
+		Aws::CognitoIdentity::Model::GetIdRequest MakeGetIdRequest(
+			const std::string & idToken,
+			const std::string & userPoolId,
+			const std::string & identityPoolId ) const;
+
+		Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest
+		MakeGetCredentialsRequest( const std::string & identityId,
+			const std::string & idToken,
+			const std::string & userPoolId ) const;
+
+		static Aws::Auth::AWSCredentials MakeCredentials(
+			const Aws::CognitoIdentity::Model::GetCredentialsForIdentityResult &
+				credForIdResult );
+
+		static IdentityCredentials MakeIdentityCredentials(
+			const Aws::CognitoIdentity::Model::GetCredentialsForIdentityResult &
+				credForIdResult );
 	};
 
 } // namespace awsx
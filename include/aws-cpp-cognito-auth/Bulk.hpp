@@ -0,0 +1,131 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_BULK_H
+#define __AWS_CPP_COGNITO_AUTH_BULK_H
+
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Auth.hpp"
+#include "Executor.hpp"
+
+
+namespace awsx {
+
+	struct BulkLoginEntry {
+		std::string username;
+		std::string password;
+		std::string userPoolId;
+		// identity pool lookups are skipped when empty
+		std::string identityPoolId;
+	};
+
+	struct BulkLoginResult {
+		// position in the input list
+		size_t index;
+		bool success;
+		AuthError error;
+
+		CognitoTokens tokens;
+		Aws::Auth::AWSCredentials credentials;
+
+		// from the start of the SRP handshake to the last response
+		std::chrono::microseconds latency;
+	};
+
+	struct BulkLoginStats {
+		size_t succeeded;
+		size_t failed;
+		std::chrono::microseconds elapsed;
+		double loginsPerSecond;
+
+		std::chrono::microseconds p50Latency;
+		std::chrono::microseconds p99Latency;
+		std::chrono::microseconds maxLatency;
+	};
+
+	struct BulkOptions {
+		// Cognito requests on the wire at once
+		size_t maxInFlight;
+
+		// threads doing the SRP math
+		size_t cpuWorkers;
+
+		// CPUs to pin them to, see CpuExecutorOptions::cpus
+		std::vector<unsigned> cpuAffinity;
+
+		// As for CognitoAuth, with the negative cache and the loginTimeout
+		// deadline, which fails a login at its next response and within
+		// which retryable failures are resent. Not used:
+		// deviceKeyStore, bulk logins neither send nor remember devices,
+		// and hedging.
+		CognitoAuthOptions authOptions;
+
+		BulkOptions()
+			: maxInFlight( 64 )
+			, cpuWorkers( std::thread::hardware_concurrency() )
+		{
+		}
+	};
+
+	// Logs in many identities of one app client concurrently. Network waits
+	// of some logins overlap the SRP math of others; in-flight requests and
+	// CPU workers are capped separately.
+	class BulkAuthenticator {
+	protected:
+		BulkOptions m_options;
+		CognitoAuth m_auth;
+		CpuExecutor m_cpu;
+
+	public:
+		typedef std::function<void( const BulkLoginResult & )> ResultHandler;
+
+		BulkAuthenticator( const std::string & regionId,
+			const std::string & clientId,
+			const BulkOptions & options = BulkOptions() );
+
+		BulkAuthenticator( const BulkAuthenticator & ) = delete;
+
+		// Blocks until every entry is done. onResult is called once per
+		// entry as soon as it finishes, never concurrently with itself.
+		BulkLoginStats Run( const std::vector<BulkLoginEntry> & entries,
+			const ResultHandler & onResult );
+
+		// Queue wait of the SRP steps, to tell a CPU bound run from one
+		// waiting on Cognito.
+		CpuExecutorStats GetCpuStats() const
+		{
+			return m_cpu.GetStats();
+		}
+	};
+
+} // namespace awsx
+
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_CLIENTS_H
+#define __AWS_CPP_COGNITO_AUTH_CLIENTS_H
+
+
+#include <memory>
+#include <mutex>
+
+#include "aws/core/client/ClientConfiguration.h"
+
+#include "Transport.hpp"
+
+
+namespace awsx {
+
+	// Transport through the cognito-idp and cognito-identity SDK clients of
+	// a region, so their connection pools survive between logins.
+	class CognitoClients : public CognitoTransport {
+	protected:
+		Aws::Client::ClientConfiguration m_clientConfig;
+
+		// the clients are made on first use, when the SDK is initialized
+		mutable std::once_flag m_cipOnce;
+		mutable std::once_flag m_ciOnce;
+		mutable std::shared_ptr<
+			Aws::CognitoIdentityProvider::CognitoIdentityProviderClient>
+			m_cipClient;
+		mutable std::shared_ptr<Aws::CognitoIdentity::CognitoIdentityClient>
+			m_ciClient;
+
+	public:
+		CognitoClients( const Aws::Client::ClientConfiguration & clientConfig );
+
+		~CognitoClients() override;
+
+		const Aws::Client::ClientConfiguration & GetClientConfig() const
+		{
+			return m_clientConfig;
+		}
+
+		const std::shared_ptr<
+			Aws::CognitoIdentityProvider::CognitoIdentityProviderClient> &
+		IdentityProvider() const;
+
+		const std::shared_ptr<Aws::CognitoIdentity::CognitoIdentityClient> &
+		Identity() const;
+
+		// Builds both clients and sends each endpoint a GET naming no
+		// operation, so DNS, TCP and TLS setup is done before the first login
+		// without calling any API or using up request quota. The replies are
+		// errors and are ignored.
+		void Warmup() override;
+
+		Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome InitiateAuth(
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthRequest &
+				request ) const override;
+
+		void InitiateAuthAsync(
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthRequest &
+				request,
+			const InitiateAuthHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::AdminInitiateAuthOutcome
+		AdminInitiateAuth(
+			const Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest &
+				request ) const override;
+
+		void AdminInitiateAuthAsync(
+			const Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest &
+				request,
+			const AdminInitiateAuthHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeOutcome
+		RespondToAuthChallenge( const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeRequest & request ) const override;
+
+		void RespondToAuthChallengeAsync(
+			const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeRequest & request,
+			const RespondToAuthChallengeHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::ConfirmDeviceOutcome ConfirmDevice(
+			const Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest &
+				request ) const override;
+
+		void ConfirmDeviceAsync(
+			const Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest &
+				request,
+			const ConfirmDeviceHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusOutcome
+		UpdateDeviceStatus( const Aws::CognitoIdentityProvider::Model::
+				UpdateDeviceStatusRequest & request ) const override;
+
+		void UpdateDeviceStatusAsync(
+			const Aws::CognitoIdentityProvider::Model::
+				UpdateDeviceStatusRequest & request,
+			const UpdateDeviceStatusHandler & handler ) const override;
+
+		Aws::CognitoIdentity::Model::GetIdOutcome GetId(
+			const Aws::CognitoIdentity::Model::GetIdRequest & request )
+			const override;
+
+		void GetIdAsync(
+			const Aws::CognitoIdentity::Model::GetIdRequest & request,
+			const GetIdHandler & handler ) const override;
+
+		Aws::CognitoIdentity::Model::GetCredentialsForIdentityOutcome
+		GetCredentialsForIdentity(
+			const Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest &
+				request ) const override;
+
+		void GetCredentialsForIdentityAsync(
+			const Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest &
+				request,
+			const GetCredentialsForIdentityHandler & handler ) const override;
+	};
+
+} // namespace awsx
+
+
+#endif
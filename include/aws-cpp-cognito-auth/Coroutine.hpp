@@ -0,0 +1,1154 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_COROUTINE_H
+#define __AWS_CPP_COGNITO_AUTH_COROUTINE_H
+
+
+// C++20 coroutine front end of CognitoAuth. The library itself builds as
+// C++11, so everything here is header-only and compiles to nothing unless
+// the including translation unit has coroutine support.
+#if defined( __cpp_impl_coroutine )
+
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "aws/cognito-idp/CognitoIdentityProviderClient.h"
+#include "aws/cognito-idp/model/AdminInitiateAuthRequest.h"
+#include "aws/cognito-idp/model/ConfirmDeviceRequest.h"
+#include "aws/cognito-idp/model/InitiateAuthRequest.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeRequest.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusRequest.h"
+
+#include "aws/cognito-identity/CognitoIdentityClient.h"
+#include "aws/cognito-identity/model/GetCredentialsForIdentityRequest.h"
+#include "aws/cognito-identity/model/GetIdRequest.h"
+
+#include "Auth.hpp"
+#include "Device.hpp"
+#include "Executor.hpp"
+
+
+namespace awsx {
+
+	// Lazily started coroutine producing a T; awaiting it starts it and
+	// resumes the awaiter when it finishes.
+	template <typename T>
+	class Task {
+	public:
+		struct promise_type {
+			std::optional<T> m_value;
+			std::exception_ptr m_error;
+			std::coroutine_handle<> m_continuation;
+
+			struct FinalAwaiter {
+				bool await_ready() noexcept
+				{
+					return false;
+				}
+
+				std::coroutine_handle<> await_suspend(
+					std::coroutine_handle<promise_type> h ) noexcept
+				{
+					auto continuation = h.promise().m_continuation;
+
+					return continuation ? continuation : std::noop_coroutine();
+				}
+
+				void await_resume() noexcept
+				{
+				}
+			};
+
+			Task get_return_object()
+			{
+				return Task(
+					std::coroutine_handle<promise_type>::from_promise( *this ) );
+			}
+
+			std::suspend_always initial_suspend() noexcept
+			{
+				return {};
+			}
+
+			FinalAwaiter final_suspend() noexcept
+			{
+				return {};
+			}
+
+			void return_value( T value )
+			{
+				m_value = std::move( value );
+			}
+
+			void unhandled_exception()
+			{
+				m_error = std::current_exception();
+			}
+		};
+
+	protected:
+		std::coroutine_handle<promise_type> m_handle;
+
+		explicit Task( std::coroutine_handle<promise_type> handle )
+			: m_handle( handle )
+		{
+		}
+
+	public:
+		Task( Task && other ) noexcept
+			: m_handle( std::exchange( other.m_handle, nullptr ) )
+		{
+		}
+
+		Task( const Task & ) = delete;
+
+		~Task()
+		{
+			if ( m_handle ) {
+				m_handle.destroy();
+			}
+		}
+
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+
+		std::coroutine_handle<> await_suspend( std::coroutine_handle<> caller )
+		{
+			m_handle.promise().m_continuation = caller;
+
+			return m_handle;
+		}
+
+		T await_resume()
+		{
+			if ( m_handle.promise().m_error ) {
+				std::rethrow_exception( m_handle.promise().m_error );
+			}
+
+			return std::move( *m_handle.promise().m_value );
+		}
+	};
+
+	// Resumes the awaiting coroutine on an executor thread.
+	class ScheduleOn {
+	protected:
+		Executor & m_executor;
+
+	public:
+		explicit ScheduleOn( Executor & executor )
+			: m_executor( executor )
+		{
+		}
+
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+
+		void await_suspend( std::coroutine_handle<> h )
+		{
+			// the coroutine may run, and destroy this awaiter, before
+			// Submit() returns
+			Executor & executor = m_executor;
+			executor.Submit( [h]() { h.resume(); } );
+		}
+
+		void await_resume() const noexcept
+		{
+		}
+	};
+
+	// One thread running callbacks at points in time, for the deadlines,
+	// hedges and retry delays of the coroutine logins. Callbacks run on that
+	// thread, so they must be short and must not throw.
+	class TimerQueue {
+	public:
+		// due time and a sequence number, unique per queue
+		typedef std::pair<std::chrono::steady_clock::time_point, uint64_t>
+			Timer;
+
+	protected:
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::map<Timer, std::function<void()>> m_timers;
+		uint64_t m_next;
+		bool m_stop;
+		std::thread m_thread;
+
+	protected:
+		void Run()
+		{
+			std::unique_lock<std::mutex> lock( m_mutex );
+
+			while ( !m_stop ) {
+				if ( m_timers.empty() ) {
+					m_condition.wait( lock );
+					continue;
+				}
+
+				auto first = m_timers.begin();
+				// a copy, the timer may be cancelled while waiting
+				auto due = first->first.first;
+
+				if ( due > std::chrono::steady_clock::now() ) {
+					m_condition.wait_until( lock, due );
+					continue;
+				}
+
+				auto callback = std::move( first->second );
+				m_timers.erase( first );
+
+				lock.unlock();
+				callback();
+				lock.lock();
+			}
+		}
+
+	public:
+		TimerQueue()
+			: m_next( 1 )
+			, m_stop( false )
+			, m_thread( [this]() { Run(); } )
+		{
+		}
+
+		TimerQueue( const TimerQueue & ) = delete;
+
+		// Drops the timers that have not fired.
+		~TimerQueue()
+		{
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				m_stop = true;
+			}
+
+			m_condition.notify_one();
+			m_thread.join();
+		}
+
+		// The queue of the coroutine logins, started on first use.
+		static TimerQueue & Instance()
+		{
+			static TimerQueue s_instance;
+
+			return s_instance;
+		}
+
+		Timer Add( std::chrono::steady_clock::time_point at,
+			std::function<void()> callback )
+		{
+			Timer timer;
+			bool first;
+
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+
+				timer = Timer( at, m_next++ );
+				m_timers.emplace( timer, std::move( callback ) );
+				first = m_timers.begin()->first == timer;
+			}
+
+			if ( first ) {
+				m_condition.notify_one();
+			}
+
+			return timer;
+		}
+
+		// Does nothing once the timer fired.
+		void Cancel( const Timer & timer )
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_timers.erase( timer );
+		}
+	};
+
+	// Resumes the awaiting coroutine on the TimerQueue thread at a point in
+	// time, e.g. for a retry delay.
+	class SleepUntil {
+	protected:
+		std::chrono::steady_clock::time_point m_at;
+
+	public:
+		explicit SleepUntil( std::chrono::steady_clock::time_point at )
+			: m_at( at )
+		{
+		}
+
+		bool await_ready() const noexcept
+		{
+			return m_at <= std::chrono::steady_clock::now();
+		}
+
+		void await_suspend( std::coroutine_handle<> h )
+		{
+			TimerQueue::Instance().Add( m_at, [h]() { h.resume(); } );
+		}
+
+		void await_resume() const noexcept
+		{
+		}
+	};
+
+	// Suspends across one async transport call and yields its outcome. The
+	// coroutine resumes on the transport thread that delivered it, or with
+	// no outcome on the TimerQueue thread when the deadline set by Until()
+	// passed first; the call then still runs, but nothing waits for it.
+	// With HedgeAfter() a second identical request goes out when the first
+	// has not answered by then, and the first success wins, so only for
+	// idempotent calls. Awaiting the same SdkCall again sends it again.
+	template <typename TOutcome>
+	class SdkCall {
+	public:
+		typedef std::function<void( const TOutcome & )> Completion;
+		typedef std::function<void( Completion )> Launch;
+
+	protected:
+		// State of one await, shared with the completions and timers, which
+		// may outlive the awaiter.
+		struct Race {
+			std::mutex mutex;
+			std::coroutine_handle<> coroutine;
+			// requests sent and not answered
+			int pending;
+			bool done;
+			std::optional<TOutcome> outcome;
+			TimerQueue::Timer deadlineTimer;
+			TimerQueue::Timer hedgeTimer;
+
+			explicit Race( std::coroutine_handle<> h )
+				: coroutine( h )
+				, pending( 1 )
+				, done( false )
+			{
+			}
+
+			// Ends the race with the first success, or with the last
+			// error once no request is left.
+			void Complete( const TOutcome & result )
+			{
+				{
+					std::lock_guard<std::mutex> lock( mutex );
+					--pending;
+
+					if ( done || ( !result.IsSuccess() && pending > 0 ) ) {
+						return;
+					}
+
+					outcome = result;
+					done = true;
+				}
+
+				Resume();
+			}
+
+			void Expire()
+			{
+				{
+					std::lock_guard<std::mutex> lock( mutex );
+
+					if ( done ) {
+						return;
+					}
+
+					done = true;
+				}
+
+				Resume();
+			}
+
+			// Whether the second request still has to go out.
+			bool Hedge()
+			{
+				std::lock_guard<std::mutex> lock( mutex );
+
+				if ( done ) {
+					return false;
+				}
+
+				++pending;
+
+				return true;
+			}
+
+			void Resume()
+			{
+				TimerQueue::Instance().Cancel( deadlineTimer );
+				TimerQueue::Instance().Cancel( hedgeTimer );
+				coroutine.resume();
+			}
+		};
+
+		Launch m_launch;
+		std::chrono::steady_clock::time_point m_deadline;
+		// zero for no hedge
+		std::chrono::microseconds m_hedgeAfter;
+		std::shared_ptr<Race> m_race;
+
+	public:
+		explicit SdkCall( Launch launch )
+			: m_launch( std::move( launch ) )
+			, m_deadline( std::chrono::steady_clock::time_point::max() )
+			, m_hedgeAfter( 0 )
+		{
+		}
+
+		SdkCall & Until( std::chrono::steady_clock::time_point deadline )
+		{
+			m_deadline = deadline;
+
+			return *this;
+		}
+
+		SdkCall & HedgeAfter( std::chrono::microseconds delay )
+		{
+			m_hedgeAfter = delay;
+
+			return *this;
+		}
+
+		// past the deadline nothing is sent
+		bool await_ready()
+		{
+			m_race.reset();
+
+			return m_deadline <= std::chrono::steady_clock::now();
+		}
+
+		void await_suspend( std::coroutine_handle<> h )
+		{
+			auto race = std::make_shared<Race>( h );
+			m_race = race;
+
+			// once the first timer is set, the coroutine may resume, and
+			// destroy this awaiter, at any time
+			Launch launch = m_launch;
+			Completion done = [race]( const TOutcome & outcome ) {
+				race->Complete( outcome );
+			};
+			auto deadline = m_deadline;
+			bool timed
+				= deadline != std::chrono::steady_clock::time_point::max();
+			auto hedgeAt = std::chrono::steady_clock::now() + m_hedgeAfter;
+			bool hedge = m_hedgeAfter.count() > 0 && hedgeAt < deadline;
+
+			auto & timers = TimerQueue::Instance();
+
+			{
+				std::lock_guard<std::mutex> lock( race->mutex );
+
+				if ( timed ) {
+					race->deadlineTimer
+						= timers.Add( deadline, [race]() { race->Expire(); } );
+				}
+
+				if ( hedge ) {
+					race->hedgeTimer
+						= timers.Add( hedgeAt, [race, launch, done]() {
+							  if ( race->Hedge() ) {
+								  launch( done );
+							  }
+						  } );
+				}
+			}
+
+			launch( done );
+		}
+
+		std::optional<TOutcome> await_resume()
+		{
+			if ( !m_race ) {
+				return std::nullopt;
+			}
+
+			return std::move( m_race->outcome );
+		}
+	};
+
+	namespace coro {
+
+		typedef std::chrono::steady_clock::time_point Deadline;
+
+		// Throws what the blocking calls throw for the error, see
+		// AuthError::Throw(); the outcome is left without its error.
+		template <typename TOutcome>
+		void ThrowIfFailed( TOutcome & outcome )
+		{
+			if ( !outcome.IsSuccess() ) {
+				CognitoAuth::MakeError( outcome.GetErrorWithOwnership() )
+					.Throw();
+			}
+		}
+
+		// The pool no longer knows the remembered device, the login has to
+		// start over without it.
+		template <typename TOutcome>
+		bool IsStaleDevice( const TOutcome & outcome )
+		{
+			return !outcome.IsSuccess()
+				&& outcome.GetError().GetErrorType()
+				== Aws::CognitoIdentityProvider::
+					CognitoIdentityProviderErrors::RESOURCE_NOT_FOUND;
+		}
+
+		inline SdkCall<Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome>
+		InitiateAuth( CognitoTransport & transport,
+			Aws::CognitoIdentityProvider::Model::InitiateAuthRequest request )
+		{
+			typedef Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome
+				Outcome;
+
+			return SdkCall<Outcome>(
+				[&transport, request]( SdkCall<Outcome>::Completion done ) {
+					transport.InitiateAuthAsync( request, done );
+				} );
+		}
+
+		inline SdkCall<
+			Aws::CognitoIdentityProvider::Model::AdminInitiateAuthOutcome>
+		AdminInitiateAuth( CognitoTransport & transport,
+			Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest
+				request )
+		{
+			typedef Aws::CognitoIdentityProvider::Model::
+				AdminInitiateAuthOutcome Outcome;
+
+			return SdkCall<Outcome>(
+				[&transport, request]( SdkCall<Outcome>::Completion done ) {
+					transport.AdminInitiateAuthAsync( request, done );
+				} );
+		}
+
+		inline SdkCall<
+			Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeOutcome>
+		RespondToAuthChallenge( CognitoTransport & transport,
+			Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeRequest
+				request )
+		{
+			typedef Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeOutcome Outcome;
+
+			return SdkCall<Outcome>(
+				[&transport, request]( SdkCall<Outcome>::Completion done ) {
+					transport.RespondToAuthChallengeAsync( request, done );
+				} );
+		}
+
+		inline SdkCall<
+			Aws::CognitoIdentityProvider::Model::ConfirmDeviceOutcome>
+		ConfirmDevice( CognitoTransport & transport,
+			Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest request )
+		{
+			typedef Aws::CognitoIdentityProvider::Model::ConfirmDeviceOutcome
+				Outcome;
+
+			return SdkCall<Outcome>(
+				[&transport, request]( SdkCall<Outcome>::Completion done ) {
+					transport.ConfirmDeviceAsync( request, done );
+				} );
+		}
+
+		inline SdkCall<
+			Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusOutcome>
+		UpdateDeviceStatus( CognitoTransport & transport,
+			Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusRequest
+				request )
+		{
+			typedef Aws::CognitoIdentityProvider::Model::
+				UpdateDeviceStatusOutcome Outcome;
+
+			return SdkCall<Outcome>(
+				[&transport, request]( SdkCall<Outcome>::Completion done ) {
+					transport.UpdateDeviceStatusAsync( request, done );
+				} );
+		}
+
+		inline SdkCall<Aws::CognitoIdentity::Model::GetIdOutcome> GetId(
+			CognitoTransport & transport,
+			Aws::CognitoIdentity::Model::GetIdRequest request )
+		{
+			typedef Aws::CognitoIdentity::Model::GetIdOutcome Outcome;
+
+			return SdkCall<Outcome>(
+				[&transport, request]( SdkCall<Outcome>::Completion done ) {
+					transport.GetIdAsync( request, done );
+				} );
+		}
+
+		inline SdkCall<
+			Aws::CognitoIdentity::Model::GetCredentialsForIdentityOutcome>
+		GetCredentialsForIdentity( CognitoTransport & transport,
+			Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest
+				request )
+		{
+			typedef Aws::CognitoIdentity::Model::
+				GetCredentialsForIdentityOutcome Outcome;
+
+			return SdkCall<Outcome>(
+				[&transport, request]( SdkCall<Outcome>::Completion done ) {
+					transport.GetCredentialsForIdentityAsync( request, done );
+				} );
+		}
+
+		// Awaits the call until the deadline, resending retryable failures
+		// as CognitoAuth::RetryBefore() allows; no outcome when the deadline
+		// passed first.
+		template <typename TOutcome>
+		Task<std::optional<TOutcome>> Call( const CognitoAuth & auth,
+			SdkCall<TOutcome> call,
+			Deadline deadline )
+		{
+			call.Until( deadline );
+
+			for ( long attempt = 0;; attempt++ ) {
+				auto outcome = co_await call;
+				Deadline retryAt;
+
+				if ( !outcome || outcome->IsSuccess()
+					|| !auth.RetryBefore( deadline,
+						attempt,
+						outcome->GetError().ShouldRetry(),
+						retryAt ) ) {
+					co_return outcome;
+				}
+
+				co_await SleepUntil( retryAt );
+			}
+		}
+
+		// Call() for GetId and GetCredentialsForIdentity, hedged when the
+		// options enable it.
+		template <typename TOutcome>
+		Task<std::optional<TOutcome>> Hedged( const CognitoAuth & auth,
+			HedgedApi api,
+			SdkCall<TOutcome> call,
+			Deadline deadline )
+		{
+			if ( !auth.GetOptions().hedging.enabled ) {
+				co_return co_await Call( auth, std::move( call ), deadline );
+			}
+
+			call.Until( deadline );
+
+			for ( long attempt = 0;; attempt++ ) {
+				auto started = std::chrono::steady_clock::now();
+				auto outcome
+					= co_await call.HedgeAfter( auth.HedgeDelay( api ) );
+
+				if ( outcome && outcome->IsSuccess() ) {
+					auth.RecordHedgedLatency( api,
+						std::chrono::duration_cast<std::chrono::microseconds>(
+							std::chrono::steady_clock::now() - started ) );
+				}
+
+				Deadline retryAt;
+
+				if ( !outcome || outcome->IsSuccess()
+					|| !auth.RetryBefore( deadline,
+						attempt,
+						outcome->GetError().ShouldRetry(),
+						retryAt ) ) {
+					co_return outcome;
+				}
+
+				co_await SleepUntil( retryAt );
+			}
+		}
+
+		// The DEVICE_SRP_AUTH and DEVICE_PASSWORD_VERIFIER rounds of a
+		// remembered device. Sets forgotten when the pool rejected the
+		// device and it was dropped; the password was fine, the login can
+		// start over.
+		inline Task<AuthResult<
+			Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeResult>>
+		DeviceSrp( CognitoAuth & auth,
+			Executor & cpu,
+			std::string userPoolId,
+			std::string username,
+			DeviceCredentials device,
+			Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeResult
+				challengeResult,
+			Deadline deadline,
+			bool & forgotten )
+		{
+			using namespace Aws::CognitoIdentityProvider;
+
+			auto transport = auth.GetTransport();
+			forgotten = false;
+
+			co_await ScheduleOn( cpu );
+			auto srp = auth.BeginSrp();
+
+			auto deviceRequest
+				= auth.MakeDeviceSrpRequest( *srp, device, challengeResult );
+
+			auto deviceOutcome = co_await Call( auth,
+				RespondToAuthChallenge( *transport, deviceRequest ),
+				deadline );
+
+			if ( !deviceOutcome ) {
+				co_return AuthError::Timeout( "RespondToAuthChallenge" );
+			}
+
+			if ( IsStaleDevice( *deviceOutcome ) ) {
+				auth.ForgetDevice( userPoolId, username );
+				forgotten = true;
+			}
+
+			if ( !deviceOutcome->IsSuccess() ) {
+				co_return CognitoAuth::MakeError(
+					deviceOutcome->GetErrorWithOwnership() );
+			}
+
+			co_await ScheduleOn( cpu );
+			auto verifierRequest = auth.MakeDevicePasswordVerifierRequest(
+				*srp, device, deviceOutcome->GetResult() );
+
+			auto verifierOutcome = co_await Call( auth,
+				RespondToAuthChallenge( *transport, verifierRequest ),
+				deadline );
+
+			if ( !verifierOutcome ) {
+				co_return AuthError::Timeout( "RespondToAuthChallenge" );
+			}
+
+			if ( IsStaleDevice( *verifierOutcome )
+				|| ( !verifierOutcome->IsSuccess()
+					&& verifierOutcome->GetError().GetErrorType()
+						== CognitoIdentityProviderErrors::NOT_AUTHORIZED ) ) {
+				// the stored device password no longer matches
+				auth.ForgetDevice( userPoolId, username );
+				forgotten = true;
+			}
+
+			if ( !verifierOutcome->IsSuccess() ) {
+				co_return CognitoAuth::MakeError(
+					verifierOutcome->GetErrorWithOwnership() );
+			}
+
+			co_return verifierOutcome->GetResult();
+		}
+
+		// Confirms and stores the device the pool handed out with the
+		// tokens. Failures only cost the next login its shortcut; the
+		// result tells whether the device was stored.
+		inline Task<bool> RememberDevice( CognitoAuth & auth,
+			Executor & cpu,
+			std::string userPoolId,
+			std::string username,
+			Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeResult
+				challengeResult,
+			Deadline deadline )
+		{
+			if ( !auth.GetOptions().deviceKeyStore
+				|| challengeResult.GetAuthenticationResult()
+					   .GetNewDeviceMetadata()
+					   .GetDeviceKey()
+					   .empty() ) {
+				co_return false;
+			}
+
+			auto transport = auth.GetTransport();
+
+			Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest
+				confirmRequest;
+			DeviceCredentials device;
+
+			co_await ScheduleOn( cpu );
+			auth.MakeConfirmDeviceRequest(
+				challengeResult, confirmRequest, device );
+
+			auto confirmOutcome = co_await Call(
+				auth, ConfirmDevice( *transport, confirmRequest ), deadline );
+
+			if ( !confirmOutcome || !confirmOutcome->IsSuccess() ) {
+				co_return false;
+			}
+
+			if ( confirmOutcome->GetResult().GetUserConfirmationNecessary() ) {
+				auto statusOutcome = co_await Call( auth,
+					UpdateDeviceStatus( *transport,
+						auth.MakeRememberDeviceRequest( challengeResult ) ),
+					deadline );
+
+				if ( !statusOutcome || !statusOutcome->IsSuccess() ) {
+					co_return false;
+				}
+			}
+
+			auth.SaveDevice( userPoolId, username, device );
+
+			co_return true;
+		}
+
+		// USER_SRP_AUTH with the remembered device, if any. After a stale
+		// device it starts over once, without one.
+		inline Task<AuthResult<CognitoTokens>> SrpLogin( CognitoAuth & auth,
+			Executor & cpu,
+			std::string username,
+			std::string password,
+			std::string userPoolId,
+			Deadline deadline,
+			bool deviceDropped )
+		{
+			using namespace Aws::CognitoIdentityProvider::Model;
+
+			auto transport = auth.GetTransport();
+
+			DeviceCredentials device;
+			bool hasDevice = !deviceDropped
+				&& auth.LoadDevice( userPoolId, username, device );
+
+			co_await ScheduleOn( cpu );
+			auto srp = auth.BeginSrp();
+
+			auto authOutcome = co_await Call( auth,
+				InitiateAuth( *transport,
+					auth.MakeInitiateAuthRequest(
+						*srp, username, hasDevice ? &device : nullptr ) ),
+				deadline );
+
+			if ( !authOutcome ) {
+				co_return AuthError::Timeout( "InitiateAuth" );
+			}
+
+			if ( hasDevice && IsStaleDevice( *authOutcome ) ) {
+				auth.ForgetDevice( userPoolId, username );
+
+				co_return co_await SrpLogin(
+					auth, cpu, username, password, userPoolId, deadline, true );
+			}
+
+			if ( !authOutcome->IsSuccess() ) {
+				co_return CognitoAuth::MakeError(
+					authOutcome->GetErrorWithOwnership() );
+			}
+
+			co_await ScheduleOn( cpu );
+			auto challengeRequest = auth.MakePasswordVerifierRequest( *srp,
+				username,
+				userPoolId,
+				password,
+				authOutcome->GetResult(),
+				hasDevice ? &device : nullptr );
+
+			auto challengeOutcome = co_await Call( auth,
+				RespondToAuthChallenge( *transport, challengeRequest ),
+				deadline );
+
+			if ( !challengeOutcome ) {
+				co_return AuthError::Timeout( "RespondToAuthChallenge" );
+			}
+
+			if ( hasDevice && IsStaleDevice( *challengeOutcome ) ) {
+				auth.ForgetDevice( userPoolId, username );
+
+				co_return co_await SrpLogin(
+					auth, cpu, username, password, userPoolId, deadline, true );
+			}
+
+			if ( !challengeOutcome->IsSuccess() ) {
+				co_return CognitoAuth::MakeError(
+					challengeOutcome->GetErrorWithOwnership() );
+			}
+
+			RespondToAuthChallengeResult result = challengeOutcome->GetResult();
+
+			if ( result.GetChallengeName()
+				== ChallengeNameType::DEVICE_SRP_AUTH ) {
+				if ( !hasDevice ) {
+					co_return AuthError( AuthErrorCode::Service,
+						nullptr,
+						"DEVICE_SRP_AUTH: no remembered device" );
+				}
+
+				bool forgotten;
+				auto deviceResult = co_await DeviceSrp( auth,
+					cpu,
+					userPoolId,
+					username,
+					device,
+					result,
+					deadline,
+					forgotten );
+
+				// a NOT_AUTHORIZED about the device must not reach the
+				// negative cache as a wrong password
+				if ( forgotten ) {
+					co_return co_await SrpLogin( auth,
+						cpu,
+						username,
+						password,
+						userPoolId,
+						deadline,
+						true );
+				}
+
+				if ( !deviceResult ) {
+					co_return deviceResult.Error();
+				}
+
+				result = deviceResult.Value();
+			}
+
+			transport->Touch();
+
+			auto tokens = auth.MakeTokens( result );
+
+			co_await RememberDevice(
+				auth, cpu, userPoolId, username, result, deadline );
+
+			co_return tokens;
+		}
+
+		// The round trips of CoAuthenticateWithUserPool(), errors of the
+		// service and timeouts come back as the AuthError.
+		inline Task<AuthResult<CognitoTokens>> UserPoolLogin(
+			CognitoAuth & auth,
+			Executor & cpu,
+			std::string username,
+			std::string password,
+			std::string userPoolId,
+			Deadline deadline )
+		{
+			auto transport = auth.GetTransport();
+
+			if ( auth.GetStrategy() == AuthStrategy::UserPassword ) {
+				auto outcome = co_await Call( auth,
+					InitiateAuth( *transport,
+						auth.MakePasswordAuthRequest( username, password ) ),
+					deadline );
+
+				if ( !outcome ) {
+					co_return AuthError::Timeout( "InitiateAuth" );
+				}
+
+				if ( !outcome->IsSuccess() ) {
+					co_return CognitoAuth::MakeError(
+						outcome->GetErrorWithOwnership() );
+				}
+
+				transport->Touch();
+
+				co_return auth.MakeTokens( outcome->GetResult() );
+			}
+
+			if ( auth.GetStrategy() == AuthStrategy::AdminUserPassword ) {
+				auto outcome = co_await Call( auth,
+					AdminInitiateAuth( *transport,
+						auth.MakeAdminPasswordAuthRequest(
+							username, userPoolId, password ) ),
+					deadline );
+
+				if ( !outcome ) {
+					co_return AuthError::Timeout( "AdminInitiateAuth" );
+				}
+
+				if ( !outcome->IsSuccess() ) {
+					co_return CognitoAuth::MakeError(
+						outcome->GetErrorWithOwnership() );
+				}
+
+				transport->Touch();
+
+				co_return auth.MakeTokens( outcome->GetResult() );
+			}
+
+			co_return co_await SrpLogin(
+				auth, cpu, username, password, userPoolId, deadline, false );
+		}
+
+		// UserPoolLogin() behind the negative cache, throwing its errors on
+		// cpu.
+		inline Task<CognitoTokens> AuthenticateWithUserPool(
+			CognitoAuth & auth,
+			Executor & cpu,
+			std::string username,
+			std::string password,
+			std::string userPoolId,
+			Deadline deadline )
+		{
+			AuthError rejected;
+
+			if ( auth.IsRejected( userPoolId, username, password, rejected ) ) {
+				rejected.Throw();
+			}
+
+			auto tokens = co_await UserPoolLogin(
+				auth, cpu, username, password, userPoolId, deadline );
+
+			co_await ScheduleOn( cpu );
+
+			auth.RecordLogin( userPoolId,
+				username,
+				password,
+				tokens ? nullptr : &tokens.Error() );
+
+			co_return std::move( tokens.Value() );
+		}
+
+	} // namespace coro
+
+	// Awaitable AuthenticateWithUserPool(). SRP math runs on cpu, e.g. a
+	// CpuExecutor, the round trips suspend the coroutine; the result is
+	// delivered on cpu. Errors throw as in AuthenticateWithUserPool(), and
+	// the negative cache, loginTimeout, retries and deviceKeyStore apply as
+	// there.
+	// The strings are taken by value as they must outlive the suspensions.
+	inline Task<CognitoTokens> CoAuthenticateWithUserPool( CognitoAuth & auth,
+		Executor & cpu,
+		std::string username,
+		std::string password,
+		std::string userPoolId )
+	{
+		co_return co_await coro::AuthenticateWithUserPool( auth,
+			cpu,
+			username,
+			password,
+			userPoolId,
+			auth.LoginDeadline() );
+	}
+
+	// Awaitable Authenticate(); as CoAuthenticateWithUserPool(), with the
+	// identity calls hedged when the options enable it. One loginTimeout
+	// covers the whole login.
+	inline Task<Aws::Auth::AWSCredentials> CoAuthenticate( CognitoAuth & auth,
+		Executor & cpu,
+		std::string username,
+		std::string password,
+		std::string userPoolId,
+		std::string identityPoolId )
+	{
+		auto transport = auth.GetTransport();
+		auto deadline = auth.LoginDeadline();
+
+		auto tokens = co_await coro::AuthenticateWithUserPool(
+			auth, cpu, username, password, userPoolId, deadline );
+
+		auto idOutcome = co_await coro::Hedged( auth,
+			HedgedApi::GetId,
+			coro::GetId( *transport,
+				auth.MakeGetIdRequest(
+					tokens.GetIdToken(), userPoolId, identityPoolId ) ),
+			deadline );
+
+		if ( !idOutcome || !idOutcome->IsSuccess() ) {
+			co_await ScheduleOn( cpu );
+
+			if ( !idOutcome ) {
+				AuthError::Timeout( "GetId" ).Throw();
+			}
+
+			coro::ThrowIfFailed( *idOutcome );
+		}
+
+		auto credOutcome = co_await coro::Hedged( auth,
+			HedgedApi::GetCredentialsForIdentity,
+			coro::GetCredentialsForIdentity( *transport,
+				auth.MakeGetCredentialsRequest(
+					idOutcome->GetResult().GetIdentityId().c_str(),
+					tokens.GetIdToken(),
+					userPoolId ) ),
+			deadline );
+
+		co_await ScheduleOn( cpu );
+
+		if ( !credOutcome ) {
+			AuthError::Timeout( "GetCredentialsForIdentity" ).Throw();
+		}
+
+		coro::ThrowIfFailed( *credOutcome );
+		transport->Touch();
+
+		co_return CognitoAuth::MakeCredentials( credOutcome->GetResult() );
+	}
+
+	// Runs a task from non-coroutine code; done gets either the error or a
+	// pointer to the result.
+	struct DetachedTask {
+		struct promise_type {
+			DetachedTask get_return_object() noexcept
+			{
+				return {};
+			}
+
+			std::suspend_never initial_suspend() noexcept
+			{
+				return {};
+			}
+
+			std::suspend_never final_suspend() noexcept
+			{
+				return {};
+			}
+
+			void return_void() noexcept
+			{
+			}
+
+			void unhandled_exception() noexcept
+			{
+				std::terminate();
+			}
+		};
+	};
+
+	template <typename T>
+	DetachedTask Spawn( Task<T> task,
+		std::function<void( std::exception_ptr, T * )> done )
+	{
+		std::optional<T> result;
+		std::exception_ptr error;
+
+		try {
+			result.emplace( co_await std::move( task ) );
+		}
+		catch ( ... ) {
+			error = std::current_exception();
+		}
+
+		done( error, result ? &*result : nullptr );
+	}
+
+} // namespace awsx
+
+
+#endif
+
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __AWS_CPP_COGNITO_AUTH_CREDENTIALS_CACHE_H
+#define __AWS_CPP_COGNITO_AUTH_CREDENTIALS_CACHE_H
+
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "aws/core/auth/AWSCredentialsProvider.h"
+
+#include "Auth.hpp"
+
+
+namespace awsx {
+
+	// The credentials of one identity, kept fresh on a thread of its own:
+	// it logs in on Start() and again refreshAhead before the credentials
+	// or tokens expire. Failed logins are retried after 1 s, doubling up to
+	// a minute, while the previous credentials are handed out until they
+	// expire.
+	class CredentialsCache : public Aws::Auth::AWSCredentialsProvider {
+	public:
+		struct Login {
+			// grows with each login, starting at one
+			uint64_t generation;
+
+			// of the credentials and tokens, whichever ends first
+			std::chrono::system_clock::time_point expiration;
+
+			CognitoTokens tokens;
+			std::string identityId;
+			Aws::Auth::AWSCredentials credentials;
+		};
+
+		// runs on the refresh thread
+		typedef std::function<void( const Login & )> Listener;
+
+	protected:
+		CognitoAuth & m_auth;
+
+		std::string m_username;
+		std::string m_password;
+		std::string m_userPoolId;
+		std::string m_identityPoolId;
+		std::chrono::seconds m_refreshAhead;
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::thread m_thread;
+		bool m_stop;
+
+		std::shared_ptr<const Login> m_login;
+		std::string m_lastError;
+
+	protected:
+		void RefreshLoop( Listener listener );
+
+	public:
+		// auth must outlive the cache.
+		CredentialsCache( CognitoAuth & auth,
+			const std::string & username,
+			const std::string & password,
+			const std::string & userPoolId,
+			const std::string & identityPoolId,
+			std::chrono::seconds refreshAhead = std::chrono::seconds( 300 ) );
+
+		CredentialsCache( const CredentialsCache & ) = delete;
+
+		~CredentialsCache() override;
+
+		// Starts the refresh; listener, when set, sees every new login.
+		void Start( const Listener & listener = Listener() );
+
+		void Stop();
+
+		// Waits for the first login, false when there is none by then.
+		bool WaitReady( std::chrono::milliseconds timeout );
+
+		// Null before the first login.
+		std::shared_ptr<const Login> GetLogin() const;
+
+		// Why the last login failed, empty after a success.
+		std::string GetLastError() const;
+
+		// Empty before the first login and once the last one expired.
+		Aws::Auth::AWSCredentials GetAWSCredentials() override;
+	};
+
+} // namespace awsx
+
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_DEVICE_H
+#define __AWS_CPP_COGNITO_AUTH_DEVICE_H
+
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+
+namespace awsx {
+
+	// Secrets of a device remembered by a user pool (DEVICE_SRP_AUTH).
+	struct DeviceCredentials {
+		std::string deviceKey;
+		std::string deviceGroupKey;
+		std::string devicePassword;
+	};
+
+	class DeviceKeyStore {
+	public:
+		virtual ~DeviceKeyStore()
+		{
+		}
+
+		virtual bool Load( const std::string & userPoolId,
+			const std::string & username,
+			DeviceCredentials & out )
+			= 0;
+
+		virtual void Save( const std::string & userPoolId,
+			const std::string & username,
+			const DeviceCredentials & device )
+			= 0;
+
+		virtual void Forget(
+			const std::string & userPoolId, const std::string & username )
+			= 0;
+	};
+
+	class MemoryDeviceKeyStore : public DeviceKeyStore {
+	protected:
+		typedef std::pair<std::string, std::string> Key;
+
+		std::mutex m_mutex;
+		std::map<Key, DeviceCredentials> m_devices;
+
+	public:
+		bool Load( const std::string & userPoolId,
+			const std::string & username,
+			DeviceCredentials & out ) override
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+
+			auto it = m_devices.find( Key( userPoolId, username ) );
+
+			if ( it == m_devices.end() ) {
+				return false;
+			}
+
+			out = it->second;
+
+			return true;
+		}
+
+		void Save( const std::string & userPoolId,
+			const std::string & username,
+			const DeviceCredentials & device ) override
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_devices[Key( userPoolId, username )] = device;
+		}
+
+		void Forget( const std::string & userPoolId,
+			const std::string & username ) override
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_devices.erase( Key( userPoolId, username ) );
+		}
+	};
+
+	// Keeps the devices in a tab separated text file, one per line, so they
+	// survive restarts. The file holds device passwords: on POSIX it is
+	// created owner-only (0600), on Windows it takes the directory's ACL,
+	// which must be kept private. Save() and Forget() throw when the file
+	// cannot be replaced.
+	class FileDeviceKeyStore : public MemoryDeviceKeyStore {
+	protected:
+		std::string m_path;
+
+	protected:
+		void Write();
+
+	public:
+		FileDeviceKeyStore( const std::string & path );
+
+		void Save( const std::string & userPoolId,
+			const std::string & username,
+			const DeviceCredentials & device ) override;
+
+		void Forget( const std::string & userPoolId,
+			const std::string & username ) override;
+	};
+
+} // namespace awsx
+
+
+#endif
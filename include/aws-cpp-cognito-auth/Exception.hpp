@@ -52,6 +52,37 @@ namespace awsx {
 		}
 	};
 
+	// Thrown when a login does not finish within its time budget.
+	class TimeoutException : public Exception {
+	public:
+		TimeoutException( const std::string & message )
+			: Exception( message )
+		{
+		}
+	};
+
+	// Thrown when the user pool rejects the username or password
+	// (NotAuthorizedException, UserNotFoundException), also for logins a
+	// NegativeCache fails without asking the pool.
+	class NotAuthorizedException : public Exception {
+	public:
+		NotAuthorizedException( const std::string & message )
+			: Exception( message )
+		{
+		}
+	};
+
+	// Thrown by CognitoAuth::RespondToChallenge() when the pool rejected
+	// the remembered device it asked for. The device was dropped from the
+	// DeviceKeyStore; the login has to start over and then goes without it.
+	class DeviceForgottenException : public Exception {
+	public:
+		DeviceForgottenException( const std::string & message )
+			: Exception( message )
+		{
+		}
+	};
+
 } // namespace awsx
 
 
@@ -0,0 +1,187 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_EXECUTOR_H
+#define __AWS_CPP_COGNITO_AUTH_EXECUTOR_H
+
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace awsx {
+
+	class Executor {
+	public:
+		virtual ~Executor()
+		{
+		}
+
+		// Tasks must not throw: there is no one to hand the exception to.
+		// The pools below stop in an assert in debug builds; otherwise the
+		// worker counts the task as failed and goes on with the next one.
+		virtual void Submit( std::function<void()> task ) = 0;
+	};
+
+	// Fixed number of threads sharing one FIFO queue.
+	class ThreadPool : public Executor {
+	protected:
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::deque<std::function<void()>> m_tasks;
+		std::vector<std::thread> m_threads;
+		bool m_stop;
+
+		std::atomic<uint64_t> m_failed;
+
+	protected:
+		void Run();
+
+	public:
+		ThreadPool( size_t threads );
+
+		ThreadPool( const ThreadPool & ) = delete;
+
+		// Runs the queued tasks to completion before returning.
+		~ThreadPool() override;
+
+		void Submit( std::function<void()> task ) override;
+
+		size_t Size() const
+		{
+			return m_threads.size();
+		}
+
+		// tasks that threw
+		uint64_t Failed() const
+		{
+			return m_failed;
+		}
+	};
+
+	struct CpuExecutorOptions {
+		// worker threads, one per core when 0
+		size_t threads;
+
+		// tasks waiting at once before Submit() throws, no limit when 0
+		size_t maxQueued;
+
+		// worker i is pinned to cpus[i % cpus.size()], not pinned when
+		// empty; ignored where the platform has no thread affinity
+		std::vector<unsigned> cpus;
+
+		CpuExecutorOptions()
+			: threads( 0 )
+			, maxQueued( 0 )
+		{
+		}
+	};
+
+	struct CpuExecutorStats {
+		size_t queued;
+		uint64_t executed;
+		uint64_t rejected;
+		// tasks that threw, see Executor::Submit()
+		uint64_t failed;
+		// tasks run by another worker than the one they were queued on
+		uint64_t stolen;
+
+		// time the executed tasks waited for a worker; a growing wait means
+		// the CPU, not the network, is the bottleneck
+		std::chrono::microseconds totalQueueWait;
+		std::chrono::microseconds maxQueueWait;
+	};
+
+	// Work stealing pool for the SRP and HKDF math of asynchronous logins,
+	// so that the transport threads only ever wait on the network. Every
+	// worker has its own queue; tasks submitted by a worker stay on its
+	// queue, others are spread round robin, and idle workers take from the
+	// queues of busy ones.
+	class CpuExecutor : public Executor {
+	protected:
+		struct Task {
+			std::function<void()> run;
+			std::chrono::steady_clock::time_point queued;
+		};
+
+		struct Worker {
+			std::mutex mutex;
+			std::deque<Task> tasks;
+			std::thread thread;
+		};
+
+		CpuExecutorOptions m_options;
+		std::vector<std::unique_ptr<Worker>> m_workers;
+
+		// sleeping workers wait on m_condition for m_queued to rise
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_stop;
+
+		std::atomic<size_t> m_queued;
+		std::atomic<size_t> m_next;
+		std::atomic<uint64_t> m_executed;
+		std::atomic<uint64_t> m_rejected;
+		std::atomic<uint64_t> m_failed;
+		std::atomic<uint64_t> m_stolen;
+		std::atomic<int64_t> m_totalWait;
+		std::atomic<int64_t> m_maxWait;
+
+	protected:
+		void Run( size_t index );
+		bool Take( size_t index, Task & task );
+		void Execute( Task & task );
+
+	public:
+		CpuExecutor(
+			const CpuExecutorOptions & options = CpuExecutorOptions() );
+
+		CpuExecutor( const CpuExecutor & ) = delete;
+
+		// Runs the queued tasks to completion before returning.
+		~CpuExecutor() override;
+
+		// Throws once maxQueued tasks are waiting.
+		void Submit( std::function<void()> task ) override;
+
+		CpuExecutorStats GetStats() const;
+
+		size_t Size() const
+		{
+			return m_workers.size();
+		}
+	};
+
+} // namespace awsx
+
+
+#endif
@@ -0,0 +1,135 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_HTTP_TRANSPORT_H
+#define __AWS_CPP_COGNITO_AUTH_HTTP_TRANSPORT_H
+
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "Options.hpp"
+#include "Transport.hpp"
+
+
+namespace awsx {
+
+	class HttpConnectionPool;
+	class ThreadPool;
+
+	// Transport speaking the Cognito JSON 1.1 protocol over its own
+	// keep-alive HTTP/1.1 connections (TLS through OpenSSL), so logins need
+	// neither Aws::InitAPI nor the SDK service clients. Requests are not
+	// signed: AdminInitiateAuth fails with an error outcome.
+	class HttpTransport : public CognitoTransport {
+	protected:
+		long m_maxRetries;
+
+		std::unique_ptr<HttpConnectionPool> m_identityProvider;
+		std::unique_ptr<HttpConnectionPool> m_identity;
+
+		// last, so queued calls finish before the pools go away
+		std::unique_ptr<ThreadPool> m_executor;
+
+	public:
+		// Uses endpointOverride, loginTimeout, maxRetries, maxConnections
+		// and asyncThreads of the options.
+		HttpTransport(
+			const std::string & regionId, const CognitoAuthOptions & options );
+
+		~HttpTransport() override;
+
+		// Opens one connection to each endpoint.
+		void Warmup() override;
+
+		Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome InitiateAuth(
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthRequest &
+				request ) const override;
+
+		void InitiateAuthAsync(
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthRequest &
+				request,
+			const InitiateAuthHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::AdminInitiateAuthOutcome
+		AdminInitiateAuth(
+			const Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest &
+				request ) const override;
+
+		void AdminInitiateAuthAsync(
+			const Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest &
+				request,
+			const AdminInitiateAuthHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeOutcome
+		RespondToAuthChallenge( const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeRequest & request ) const override;
+
+		void RespondToAuthChallengeAsync(
+			const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeRequest & request,
+			const RespondToAuthChallengeHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::ConfirmDeviceOutcome ConfirmDevice(
+			const Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest &
+				request ) const override;
+
+		void ConfirmDeviceAsync(
+			const Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest &
+				request,
+			const ConfirmDeviceHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusOutcome
+		UpdateDeviceStatus( const Aws::CognitoIdentityProvider::Model::
+				UpdateDeviceStatusRequest & request ) const override;
+
+		void UpdateDeviceStatusAsync(
+			const Aws::CognitoIdentityProvider::Model::
+				UpdateDeviceStatusRequest & request,
+			const UpdateDeviceStatusHandler & handler ) const override;
+
+		Aws::CognitoIdentity::Model::GetIdOutcome GetId(
+			const Aws::CognitoIdentity::Model::GetIdRequest & request )
+			const override;
+
+		void GetIdAsync(
+			const Aws::CognitoIdentity::Model::GetIdRequest & request,
+			const GetIdHandler & handler ) const override;
+
+		Aws::CognitoIdentity::Model::GetCredentialsForIdentityOutcome
+		GetCredentialsForIdentity(
+			const Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest &
+				request ) const override;
+
+		void GetCredentialsForIdentityAsync(
+			const Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest &
+				request,
+			const GetCredentialsForIdentityHandler & handler ) const override;
+	};
+
+} // namespace awsx
+
+
+#endif
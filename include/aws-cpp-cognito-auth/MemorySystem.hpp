@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_MEMORY_SYSTEM_H
+#define __AWS_CPP_COGNITO_AUTH_MEMORY_SYSTEM_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "aws/core/Aws.h"
+#include "aws/core/utils/memory/MemorySystemInterface.h"
+
+
+namespace awsx {
+
+	struct PooledMemoryStats {
+		// bytes of the slabs the pooled blocks are carved from, never
+		// returned before the memory system is gone
+		size_t slabBytes;
+
+		// refills of a thread's pool from the shared one
+		uint64_t refills;
+
+		// blocks above the largest size class, straight from malloc
+		uint64_t largeAllocations;
+	};
+
+	// Memory system for the SDK built with custom memory management
+	// (-DCUSTOM_MEMORY_MANAGEMENT=ON), where every Aws::String, Aws::Map and
+	// HTTP buffer goes through Aws::Malloc. The small, short-lived blocks of
+	// a login's round trips come from per-thread free lists of 32 size
+	// classes up to 8 KB, so concurrent logins do not meet on a malloc lock;
+	// larger blocks go to malloc. Threads take and return blocks in batches
+	// from a shared pool.
+	//
+	// Install() it in the SDKOptions before Aws::InitAPI; it must outlive
+	// Aws::ShutdownAPI.
+	class PooledMemorySystem
+		: public Aws::Utils::Memory::MemorySystemInterface {
+	public:
+		class Central;
+
+	protected:
+		std::shared_ptr<Central> m_central;
+
+	public:
+		PooledMemorySystem();
+
+		PooledMemorySystem( const PooledMemorySystem & ) = delete;
+
+		~PooledMemorySystem() override;
+
+		void Install( Aws::SDKOptions & options )
+		{
+			options.memoryManagementOptions.memoryManager = this;
+		}
+
+		void Begin() override;
+
+		// Hands the calling thread's blocks back to the shared pool.
+		void End() override;
+
+		void * AllocateMemory( std::size_t blockSize,
+			std::size_t alignment,
+			const char * allocationTag = nullptr ) override;
+
+		void FreeMemory( void * memoryPtr ) override;
+
+		PooledMemoryStats GetStats() const;
+	};
+
+} // namespace awsx
+
+
+#endif
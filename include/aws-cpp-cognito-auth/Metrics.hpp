@@ -0,0 +1,197 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_METRICS_H
+#define __AWS_CPP_COGNITO_AUTH_METRICS_H
+
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "aws/core/Aws.h"
+
+
+namespace awsx {
+
+	// Counts of a latency histogram, taken at one point in time.
+	struct LatencySnapshot {
+		uint64_t count;
+		std::chrono::microseconds total;
+		std::chrono::microseconds max;
+
+		// log-linear buckets, see LatencyCounter
+		std::vector<uint64_t> buckets;
+
+		LatencySnapshot()
+			: count( 0 )
+			, total( 0 )
+			, max( 0 )
+		{
+		}
+
+		std::chrono::microseconds Mean() const
+		{
+			return count > 0
+				? total / static_cast<int64_t>( count )
+				: std::chrono::microseconds( 0 );
+		}
+
+		// Upper bound of the bucket holding the percentile, within 1/16.
+		std::chrono::microseconds Percentile( double percentile ) const;
+	};
+
+	// Lock free latency histogram: every power of two microseconds is split
+	// into 16 linear buckets, up to about half an hour.
+	class LatencyCounter {
+	public:
+		static const int s_subBits = 4;
+		static const int s_maxBits = 30;
+		static const size_t s_bucketCount = ( s_maxBits - s_subBits + 2 )
+			<< s_subBits;
+
+	protected:
+		std::atomic<uint64_t> m_buckets[s_bucketCount];
+		std::atomic<uint64_t> m_count;
+		std::atomic<int64_t> m_total;
+		std::atomic<int64_t> m_max;
+
+	public:
+		LatencyCounter();
+
+		LatencyCounter( const LatencyCounter & ) = delete;
+
+		static size_t Index( uint64_t value );
+
+		// highest value counted in the bucket
+		static uint64_t ValueAt( size_t index );
+
+		void Add( std::chrono::microseconds latency );
+
+		LatencySnapshot Snapshot() const;
+	};
+
+	// HTTP level numbers of one Cognito API. The latencies other than
+	// attempt are the ones the SDK's HTTP client reports, in milliseconds:
+	// dns, connect and tls (DnsLatency, TcpLatency and SslLatency) only
+	// count attempts that opened a connection, firstByte is ConnectLatency,
+	// which the curl client measures up to the first response byte. Which
+	// of them are reported at all depends on the HTTP client.
+	struct ApiMetrics {
+		uint64_t requests;
+
+		// attempts beyond the first of each request
+		uint64_t retries;
+
+		// attempts that failed, whether retried or not
+		uint64_t failures;
+
+		// attempts on a pooled connection
+		uint64_t reusedConnections;
+
+		// whole attempts, measured by the monitor
+		LatencySnapshot attempt;
+
+		LatencySnapshot dns;
+		LatencySnapshot connect;
+		LatencySnapshot tls;
+		LatencySnapshot firstByte;
+
+		ApiMetrics()
+			: requests( 0 )
+			, retries( 0 )
+			, failures( 0 )
+			, reusedConnections( 0 )
+		{
+		}
+	};
+
+	// Aggregates what the SDK reports through its monitoring interface about
+	// the cognito-idp and cognito-identity calls, per API. Install() it in
+	// the SDKOptions before Aws::InitAPI; the SDK then reports the calls of
+	// every client, so the numbers cover all CognitoAuth instances using
+	// TransportKind::Sdk. The Http and Http2 transports are not covered.
+	class CognitoMetrics {
+	public:
+		// APIs with their own counters, others are not counted.
+		enum Api {
+			InitiateAuth,
+			AdminInitiateAuth,
+			RespondToAuthChallenge,
+			ConfirmDevice,
+			UpdateDeviceStatus,
+			GetId,
+			GetCredentialsForIdentity,
+			ApiCount
+		};
+
+		struct Counters {
+			std::atomic<uint64_t> requests;
+			std::atomic<uint64_t> retries;
+			std::atomic<uint64_t> failures;
+			std::atomic<uint64_t> reusedConnections;
+
+			LatencyCounter attempt;
+			LatencyCounter dns;
+			LatencyCounter connect;
+			LatencyCounter tls;
+			LatencyCounter firstByte;
+
+			Counters();
+		};
+
+	protected:
+		std::unique_ptr<Counters[]> m_counters;
+
+	public:
+		CognitoMetrics();
+
+		CognitoMetrics( const CognitoMetrics & ) = delete;
+
+		// Adds a monitor reporting to the metrics to the options.
+		static void Install( const std::shared_ptr<CognitoMetrics> & metrics,
+			Aws::SDKOptions & options );
+
+		static const char * Name( Api api );
+
+		// ApiCount for other requests.
+		static Api Find( const char * requestName );
+
+		Counters & Of( Api api )
+		{
+			return m_counters[api];
+		}
+
+		// Numbers of the APIs called so far, by name.
+		std::map<std::string, ApiMetrics> Snapshot() const;
+	};
+
+} // namespace awsx
+
+
+#endif
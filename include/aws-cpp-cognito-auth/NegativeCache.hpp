@@ -0,0 +1,144 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __AWS_CPP_COGNITO_AUTH_NEGATIVE_CACHE_H
+#define __AWS_CPP_COGNITO_AUTH_NEGATIVE_CACHE_H
+
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Result.hpp"
+
+
+namespace awsx {
+
+	class HmacSha256Key;
+
+	struct NegativeCachePolicy {
+		// how long a login fails early after the first rejection
+		std::chrono::milliseconds initialTtl;
+
+		// growth of that time with each further rejection
+		double multiplier;
+
+		std::chrono::milliseconds maxTtl;
+
+		size_t maxEntries;
+
+		NegativeCachePolicy()
+			: initialTtl( 1000 )
+			, multiplier( 2.0 )
+			, maxTtl( 300000 )
+			, maxEntries( 10000 )
+		{
+		}
+	};
+
+	struct NegativeCacheStats {
+		// logins failed without a request
+		uint64_t hits;
+
+		// rejections recorded
+		uint64_t rejections;
+
+		size_t entries;
+	};
+
+	// Remembers the user pool, username and password of rejected logins,
+	// so a client retrying a bad password fails without the SRP math, the
+	// round trips and the quota they cost. A rejected password is blocked
+	// for initialTtl, then multiplier times longer after each further
+	// rejection; entries idle for maxTtl start over. A full cache drops the
+	// entry rejected longest ago. Passwords are only kept as an HMAC under
+	// a random key of the process.
+	class NegativeCache {
+	protected:
+		struct Entry {
+			unsigned rejections;
+			std::chrono::steady_clock::time_point until;
+			AuthError error;
+
+			// in m_order
+			std::list<std::string>::iterator position;
+		};
+
+		NegativeCachePolicy m_policy;
+		std::unique_ptr<HmacSha256Key> m_key;
+
+		mutable std::mutex m_mutex;
+		std::unordered_map<std::string, Entry> m_entries;
+
+		// keys of m_entries, the least recently rejected first
+		std::list<std::string> m_order;
+
+		uint64_t m_hits;
+		uint64_t m_rejections;
+
+	protected:
+		std::string MakeKey( const std::string & userPoolId,
+			const std::string & username,
+			const std::string & password ) const;
+
+		// Drops the least recently rejected entry.
+		void MakeRoom();
+
+	public:
+		NegativeCache( const NegativeCachePolicy & policy
+			= NegativeCachePolicy() );
+
+		NegativeCache( const NegativeCache & ) = delete;
+
+		~NegativeCache();
+
+		// True, with the pool's error, while the password is blocked.
+		bool IsRejected( const std::string & userPoolId,
+			const std::string & username,
+			const std::string & password,
+			AuthError & error );
+
+		void Reject( const std::string & userPoolId,
+			const std::string & username,
+			const std::string & password,
+			const AuthError & error );
+
+		// Forgets the password after a successful login.
+		void Accept( const std::string & userPoolId,
+			const std::string & username,
+			const std::string & password );
+
+		void Clear();
+
+		NegativeCacheStats GetStats() const;
+	};
+
+} // namespace awsx
+
+
+#endif
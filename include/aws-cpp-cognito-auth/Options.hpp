@@ -0,0 +1,227 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_OPTIONS_H
+#define __AWS_CPP_COGNITO_AUTH_OPTIONS_H
+
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+
+namespace awsx {
+
+	class DeviceKeyStore;
+	class NegativeCache;
+	class SdkStartup;
+
+	// How the user pool login proves the password.
+	enum class AuthStrategy {
+		// USER_SRP_AUTH, the password never leaves the process
+		Srp,
+
+		// USER_PASSWORD_AUTH, one round trip and no client side crypto;
+		// the app client must allow the flow
+		UserPassword,
+
+		// ADMIN_USER_PASSWORD_AUTH through AdminInitiateAuth, signed with
+		// the process' IAM credentials; for trusted backends
+		AdminUserPassword
+	};
+
+	// How CognitoAuth reaches cognito-idp and cognito-identity.
+	enum class TransportKind {
+		// the SDK clients, Aws::InitAPI must have been called
+		Sdk,
+
+		// built in keep-alive HTTP/1.1 client speaking the JSON protocol
+		// directly; needs no SDK initialization but cannot sign requests,
+		// so AuthStrategy::AdminUserPassword is not available
+		Http,
+
+		// same protocol and limits as Http, multiplexed over a few HTTP/2
+		// connections per endpoint through libcurl; for login bursts
+		Http2
+	};
+
+	// The calls HedgingPolicy applies to, each with its own latencies.
+	enum class HedgedApi {
+		GetId,
+		GetCredentialsForIdentity
+	};
+
+	// Hedging of the idempotent cognito-identity calls (GetId and
+	// GetCredentialsForIdentity). When the first attempt has not answered
+	// within the observed latency percentile, a second identical request is
+	// sent and whichever succeeds first wins.
+	struct HedgingPolicy {
+		bool enabled;
+
+		// latency percentile of recent calls, in (0, 100)
+		double percentile;
+
+		// lower bound of the hedge delay, also used until enough samples
+		// have been collected
+		std::chrono::milliseconds minDelay;
+
+		HedgingPolicy()
+			: enabled( false )
+			, percentile( 95.0 )
+			, minDelay( 50 )
+		{
+		}
+	};
+
+	// Client side limit of one Cognito quota category: a token bucket caps
+	// the request rate, and an AIMD window caps the requests in flight. The
+	// window halves on a throttling reply and grows by about one per window
+	// of successful replies, so a fleet backs off instead of retrying into
+	// the throttle.
+	struct RateLimit {
+		// requests per second, zero means no rate limit
+		double rate;
+
+		// requests that may start at once after an idle period
+		double burst;
+
+		// bounds of the concurrency window, which starts at the maximum
+		size_t minConcurrency;
+		size_t maxConcurrency;
+
+		explicit RateLimit( double rate = 0.0, size_t maxConcurrency = 64 )
+			: rate( rate )
+			, burst( rate > 1.0 ? rate : 1.0 )
+			, minConcurrency( 1 )
+			, maxConcurrency( maxConcurrency )
+		{
+		}
+	};
+
+	// Limits shared by every login on the transport, one per quota
+	// category. Requests over the limit queue for up to maxWait and then
+	// fail with TooManyRequestsException without reaching Cognito.
+	struct RateLimitPolicy {
+		bool enabled;
+
+		// InitiateAuth, AdminInitiateAuth and RespondToAuthChallenge; 120/s
+		// is the default UserAuthentication quota of an account
+		RateLimit authentication;
+
+		// ConfirmDevice and UpdateDeviceStatus
+		RateLimit devices;
+
+		// GetId and GetCredentialsForIdentity
+		RateLimit identity;
+
+		std::chrono::milliseconds maxWait;
+
+		RateLimitPolicy()
+			: enabled( false )
+			, authentication( 120.0 )
+			, maxWait( 10000 )
+		{
+		}
+	};
+
+	struct CognitoAuthOptions {
+		// call CognitoAuth::Warmup() from the constructor
+		bool warmup;
+
+		// Startup mode for CLIs and short-lived functions: MakeTransport()
+		// returns a LazyTransport built (and warmed) on a thread of its own,
+		// and the constructor computes the SRP group, OpenSSL state and the
+		// first login's ephemeral A on another, instead of doing any of it
+		// before returning. The first login waits only for what it uses.
+		bool lazyStart;
+
+		// Aws::InitAPI running in the background, which the lazily built
+		// transport waits for; only used with lazyStart.
+		std::shared_ptr<SdkStartup> sdkStartup;
+
+		AuthStrategy strategy;
+
+		TransportKind transport;
+
+		// overall time budget of one login, zero means unlimited
+		std::chrono::milliseconds loginTimeout;
+
+		// retries per call, negative keeps the SDK default strategy (three
+		// retries with the Http and Http2 transports); with a loginTimeout
+		// the transports send each call once and the login retries within
+		// its budget
+		long maxRetries;
+
+		HedgingPolicy hedging;
+
+		// wraps the transport in a RateLimitedTransport
+		RateLimitPolicy rateLimit;
+
+		// "scheme://host:port" used instead of the regional endpoints for
+		// both services, e.g. a local stand-in
+		std::string endpointOverride;
+
+		// pooled connections per service (HTTP/2 connections with Http2),
+		// zero keeps the default
+		unsigned maxConnections;
+
+		// threads running the async calls, zero picks a small pool when
+		// deadlines or hedging need one
+		size_t asyncThreads;
+
+		// Remembers the device after a login and answers DEVICE_SRP_AUTH
+		// with it on the next ones, so pools with device tracking skip MFA.
+		// Null disables device tracking. Only used by AuthStrategy::Srp.
+		std::shared_ptr<DeviceKeyStore> deviceKeyStore;
+
+		// Fails logins with a username and password the pool rejected
+		// recently without asking it again. Null disables the cache; one
+		// cache may be shared by several CognitoAuth instances.
+		std::shared_ptr<NegativeCache> negativeCache;
+
+		// DeviceName sent with ConfirmDevice, empty lets the pool pick one
+		std::string deviceName;
+
+		// secret of the app client, when it has one; every request then
+		// carries the SECRET_HASH
+		std::string clientSecret;
+
+		CognitoAuthOptions()
+			: warmup( false )
+			, lazyStart( false )
+			, strategy( AuthStrategy::Srp )
+			, transport( TransportKind::Sdk )
+			, loginTimeout( 0 )
+			, maxRetries( -1 )
+			, maxConnections( 0 )
+			, asyncThreads( 0 )
+		{
+		}
+	};
+
+} // namespace awsx
+
+
+#endif
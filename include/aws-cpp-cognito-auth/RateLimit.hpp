@@ -0,0 +1,243 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __AWS_CPP_COGNITO_AUTH_RATE_LIMIT_H
+#define __AWS_CPP_COGNITO_AUTH_RATE_LIMIT_H
+
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "Options.hpp"
+#include "Transport.hpp"
+
+
+namespace awsx {
+
+	struct RateLimitStats {
+		// requests waiting for a slot
+		size_t queued;
+
+		size_t inFlight;
+
+		// current size of the AIMD window
+		double concurrency;
+
+		uint64_t started;
+
+		// throttling replies from Cognito
+		uint64_t throttled;
+
+		// requests that gave up waiting, or were queued at shutdown
+		uint64_t expired;
+	};
+
+	// The token bucket and concurrency window of one RateLimit. Requests
+	// start right away while both allow it, otherwise they queue in order
+	// and a thread, started on the first wait, starts them as tokens and
+	// slots come back.
+	class AdaptiveLimiter {
+	public:
+		typedef std::chrono::steady_clock::time_point Ticket;
+
+		// runs with the start time, which goes back to Complete()
+		typedef std::function<void( Ticket )> Start;
+
+		typedef std::function<void()> Expire;
+
+	protected:
+		struct Waiter {
+			Start start;
+			Expire expire;
+			std::chrono::steady_clock::time_point deadline;
+		};
+
+		RateLimit m_limit;
+		std::chrono::milliseconds m_maxWait;
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::deque<Waiter> m_queue;
+		std::thread m_thread;
+		bool m_stop;
+
+		double m_tokens;
+		std::chrono::steady_clock::time_point m_refilled;
+
+		double m_window;
+		size_t m_inFlight;
+
+		// replies to requests started before this do not shrink the window
+		// again, one burst of throttles halves it once
+		Ticket m_decreased;
+
+		uint64_t m_started;
+		uint64_t m_throttled;
+		uint64_t m_expired;
+
+	protected:
+		void Refill( std::chrono::steady_clock::time_point now );
+		bool CanStart() const;
+		void Take();
+		void Run();
+
+	public:
+		AdaptiveLimiter(
+			const RateLimit & limit, std::chrono::milliseconds maxWait );
+
+		AdaptiveLimiter( const AdaptiveLimiter & ) = delete;
+
+		~AdaptiveLimiter();
+
+		// Runs start, possibly on the calling thread, once a token and a slot
+		// are free, or expire when that takes longer than maxWait.
+		void Submit( const Start & start, const Expire & expire );
+
+		// Gives the slot back; a throttled reply halves the window, any
+		// other reply grows it.
+		void Complete( Ticket ticket, bool throttled );
+
+		// Expires the queued requests and joins the thread.
+		void Stop();
+
+		RateLimitStats GetStats() const;
+	};
+
+	// Puts the calls of another transport through one AdaptiveLimiter per
+	// Cognito quota category. Calls that waited longer than maxWait fail
+	// with a TooManyRequestsException error, which is not retryable.
+	class RateLimitedTransport : public CognitoTransport {
+	protected:
+		std::shared_ptr<AdaptiveLimiter> m_authentication;
+		std::shared_ptr<AdaptiveLimiter> m_devices;
+		std::shared_ptr<AdaptiveLimiter> m_identity;
+
+		std::chrono::milliseconds m_maxWait;
+
+		// last, so the calls it still runs can complete on the limiters
+		std::shared_ptr<CognitoTransport> m_transport;
+
+	public:
+		RateLimitedTransport( std::shared_ptr<CognitoTransport> transport,
+			const RateLimitPolicy & policy );
+
+		~RateLimitedTransport() override;
+
+		std::shared_ptr<CognitoTransport> GetTransport() const
+		{
+			return m_transport;
+		}
+
+		RateLimitStats GetAuthenticationStats() const
+		{
+			return m_authentication->GetStats();
+		}
+
+		RateLimitStats GetDeviceStats() const
+		{
+			return m_devices->GetStats();
+		}
+
+		RateLimitStats GetIdentityStats() const
+		{
+			return m_identity->GetStats();
+		}
+
+		// Not limited.
+		void Warmup() override;
+
+		Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome InitiateAuth(
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthRequest &
+				request ) const override;
+
+		void InitiateAuthAsync(
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthRequest &
+				request,
+			const InitiateAuthHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::AdminInitiateAuthOutcome
+		AdminInitiateAuth(
+			const Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest &
+				request ) const override;
+
+		void AdminInitiateAuthAsync(
+			const Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest &
+				request,
+			const AdminInitiateAuthHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeOutcome
+		RespondToAuthChallenge( const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeRequest & request ) const override;
+
+		void RespondToAuthChallengeAsync(
+			const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeRequest & request,
+			const RespondToAuthChallengeHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::ConfirmDeviceOutcome ConfirmDevice(
+			const Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest &
+				request ) const override;
+
+		void ConfirmDeviceAsync(
+			const Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest &
+				request,
+			const ConfirmDeviceHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusOutcome
+		UpdateDeviceStatus( const Aws::CognitoIdentityProvider::Model::
+				UpdateDeviceStatusRequest & request ) const override;
+
+		void UpdateDeviceStatusAsync(
+			const Aws::CognitoIdentityProvider::Model::
+				UpdateDeviceStatusRequest & request,
+			const UpdateDeviceStatusHandler & handler ) const override;
+
+		Aws::CognitoIdentity::Model::GetIdOutcome GetId(
+			const Aws::CognitoIdentity::Model::GetIdRequest & request )
+			const override;
+
+		void GetIdAsync(
+			const Aws::CognitoIdentity::Model::GetIdRequest & request,
+			const GetIdHandler & handler ) const override;
+
+		Aws::CognitoIdentity::Model::GetCredentialsForIdentityOutcome
+		GetCredentialsForIdentity(
+			const Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest &
+				request ) const override;
+
+		void GetCredentialsForIdentityAsync(
+			const Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest &
+				request,
+			const GetCredentialsForIdentityHandler & handler ) const override;
+	};
+
+} // namespace awsx
+
+
+#endif
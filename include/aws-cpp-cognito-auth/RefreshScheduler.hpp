@@ -0,0 +1,228 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_REFRESH_SCHEDULER_H
+#define __AWS_CPP_COGNITO_AUTH_REFRESH_SCHEDULER_H
+
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Auth.hpp"
+
+
+namespace awsx {
+
+	class ThreadPool;
+	class TimerWheel;
+
+	struct RefreshSchedulerOptions {
+		// how long before the tokens or credentials expire a session is
+		// renewed, at most half their lifetime
+		std::chrono::seconds refreshAhead;
+
+		// renewals start up to this much earlier still, at random per
+		// session, so sessions created together do not renew together
+		std::chrono::seconds jitter;
+
+		// renewals started per second across all sessions, unlimited when
+		// zero; sessions due beyond it wait, earliest expiration first
+		double maxRate;
+
+		// renewals running at once
+		size_t threads;
+
+		RefreshSchedulerOptions()
+			: refreshAhead( 300 )
+			, jitter( 120 )
+			, maxRate( 20.0 )
+			, threads( 4 )
+		{
+		}
+	};
+
+	struct RefreshSchedulerStats {
+		size_t sessions;
+
+		// sessions past their renewal time waiting for the rate limit
+		size_t waiting;
+
+		// renewals through the refresh token, and full logins after the
+		// pool rejected it
+		uint64_t refreshed;
+		uint64_t loggedIn;
+
+		// renewals that failed, each is retried after 1 s doubling up to
+		// a minute
+		uint64_t failed;
+
+		// renewals that ended, or failed, after the session expired
+		uint64_t missedDeadlines;
+
+		// longest a due session waited for the rate limit
+		std::chrono::milliseconds maxWait;
+	};
+
+	// Keeps the tokens and credentials of many sessions fresh from a few
+	// threads: one hierarchical timer wheel with a one second tick holds a
+	// renewal timer per session, so adding and removing sessions is O(1).
+	// A renewal uses the refresh token and falls back to a full login with
+	// the password when the pool rejects it, then fetches new credentials
+	// for sessions with an identity pool.
+	class RefreshScheduler {
+	public:
+		// Identifies a session for as long as it is scheduled.
+		typedef uint64_t SessionId;
+
+		// Run on the renewal threads, without the scheduler's lock held.
+		typedef std::function<void( SessionId id, const CognitoLogin & login )>
+			Listener;
+
+		typedef std::function<void( SessionId id,
+			const std::string & username,
+			std::chrono::system_clock::time_point expiration )>
+			MissListener;
+
+	protected:
+		struct Session {
+			uint32_t generation;
+			bool live;
+
+			std::string username;
+			std::string password;
+			std::string userPoolId;
+			std::string identityPoolId;
+
+			CognitoLogin login;
+			std::chrono::system_clock::time_point expiration;
+
+			// renewal timer, none while the renewal is due or running
+			uint32_t timer;
+			std::chrono::seconds backoff;
+			bool missed;
+		};
+
+		struct Due {
+			std::chrono::system_clock::time_point expiration;
+			std::chrono::steady_clock::time_point since;
+			SessionId id;
+
+			bool operator<( const Due & other ) const
+			{
+				// earliest expiration on top
+				return expiration > other.expiration;
+			}
+		};
+
+		CognitoAuth & m_auth;
+		RefreshSchedulerOptions m_options;
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_stop;
+		std::thread m_thread;
+
+		std::chrono::steady_clock::time_point m_started;
+		std::unique_ptr<TimerWheel> m_wheel;
+		std::vector<Session> m_sessions;
+		std::vector<uint32_t> m_freeSessions;
+		std::priority_queue<Due> m_due;
+		std::mt19937 m_random;
+
+		double m_tokens;
+		std::chrono::steady_clock::time_point m_refilled;
+
+		// wheel tick the scheduler thread sleeps until
+		uint64_t m_wakeTick;
+
+		RefreshSchedulerStats m_stats;
+
+		Listener m_listener;
+		MissListener m_missListener;
+
+		// last, so that stopping it finishes the renewals first
+		std::unique_ptr<ThreadPool> m_workers;
+
+	protected:
+		// Seconds since the scheduler was made, the wheel's time.
+		uint64_t Tick( std::chrono::steady_clock::time_point time ) const;
+
+		// Null for removed sessions; m_mutex is held.
+		const Session * Find( SessionId id ) const;
+		Session * Find( SessionId id );
+
+		// Sets the renewal timer of a session; m_mutex is held.
+		void Schedule( SessionId id, std::chrono::seconds delay );
+		void ScheduleRenewal( SessionId id );
+
+		void Run();
+		void Renew( SessionId id );
+
+	public:
+		// auth must outlive the scheduler.
+		RefreshScheduler( CognitoAuth & auth,
+			const RefreshSchedulerOptions & options
+			= RefreshSchedulerOptions() );
+
+		RefreshScheduler( const RefreshScheduler & ) = delete;
+
+		~RefreshScheduler();
+
+		// Starts renewing; listener sees every renewed login, missListener
+		// every session that expired before it could be renewed.
+		void Start( const Listener & listener = Listener(),
+			const MissListener & missListener = MissListener() );
+
+		void Stop();
+
+		// Schedules the renewal of a login. Without a password the session
+		// lives only as long as its refresh token.
+		SessionId Add( const std::string & username,
+			const std::string & password,
+			const std::string & userPoolId,
+			const std::string & identityPoolId,
+			const CognitoLogin & login );
+
+		// False when the session is not scheduled (any more).
+		bool Remove( SessionId id );
+
+		// The latest login of the session, false when it is not scheduled.
+		bool Get( SessionId id, CognitoLogin & login ) const;
+
+		RefreshSchedulerStats GetStats() const;
+	};
+
+} // namespace awsx
+
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_REGISTRY_H
+#define __AWS_CPP_COGNITO_AUTH_REGISTRY_H
+
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Auth.hpp"
+
+
+namespace awsx {
+
+	struct CognitoTenant {
+		std::string regionId;
+		std::string clientId;
+		std::string userPoolId;
+		std::string identityPoolId;
+
+		// secret of the tenant's app client, if it has one
+		std::string clientSecret;
+	};
+
+	// CognitoAuth instances of many tenants. All tenants of a region share
+	// one transport (and so its connection pools and async threads);
+	// the SRP group is process wide anyway. A tenant costs its CognitoAuth
+	// and a map entry. Lookups lock one of several shards only.
+	class CognitoAuthRegistry {
+	protected:
+		struct Entry {
+			CognitoTenant tenant;
+			std::shared_ptr<CognitoAuth> auth;
+		};
+
+		struct Shard {
+			std::mutex mutex;
+			std::unordered_map<std::string, Entry> tenants;
+		};
+
+		CognitoAuthOptions m_options;
+
+		std::vector<std::unique_ptr<Shard>> m_shards;
+
+		std::mutex m_regionsMutex;
+		std::map<std::string, std::shared_ptr<CognitoTransport>> m_regions;
+
+	protected:
+		Shard & ShardOf( const std::string & tenantId ) const;
+
+		bool Find( const std::string & tenantId, Entry & out ) const;
+
+	public:
+		// options apply to every tenant, apart from the client secret;
+		// lazyStart only makes the regional transports lazy
+		CognitoAuthRegistry(
+			const CognitoAuthOptions & options = CognitoAuthOptions(),
+			size_t shards = 64 );
+
+		CognitoAuthRegistry( const CognitoAuthRegistry & ) = delete;
+
+		// Adds or replaces a tenant. Logins already running keep using the
+		// previous configuration.
+		void Register(
+			const std::string & tenantId, const CognitoTenant & tenant );
+
+		bool Remove( const std::string & tenantId );
+
+		// Null for unknown tenants.
+		std::shared_ptr<CognitoAuth> Get( const std::string & tenantId ) const;
+
+		size_t Size() const;
+
+		// The transport shared by the tenants of a region, created on
+		// demand.
+		std::shared_ptr<CognitoTransport> GetTransport(
+			const std::string & regionId );
+
+		// Warms the transports of every region registered so far.
+		void Warmup();
+
+		// Throw Exception for unknown tenants.
+		Aws::Auth::AWSCredentials Authenticate( const std::string & tenantId,
+			const std::string & username,
+			const std::string & password ) const;
+
+		CognitoTokens AuthenticateWithUserPool( const std::string & tenantId,
+			const std::string & username,
+			const std::string & password ) const;
+	};
+
+} // namespace awsx
+
+
+#endif
@@ -0,0 +1,225 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_RESULT_H
+#define __AWS_CPP_COGNITO_AUTH_RESULT_H
+
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "Exception.hpp"
+
+
+namespace awsx {
+
+	enum class AuthErrorCode {
+		NotAuthorized,
+		UserNotFound,
+		UserNotConfirmed,
+		PasswordResetRequired,
+		// the login needs an answer from the user, see BeginAuthentication()
+		ChallengeRequired,
+		InvalidParameter,
+		Throttled,
+		Timeout,
+		Network,
+		// any other error of the service
+		Service
+	};
+
+	// Why a login failed. Holds the code and the pieces of the message; the
+	// text itself is only put together when asked for. The pieces are
+	// literals or live in m_owner, so errors are made and copied without
+	// copying any text.
+	class AuthError {
+	protected:
+		AuthErrorCode m_code;
+		bool m_retryable;
+
+		// Cognito's exception name, or the operation that timed out. Null
+		// when m_detail is the whole message.
+		const char * m_name;
+		const char * m_detail;
+
+		// what m_name and m_detail point into when they are not literals
+		std::shared_ptr<const void> m_owner;
+
+	public:
+		AuthError( AuthErrorCode code = AuthErrorCode::Service,
+			const char * name = nullptr,
+			const char * detail = "",
+			bool retryable = false,
+			std::shared_ptr<const void> owner = nullptr )
+			: m_code( code )
+			, m_retryable( retryable )
+			, m_name( name )
+			, m_detail( detail )
+			, m_owner( std::move( owner ) )
+		{
+		}
+
+		// Keeps a copy of detail.
+		AuthError( AuthErrorCode code,
+			const char * name,
+			const std::string & detail,
+			bool retryable = false )
+			: m_code( code )
+			, m_retryable( retryable )
+			, m_name( name )
+		{
+			auto text = std::make_shared<const std::string>( detail );
+			m_detail = text->c_str();
+			m_owner = std::move( text );
+		}
+
+		static AuthError Timeout( const char * operation )
+		{
+			return AuthError( AuthErrorCode::Timeout, operation, "", true );
+		}
+
+		static AuthError ChallengePending( const std::string & challengeName )
+		{
+			return AuthError(
+				AuthErrorCode::ChallengeRequired, nullptr, challengeName );
+		}
+
+		AuthErrorCode GetCode() const
+		{
+			return m_code;
+		}
+
+		// Throttling, timeouts and network errors; the same login may
+		// succeed when tried again later.
+		bool IsRetryable() const
+		{
+			return m_retryable;
+		}
+
+		// The text the throwing calls use, e.g.
+		// "NotAuthorizedException: Incorrect username or password."
+		std::string GetMessage() const
+		{
+			if ( m_code == AuthErrorCode::Timeout ) {
+				return std::string( m_name ) + ": login deadline exceeded";
+			}
+
+			if ( m_code == AuthErrorCode::ChallengeRequired ) {
+				return std::string( m_detail ) + ": challenge pending, see "
+					+ "CognitoAuth::RespondToChallenge()";
+			}
+
+			return m_name ? std::string( m_name ) + ": " + m_detail
+						  : std::string( m_detail );
+		}
+
+		// Throws the exception the throwing calls throw for this error.
+		[[noreturn]] void Throw() const
+		{
+			if ( m_code == AuthErrorCode::Timeout ) {
+				throw TimeoutException( GetMessage() );
+			}
+
+			if ( m_code == AuthErrorCode::NotAuthorized
+				|| m_code == AuthErrorCode::UserNotFound ) {
+				throw NotAuthorizedException( GetMessage() );
+			}
+
+			throw Exception( GetMessage() );
+		}
+	};
+
+	// The value of a login step or why it failed.
+	template <typename T>
+	class AuthResult {
+	protected:
+		bool m_ok;
+		T m_value;
+		AuthError m_error;
+
+	public:
+		AuthResult( const T & value )
+			: m_ok( true )
+			, m_value( value )
+		{
+		}
+
+		AuthResult( T && value )
+			: m_ok( true )
+			, m_value( std::move( value ) )
+		{
+		}
+
+		AuthResult( const AuthError & error )
+			: m_ok( false )
+			, m_error( error )
+		{
+		}
+
+		AuthResult( AuthError && error )
+			: m_ok( false )
+			, m_error( std::move( error ) )
+		{
+		}
+
+		bool HasValue() const
+		{
+			return m_ok;
+		}
+
+		explicit operator bool() const
+		{
+			return m_ok;
+		}
+
+		// Throws the error's exception, see AuthError::Throw().
+		T & Value()
+		{
+			if ( !m_ok ) {
+				m_error.Throw();
+			}
+
+			return m_value;
+		}
+
+		const T & Value() const
+		{
+			if ( !m_ok ) {
+				m_error.Throw();
+			}
+
+			return m_value;
+		}
+
+		const AuthError & Error() const
+		{
+			return m_error;
+		}
+	};
+
+} // namespace awsx
+
+
+#endif
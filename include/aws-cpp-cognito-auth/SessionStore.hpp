@@ -0,0 +1,154 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_SESSION_STORE_H
+#define __AWS_CPP_COGNITO_AUTH_SESSION_STORE_H
+
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "aws/core/auth/AWSCredentialsProvider.h"
+
+#include "Auth.hpp"
+
+
+namespace awsx {
+
+	struct SessionStoreStats {
+		size_t sessions;
+
+		// bytes taken from the heap for records, of which liveBytes hold
+		// current ones and the rest replaced or expired ones until the next
+		// compaction
+		size_t arenaBytes;
+		size_t liveBytes;
+
+		size_t indexBytes;
+
+		// replacements that fit the old record, and ones that had to move
+		uint64_t replacedInPlace;
+		uint64_t relocated;
+	};
+
+	// Tokens and credentials of many users, e.g. the sessions of a gateway.
+	// Each session is one length-prefixed record in large arena chunks,
+	// found through an open addressing table of (hash, location) slots, so
+	// a session costs its bytes plus about 4% instead of a handful of heap
+	// blocks. Records leave a little room, so a refresh usually overwrites
+	// its record in place. Space of replaced and expired records is
+	// reclaimed by Expire(); cognito-auth-loadgen --session-store reports
+	// the memory per session.
+	class SessionStore {
+	protected:
+		struct Slot {
+			uint64_t hash;
+			uint32_t chunk;
+			uint32_t offset;
+		};
+
+		struct Chunk {
+			std::unique_ptr<uint8_t[]> data;
+			size_t size;
+			size_t used;
+		};
+
+		size_t m_chunkSize;
+		uint64_t m_seed;
+
+		mutable std::mutex m_mutex;
+		std::vector<Chunk> m_chunks;
+		std::vector<Slot> m_slots;
+
+		size_t m_sessions;
+		size_t m_tombstones;
+		size_t m_usedBytes;
+		size_t m_liveBytes;
+
+		uint64_t m_replacedInPlace;
+		uint64_t m_relocated;
+
+	protected:
+		uint64_t Hash( const std::string & userPoolId,
+			const std::string & username ) const;
+
+		uint8_t * RecordAt( const Slot & slot ) const;
+
+		// Slot of the session, or the one to insert it into.
+		size_t Find( uint64_t hash,
+			const std::string & userPoolId,
+			const std::string & username,
+			bool & found ) const;
+
+		Slot Allocate( size_t bytes );
+
+		void Drop( Slot & slot );
+
+		void Rehash( size_t capacity );
+
+		// Copies the live records to new chunks and frees the old ones.
+		void Compact();
+
+	public:
+		SessionStore(
+			size_t expectedSessions = 1024, size_t chunkSize = 4 << 20 );
+
+		SessionStore( const SessionStore & ) = delete;
+
+		// Adds the session, or replaces the one of the same user.
+		void Put( const std::string & userPoolId,
+			const std::string & username,
+			const CognitoTokens & tokens,
+			const Aws::Auth::AWSCredentials & credentials,
+			std::chrono::system_clock::time_point expiration );
+
+		// False when there is no session of the user or it has expired.
+		bool Get( const std::string & userPoolId,
+			const std::string & username,
+			CognitoTokens & tokens,
+			Aws::Auth::AWSCredentials & credentials ) const;
+
+		bool Erase(
+			const std::string & userPoolId, const std::string & username );
+
+		// Drops the sessions expired by now, compacting the arena once it
+		// holds more dropped bytes than live ones. Returns the number of
+		// sessions dropped.
+		size_t Expire( std::chrono::system_clock::time_point now
+			= std::chrono::system_clock::now() );
+
+		size_t Size() const;
+
+		SessionStoreStats GetStats() const;
+	};
+
+} // namespace awsx
+
+
+#endif
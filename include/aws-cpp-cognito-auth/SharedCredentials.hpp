@@ -0,0 +1,160 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __AWS_CPP_COGNITO_AUTH_SHARED_CREDENTIALS_H
+#define __AWS_CPP_COGNITO_AUTH_SHARED_CREDENTIALS_H
+
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "aws/core/auth/AWSCredentialsProvider.h"
+
+#include "Auth.hpp"
+#include "CredentialsCache.hpp"
+
+
+namespace awsx {
+
+	class SharedMemory;
+
+	// One login as published through shared memory.
+	struct SharedLogin {
+		// grows with each Publish(), zero before the first
+		uint64_t generation;
+
+		// of the credentials and tokens, whichever ends first
+		std::chrono::system_clock::time_point expiration;
+
+		std::string accessKeyId;
+		std::string secretKey;
+		std::string sessionToken;
+
+		std::string idToken;
+		std::string accessToken;
+	};
+
+	// Writes logins into a named shared memory segment (POSIX shm, e.g.
+	// "/cognito-credentials", or a Windows file mapping) that processes
+	// with a SharedCredentialsReader copy from, so a host of pre-forked
+	// workers needs one login instead of one per worker. The segment is a
+	// seqlock: Publish() never waits for readers, and readers only retry
+	// while a Publish() is in progress. One publisher per segment; the
+	// segment is readable by the owner only. Refresh tokens are not
+	// published.
+	class SharedCredentialsPublisher {
+	protected:
+		std::unique_ptr<SharedMemory> m_memory;
+
+		// one Publish() at a time
+		std::mutex m_publishMutex;
+
+		std::unique_ptr<CredentialsCache> m_cache;
+
+	public:
+		// Creates the segment or takes over an existing one.
+		explicit SharedCredentialsPublisher( const std::string & name );
+
+		SharedCredentialsPublisher( const SharedCredentialsPublisher & )
+			= delete;
+
+		// Stops the refresh; the segment stays, see Remove().
+		~SharedCredentialsPublisher();
+
+		// Throws when the login does not fit the segment.
+		void Publish( CognitoTokens tokens,
+			const Aws::Auth::AWSCredentials & credentials,
+			std::chrono::system_clock::time_point expiration );
+
+		// Publishes every login of a CredentialsCache over the arguments.
+		// auth must outlive Stop().
+		void Start( CognitoAuth & auth,
+			const std::string & username,
+			const std::string & password,
+			const std::string & userPoolId,
+			const std::string & identityPoolId,
+			std::chrono::seconds refreshAhead = std::chrono::seconds( 300 ) );
+
+		void Stop();
+
+		// Why the last login of the refresh failed, empty after a success.
+		std::string GetLastError() const;
+
+		// Deletes the segment name; mapped segments stay valid.
+		static void Remove( const std::string & name );
+	};
+
+	class SharedCredentialsReader {
+	protected:
+		std::unique_ptr<SharedMemory> m_memory;
+
+	public:
+		// Opens the segment read only, throws when it does not exist.
+		explicit SharedCredentialsReader( const std::string & name );
+
+		SharedCredentialsReader( const SharedCredentialsReader & ) = delete;
+
+		~SharedCredentialsReader();
+
+		// Generation of the latest login, zero before the first; a single
+		// atomic load, to check whether Read() has anything new.
+		uint64_t GetGeneration() const;
+
+		// Copies the latest login, false before the first or when the
+		// segment stays mid-write, e.g. after the publisher crashed in
+		// Publish().
+		bool Read( SharedLogin & login ) const;
+	};
+
+	// SDK credentials provider over a SharedCredentialsReader. The last
+	// credentials read are kept and handed out while the generation in the
+	// segment is unchanged, so most calls are one atomic load and a copy
+	// of the kept credentials. Returns empty credentials before the first
+	// login and once the published ones expired.
+	class SharedCredentialsProvider
+		: public Aws::Auth::AWSCredentialsProvider {
+	protected:
+		struct Snapshot {
+			uint64_t generation;
+			std::chrono::system_clock::time_point expiration;
+			Aws::Auth::AWSCredentials credentials;
+		};
+
+		SharedCredentialsReader m_reader;
+
+		std::mutex m_mutex;
+		std::shared_ptr<const Snapshot> m_snapshot;
+
+	public:
+		explicit SharedCredentialsProvider( const std::string & name );
+
+		Aws::Auth::AWSCredentials GetAWSCredentials() override;
+	};
+
+} // namespace awsx
+
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_STARTUP_H
+#define __AWS_CPP_COGNITO_AUTH_STARTUP_H
+
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aws/core/Aws.h"
+
+#include "Transport.hpp"
+
+
+namespace awsx {
+
+	// Runs Aws::InitAPI on a thread of its own, so a CLI or function can
+	// parse its arguments and set up everything else meanwhile, and
+	// Aws::ShutdownAPI on destruction, which must come after every client
+	// is gone.
+	class SdkStartup {
+	protected:
+		Aws::SDKOptions m_options;
+		std::shared_future<void> m_ready;
+
+	public:
+		explicit SdkStartup(
+			const Aws::SDKOptions & options = Aws::SDKOptions() );
+
+		SdkStartup( const SdkStartup & ) = delete;
+
+		~SdkStartup();
+
+		// Blocks until Aws::InitAPI returned.
+		void Wait() const;
+	};
+
+	// Transport built on a thread of its own, for CognitoAuthOptions
+	// lazyStart. Async calls made before it is ready are queued and started
+	// once it is, sync calls and Warmup() block. When building fails, the
+	// calls complete with an InternalFailure error.
+	class LazyTransport : public CognitoTransport {
+	public:
+		typedef std::function<std::shared_ptr<CognitoTransport>()> Factory;
+
+		// Starts a call on the transport, or fails it with the error when
+		// the transport is null.
+		typedef std::function<void(
+			const CognitoTransport * transport, const std::string & error )>
+			Call;
+
+	protected:
+		mutable std::mutex m_mutex;
+		mutable std::condition_variable m_condition;
+		bool m_ready;
+		std::shared_ptr<CognitoTransport> m_transport;
+		std::string m_error;
+		mutable std::vector<Call> m_waiting;
+
+		std::thread m_thread;
+
+	protected:
+		void Build( Factory factory,
+			std::shared_ptr<SdkStartup> startup,
+			bool warmup );
+
+		// Blocks until the transport is built, null when that failed.
+		const CognitoTransport * Ready() const;
+
+		void WhenReady( Call call ) const;
+
+	public:
+		// The factory runs after the startup, when there is one. With warmup
+		// the transport is warmed once the calls queued so far have started.
+		LazyTransport( Factory factory,
+			std::shared_ptr<SdkStartup> startup = nullptr,
+			bool warmup = false );
+
+		~LazyTransport() override;
+
+		// Blocks until the transport is built, throws Exception when that
+		// failed.
+		std::shared_ptr<CognitoTransport> GetTransport() const;
+
+		void Warmup() override;
+
+		Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome InitiateAuth(
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthRequest &
+				request ) const override;
+
+		void InitiateAuthAsync(
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthRequest &
+				request,
+			const InitiateAuthHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::AdminInitiateAuthOutcome
+		AdminInitiateAuth(
+			const Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest &
+				request ) const override;
+
+		void AdminInitiateAuthAsync(
+			const Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest &
+				request,
+			const AdminInitiateAuthHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeOutcome
+		RespondToAuthChallenge( const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeRequest & request ) const override;
+
+		void RespondToAuthChallengeAsync(
+			const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeRequest & request,
+			const RespondToAuthChallengeHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::ConfirmDeviceOutcome ConfirmDevice(
+			const Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest &
+				request ) const override;
+
+		void ConfirmDeviceAsync(
+			const Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest &
+				request,
+			const ConfirmDeviceHandler & handler ) const override;
+
+		Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusOutcome
+		UpdateDeviceStatus( const Aws::CognitoIdentityProvider::Model::
+				UpdateDeviceStatusRequest & request ) const override;
+
+		void UpdateDeviceStatusAsync(
+			const Aws::CognitoIdentityProvider::Model::
+				UpdateDeviceStatusRequest & request,
+			const UpdateDeviceStatusHandler & handler ) const override;
+
+		Aws::CognitoIdentity::Model::GetIdOutcome GetId(
+			const Aws::CognitoIdentity::Model::GetIdRequest & request )
+			const override;
+
+		void GetIdAsync(
+			const Aws::CognitoIdentity::Model::GetIdRequest & request,
+			const GetIdHandler & handler ) const override;
+
+		Aws::CognitoIdentity::Model::GetCredentialsForIdentityOutcome
+		GetCredentialsForIdentity(
+			const Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest &
+				request ) const override;
+
+		void GetCredentialsForIdentityAsync(
+			const Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest &
+				request,
+			const GetCredentialsForIdentityHandler & handler ) const override;
+	};
+
+} // namespace awsx
+
+
+#endif
@@ -0,0 +1,221 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_TRANSPORT_H
+#define __AWS_CPP_COGNITO_AUTH_TRANSPORT_H
+
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include "aws/cognito-idp/CognitoIdentityProviderClient.h"
+
+#include "aws/cognito-identity/CognitoIdentityClient.h"
+
+
+namespace awsx {
+
+	// The cognito-idp and cognito-identity calls a login needs, with the
+	// request and outcome types of the SDK models. Implementations own the
+	// connections, so they are shared by every login using them. All calls
+	// are thread safe; the Async handlers run on the transport's threads.
+	class CognitoTransport {
+	public:
+		typedef std::function<void(
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome & )>
+			InitiateAuthHandler;
+
+		typedef std::function<void( const Aws::CognitoIdentityProvider::
+				Model::AdminInitiateAuthOutcome & )>
+			AdminInitiateAuthHandler;
+
+		typedef std::function<void( const Aws::CognitoIdentityProvider::
+				Model::RespondToAuthChallengeOutcome & )>
+			RespondToAuthChallengeHandler;
+
+		typedef std::function<void(
+			const Aws::CognitoIdentityProvider::Model::ConfirmDeviceOutcome & )>
+			ConfirmDeviceHandler;
+
+		typedef std::function<void( const Aws::CognitoIdentityProvider::
+				Model::UpdateDeviceStatusOutcome & )>
+			UpdateDeviceStatusHandler;
+
+		typedef std::function<void(
+			const Aws::CognitoIdentity::Model::GetIdOutcome & )>
+			GetIdHandler;
+
+		typedef std::function<void( const Aws::CognitoIdentity::Model::
+				GetCredentialsForIdentityOutcome & )>
+			GetCredentialsForIdentityHandler;
+
+	protected:
+		std::atomic<std::chrono::steady_clock::rep> m_lastUse;
+
+		std::mutex m_keepAliveMutex;
+		std::condition_variable m_keepAliveCondition;
+		std::thread m_keepAliveThread;
+		bool m_keepAliveStop;
+
+	protected:
+		void KeepAliveLoop( std::chrono::seconds interval );
+
+	public:
+		CognitoTransport();
+
+		CognitoTransport( const CognitoTransport & ) = delete;
+
+		// Implementations call StopKeepAlive() in their destructor, the
+		// keep-alive thread uses Warmup().
+		virtual ~CognitoTransport();
+
+		// Marks the pooled connections as recently used.
+		void Touch()
+		{
+			m_lastUse
+				= std::chrono::steady_clock::now().time_since_epoch().count();
+		}
+
+		// Sets up the connections to both services ahead of the first login.
+		virtual void Warmup() = 0;
+
+		// Re-runs Warmup() whenever the connections were idle for a whole
+		// interval, so the pooled connections are not closed by the server.
+		void StartKeepAlive( std::chrono::seconds interval );
+		void StopKeepAlive();
+
+		virtual Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome
+		InitiateAuth(
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthRequest &
+				request ) const = 0;
+
+		virtual void InitiateAuthAsync(
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthRequest &
+				request,
+			const InitiateAuthHandler & handler ) const = 0;
+
+		virtual Aws::CognitoIdentityProvider::Model::AdminInitiateAuthOutcome
+		AdminInitiateAuth(
+			const Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest &
+				request ) const = 0;
+
+		virtual void AdminInitiateAuthAsync(
+			const Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest &
+				request,
+			const AdminInitiateAuthHandler & handler ) const = 0;
+
+		virtual Aws::CognitoIdentityProvider::Model::
+			RespondToAuthChallengeOutcome
+			RespondToAuthChallenge( const Aws::CognitoIdentityProvider::Model::
+					RespondToAuthChallengeRequest & request ) const = 0;
+
+		virtual void RespondToAuthChallengeAsync(
+			const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeRequest & request,
+			const RespondToAuthChallengeHandler & handler ) const = 0;
+
+		virtual Aws::CognitoIdentityProvider::Model::ConfirmDeviceOutcome
+		ConfirmDevice(
+			const Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest &
+				request ) const = 0;
+
+		virtual void ConfirmDeviceAsync(
+			const Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest &
+				request,
+			const ConfirmDeviceHandler & handler ) const = 0;
+
+		virtual Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusOutcome
+		UpdateDeviceStatus( const Aws::CognitoIdentityProvider::Model::
+				UpdateDeviceStatusRequest & request ) const = 0;
+
+		virtual void UpdateDeviceStatusAsync(
+			const Aws::CognitoIdentityProvider::Model::
+				UpdateDeviceStatusRequest & request,
+			const UpdateDeviceStatusHandler & handler ) const = 0;
+
+		virtual Aws::CognitoIdentity::Model::GetIdOutcome GetId(
+			const Aws::CognitoIdentity::Model::GetIdRequest & request )
+			const = 0;
+
+		virtual void GetIdAsync(
+			const Aws::CognitoIdentity::Model::GetIdRequest & request,
+			const GetIdHandler & handler ) const = 0;
+
+		virtual Aws::CognitoIdentity::Model::GetCredentialsForIdentityOutcome
+		GetCredentialsForIdentity(
+			const Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest &
+				request ) const = 0;
+
+		virtual void GetCredentialsForIdentityAsync(
+			const Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest &
+				request,
+			const GetCredentialsForIdentityHandler & handler ) const = 0;
+
+		// Future based variants on top of the Async calls.
+
+		std::future<Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome>
+		InitiateAuthCallable(
+			const Aws::CognitoIdentityProvider::Model::InitiateAuthRequest &
+				request ) const;
+
+		std::future<
+			Aws::CognitoIdentityProvider::Model::AdminInitiateAuthOutcome>
+		AdminInitiateAuthCallable(
+			const Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest &
+				request ) const;
+
+		std::future<
+			Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeOutcome>
+		RespondToAuthChallengeCallable(
+			const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeRequest & request ) const;
+
+		std::future<Aws::CognitoIdentityProvider::Model::ConfirmDeviceOutcome>
+		ConfirmDeviceCallable(
+			const Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest &
+				request ) const;
+
+		std::future<
+			Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusOutcome>
+		UpdateDeviceStatusCallable( const Aws::CognitoIdentityProvider::Model::
+				UpdateDeviceStatusRequest & request ) const;
+
+		std::future<Aws::CognitoIdentity::Model::GetIdOutcome> GetIdCallable(
+			const Aws::CognitoIdentity::Model::GetIdRequest & request ) const;
+
+		std::future<Aws::CognitoIdentity::Model::GetCredentialsForIdentityOutcome>
+		GetCredentialsForIdentityCallable(
+			const Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest &
+				request ) const;
+	};
+
+} // namespace awsx
+
+
+#endif
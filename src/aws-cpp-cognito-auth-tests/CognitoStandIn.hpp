@@ -0,0 +1,563 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_COGNITO_STAND_IN_H
+#define __AWS_CPP_COGNITO_AUTH_COGNITO_STAND_IN_H
+
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SrpCorpus.hpp"
+
+
+namespace awsx {
+
+	// Cognito on 127.0.0.1 for the tests: answers the JSON 1.1 operations
+	// of a login with canned results, after an injected delay or with an
+	// injected failure, and counts the requests of each operation. Nothing
+	// is verified; SRP_B and the salt come from the known answers, so the
+	// client math runs for real. Optionally the pool asks for an MFA code
+	// or a remembered device, or hands out a new device.
+	class CognitoStandIn {
+	protected:
+		struct Delay {
+			std::chrono::milliseconds delay;
+			size_t times;
+		};
+
+		int m_listener;
+		unsigned short m_port;
+		std::thread m_acceptor;
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_stopped;
+		bool m_stop;
+
+		std::map<std::string, size_t> m_counts;
+		std::map<std::string, Delay> m_delays;
+		std::map<std::string, size_t> m_failures;
+
+		// device the pool knows, requests with another DEVICE_KEY fail
+		std::string m_device;
+		// device handed out with the tokens
+		std::string m_newDevice;
+		bool m_mfa;
+		bool m_deviceAfterMfa;
+
+		std::set<int> m_connections;
+		std::vector<std::thread> m_workers;
+
+	protected:
+		// The challenge of the known answer with a full size B.
+		static const SrpKnownAnswer & Answer()
+		{
+			for ( const auto & answer : s_srpCorpus ) {
+				if ( strcmp( answer.name, "full size B" ) == 0 ) {
+					return answer;
+				}
+			}
+
+			return s_srpCorpus[0];
+		}
+
+		static std::string Challenge(
+			const char * name, const std::string & parameters )
+		{
+			return std::string( "{\"ChallengeName\":\"" ) + name
+				+ "\",\"Session\":\"stand-in\",\"ChallengeParameters\":{"
+				+ parameters + "}}";
+		}
+
+		// PASSWORD_VERIFIER and DEVICE_PASSWORD_VERIFIER
+		static std::string VerifierChallenge( const char * name )
+		{
+			return Challenge( name,
+				std::string( "\"SALT\":\"" ) + Answer().salt
+					+ "\",\"SECRET_BLOCK\":\"" + Answer().secretBlock
+					+ "\",\"SRP_B\":\"" + Answer().B
+					+ "\",\"USERNAME\":\"user\","
+					  "\"USER_ID_FOR_SRP\":\"user\"" );
+		}
+
+		std::string Tokens() const
+		{
+			std::string device;
+
+			if ( !m_newDevice.empty() ) {
+				device = ",\"NewDeviceMetadata\":{\"DeviceGroupKey\":"
+						 "\"stand-in-group\",\"DeviceKey\":\""
+					+ m_newDevice + "\"}";
+			}
+
+			return "{\"AuthenticationResult\":{\"AccessToken\":\"access\","
+				   "\"ExpiresIn\":3600,\"IdToken\":\"id\","
+				   "\"RefreshToken\":\"refresh\",\"TokenType\":\"Bearer\""
+				+ device + "},\"ChallengeParameters\":{}}";
+		}
+
+		// The string value of a key in the body, empty without it.
+		static std::string Value(
+			const std::string & body, const std::string & key )
+		{
+			std::string prefix = "\"" + key + "\":\"";
+			size_t start = body.find( prefix );
+
+			if ( start == std::string::npos ) {
+				return std::string();
+			}
+
+			start += prefix.size();
+
+			return body.substr( start, body.find( '"', start ) - start );
+		}
+
+		// The reply to a request, empty for an unknown operation; status
+		// is set for errors.
+		std::string Respond( const std::string & operation,
+			const std::string & body,
+			std::string & status ) const
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+
+			std::string deviceKey = Value( body, "DEVICE_KEY" );
+
+			if ( !deviceKey.empty() && deviceKey != m_device ) {
+				status = "400 Bad Request";
+
+				return "{\"__type\":\"ResourceNotFoundException\","
+					   "\"message\":\"Device does not exist.\"}";
+			}
+
+			std::string challenge = Value( body, "ChallengeName" );
+
+			if ( operation == "InitiateAuth"
+				&& Value( body, "AuthFlow" ) == "USER_SRP_AUTH" ) {
+				return VerifierChallenge( "PASSWORD_VERIFIER" );
+			}
+
+			if ( operation == "RespondToAuthChallenge"
+				&& challenge == "PASSWORD_VERIFIER" ) {
+				if ( m_mfa ) {
+					return Challenge( "SOFTWARE_TOKEN_MFA", "" );
+				}
+
+				if ( !deviceKey.empty() ) {
+					return Challenge( "DEVICE_SRP_AUTH", "" );
+				}
+			}
+
+			if ( operation == "RespondToAuthChallenge"
+				&& challenge == "SOFTWARE_TOKEN_MFA"
+				&& m_deviceAfterMfa ) {
+				return Challenge( "DEVICE_SRP_AUTH", "" );
+			}
+
+			if ( operation == "RespondToAuthChallenge"
+				&& challenge == "DEVICE_SRP_AUTH" ) {
+				return VerifierChallenge( "DEVICE_PASSWORD_VERIFIER" );
+			}
+
+			if ( operation == "InitiateAuth"
+				|| operation == "AdminInitiateAuth"
+				|| operation == "RespondToAuthChallenge" ) {
+				return Tokens();
+			}
+
+			if ( operation == "ConfirmDevice" ) {
+				return "{\"UserConfirmationNecessary\":false}";
+			}
+
+			if ( operation == "UpdateDeviceStatus" ) {
+				return "{}";
+			}
+
+			if ( operation == "GetId" ) {
+				return "{\"IdentityId\":\"us-east-1:stand-in\"}";
+			}
+
+			if ( operation == "GetCredentialsForIdentity" ) {
+				return "{\"IdentityId\":\"us-east-1:stand-in\","
+					   "\"Credentials\":{\"AccessKeyId\":\"ASIASTANDIN\","
+					   "\"SecretKey\":\"secret\",\"SessionToken\":\"session\","
+					   "\"Expiration\":4102444800}}";
+			}
+
+			return std::string();
+		}
+
+		// One request off the connection: false once it is closed.
+		static bool Read( int fd,
+			std::string & buffer,
+			std::string & operation,
+			std::string & body )
+		{
+			size_t end;
+
+			while ( ( end = buffer.find( "\r\n\r\n" ) ) == std::string::npos ) {
+				if ( !Receive( fd, buffer ) ) {
+					return false;
+				}
+			}
+
+			size_t length = 0;
+			bool expectContinue = false;
+			operation.clear();
+
+			size_t line = buffer.find( "\r\n" ) + 2;
+
+			while ( line < end ) {
+				size_t next = buffer.find( "\r\n", line );
+				std::string header = buffer.substr( line, next - line );
+				line = next + 2;
+
+				size_t colon = header.find( ':' );
+
+				if ( colon == std::string::npos ) {
+					continue;
+				}
+
+				std::string name = header.substr( 0, colon );
+				std::string value = header.substr( colon + 1 );
+				value.erase( 0, value.find_first_not_of( ' ' ) );
+
+				std::transform(
+					name.begin(), name.end(), name.begin(), ::tolower );
+
+				if ( name == "content-length" ) {
+					length = strtoul( value.c_str(), nullptr, 10 );
+				}
+				else if ( name == "x-amz-target" ) {
+					operation = value.substr( value.find( '.' ) + 1 );
+				}
+				else if ( name == "expect" ) {
+					expectContinue = true;
+				}
+			}
+
+			buffer.erase( 0, end + 4 );
+
+			if ( expectContinue && buffer.size() < length
+				&& !Send( fd, "HTTP/1.1 100 Continue\r\n\r\n" ) ) {
+				return false;
+			}
+
+			while ( buffer.size() < length ) {
+				if ( !Receive( fd, buffer ) ) {
+					return false;
+				}
+			}
+
+			body = buffer.substr( 0, length );
+			buffer.erase( 0, length );
+
+			return true;
+		}
+
+		static bool Receive( int fd, std::string & buffer )
+		{
+			char data[4096];
+			ssize_t received = recv( fd, data, sizeof( data ), 0 );
+
+			if ( received <= 0 ) {
+				return false;
+			}
+
+			buffer.append( data, static_cast<size_t>( received ) );
+
+			return true;
+		}
+
+		static bool Send( int fd, const std::string & data )
+		{
+#ifdef MSG_NOSIGNAL
+			const int flags = MSG_NOSIGNAL;
+#else
+			const int flags = 0;
+#endif
+			for ( size_t sent = 0; sent < data.size(); ) {
+				ssize_t n = send(
+					fd, data.data() + sent, data.size() - sent, flags );
+
+				if ( n <= 0 ) {
+					return false;
+				}
+
+				sent += static_cast<size_t>( n );
+			}
+
+			return true;
+		}
+
+		// Counts the request and waits out its delay; false when the
+		// stand-in stopped meanwhile.
+		bool Admit( const std::string & operation )
+		{
+			std::unique_lock<std::mutex> lock( m_mutex );
+
+			++m_counts[operation];
+
+			auto found = m_delays.find( operation );
+
+			if ( found == m_delays.end() || found->second.times == 0 ) {
+				return !m_stop;
+			}
+
+			auto delay = found->second.delay;
+			--found->second.times;
+
+			return !m_stopped.wait_for(
+				lock, delay, [this]() { return m_stop; } );
+		}
+
+		// Takes one of the failures set for the operation.
+		bool Failing( const std::string & operation )
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+
+			auto found = m_failures.find( operation );
+
+			if ( found == m_failures.end() || found->second == 0 ) {
+				return false;
+			}
+
+			--found->second;
+
+			return true;
+		}
+
+		void Serve( int fd )
+		{
+			std::string buffer;
+			std::string operation;
+			std::string body;
+
+			while (
+				Read( fd, buffer, operation, body ) && Admit( operation ) ) {
+				std::string status = "200 OK";
+				std::string reply = Respond( operation, body, status );
+
+				if ( Failing( operation ) ) {
+					status = "500 Internal Server Error";
+					reply = "{\"__type\":\"InternalErrorException\","
+							"\"message\":\"stand-in failure\"}";
+				}
+				else if ( reply.empty() ) {
+					status = "400 Bad Request";
+					reply = "{\"__type\":\"UnknownOperationException\","
+							"\"message\":\"stand-in: "
+						+ operation + "\"}";
+				}
+
+				std::string response = "HTTP/1.1 " + status
+					+ "\r\nContent-Type: application/x-amz-json-1.1"
+					  "\r\nx-amzn-RequestId: stand-in\r\nContent-Length: "
+					+ std::to_string( reply.size() ) + "\r\n\r\n" + reply;
+
+				if ( !Send( fd, response ) ) {
+					break;
+				}
+			}
+
+			std::lock_guard<std::mutex> lock( m_mutex );
+
+			m_connections.erase( fd );
+			close( fd );
+		}
+
+		void Accept()
+		{
+			for ( ;; ) {
+				int fd = accept( m_listener, nullptr, nullptr );
+
+				std::lock_guard<std::mutex> lock( m_mutex );
+
+				if ( m_stop ) {
+					if ( fd >= 0 ) {
+						close( fd );
+					}
+
+					return;
+				}
+
+				if ( fd < 0 ) {
+					continue;
+				}
+
+				m_connections.insert( fd );
+				m_workers.emplace_back( &CognitoStandIn::Serve, this, fd );
+			}
+		}
+
+	public:
+		CognitoStandIn()
+			: m_stop( false )
+			, m_mfa( false )
+			, m_deviceAfterMfa( false )
+		{
+			m_listener = socket( AF_INET, SOCK_STREAM, 0 );
+
+			sockaddr_in address = sockaddr_in();
+			address.sin_family = AF_INET;
+			address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+			address.sin_port = 0;
+
+			socklen_t size = sizeof( address );
+
+			if ( m_listener < 0
+				|| bind( m_listener,
+					   reinterpret_cast<sockaddr *>( &address ),
+					   sizeof( address ) )
+					!= 0
+				|| listen( m_listener, 64 ) != 0
+				|| getsockname( m_listener,
+					   reinterpret_cast<sockaddr *>( &address ),
+					   &size )
+					!= 0 ) {
+				throw std::runtime_error( "stand-in: cannot listen" );
+			}
+
+			m_port = ntohs( address.sin_port );
+			m_acceptor = std::thread( &CognitoStandIn::Accept, this );
+		}
+
+		CognitoStandIn( const CognitoStandIn & ) = delete;
+
+		// Drops the connections, delayed requests go unanswered.
+		~CognitoStandIn()
+		{
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				m_stop = true;
+
+				for ( int fd : m_connections ) {
+					shutdown( fd, SHUT_RDWR );
+				}
+			}
+
+			m_stopped.notify_all();
+
+			shutdown( m_listener, SHUT_RDWR );
+			m_acceptor.join();
+			close( m_listener );
+
+			for ( auto & worker : m_workers ) {
+				worker.join();
+			}
+		}
+
+		// For CognitoAuthOptions::endpointOverride.
+		std::string Endpoint() const
+		{
+			return "http://127.0.0.1:" + std::to_string( m_port );
+		}
+
+		unsigned short Port() const
+		{
+			return m_port;
+		}
+
+		// The next times requests of the operation, e.g. "InitiateAuth",
+		// are answered only after the delay.
+		void SetDelay( const std::string & operation,
+			std::chrono::milliseconds delay,
+			size_t times = static_cast<size_t>( -1 ) )
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+
+			Delay & entry = m_delays[operation];
+			entry.delay = delay;
+			entry.times = times;
+		}
+
+		// The next times requests of the operation fail with a retryable
+		// InternalErrorException (HTTP 500).
+		void SetFailures( const std::string & operation, size_t times )
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_failures[operation] = times;
+		}
+
+		// The device the pool remembers: logins naming it get the
+		// DEVICE_SRP_AUTH round, any other DEVICE_KEY is a stale device
+		// (ResourceNotFoundException).
+		void SetDevice( const std::string & deviceKey )
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_device = deviceKey;
+		}
+
+		// Tokens come with NewDeviceMetadata of this key, empty for none.
+		void SetNewDevice( const std::string & deviceKey )
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_newDevice = deviceKey;
+		}
+
+		// SOFTWARE_TOKEN_MFA after the password, any code is accepted; with
+		// deviceAfter the pool then asks for the device.
+		void SetMfa( bool mfa, bool deviceAfter = false )
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_mfa = mfa;
+			m_deviceAfterMfa = deviceAfter;
+		}
+
+		// Requests of the operation received so far.
+		size_t Count( const std::string & operation ) const
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+
+			auto found = m_counts.find( operation );
+
+			return found != m_counts.end() ? found->second : 0;
+		}
+
+		void ResetCounts()
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_counts.clear();
+		}
+	};
+
+} // namespace awsx
+
+
+#endif
@@ -0,0 +1,208 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_H2C_FRONT_H
+#define __AWS_CPP_COGNITO_AUTH_H2C_FRONT_H
+
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+
+namespace awsx {
+
+
+	// nghttpx on 127.0.0.1 taking cleartext HTTP/2 (h2c) and HTTP/1.1 and
+	// forwarding both to an HTTP/1.1 backend such as CognitoStandIn, so
+	// that the Http and Http2 transports can be compared against the same
+	// server. The binary is $NGHTTPX or nghttpx on the PATH; Available()
+	// is false when it could not be started.
+	class H2cFront {
+	protected:
+		pid_t m_pid;
+		int m_port;
+
+		static int FreePort()
+		{
+			int s = socket( AF_INET, SOCK_STREAM, 0 );
+
+			if ( s < 0 ) {
+				return 0;
+			}
+
+			sockaddr_in address = sockaddr_in();
+			address.sin_family = AF_INET;
+			address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+			socklen_t size = sizeof( address );
+
+			int port = bind( s,
+						   reinterpret_cast<sockaddr *>( &address ),
+						   sizeof( address ) )
+					== 0
+				&& getsockname(
+					   s, reinterpret_cast<sockaddr *>( &address ), &size )
+					== 0
+				? ntohs( address.sin_port )
+				: 0;
+
+			close( s );
+
+			return port;
+		}
+
+		bool Accepting() const
+		{
+			int s = socket( AF_INET, SOCK_STREAM, 0 );
+
+			if ( s < 0 ) {
+				return false;
+			}
+
+			sockaddr_in address = sockaddr_in();
+			address.sin_family = AF_INET;
+			address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+			address.sin_port = htons( static_cast<uint16_t>( m_port ) );
+
+			bool connected = connect( s,
+								 reinterpret_cast<sockaddr *>( &address ),
+								 sizeof( address ) )
+				== 0;
+
+			close( s );
+
+			return connected;
+		}
+
+		void Stop()
+		{
+			if ( m_pid > 0 ) {
+				kill( m_pid, SIGTERM );
+				waitpid( m_pid, nullptr, 0 );
+				m_pid = -1;
+			}
+		}
+
+	public:
+		explicit H2cFront( int backendPort )
+			: m_pid( -1 )
+			, m_port( FreePort() )
+		{
+			if ( m_port == 0 ) {
+				return;
+			}
+
+			const char * binary = getenv( "NGHTTPX" );
+
+			if ( binary == nullptr || *binary == '\0' ) {
+				binary = "nghttpx";
+			}
+
+			std::string frontend
+				= "--frontend=127.0.0.1," + std::to_string( m_port )
+				+ ";no-tls";
+			std::string backend
+				= "--backend=127.0.0.1," + std::to_string( backendPort );
+
+			m_pid = fork();
+
+			if ( m_pid == 0 ) {
+				int null = open( "/dev/null", O_RDWR );
+				dup2( null, 1 );
+				dup2( null, 2 );
+
+				execlp( binary,
+					binary,
+					frontend.c_str(),
+					backend.c_str(),
+					"--workers=1",
+					"--conf=/dev/null",
+					"--frontend-http2-max-concurrent-streams=256",
+					static_cast<char *>( nullptr ) );
+				_exit( 127 );
+			}
+
+			if ( m_pid < 0 ) {
+				return;
+			}
+
+			auto deadline
+				= std::chrono::steady_clock::now() + std::chrono::seconds( 5 );
+
+			while ( !Accepting() ) {
+				if ( waitpid( m_pid, nullptr, WNOHANG ) != 0 ) {
+					// exited already, e.g. not installed
+					m_pid = -1;
+
+					return;
+				}
+
+				if ( std::chrono::steady_clock::now() > deadline ) {
+					Stop();
+
+					return;
+				}
+
+				std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+			}
+		}
+
+		~H2cFront()
+		{
+			Stop();
+		}
+
+		H2cFront( const H2cFront & ) = delete;
+		H2cFront & operator=( const H2cFront & ) = delete;
+
+		bool Available() const
+		{
+			return m_pid > 0;
+		}
+
+		int Port() const
+		{
+			return m_port;
+		}
+
+		std::string Endpoint() const
+		{
+			return "http://127.0.0.1:" + std::to_string( m_port );
+		}
+	};
+
+
+} // namespace awsx
+
+
+#endif
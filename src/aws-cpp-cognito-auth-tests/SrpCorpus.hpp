@@ -0,0 +1,921 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Generated by srp-corpus.py, do not edit.
+
+#ifndef __AWS_CPP_COGNITO_AUTH_SRP_CORPUS_H
+#define __AWS_CPP_COGNITO_AUTH_SRP_CORPUS_H
+
+
+namespace awsx {
+
+	struct SrpKnownAnswer {
+		const char * name;
+		const char * a;
+		const char * B;
+		const char * salt;
+		const char * userPoolId;
+		const char * username;
+		const char * password;
+		const char * secretBlock;
+		const char * timestamp;
+		const char * A;
+		const char * u;
+		const char * S;
+		const char * key;
+		const char * claim;
+	};
+
+	static const SrpKnownAnswer s_srpCorpus[] = {
+		{
+			"baseline",
+			"F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF000102030405060708090A0B"
+			"0C0D0E0F",
+			"ABCDEF0123",
+			"f234ab",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"99E5DFCFA0947732EC295FD4786D1B438AB32A88ED4520A983DC0EE8"
+			"CEEB3768A6BAB8E70FF99564E8B079DE784A50453D109023127225F0"
+			"9D671EAE5907A12CF4A22D6ECB090F0940EFC156E030F58339621129"
+			"BB9F9334F64363E0FDAED419F5BC425854D71A3AF0C6D85C59CC642C"
+			"B9DF04B9039668815CD463412E8F576338165CC910ED87D0B5C55207"
+			"08477D8F20EA800678E2C14A7694496D01953563B12B60E30640A861"
+			"D45324CA1347EE72E8D8047E0D14C34A2F05F4C82ECA250AFE8D94CA"
+			"B30F4B6BD3EF5AB685EE25EEF9F4DD3066D258AF2B740A109255647B"
+			"772C85581C4763283B672797E1EAFD841957F4BD2539D1C9C7766153"
+			"A28BC2D92FD9C8B30B8D27D7F3E538C555966553526D2CC973F513DC"
+			"D3018462613676021598F331F9639FDE8E686F9AA8D6AA5E4903740A"
+			"FDD9177334962C51223CE43FE859BB5DDD94900C4976BD4CDB0CADBF"
+			"6E4A1476177C80A63094471D9E22D21D159B5D0C207D438D5E6C7A84"
+			"9DB4986B5F3766A9098E90772CB77C68B3615C68",
+			"566CF46852E890B8E25CDA9C33B64FFD4FBDF4AC1724EAB36C5BF4D3"
+			"3F0F06C0",
+			"A5C761A3586079C210C569FBBF93B8F3FDA04B353B8DACE900023630"
+			"57E61285812F1983AF78590224AD835B981908378830EF230A0DA24F"
+			"62FAE67AEB6FB5C38A767D32A4DC67A8553712A35A6A7883CD6588B7"
+			"FFCD45AD5A7BE340D40A862E7800FAEE8D101D5D407E6FB35093E3FF"
+			"A957ACAA7223B366F65ACBB42E6D895BDFE4A9ACEF4E5AB476BC288E"
+			"DE427656F402E01FD488148D9C6E8FC624D466ADFC8744A0C76AF9D1"
+			"89BBC1C2675E6050D31E828E9FC67A120C54AE530362D455CFC98D14"
+			"8C70BA43BFF7DEE83AD2D7648B23261E526566302D0FBBC8BBCAC443"
+			"EA5F7878AB1ADF1168034CD3B9727B60CEA87EF85439E0859D9E62B0"
+			"84D3AC9FEE40A02986EAA17F1A1CDCB4183BB222DFC664A54CC7576D"
+			"499423C03A48A922157A928A29BF3444D5E06BDCE3DC78F56F702192"
+			"6A7F20A7D3CC01EF68E1006299C22FAE9A04155FABDB48B826EE6420"
+			"16EC8C6DE68A7E465A86F7D81E52DC129C887A4C682DEA98E420B716"
+			"454C4D36D4ED25C0AB19C31DDE7AD6860B596C17",
+			"FA5EF9BD6AF74A673AC6D8F2836153C7",
+			"hetrjy2uk5NVJ6S+stJBElxdumd6eoLFgUq1N7YTM/w="
+		},
+		{
+			"a with leading zero bytes",
+			"0000FB58D4B202D1E22E039789120915B1A69D7A13CC7BFBFB02049C"
+			"69BFE066",
+			"ABCDEF0123",
+			"f234ab",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"9297218BD5F203DD0DB588175646CE5B6B00F7B5452F249DF477815F"
+			"A7122B1A1E32BF778080FCA5BED990968B6E91607F724FF4DDF43CDF"
+			"01584A2DD0984E5AAC0986C3C20F4EB36B42BE912BDAACAE981A5D26"
+			"535D9D054F67B5D47114DB058227A4CAC16037464E3D8AAD03626296"
+			"14D32EBBAFCD2AFFE0F93A19A9E8D164F681C15F198EF98FE71874FB"
+			"2379B5A4776A08DF1C44822FBD3A2FD7D24734E23DDE0F33176ABCC7"
+			"7EA9EB8749162D707A3517C1E5425C241CBD145DF6F7F29AE1C0CE38"
+			"0CD48B4438AFBD9EF9EBC5B1E1A117A776EF6AE5C650473C62DC1D0C"
+			"30FC75B163982B6E653687F355D9A05AD55A329B25688DA230E0BAFB"
+			"E12751DFC2FD83DCA0240BF435D292B3FF77093F63EA21DC620D5788"
+			"949CC01989F59EC8DA11F14F275ECF308D3D76A4AF88767AE1327A49"
+			"5388F4AE3AB7CB466A56C224BCE0A2C835EA58BF1E467F3DE449A876"
+			"C88D9E85D60B9D56FD8885C5A64E11C1A82B19B017D6785C499900F4"
+			"37A627149F16762C6E378E4DF5A46E7890828134",
+			"50BC6F6B09ED185645B769AE56A0D3F40AC3382DB9689577922DB70C"
+			"27CE3313",
+			"EDC5E745E2B28255D63EA59308F7C668FE2916F507D53C45D95346DF"
+			"3598E89063C2A84016FD3AD0539DFD62265842DF4FD1B1AEA46AAC2E"
+			"56ACDF23EAA6E702050FACF3AD464F4C9F7F70062C506F5F6D5F3C0B"
+			"C5F5EB993A4C5C31C991F942955E2CC3FF873BA52805C4246DE30519"
+			"783AF41F6F4283F1F1A81906006EADA0E1EE661A1785632959583397"
+			"15A91C8A9247044029E780E6FFB92C45A12301108E3851F91A2250A3"
+			"544C9EB87FC3A08EE52C393AAB78EB766817D4B9CA499BAE388E8796"
+			"D8334D727FC5BC5B5EBC822B129467F5CD2873B5DDBEFD6845ACE7EC"
+			"F09F574948895E3E40083E19386B3D2ECF14D8C881381727660F91C0"
+			"A6AE12F7E5E8541FAC5C6176C08769F9C996BA6B3BD5DBEB1F3AFDF3"
+			"325AEC25B3C39E714C4736234E57D1803960614D6A98D8793238BBE2"
+			"2879C546B76AE69A69E704C852EE9388B2E736E13A07AC689B1A0D59"
+			"4E8E4208D249A99A54D767BF79EEB678D4502ABD63D34B2B0CB48B3C"
+			"89529238B397011FD5A49261893580FBE0C80D9E",
+			"6152B45FCF048D5FC220D3A3796DC6F8",
+			"qN4wEUNL48PvigbSieLHqle0e3tcFDtAvCOTas65x1w="
+		},
+		{
+			"odd length B",
+			"F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF000102030405060708090A0B"
+			"0C0D0E0F",
+			"1ABCDEF01",
+			"f234ab",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"99E5DFCFA0947732EC295FD4786D1B438AB32A88ED4520A983DC0EE8"
+			"CEEB3768A6BAB8E70FF99564E8B079DE784A50453D109023127225F0"
+			"9D671EAE5907A12CF4A22D6ECB090F0940EFC156E030F58339621129"
+			"BB9F9334F64363E0FDAED419F5BC425854D71A3AF0C6D85C59CC642C"
+			"B9DF04B9039668815CD463412E8F576338165CC910ED87D0B5C55207"
+			"08477D8F20EA800678E2C14A7694496D01953563B12B60E30640A861"
+			"D45324CA1347EE72E8D8047E0D14C34A2F05F4C82ECA250AFE8D94CA"
+			"B30F4B6BD3EF5AB685EE25EEF9F4DD3066D258AF2B740A109255647B"
+			"772C85581C4763283B672797E1EAFD841957F4BD2539D1C9C7766153"
+			"A28BC2D92FD9C8B30B8D27D7F3E538C555966553526D2CC973F513DC"
+			"D3018462613676021598F331F9639FDE8E686F9AA8D6AA5E4903740A"
+			"FDD9177334962C51223CE43FE859BB5DDD94900C4976BD4CDB0CADBF"
+			"6E4A1476177C80A63094471D9E22D21D159B5D0C207D438D5E6C7A84"
+			"9DB4986B5F3766A9098E90772CB77C68B3615C68",
+			"906F20B779BD3E9EABFE13FBBEB39D4CEA9D76D099E921A3E2E31387"
+			"AC7181BD",
+			"B5ECE0E01129E1875A42BD8D43AB668DD4843040ABF42F02C9607A19"
+			"16AE183BEC207DE91528B3240BB17ED0EE32C5068A465DFCC0AFD7D7"
+			"2E6068D0959B6E5BBA387ACCD9E87FE9E3C68718BA41E527D2A89CEA"
+			"F1CF744AEC8397A0E6BAB4115287E3337D2D4F5E45EC2F83BB57DAC4"
+			"2ADD633BB6620942C60F5BF93FB3AAC8510E52D8D9862D5D4E04407A"
+			"B846F3C1C841DF2C0BD24551FD9DCDED8F7030AC2EDC280EA4395566"
+			"11AB12E265A9D8C6605ACA08B07F2B40D233A209EE757FF05BB129A4"
+			"325436B7F3527DBEF424D90D68CCEF67FEDA958BDAD8C5B357D1AD78"
+			"5DF1A2ECB9AA5CAE3C3548823EABF0B8EC619C47E62B4853A652670F"
+			"971A1D47B0091FD4E8D4A8A79333D02D9C0F51BECB5D5A372F73C7DD"
+			"3068238275BDFF1C49BF2112CF4B632C1A35CB4127CA67272DA8B1B4"
+			"95C598ED8E3F0113F13B9443962F27BCF9CE87E21E7BCD98973F129B"
+			"0F1301513410400D9FAB645FF55FB4208F3A8BFB9EEB7FFBAB07F403"
+			"9EBCD28AB256590B86095E491C807ED792065D44",
+			"9681F99771F5AAC2DFB2A85800435D8F",
+			"Jpe0Lnd8i5t+VA34miqERPQsRYEARdZZIrINVnEFDco="
+		},
+		{
+			"odd length B with a high first digit",
+			"F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF000102030405060708090A0B"
+			"0C0D0E0F",
+			"ABCDEF012",
+			"f234ab",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"99E5DFCFA0947732EC295FD4786D1B438AB32A88ED4520A983DC0EE8"
+			"CEEB3768A6BAB8E70FF99564E8B079DE784A50453D109023127225F0"
+			"9D671EAE5907A12CF4A22D6ECB090F0940EFC156E030F58339621129"
+			"BB9F9334F64363E0FDAED419F5BC425854D71A3AF0C6D85C59CC642C"
+			"B9DF04B9039668815CD463412E8F576338165CC910ED87D0B5C55207"
+			"08477D8F20EA800678E2C14A7694496D01953563B12B60E30640A861"
+			"D45324CA1347EE72E8D8047E0D14C34A2F05F4C82ECA250AFE8D94CA"
+			"B30F4B6BD3EF5AB685EE25EEF9F4DD3066D258AF2B740A109255647B"
+			"772C85581C4763283B672797E1EAFD841957F4BD2539D1C9C7766153"
+			"A28BC2D92FD9C8B30B8D27D7F3E538C555966553526D2CC973F513DC"
+			"D3018462613676021598F331F9639FDE8E686F9AA8D6AA5E4903740A"
+			"FDD9177334962C51223CE43FE859BB5DDD94900C4976BD4CDB0CADBF"
+			"6E4A1476177C80A63094471D9E22D21D159B5D0C207D438D5E6C7A84"
+			"9DB4986B5F3766A9098E90772CB77C68B3615C68",
+			"98FE3A652F32C0FD60A68ED7213C1404CAF826908C710B9A085DCF94"
+			"D45F7175",
+			"BCF24B831D4672AD5BA5AD6D28FBDFB1CD44D3ADE5B06D5D569FBED9"
+			"BD1EB533037658580B9C58151D38D2011100CBFBA51306110A43CF55"
+			"32C6780477A5172BFF0ECF2B13233FB578937AB49F3EDA7C8A5EBFBC"
+			"2BB0C63E6ED2DFA1D75EFCFAE6A48436ACBFBE14E76B88151D5D0896"
+			"A4CF88A442B680AD22CA9B82B4E35605B67561E18BCC108FABA31B37"
+			"3FCC32C0BA1F6AD947DCB2B2844E5EBCBDA9351CE15337009CC25D74"
+			"852E41902CC581F946046286C3577B6B0020275038CB5BEB7924A59F"
+			"D844D4062FFE0953E275D0F652EA012C24B0F375C4F388391F8436C7"
+			"C2D15A84D4DCC19B74AA434184A489EF9F65ACF3C4808F3AC757A42F"
+			"EE6BA4B0C6115D74556EFD2369D2ABC6ED4F1C11B1BEB7D6CBB1900B"
+			"E6E46A01936132978F19212DCF533848D3DFDAF7B96BC31BD81E9062"
+			"A2A49C4864C7B2AA71105090F2373FA05DC6E908C834E1D60674B4C7"
+			"ED20EF47E5340728641610E986A23F771F6F2A597AD5AB09416251C4"
+			"A5FFB7907B5303555DAD1B3DD2FB823FF63B91D9",
+			"389B615BDCE5648082DC0F88DECCD896",
+			"0TXHpUb7xi9tsXNqqQTNbp3HBjBlKNqrjLFbHmSfOWs="
+		},
+		{
+			"odd length salt",
+			"F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF000102030405060708090A0B"
+			"0C0D0E0F",
+			"ABCDEF0123",
+			"abc",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"99E5DFCFA0947732EC295FD4786D1B438AB32A88ED4520A983DC0EE8"
+			"CEEB3768A6BAB8E70FF99564E8B079DE784A50453D109023127225F0"
+			"9D671EAE5907A12CF4A22D6ECB090F0940EFC156E030F58339621129"
+			"BB9F9334F64363E0FDAED419F5BC425854D71A3AF0C6D85C59CC642C"
+			"B9DF04B9039668815CD463412E8F576338165CC910ED87D0B5C55207"
+			"08477D8F20EA800678E2C14A7694496D01953563B12B60E30640A861"
+			"D45324CA1347EE72E8D8047E0D14C34A2F05F4C82ECA250AFE8D94CA"
+			"B30F4B6BD3EF5AB685EE25EEF9F4DD3066D258AF2B740A109255647B"
+			"772C85581C4763283B672797E1EAFD841957F4BD2539D1C9C7766153"
+			"A28BC2D92FD9C8B30B8D27D7F3E538C555966553526D2CC973F513DC"
+			"D3018462613676021598F331F9639FDE8E686F9AA8D6AA5E4903740A"
+			"FDD9177334962C51223CE43FE859BB5DDD94900C4976BD4CDB0CADBF"
+			"6E4A1476177C80A63094471D9E22D21D159B5D0C207D438D5E6C7A84"
+			"9DB4986B5F3766A9098E90772CB77C68B3615C68",
+			"566CF46852E890B8E25CDA9C33B64FFD4FBDF4AC1724EAB36C5BF4D3"
+			"3F0F06C0",
+			"3A87CE3207DD65C5510CD60CE08D446F275B7E5A9637A8A0C9147480"
+			"328C5C21E70515CE159F8D4B6D6F5BF16B5EF379A53D88AD2BE35E82"
+			"FA49ADD7A01F4B80A06D5EF97B7C5B7CDFC1A2DAAA78E65860CA7E4E"
+			"DCAF050E8C7B8FF5F07A5575F4EDB047D25F1D0DF764AEC9C4FE8857"
+			"D7B2712BDBC31421DAEBD8721883FB99E6CBD7F4F02D2A29949BBAE4"
+			"10BC5E0A38F20B3DC892D1A32982D6B809A052A48AF3324FBD558F8E"
+			"BE6DF75261208CCD824493295C791981C13329A49A23960B93212245"
+			"52B3B098D35EAFBE49B3F5EF2D70A9162DF1B964210B46EE9EE6BA2F"
+			"7EC34D9B92DF56CD570DE7F34DE511D867AD654E197EE93C54AB5992"
+			"51B69C541122B48F03D5AF57CD187E77123D109986590C660CE58697"
+			"98B3CBE44B95832BCCB55CEF0D8B07BDDB6C25714238510B7C5ADBFA"
+			"2934DDCEA041F451F71F46A93B9662567ECC2D6E46BEC016E9080D95"
+			"1F6D39EEDFBAB871C1D2AF39B0E54F4719146BD61F352DFC7724080C"
+			"093B68FDDFA32A836854A783370F2870688E1F7D",
+			"9477A95C2B89AA67C94AFCE62053A881",
+			"1uPXx4OtIwqLyjG8fQaqR3V/HbmzGLx6I55+20vawM0="
+		},
+		{
+			"salt with a leading zero byte",
+			"F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF000102030405060708090A0B"
+			"0C0D0E0F",
+			"ABCDEF0123",
+			"00f234ab",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"99E5DFCFA0947732EC295FD4786D1B438AB32A88ED4520A983DC0EE8"
+			"CEEB3768A6BAB8E70FF99564E8B079DE784A50453D109023127225F0"
+			"9D671EAE5907A12CF4A22D6ECB090F0940EFC156E030F58339621129"
+			"BB9F9334F64363E0FDAED419F5BC425854D71A3AF0C6D85C59CC642C"
+			"B9DF04B9039668815CD463412E8F576338165CC910ED87D0B5C55207"
+			"08477D8F20EA800678E2C14A7694496D01953563B12B60E30640A861"
+			"D45324CA1347EE72E8D8047E0D14C34A2F05F4C82ECA250AFE8D94CA"
+			"B30F4B6BD3EF5AB685EE25EEF9F4DD3066D258AF2B740A109255647B"
+			"772C85581C4763283B672797E1EAFD841957F4BD2539D1C9C7766153"
+			"A28BC2D92FD9C8B30B8D27D7F3E538C555966553526D2CC973F513DC"
+			"D3018462613676021598F331F9639FDE8E686F9AA8D6AA5E4903740A"
+			"FDD9177334962C51223CE43FE859BB5DDD94900C4976BD4CDB0CADBF"
+			"6E4A1476177C80A63094471D9E22D21D159B5D0C207D438D5E6C7A84"
+			"9DB4986B5F3766A9098E90772CB77C68B3615C68",
+			"566CF46852E890B8E25CDA9C33B64FFD4FBDF4AC1724EAB36C5BF4D3"
+			"3F0F06C0",
+			"A5C761A3586079C210C569FBBF93B8F3FDA04B353B8DACE900023630"
+			"57E61285812F1983AF78590224AD835B981908378830EF230A0DA24F"
+			"62FAE67AEB6FB5C38A767D32A4DC67A8553712A35A6A7883CD6588B7"
+			"FFCD45AD5A7BE340D40A862E7800FAEE8D101D5D407E6FB35093E3FF"
+			"A957ACAA7223B366F65ACBB42E6D895BDFE4A9ACEF4E5AB476BC288E"
+			"DE427656F402E01FD488148D9C6E8FC624D466ADFC8744A0C76AF9D1"
+			"89BBC1C2675E6050D31E828E9FC67A120C54AE530362D455CFC98D14"
+			"8C70BA43BFF7DEE83AD2D7648B23261E526566302D0FBBC8BBCAC443"
+			"EA5F7878AB1ADF1168034CD3B9727B60CEA87EF85439E0859D9E62B0"
+			"84D3AC9FEE40A02986EAA17F1A1CDCB4183BB222DFC664A54CC7576D"
+			"499423C03A48A922157A928A29BF3444D5E06BDCE3DC78F56F702192"
+			"6A7F20A7D3CC01EF68E1006299C22FAE9A04155FABDB48B826EE6420"
+			"16EC8C6DE68A7E465A86F7D81E52DC129C887A4C682DEA98E420B716"
+			"454C4D36D4ED25C0AB19C31DDE7AD6860B596C17",
+			"FA5EF9BD6AF74A673AC6D8F2836153C7",
+			"hetrjy2uk5NVJ6S+stJBElxdumd6eoLFgUq1N7YTM/w="
+		},
+		{
+			"salt without the high bit",
+			"F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF000102030405060708090A0B"
+			"0C0D0E0F",
+			"ABCDEF0123",
+			"7f34ab",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"99E5DFCFA0947732EC295FD4786D1B438AB32A88ED4520A983DC0EE8"
+			"CEEB3768A6BAB8E70FF99564E8B079DE784A50453D109023127225F0"
+			"9D671EAE5907A12CF4A22D6ECB090F0940EFC156E030F58339621129"
+			"BB9F9334F64363E0FDAED419F5BC425854D71A3AF0C6D85C59CC642C"
+			"B9DF04B9039668815CD463412E8F576338165CC910ED87D0B5C55207"
+			"08477D8F20EA800678E2C14A7694496D01953563B12B60E30640A861"
+			"D45324CA1347EE72E8D8047E0D14C34A2F05F4C82ECA250AFE8D94CA"
+			"B30F4B6BD3EF5AB685EE25EEF9F4DD3066D258AF2B740A109255647B"
+			"772C85581C4763283B672797E1EAFD841957F4BD2539D1C9C7766153"
+			"A28BC2D92FD9C8B30B8D27D7F3E538C555966553526D2CC973F513DC"
+			"D3018462613676021598F331F9639FDE8E686F9AA8D6AA5E4903740A"
+			"FDD9177334962C51223CE43FE859BB5DDD94900C4976BD4CDB0CADBF"
+			"6E4A1476177C80A63094471D9E22D21D159B5D0C207D438D5E6C7A84"
+			"9DB4986B5F3766A9098E90772CB77C68B3615C68",
+			"566CF46852E890B8E25CDA9C33B64FFD4FBDF4AC1724EAB36C5BF4D3"
+			"3F0F06C0",
+			"3FD7B24391F675553AE3C4EB93FD24176039A10DFAC0B8C140F9067D"
+			"4C308F097EE7677E76BF96B41F394F2942E6CDD827BA777536B3099C"
+			"2B728CCC5B8B1DDEB6CE4EA1F1E6A0E5FF7EE6247FF86EAF9721B1E6"
+			"FEA06F6A59CB3C52D0FB7E1081E7B366F11416EE8F615020D489834B"
+			"7FE960B71D75FAFC825C773BF43CBDD843D1C6EDF01ADBF9B051C309"
+			"E2B9E59A3C825475824FFB0B7AF5B09951073C94BB1DC44D6441F3D8"
+			"71995CD2FD4B2C135541BB4A7A0FFB74DB7C6A93018D1DAE3D334A4C"
+			"788FB5842EA70C22DBB3D72C3E58FAE4E4EA8533BC8F2F6D70BE20C3"
+			"58615128C2351FA431E37D12631CA0754461B23142A6759D4DFAB783"
+			"5E108FB3374A67C7D88A8EC8B177638020E2EA77C41E9ABE9CE6D764"
+			"092834FEBE3F63FC77EF7AF43E77B0891D1767520A59BE316FF1B7FA"
+			"D93404A2207A1AD2F7E16954D9B0680B68CA7E77F9ABCD9163620B68"
+			"7FAF8505E8F729DEBA525507DC993A4F0E567E7E5C1368DBF4D0EBE4"
+			"492029563994BB79A383B0C0D4C5069F1A8C33A9",
+			"42C4B347FA17E06F01DC60EF7851EFDA",
+			"dT2pBMWNkpFTwGad0GwIDRJbxpVDLkAOBeAUONEZkBA="
+		},
+		{
+			"B at least N",
+			"F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF000102030405060708090A0B"
+			"0C0D0E0F",
+			"FFFFFFFFFFFFFFFFC90FDAA22168C234C4C6628B80DC1CD129024E08"
+			"8A67CC74020BBEA63B139B22514A08798E3404DDEF9519B3CD3A431B"
+			"302B0A6DF25F14374FE1356D6D51C245E485B576625E7EC6F44C42E9"
+			"A637ED6B0BFF5CB6F406B7EDEE386BFB5A899FA5AE9F24117C4B1FE6"
+			"49286651ECE45B3DC2007CB8A163BF0598DA48361C55D39A69163FA8"
+			"FD24CF5F83655D23DCA3AD961C62F356208552BB9ED529077096966D"
+			"670C354E4ABC9804F1746C08CA18217C32905E462E36CE3BE39E772C"
+			"180E86039B2783A2EC07A28FB5C55DF06F4C52C9DE2BCBF695581718"
+			"3995497CEA956AE515D2261898FA051015728E5A8AAAC42DAD33170D"
+			"04507A33A85521ABDF1CBA64ECFB850458DBEF0A8AEA71575D060C7D"
+			"B3970F85A6E1E4C7ABF5AE8CDB0933D71E8C94E04A25619DCEE3D226"
+			"1AD2EE6BF12FFA06D98A0864D87602733EC86A64521F2B18177B200C"
+			"BBE117577A615D6C770988C0BAD946E208E24FA074E5AB3143DB5BFC"
+			"E0FD108E4B82D120A93AD2CB0000000000000004",
+			"f234ab",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"99E5DFCFA0947732EC295FD4786D1B438AB32A88ED4520A983DC0EE8"
+			"CEEB3768A6BAB8E70FF99564E8B079DE784A50453D109023127225F0"
+			"9D671EAE5907A12CF4A22D6ECB090F0940EFC156E030F58339621129"
+			"BB9F9334F64363E0FDAED419F5BC425854D71A3AF0C6D85C59CC642C"
+			"B9DF04B9039668815CD463412E8F576338165CC910ED87D0B5C55207"
+			"08477D8F20EA800678E2C14A7694496D01953563B12B60E30640A861"
+			"D45324CA1347EE72E8D8047E0D14C34A2F05F4C82ECA250AFE8D94CA"
+			"B30F4B6BD3EF5AB685EE25EEF9F4DD3066D258AF2B740A109255647B"
+			"772C85581C4763283B672797E1EAFD841957F4BD2539D1C9C7766153"
+			"A28BC2D92FD9C8B30B8D27D7F3E538C555966553526D2CC973F513DC"
+			"D3018462613676021598F331F9639FDE8E686F9AA8D6AA5E4903740A"
+			"FDD9177334962C51223CE43FE859BB5DDD94900C4976BD4CDB0CADBF"
+			"6E4A1476177C80A63094471D9E22D21D159B5D0C207D438D5E6C7A84"
+			"9DB4986B5F3766A9098E90772CB77C68B3615C68",
+			"B6D451C4712679D82402F1637DEF56FC8F6FDDB418E928109FBA7B40"
+			"C681F35A",
+			"9CC3036B3FF66941CB2FB903DF720FD019E3EFFEF857F156B2EA3B38"
+			"415F6F6E20AA66D3159FF563AD93371AE89397E4BD99BDB57B2FB4A7"
+			"917A069330425CDE64E0D9FA6DF1B34A7412259F9570DE8916DCA5E6"
+			"333BBE762A30C7E82B88BFC000E36C6FD07C7AAD4A77246583161E74"
+			"7F083602D84C38F359A21202686E7F87F34A13DE996EA0DBAA5B8641"
+			"6DD8ED2CC2F2F0142EFEBFF4CC2BEB72F8EAA9F5BF6290BA9A7C6ADC"
+			"C9071216BC5FD68E81A911A5819117BFD4765CC9A4ACFCCEC74E7DC7"
+			"A987AB6AFCDF88FF27A1DBBB84A4C04FF1A22DE8E65BAF2855E097B7"
+			"4945D990A8BCE0AECA02E8A1DD987332F054BE93CDD06B96908F549B"
+			"0E285206BD468E9D4337C14586CA32F5592BC864694C9C4E70D37A43"
+			"66FD4F5DD4124F46CE01E278394F1A68C273C0C8935FF12A03C4AB3B"
+			"EAEA5827CD7B13BBE60215819BD158D8FC99681E18EF5077B40063A3"
+			"2C8B840EFA2C9AD627EC5FC3518960862733BF034171FC2FE8449787"
+			"D2A37E891F62B128DA953FF00492EB2250591691",
+			"EEAAC19F4A8EA2A7CD5F65149D4762D3",
+			"WLJqvbAtIHjFZ6DigcoFFBPMVSZgzDYT6cdabAnHsRs="
+		},
+		{
+			"empty password and secret block",
+			"F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF000102030405060708090A0B"
+			"0C0D0E0F",
+			"ABCDEF0123",
+			"f234ab",
+			"us-east-1_Pool1",
+			"user",
+			"",
+			"",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"99E5DFCFA0947732EC295FD4786D1B438AB32A88ED4520A983DC0EE8"
+			"CEEB3768A6BAB8E70FF99564E8B079DE784A50453D109023127225F0"
+			"9D671EAE5907A12CF4A22D6ECB090F0940EFC156E030F58339621129"
+			"BB9F9334F64363E0FDAED419F5BC425854D71A3AF0C6D85C59CC642C"
+			"B9DF04B9039668815CD463412E8F576338165CC910ED87D0B5C55207"
+			"08477D8F20EA800678E2C14A7694496D01953563B12B60E30640A861"
+			"D45324CA1347EE72E8D8047E0D14C34A2F05F4C82ECA250AFE8D94CA"
+			"B30F4B6BD3EF5AB685EE25EEF9F4DD3066D258AF2B740A109255647B"
+			"772C85581C4763283B672797E1EAFD841957F4BD2539D1C9C7766153"
+			"A28BC2D92FD9C8B30B8D27D7F3E538C555966553526D2CC973F513DC"
+			"D3018462613676021598F331F9639FDE8E686F9AA8D6AA5E4903740A"
+			"FDD9177334962C51223CE43FE859BB5DDD94900C4976BD4CDB0CADBF"
+			"6E4A1476177C80A63094471D9E22D21D159B5D0C207D438D5E6C7A84"
+			"9DB4986B5F3766A9098E90772CB77C68B3615C68",
+			"566CF46852E890B8E25CDA9C33B64FFD4FBDF4AC1724EAB36C5BF4D3"
+			"3F0F06C0",
+			"927747DCA91FEAD1D98999EEDB4F9A517F3229D4989E7C92F860CF16"
+			"4619E4D2348F559AA021B7708A15AD9A6A4D2B4535C9091F2586B5DA"
+			"31DBD73F5B456CCBFDBCC3ED075B1C41B449E2096D7486C228025086"
+			"A97BC483AFEA670E682F9D1BD4D2BB7F9811BEFABAB8725698958643"
+			"DCE686681D45D592558A7A20B7CD8B306A761BAA99C38EDEB91D16F7"
+			"4D4D91899B54E40BA84A6F182D20757EEAB3D120A90B03D7FA890384"
+			"9672D0AB431FBCC3BD9719893B9C1BAFDBEE29149E1936BE89230829"
+			"2023F24112E34673AD187754306238430255C7FD23CD37CC712C48F9"
+			"DFB4C9733E678D80D464BD1BB952FF7DD6E403A62F5FAEA8AD3330EB"
+			"E8BECAB5B9C13A4D56C673C2D8B02A4FA518E2B4AB116B4D612AE01E"
+			"AEB9DFBA1C68CE2CC39C13D4F90C7146E2BF7F1FADF949EE9EB51A3D"
+			"32B69A4155DFC4164B485F910E1E8AD4AE94BAEE8F6431D6A6FFB08F"
+			"663EE2545B6080B207469EACAF6671E91345202CB79878EA53A79DFF"
+			"A6F221C7E176E3F94DBAB22878F1C83521331A52",
+			"5C7AC79955DDAA7F5400561A1D7030B4",
+			"yzKDmGemzbluStNLV1v07zSqQ+t9R9IPKMGJ9FwBUlA="
+		},
+		{
+			"full size B",
+			"8CD470C704FB1186038B5B93853E7E02C5DB24555E84A5EF55932DE7"
+			"0CE384FD",
+			"F8D918856DD7D81F6E79DB9515F87E06B10FB51DEC5806AC15E98506"
+			"4687D6FB171F19B0B29B59E1F819D3C55E74B3A5AABC1A22078831A7"
+			"212962C4BAA2BDCAC5A56DD3A40C9FB8B77201F82FFC10C6824E443C"
+			"2018E51441899C02839F83E523C13528ECAACFB91ECB254F5B215CA4"
+			"C178A028BC688F91A669B65758DD2C9ADFC36C8A91F6A77A92E72B13"
+			"2A37758D5E1D2C9A4F399F8B50BEA1CBF4A1CE29204568CBC6B9A751"
+			"FB5845802D98E8B7D0571F0DB51C8A7710196F7B85C0B9CB50627F9A"
+			"34692892693C1738F8F547A686CA9FBFD8116A7DE10159B93DCC9D60"
+			"323364439ADBD57721A97CF0F1616BDEEF8C0E9893F3B860543B31F4"
+			"AAB5E5EA05D03A24EECE960EC02CB7F4B3AB6AA2A671CE3DA3B522E6"
+			"0D4A2603A22C5D7B336A11C2373EE8B3A902AD2F4112B353A2CA9EC3"
+			"CA7DCCFC0050C95647A7BE0BAEBF026787CD73AA5BBDD58CBAA021BD"
+			"79B36FF68868F563A590811D4D33AE39750D2C5210BC28AAB0EBA106"
+			"CD39DCBF2547AE92E122EB67FB3F03BECEB5FDF6",
+			"8615D233A1FD9947F26A857DF308FDCC",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"ABE02ED8E0856F94E6B1113EFB0FCD6F8F2723C1C59CB585A634D216"
+			"3344A1A441183036A88375FF7D643F69CD2AD22B1CDBAA2651FE26F3"
+			"138E8F249EC8662AADB0C7029DE5B0FF6DA8D4FF8781C4689E481F71"
+			"A906A70A410A532513ECC8E05F59010C26DF0D66E6E78F1F84DEACA6"
+			"A39758E859F49BAE182BD6F13F63E1B8D23260B0384019087BE73C91"
+			"80B007E77F9BFC3F4D7D61483EDAF3B4A2386160CDB62357C00EB56B"
+			"52F5122A26FB6017DC533BAF61C072780D5DE429A782762B24C5A105"
+			"1F04E6CA77EFF0C96CCA930A172651212DDDE7B49A974B5D1D813FD2"
+			"29B7061A7151F68C436687D2A7BB7A4A15A46BFEE1E789A4F61CE086"
+			"DA8C736F3883FD4AC71476DF01230A260288DB82292C6CA29F8B2C22"
+			"5F06C700A71985431B2321CFA624285BD82C1A365C65C3A16346EFCA"
+			"A56815C3B527EDB98E912876EDA78775D5B8C63ED968B699E0FDCEC9"
+			"79F11BA6FB3A406C8609CC04FCA541768CB7BD7CAD5976286A0BBAF9"
+			"C6F1FB16039925D479FB33F1CAB5E94C18B403BC",
+			"5DEB03679A88B0CEFF093BA266440C84BD27DDA96D47DCAD5293E6DC"
+			"5F42AE6C",
+			"66EE399395AE00E567388AD10AFA649138D9C99D2F5B32B913592A42"
+			"0C5E7286336B682C2DE9B5EDDD97CEECFC3FFCD94234ADCBDB00EE59"
+			"E2B36E4E04F411CB4C602873339F5DE7EAC4A6FE3624387BC457BD78"
+			"4A115B91195BF2E29B04BEE01233A18BD1BFF607DA020E44AF12A6F4"
+			"66C010E51A5C50A3F4E1F865EA7EAF75135E4C5091993A625DE74200"
+			"9B326DC80CEE51A4C7CB48DEE43ECDA6490F4C9F5DBA5C22B0065EAF"
+			"7192E1A87A62D46E741D0740F5E40781F48A9E560F8AC80848634D21"
+			"39785810CA313AD8170AE0F93534EC10E93715ED22F78D28797EDCA0"
+			"4108D0D4C4DA0516005510BE8AD3BC7B81240EF5FFFB1DC7FF3C810D"
+			"82F8AE61B0FBDB6C7F6A35F23A2C6DBB3021B889A90B38F6B82AA29C"
+			"03137C53923A24DD90E38E92516463C028BA2E083B0CB30F4799ADF1"
+			"C13EEC19538D4BB9AB03C8D5E8E6DB11A54650D4ED2C046536DE6EA8"
+			"6CF171F1E647BFEE4B4B1426A427CAEAF087EBDA75023DA76962E098"
+			"F63264B657D0616BA7D7B6E821B717C78B034A84",
+			"5EC777B2470D953E026B48006B894755",
+			"tk/d+5P3tYyFFuJlEdzdWztRlfTPQL0FpUNAhKGoxd8="
+		},
+		{
+			"A with the high bit",
+			"F1D0F7477D5EA96709576C6AFC53AB48AEEF9FEBB8856A00E51E4017"
+			"6FA60CC3",
+			"75D106A4A7B3CFC438591054C8A19236145BCD3923DF4C3567C1740C"
+			"0EF621DCDF277AFF7D419863FCAA19CE0F1010708C810821A8B40B27"
+			"EE7427D8F5E0E2BD6EF26D0CD010DDEBDE4DAB617DED2112F2EB7B36"
+			"7C8B433CE68650CD532F49D6C6D8BE4D8FD13DE8D1BA4B4A9938FEFD"
+			"698FD8F0AC1CC1C8BFF09DD90734B8120ACFCCC227EA35E4853E27E8"
+			"3CBFEC4798BD0BD004B498377A03789DA82952E53FDC0E5F463C308C"
+			"1BA992CCC707DCD25947EB0E721A116D1E854F42508AF6AFB41214DE"
+			"691E0C17D6B9EF413C4BD1C65176E1C6F62BEF879F54A4A1D7091447"
+			"99B8B4DB5359134BF4B301494540C7B5175A783393104FDAB4077BD9"
+			"8E5FD8D5A9A094F06DE1066E47C7921670358595C1989817CD388CF1"
+			"CDDFD885151503A68CADB2A2CB124E53DC49BFE61EA3773A3BEF27F6"
+			"8D55FB767D768640F53D6B146DD36166775C98359C1ECFBD24239B5A"
+			"25A1D3F7D67A405316CB3651584A6899F1D6B738D337784DFBB210AB"
+			"7E00C4729B46E9C7822F8C395E88E650E28BEE8F",
+			"ACE73C7D6B6078BC86C0644ED50C221F",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"EA7D4C648D547E71315B1D83A383680139D1A2D6EA5AB8FE056BA3FE"
+			"FCEF9A842B46A6AF89E50692D870C1271E8E6E47D7D393B47F892568"
+			"C006614F28D40942632D34DD3CD524FE2200EB470A2A54F6BE47E0D2"
+			"0AF301C80E707DA74D315E8C0D850B6B39124800A658DA46B3C1EDEB"
+			"92B2A048DB53E2CB63249012DEBBC754079DDA7F00059F8865DE8022"
+			"5CB3716AA4E4788DA6E62830BCC48898CADF631377CF546111DA6ED9"
+			"85982FD9B171DAE81FF7B439F6A8A4C3613947A24E912F60E9576427"
+			"6C10F61E30BD833BF2ADA95CBB1E03F7ABB6D244D6F4D74997A37B5C"
+			"B49376B26E4C13BE1FBD833340CF7083291057294DDF252E03F789F2"
+			"0CAD102F342F0ADBA127DF675E12BE52C36ED6F310DDBE00ADDC250A"
+			"03D57B8AA76A169CD00651CD0BE0EA2D89503CD534F1E633A2887316"
+			"930DD672D1422ECB93EEE4F6E0B947BF8EE5222F191AC43970929585"
+			"9C6D2F6ED493B20070FC1908845BD5DE5767CAB9B3BA76B8C34E6B6A"
+			"3013039CA154E1066D10641D620DBCE5429E25DB",
+			"9EA46C31072AE78AEB81E009E69B30F849F59640F0AD5A7161A83ADB"
+			"6BEEFCA0",
+			"776076B4D9D50347E8A154232A8AE474A1EA4FDD173051C2B27AE423"
+			"A097F870B6F4CFB8BAFA1AA772013D5C1B1B8EFBB2B18361A54A802E"
+			"7092CC5B796B5B31367FFEE374FB84B869E1784FD9754BBCC6EB3241"
+			"4AEBDAA8395A5D079AF97A9898ED8ABD6039A6D4DA89AA70F579D9BD"
+			"5873D46AAE01C7E717F9D3165D64D69E1B1BA1DD534BC35FA6B57E2A"
+			"DF5167BB10EA369FC155216545BC587D5724BA430EAD69929969BE1F"
+			"8C60C89134A96E829BAD2BE54968AB0D14750D0EA6B9B4A9F15282FA"
+			"7CD9B6A542AF43E2CCB2F443A7651317DD86F176E32370B3CFEC21A2"
+			"A8F0EEDFCF88376803AAA9C54DAEB610C610C1ABFE26DCE155562908"
+			"365A05048B45C3B5A21316C2EF979C4660E979ABE1B87D4E91F266A2"
+			"750CE5B48C858942EF49D552D34B92A9C5CAF9A68B39FE44CE2A8995"
+			"C9D6A2A443ED3004D071432EAF3C94DFF62405E70D9A22118CBE5388"
+			"5FD6795FA82BB5FAF9BA06CC530E55A43531DDE3676F6FF72979E044"
+			"0F2EE76456EC77D13FF5828F6FD62938F7EF1FEB",
+			"208ADD14FF3220DE5B5C0540A9D458E0",
+			"ebGr4ZJIMk3CGrcvuSUVq0lx5QcV513iZFqWWKWX7ys="
+		},
+		{
+			"A without the high bit",
+			"32F1CFF1D9A9BEB600CD68EBF162C029040D02BB73D82CCC49FD9805"
+			"D021509B",
+			"065B525CA71BFC9BC0EDE94FBC496DCFCCBD6A038ACE00049789AFDC"
+			"E5003A7B911CE663C23F578F82F1DC6F6F67571AB3D438B199625FDA"
+			"1C21417207B692E0DC416F0756B01C1E54EDCC746D90D3830D19AB96"
+			"D5E16FCAEE9E81A94A542C5C1503C7DF85F1A179B243CC4B7F93978F"
+			"C09F6F8DDD72ED73D6ED061EFF0FD00D269D2C5244C60F3D5D5467D9"
+			"57DAE52E774BE702191067BE0D47F4D3DEC1AC69CAA60BF382B24549"
+			"1E663D186394BE22A87BE01C4D65BA8149FF0D5D2F75C3F03B339DEA"
+			"97DC164F04E7B372650B1E226ADC1177E856441627E0641E10C0D43B"
+			"EAFE3F39775C8CF41FC406BBF3C433B9E80B3C259DD670AE547FDC8C"
+			"3B8C4BB7E6F5CF9A5615584A7FEE09CE39165BB84315CE557D8B5D24"
+			"B8375B34FF9C27ABBBE2967E67F2F63ECA27EDCAF3AD7628C5C48EFD"
+			"3DC4250B517B29796DA251C82FF4774A227AF76475C9C4FA221B5754"
+			"A5814D83737A376C7957495B81A91B11992C5EB80AEC707AFE124EE9"
+			"B90C9F0430DF3503C6E8AC9B084746880A3E7DCC",
+			"6090D54236FB14BA0C29D5FC1639F1D5",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"2244741B09A1FC442C7E92D4217507F8FAE3756B4FF38A08FB502690"
+			"AF65C25D4FCF4E86968CE420596134CFF478FAE00B33EF9E93C0DFB8"
+			"138DA1C733A6A61E1FA1AB24D523E63F9942AD138761A443E0345660"
+			"64B71C70A14CDCED6D289F7C91FCD9B47E2896B6090C08B515E71B6F"
+			"604958C5E5DDDAC01B670BCE84940AECB8455717DB2D0DEB390484F2"
+			"D478B20DF5644DFB09BFB87DCFA242E24AB2A54B4233FBB6D20FEF59"
+			"D0C8EF1D9E654F416415BF6DC3D136F7F2627F7E0A41C61F6B05F18D"
+			"DCDC35B78BE27E4A7C08F135A8E6E114DA0013B1A3E1DE17196E934A"
+			"13525758ECE9577BCBC88A95E7A228ED625085E7C13E16DB4D7C6F16"
+			"D693FE12464A370FEF506E4990E361A4ECFB903DA320A06777D63543"
+			"517C6FE175057BFCCAAC2DFE18FF95BE55DCD18ABCED53F2F21E97CC"
+			"81AEC1F66728427829B8C05AF82C9EB0D6A4287B00A2C88E49357ECF"
+			"387619E2740B9D7D85B63A1E83D0702750296149FA855D6D1915C8FF"
+			"D4F1BA1A67F9487453183437D9B7DA4B781B9A7A",
+			"9836A6E18AF633E5C1645A9DD4CEBD7BC95F8E528005F5AF718D9A31"
+			"39F8288B",
+			"80FD54FD07E75CA1F6B51B967E249866056847821C5B72AC33E442C2"
+			"29DC3FBF432C7BEFF61137ABDF61CCACAF706137E80942B9932778A2"
+			"A95E77A8A80E87844F657B9E6709E009348452C687AA675C107CCA0C"
+			"B9CFD906154A08FD9B81049CF1EBBB691B6FFE0733EA98DAA585002D"
+			"4170C1898F47B41B46C43BC3A892B778F78E34ACDC06B8F1A8E0D8CA"
+			"E1E34EAF500B25A668C8D99BE610E5BCA45A1033C2A3E9DC43427993"
+			"40BFEF4E9A4DBC346EC0E79FDF8C5861400780995D7FC23C95246311"
+			"B0188B324679718B41B71929438AEDF33A24EFDB16E28AD86F9436E2"
+			"BA21A43F641E00DB12CC56D58D655688DAF6B8BE8E0AE926AC8B1174"
+			"2546BF33C6E38BF52E5489F513017F3FA39663676731D849BD59061E"
+			"3D997A5CD05F36A78213B1A59AC201DCAFD8279724C137C14E659EC8"
+			"195132CC1D03290DE1C7ED69D14FEBD1525CC800DC3611A0A9B1D81E"
+			"C68B7D7E7724BE52C86FFD6A3EAC32A69A5BC7D8274714CB1956C4CC"
+			"444E7DB1C785EC3AFC493B10C212A0879B5F692F",
+			"084CE5BC72C527D85430DE7A249599C3",
+			"pDt/SVIVFbJQFO4sOT/urrSg9v7DHlfctKYnfVc5TWk="
+		},
+		{
+			"u with a leading zero byte",
+			"6227FA4B699DBC665F9A06FF10664751C9EDF1DD7C3281A70ED45A49"
+			"25DD0B91",
+			"43B9EC58CC68E285C70BB42AE11615FDB66D91787BB63ED4CAE6025B"
+			"760D2A3D588DAED548F4881B5B6189664F07D0AF9527F31A165B7872"
+			"641DA5B736F03BFDBF20CB1B935E6365A9DFCA348F159054A19D2861"
+			"3C5D1104999B7F32D6CA87CA042A5ACCCB9A8E857B07D1B92750F45C"
+			"7A07D83377F067D1DE703EB08A19F4936B8452869ADFE716C6A4846B"
+			"07DF9D022A36AF3099B78AB3EF26CAD3EEC65031974F9900C829546F"
+			"22631055EEE126E36942FC7BC1FFEFBFD66CDC0947B696BA704130DB"
+			"C813340F560411FD8925CFD0C1D62178D8DF5B85334F5FD99661DEC9"
+			"66941D64C0AE66D0D793CDC57CEED1D2780EAF3DB9985DBFC571E423"
+			"553D80B9F4C63EE0507E186DF9F4013245F36AF83C17B3855F815ACE"
+			"8B0054C1DE748EAD5EE09D7D3C2D8249ED493A371C08A77AE9B4EB0D"
+			"CF2B85D41350CDD53D3C06BB19951425A538FDC74BC825FF0D462DCC"
+			"E6E4984C24207A8BB46ABD9D0788F311E0F95FAF1965935270F89AF6"
+			"9F1F7C419A9412F4A4B7D507A2C7BBBEEA9B8791",
+			"7274665EF50DA122A84772B6E2CD6C98",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"50BC1A408AAE5D1D73AC3B9FE39A15148F5CD3CB923FFC7CA0270B5B"
+			"5CB287EA742C0DC40E3D941C47DF7BEDD7D27CFF18177E5405533D25"
+			"4175D2644A6335486F006EA6FF67B5E1A496F6C9C64EEEDFCFCFAC7B"
+			"BA58D58A4D1D78EC94D8A869EE7582F4C5255284CBDDC1F20C5AE3D1"
+			"D15F8FF8C4FF4F67F6AB76DFA5DBB05C72C9FD46270B6937698A8A67"
+			"623EA41FC87109412E1954E8EC85E2BBB9E8E79E428817D782F18DCA"
+			"E7C6DD4377F2FE54CE901092B11C8EFDA0FC8C9298DF677CC8255B0B"
+			"2E51565A1EE30F1A2E06C8BD501388FB16D4D30E8EE1190D9D4B913A"
+			"F10F598103818B8002D864E2008B58AB81B0F9CC71B1113E45762D71"
+			"99466557A727F731B94AA770BA722C7B38D620B56BB4CF29DAABF6AB"
+			"8ED39C78A495CD472878D3F7DE3837B350D1A46B111B586069D6D629"
+			"80A194C95C1A088C41D04F2F23ED28F99BCADEDE056CC8537F08B2D9"
+			"D378160D6FA5C6E5E4BD5477091A9B234FBB2BCFAA5A606F96B649BE"
+			"35DF512FA6BF217DD07C4F9F4D295C81B2712A2B",
+			"BD2AA3BA0A6DBBC834EAC4FF690FCFB7DB5F9A77CE2B951209B38A8D"
+			"0FE473",
+			"924A127BF4ECD918B3523604E8B690D4AC4B10A5C48CCEE45B4F6EC0"
+			"47F153AC62467E81848D480AC1C4CF466D4797713C5771ED499ECF4F"
+			"93B49B607BE1F1355097F92154632AEED6D280D6B763CA7F576C069D"
+			"A84261153BB6F408954906A321AAE21E85804F11DC44F2A064248651"
+			"01F3B7376A7F24E65536EBBF59EA64178BBA025C996835FAB9F2A662"
+			"EA18D916B6D39165704E7F308654153A3353324127F560B4E5A68F9D"
+			"F46A8745A2746D745197A248EE3ED88F2BA496A7C630DD76CD4EDC83"
+			"313ABB66A42BAD30B81F46BD9FC2358826067DB5F406427C5765E87A"
+			"95FE0BB4793A03C7274DD62F690D4220828D8E58E952725213C043EE"
+			"095D1D3FFBE3073E2C3380C59291A93F6DBEA7386F25002017C74427"
+			"F4BE7564721FBA9D9FE7828570B526049E035F4801AE0D200895A05A"
+			"4769B8C9B3751F0B8F30A2C32B391259FAB7174AA583839EEFC77554"
+			"C47C9716D0C26DCD00E8A31F36C73E5E3E7CD3E947CEDB0DF704EE1B"
+			"1DBF18510CAF15E41A0EBDA153A247B097C85BB5",
+			"D276F295BA2DE7A6C916E15577D0A33B",
+			"++H2a+W/jzbRHYKq/6Hl30RBHllTuwpGsW1hqkJNyJk="
+		},
+		{
+			"u without the high bit",
+			"466D179641BA0DACF58B8CB88ADD9577EBCE96C71B43B382CC015FED"
+			"253AD483",
+			"2E1FB03E235259946E19676546CC3780C1316629B85CCCE3EA0B515C"
+			"B5C53C8FFC0FDC83068238B8A937A190F50DC40FD2F11143E09E7CB3"
+			"F62B471FF865D545936182A14C3F2A8C6587D5790DCFAEE91E16F237"
+			"3D3B2E36ACEAC5B31B4528C8A97E8CD49DAB09B3B1D2DFFE09F90B19"
+			"CC516AD3B5E0745108AC4A166AA27BE88D014F954B0B4C1478270912"
+			"9A059C992380CF70EAA359E48199EA40F0FAE0BA1DA0345AA5C6AC5A"
+			"379CD4CC7E023947EA0DF8F416E3A720E8E3829D2BF03276759462E7"
+			"92FA877625C67128FFBC32E884308D4AA1ED9853BE540C24782E8E7E"
+			"BB5E9E24DA9A76223F66515A08BB0EFB63C63591CD9D1DC0937D903A"
+			"43AD87CBDDEE18E850F6D9C15738E01F6374E7C1AC4A76E1BDA8083E"
+			"BF0C69B357B62FD7AF14ACD67843FB22C427EABACE2781AD0431A3C8"
+			"A71819E3250E697C5A9DC49960CBE1AC07B228FEEFE29911094F16C1"
+			"073B2D2340E57EC173453CD18A4EE2A210A4EF9A29881D1263468E72"
+			"0A81FDC6FB08DE880DED2417AFBEA38C6452B87A",
+			"CBFA7793E2712C3CCAA9BEEC2D980ACE",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"21C015872CDA127648C11BE3F5A3981BEA145A68F637949A8CCEA4AF"
+			"41083C82089A994C4BDDD8D77A29A35CE4CA0ADB4C3C8FC0767B35C3"
+			"CAA43A543D4DEFF0725CD55AF6A0057AE7B17235AD6CEED50CA3C0A8"
+			"25D5CD90C1AE9D6D6C9EA583FD11CEAE5F31AC2B1D869E51B91B7109"
+			"34B20480975D18156A250367C3704C76F745B1DBE8756C044A419DA9"
+			"8CA36BBA451264F19038D885A7D57B4411773502692DC3D4675A352F"
+			"6B87D9C1CB64BC14530E6B93C17DD8FF5084B49B8CFCE6DA7EB20FB7"
+			"35F015D3DD782CB5513039938922FBFAE9E61A762AA10E88AAC343F5"
+			"8DEDE86FCC480383ADE85E4D8E233E3F0D4C7EED8DB2A29584712F6D"
+			"C895530B0E4CF43AF6877D2CCCCC6B2DBD20DB26B20A6467A906380A"
+			"2005721B8F9877F59B0C994FD465B064EB961D005DF42F4539EEC1B0"
+			"91A95CA61B5DE8D985730A9FF2C4B5017F7AA82B437783580924FDEB"
+			"905205759FE6973FE970578267CEAB355EA04CB7D1BC2E38BD36B060"
+			"21B639B6E84B327DA734BB43CE92C85DAB762009",
+			"239E4B5E9E90CD5456A9EFCBD0D37D7349ED542125A84636AF32089A"
+			"E06BDF5B",
+			"88FE2C13D6DC658E3F346DFF555A9BCE0010E0B2CABB34FF8AD0E7DB"
+			"380AC1BFDB7A2080E0D3D435328535125FF3E6DDF197AB0CC5162503"
+			"1A402899C3B0280993F354F64053AC23B418D960E3C858EB77BF662B"
+			"74D896B66957EE5F1F42E7024A1144A9C1485EDEF5B2E636E75FACA7"
+			"94713DB79FA9D02AAA2A28479B5166F4F34413B2A911B3E3D6837C1A"
+			"320DCE8CF59501ABBEB9EADEBAC5B3EFC13245A6457F342C4B4A50A5"
+			"C8CEAF6393172A945BF070C9F57FB95648DA80054099CF83664C33A0"
+			"C674F8CA0EF4CDAB86F50C5EFCDDF4ACEC7D2634991467909F0E5DC1"
+			"0D3C5F3443725814BD7E2AEF158FFF3F20C6A3292C6FC83922EE3ADC"
+			"18140F4DD9F9412D46FE11319A6B5ABCB9929176D4587ECDBA3EC9DB"
+			"F02CA034F23BEA734708DE6B91F52C93BBDEC2482647BB8FD422E60F"
+			"5985B7A2815D34B7088A2AFFEDDA8A9C04B29214849A0C19AEDD9A0F"
+			"2DD5FC35A7B08C61F251081F89741438E8B46C1762ECCE2FA85AFBE3"
+			"8317B309CC3948D642E7B94702AF01D2198B24F5",
+			"9F0D9F1ED4F97CBB715FC7D1C6F7D97F",
+			"6uqNuFB+oOHN15cWhvt7G3diEN16deRVU+kEWF4QyUg="
+		},
+		{
+			"S with a leading zero byte",
+			"E9807D0F480B6BB9E10216FF4DEF67B1452B67D7E29669010F5D747A"
+			"20E35973",
+			"AB8E4364EDC16CE5FC3D7DFFF7D3C3ACBF5C97C400B439F7BBA13B6D"
+			"E79F285978D4FE1A769D48CC1F9E44D72EDDC6D8887E6C1FAB6B3D2B"
+			"2FEFA599D22D006C0FD249CD854F33F8B1878734CCA07071410B92DE"
+			"13166CE880AC5B6301B4357F887EEF2654D55810FF77D478F9E5A3F6"
+			"BF777590920E085CF2111EB98BBC3B59C9193776D86E93DF5307A765"
+			"EFEBE1F43B56233BA6EDA68269DA0085A43A6531357038EFDB98916D"
+			"C1B78B2A7C0FDC853A56AB50004809505575FAAC88866FAC3B67E9B3"
+			"309C60D225AF8B6182087259055BC6E96EFE6A46D949C482B7FF5116"
+			"A9D891B4152C57C7AD5925CAB7AE08F7A25B35CBCB81E969673D61A8"
+			"F30D557210A461941BAF9384E898637DBF6D60EA50AE0253967396CF"
+			"1850ECD9FA64779C187377E01DCA697E8D94D1D83049C1442B678A4C"
+			"6CD0EF7547E959644A137D26E2F7C9D4DB5BEBA9F4C2B658FC74E402"
+			"766BD79D9CAAB2B66B44C45DE53AB0B0B1BDE35BFE7DEDDCA6A20845"
+			"11EFB70332E2E1352AE22ED0EB4650243C5ABD79",
+			"F624A485E0DBD2FEFED6067E3B7EB6A1",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"84EBEB4FF9176B830BB3B5ECB3E7D91E00D483D5D2F921A3F6E0EA51"
+			"56614639AA97C68354A0D482DEFDEB8A743A668000C81872668DA705"
+			"52D3E80E3EB2E92165ABC3BA6DB5EE85FEB70BEC6D026469CB315E27"
+			"B685221A3D9B5836F447620B66EA229F3C11356EF7D0E9C9E24D8F3A"
+			"F016FEB10E692EF9C21E060A6F3371DD4A4D8EFE24FD7B56BA1D272C"
+			"18AA07B4322FA1FBC7F2A28D4D32CE6AF7CFCB87F16056AF6192B747"
+			"49E1829560DA5A5BDE3C01CA28932C93FBBE0F7EC8F9CCB175A055EB"
+			"0F2E4B95890EFC8E2796AF10DBCC6C5686C6EC99DB14D379D4F4745A"
+			"CB9A64CA164B1F3CCD54D141EE69541E93BC8E8881F3F644C7E2017B"
+			"AD8C67EEF5F8EC2F60BBA629547C2727BF4B60EFE01069CB8A4A3FFB"
+			"251CB8E5F1A63265CC1D66A7DCEEB2C7B6D95E624EEBED85CE309AFA"
+			"7462DD0E2B9CFB00BCAD417E0365B95267EF208A3CD8EE16B063AB85"
+			"E068E3C127049AB8D7D18BCA786ABEEF48D0E2919A8E67ED26BC1693"
+			"26B30E3DCC864219430F7C75C7B58BE8F9FEB36E",
+			"6A64E93D3810BCC235329E448724E0DD0873F7E71D9D6A509416F548"
+			"EAA32976",
+			"8C898FDA0B7F48F84E5B32C32D667276008BB5DEF8C1F12C98A7DC7E"
+			"F3E44889FC7F69741E85F9E34EE01D7B7855E2C8BE852733FD146949"
+			"7E63AAB1E276B4F12A5CF35799C21F09EF7248FC1D731A35FA30F0F7"
+			"A9FA23D894026B4E3378FAE68D8CE700729602E83F6961C9B8C06AB5"
+			"6D6A0C3FA5660FC1F87AA4A2F91AE24A6EFA351A52ADEDA295D74F67"
+			"2CF9F205B86BE4FE47BA27E4E1495E5CAA4E4AC7D0E3E39161CE0653"
+			"05A154732A2CCDE134D23CD4B027937CA667A39B82F2ACA543B61B1B"
+			"171C339B1D647B84B08458D323BF0CB972E0C8CEA6FC64A3823E19EE"
+			"1DE48FBB42747443DC2C001ABCEC8B407B0EDA009A86DF093385A73C"
+			"4BC890526A3DF2BF229D2366F085434D537A1889038188CDF2E207FE"
+			"094B9C27E0958FC30FBA8CADED5806935512D330A724BBB4065994A6"
+			"B4B044161032D9BC7DE46A1C68D6DE276DE314C5B15B6CD996787E7E"
+			"12CAD5DB65BB9F641190D3D16BC194B63670BF0E29DB3A35A72D3CD3"
+			"B3CE0304A161C254D318C066862F250E56C1B5",
+			"34217C57AADFD36BA6708C1D51F331F0",
+			"qQPEJGZ99Vw9a9CdtdYZD1LsOJ7RJe84JwCU+uldnog="
+		},
+		{
+			"S without the high bit",
+			"45354BD4793EF962D856826748F2B30AAC9D0FC3267FC66EE1E860D3"
+			"6AF0C4FC",
+			"F1D278C3744D4A343BEA94DD0714851A17900D8ABC2502EAEDD9CC7E"
+			"B92252F2FED06C0D239342D56EB8848799D2A85F277E0E1A1899645F"
+			"0AA2F3FACE31C0FDEB3A70610EA81A8B0951F160E1F25E431C91F8DB"
+			"ED3FB37FF5A391CC22B7636A88D82CBB4F353CDF23E5BF32932F69AF"
+			"815D2423F1659036BD831DAA8FEF5D2F996828CFADDD85FB34726270"
+			"42B924589AFBF521C59B180F73E5A2306B4130D5A481FA3B2DCC935D"
+			"57B5756C4FA3C3B12CA25C9F213293641082A132DFD09407783C0C2B"
+			"24472401609733A188773C7C535DB27BC5D6F65BAA1E4AED649E5B3C"
+			"DD50D30356A94E84383864FF74B3F39BBA0AE44B8E73760DFDB5C825"
+			"F8FCC8F704C01D207AA52E5FABF41AB06C445E4658589181E915A0F6"
+			"AB11450EE6BD6A98E90D299E7A8467C61DF0F92F5E6E9BEF789FB2C0"
+			"AD68C85CF04AD3CA2D274823C96F3C5297CD7E874816F9822D895112"
+			"B6AD8AB32F90CF1405E17CEBAD314101AAC2D56EF81218434788DEB1"
+			"509BD18BDAB7E09148C8FE486918A2E4139F963A",
+			"4C41BAAEE305932098A2947FDCEAFC82",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"0B60F2ECCBFD7BB0F81C39CF47B7F0AD9B3460DE59267304117FDA99"
+			"AA13067501EE90A6E90E31169EA8DED9D20B79E1D99C8408924F1BBF"
+			"716BE2C7443438B11A32B9FB6B9E33D406F1F19F1E60402B3977508A"
+			"E7AA35E36FF8FEB3E691683474EA7680581B2E8606A7ADEC257B7E37"
+			"FA0FE95AEB15C6DD4C4DE7BC8D1825F84DB7263DB5A708956AFC4A5E"
+			"D965D743E9337E591612D5D21D9A16DC10ABB283AA987BA70E0D962F"
+			"85E520B2EE029D9F62C7331DBE5F1289D99075EB3EA233DFEC283E0D"
+			"4FF5C8C92E88FED77374598BDCF6D85F4E09BA909B49CDA08B78E0BD"
+			"416B1F22C0B93BB801C7D9830AA577344A6A1942AC2EF87D2327BB6F"
+			"178FB6A511C009AAD5EC81776ED882AC318C683EB0D7E19ED3AA2564"
+			"CE1EE561673A8958D80EB586DD4D3C5ACF2F25851E195045F5FDAB94"
+			"D00623761C9069DFF4AAFBD12EF2B6B145CA63673F51E12D62CC4E3F"
+			"410E5970AA919DB832A0F584E8C49C6B11399DD3021E87FC4DA15F73"
+			"D9A46336E0522B3FCD73D5928A86F666EF009421",
+			"D0BD5C0DD8BBCF3B689A64FD6F8BDF51FCCBA8A8ED8A169F7EF4934A"
+			"387E9DC7",
+			"630BD2931F6DB5E4FF91027122FE8261DCB5C9F07DD3AA4CE6764FED"
+			"20C43905E9B58E0AC017F961798C6544ECA16E738BF937C0E3FBCD0F"
+			"32EF37BC13046EA8BE61282A8D9EBB4198C0D337125080C352FC1DF0"
+			"62E40913F74B6FCC3ACD88C5E8B962210949C641E9D054206F936F91"
+			"350C776404ED90C389CDA17DF28F309A608A5F3FC6278DEC20E7E824"
+			"AEAF10F0ED4666F22BBDF482022387642A15023732E0C3FB262E3EFC"
+			"2583F5AA2D93CE951189475ACC4E4342CF169AD0E2BF655BD1031928"
+			"5B81C1AB22582C21C078A7775427F2C11298948B4E539F6CBE520A3D"
+			"C87655E53D2A142193E19E049676085419DC0E1F8E78381E0108DC36"
+			"772111E965B554C2160FCC5FC212A5DB0A483FB3CBC5B4A30580E7C0"
+			"9A3561BCF02B5230E065042F187891B53A27ECB8392CB10A0B4DEF4F"
+			"4F86AACBACBF535C64CA9281764FFAA1F74CF8E0E051421ACA37251F"
+			"A6DDCB2D0637382551840A8A70651FF0F3E8F538E5841B15C21075EF"
+			"6D66BC368EFE926630347664885D569157439358",
+			"89C1E4F97DF1172CC3A256584004DC76",
+			"VdxCtWi+JyhMO6xzZsLqx4ltW7LYmL4M1YaQf+XEOg4="
+		},
+		{
+			"S with the high bit",
+			"609DC1133FA2F7709E762FEABF1132048E160ECB2C6520749E99BB2F"
+			"F316A6CF",
+			"C8AF97BCD092EA169A778EB6CBCD8441E46E095A01587D393CC3AF80"
+			"9985BAC1FD5AE97621CC73A1E5BA0159E109F2E028D9DDA126651BEE"
+			"CBA18D0E8221959C21E43E05D8458A7C875AE7BC66293B85F5B6A496"
+			"2C03A2EF1C3466F7115CF5C3C437E05C65413E35441A8119559F2CB4"
+			"CFFB3F6382FD0BEE130D6D8FE4C8AE678772754CCEBE644005589CB8"
+			"3BDB9BFE1772702DB15EEBC075D12ECE3FB8908A290042BC53EC70C2"
+			"67A9BF00324B48E408050AB47BEDDF6E20D488718672EBC67EA02E72"
+			"EC916BCE342016CD6834211423639038971858E69193AC6462FE3F8A"
+			"A169C545241D9B0024D0C5CA988B58956C6831AB94250DBD2D34146A"
+			"FF23F1347BBD495ED0AF715024DD352214E0526A8A88C6713344E8A2"
+			"2ADC2C159324F60A23637449EC74344F7730A1C2C8F5FB6EAE8E45FD"
+			"23A3CC4A57FD625E53550C2729D4F9AA8A2431AEEC48E3A562D7AB7F"
+			"9CB77FFC3DB8DB44B45AFF58682D3545DF42C411B9E7A3995C58AF7D"
+			"75D6291FCE6A49AE64332EA79DB5B9F1EEDCE99B",
+			"02F594A81C80A06E9F9EAEF49D60DC25",
+			"us-east-1_Pool1",
+			"user",
+			"pw",
+			"c2VjcmV0",
+			"Mon Jan 1 00:00:00 UTC 2024",
+			"A89E74EAF378452B29A1CF4D885E0B58C534E942C4989C2BAD341714"
+			"58C75ECE774B0D3FD0BA0A3A5A679B1336B282D3F9A666E867DE9275"
+			"B179DA9A764EBAB2AA34E8AD63043F2594BE5397B62D8358F88100B5"
+			"12EC16B16EC0889B3CEE4343CA492963C1FDD9DAA3F30438A20E512F"
+			"7DFC7F85979A4B3675E0060470CE44CA27F5B3079A6D45A33B689FFB"
+			"100E419B92D87FF7EA93C5A9738FC3C94457A8702F6DACF2E89A7CC6"
+			"C9439F6DFA9CF442761E1D15E7E954DC85AA53C4D1E071E5ED522F7D"
+			"5E73D6ED58967AEDA11F47928C880C136F944D99BDF4711083A90DAD"
+			"05C8FF8647640A12E3BB39D43AD524350B6BED507C4B3E7888CF13F0"
+			"2FB1988655A37E0914870283C10FD4CA989904A89C0C5B20661477B8"
+			"759B30CFE80D9F9B66E7CB7C0DDA3CE0AE0AEFAFFDD29B19AE95A4B8"
+			"394ADD44B67C18B10EA84956C47074433038DEC45F9B60373F579E3D"
+			"834CF99AA9F050C4BFF04153086C571568714220FBFAD92C09D006DD"
+			"F291337FE4F00492D5F27BFD0ED29B66849FCF05",
+			"3DE1E87BBC92391C6A607C2EE8E3EB63A26C7FD4C57559B97992C2DA"
+			"3ED3B57D",
+			"FEA26AF1F853357AF6D08BA94014918E87146D34F6A99613139D45EB"
+			"62C1776E13904BA5DC65C7A412659A97D949BC7BB72F793DAB63A113"
+			"9974940B9CE0652DB063BC59F859EA9B512ED6ACAAA4C08EA996FB20"
+			"5B0B2495AE1F3F9815E6649DFA43275FBE6C980CFCE94420852035DA"
+			"A24020019A049CDC4710C2A7D59E49BCDA455A1362D43D2F62454F22"
+			"B7AFB9A711362F9E0F76C16A20A073027ED685E044272ED605CB8C31"
+			"D7D41B330F2399856A6FDE7682FAD9EB4CA18BDF93BFC19D11C2C532"
+			"B4444F47553961DC27867D6DF2D38CF6A1891E82D09F16BC958BF0DD"
+			"644B8DF59861542C5B9557046471F12C8005A98738CBF50706F8D339"
+			"C0C34C9253149AA8A2BADA92EB22CFC249E666DF5BC2AE8E77EFBE65"
+			"F4155C2EDFDCEA7E24EABC283131F66BDB39D25E5F2E4EF8FFEB53F6"
+			"A13458F707E71E7FBF0F54EBE24AA72C20D6B83EB6A791DFA59A6317"
+			"7E4E1B1B1C2D5B6BFBB8471DDC0EA200FF49B6CF3D959DA8038C1283"
+			"51321E27D65DCE1B6960616DB72F483932640CBE",
+			"E407129FBAEAA26856B81DFB86860783",
+			"1Hv2UM7mhliWdZEgJDxiZY33qoDx0hQ1HxdEGKcAGRM="
+		},
+	};
+
+} // namespace awsx
+
+
+#endif
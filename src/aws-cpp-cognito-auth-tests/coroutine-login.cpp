@@ -0,0 +1,339 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Runs CoAuthenticate() and CoAuthenticateWithUserPool() through the Http
+// transport against CognitoStandIn, as deadline-and-hedging and
+// device-login do for the blocking logins: the login deadline, retries
+// within it, hedged identity calls and remembered, new and stale devices.
+// Needs C++20.
+
+#include <chrono>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "../../include/aws-cpp-cognito-auth/Coroutine.hpp"
+#include "../../include/aws-cpp-cognito-auth/Device.hpp"
+
+#include "CognitoStandIn.hpp"
+
+
+using namespace awsx;
+
+
+static int s_failures = 0;
+
+static void Expect( bool condition, const std::string & what )
+{
+	if ( !condition ) {
+		std::cerr << "FAILED: " << what << std::endl;
+		++s_failures;
+	}
+}
+
+// A store whose Forget() does nothing.
+class StickyDeviceKeyStore : public MemoryDeviceKeyStore {
+public:
+	void Forget( const std::string & userPoolId,
+		const std::string & username ) override
+	{
+	}
+};
+
+static CognitoAuthOptions StandInOptions( const CognitoStandIn & standIn )
+{
+	CognitoAuthOptions options;
+	options.transport = TransportKind::Http;
+	options.endpointOverride = standIn.Endpoint();
+
+	return options;
+}
+
+static DeviceCredentials Device( const std::string & deviceKey )
+{
+	DeviceCredentials device;
+	device.deviceKey = deviceKey;
+	device.deviceGroupKey = "stand-in-group";
+	device.devicePassword = "device-password";
+
+	return device;
+}
+
+static long long Since( std::chrono::steady_clock::time_point start )
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - start )
+		.count();
+}
+
+static std::string Times( const CognitoStandIn & standIn, const char * op )
+{
+	return std::string( op ) + " sent "
+		+ std::to_string( standIn.Count( op ) ) + " times";
+}
+
+// Runs the task to its end; the error, if any, is rethrown by get().
+template <typename T>
+static T Run( Task<T> task )
+{
+	auto promise = std::make_shared<std::promise<T>>();
+	auto future = promise->get_future();
+
+	Spawn<T>( std::move( task ),
+		[promise]( std::exception_ptr error, T * result ) {
+			if ( error ) {
+				promise->set_exception( error );
+			}
+			else {
+				promise->set_value( std::move( *result ) );
+			}
+		} );
+
+	return future.get();
+}
+
+// ", got <what>" of the exception the task ended with.
+template <typename T>
+static std::string Fails( Task<T> task )
+{
+	try {
+		Run( std::move( task ) );
+	}
+	catch ( const std::exception & e ) {
+		return e.what();
+	}
+
+	return std::string();
+}
+
+static void TestLogin( Executor & cpu )
+{
+	CognitoStandIn standIn;
+
+	{
+		CognitoAuth auth( "us-east-1", "client", StandInOptions( standIn ) );
+
+		auto tokens = Run( CoAuthenticateWithUserPool(
+			auth, cpu, "user", "password", "pool" ) );
+
+		Expect( tokens.GetIdToken() == "id", "login: id token" );
+
+		auto credentials = Run( CoAuthenticate(
+			auth, cpu, "user", "password", "pool", "identity" ) );
+
+		Expect( credentials.GetAWSAccessKeyId() == "ASIASTANDIN",
+			"login: credentials of the stand-in" );
+	}
+
+	Expect( standIn.Count( "InitiateAuth" ) == 2,
+		"login: " + Times( standIn, "InitiateAuth" ) );
+}
+
+// InitiateAuth answers after 3 s, the login has 300 ms.
+static void TestDeadline( Executor & cpu )
+{
+	CognitoStandIn standIn;
+	standIn.SetDelay( "InitiateAuth", std::chrono::milliseconds( 3000 ) );
+
+	auto options = StandInOptions( standIn );
+	options.loginTimeout = std::chrono::milliseconds( 300 );
+
+	{
+		CognitoAuth auth( "us-east-1", "client", options );
+
+		auto start = std::chrono::steady_clock::now();
+		bool timedOut = false;
+
+		try {
+			Run( CoAuthenticateWithUserPool(
+				auth, cpu, "user", "password", "pool" ) );
+		}
+		catch ( const TimeoutException & ) {
+			timedOut = true;
+		}
+		catch ( const std::exception & e ) {
+			Expect( false,
+				std::string( "deadline: unexpected error " ) + e.what() );
+		}
+
+		auto elapsed = Since( start );
+
+		Expect( timedOut, "deadline: TimeoutException" );
+		Expect( elapsed < 1000,
+			"deadline: failed after " + std::to_string( elapsed ) + " ms" );
+
+		// a resent InitiateAuth would arrive meanwhile
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1000 ) );
+	}
+
+	Expect( standIn.Count( "InitiateAuth" ) == 1,
+		"deadline: " + Times( standIn, "InitiateAuth" ) );
+	Expect( standIn.Count( "RespondToAuthChallenge" ) == 0,
+		"deadline: no RespondToAuthChallenge after the deadline" );
+}
+
+// GetId fails twice with a retryable error; the login resends it within
+// its deadline.
+static void TestRetryWithinDeadline( Executor & cpu )
+{
+	CognitoStandIn standIn;
+	standIn.SetFailures( "GetId", 2 );
+
+	auto options = StandInOptions( standIn );
+	options.loginTimeout = std::chrono::milliseconds( 2000 );
+
+	{
+		CognitoAuth auth( "us-east-1", "client", options );
+
+		auto error = Fails( CoAuthenticate(
+			auth, cpu, "user", "password", "pool", "identity" ) );
+
+		Expect( error.empty(), "retry: the login succeeds, got " + error );
+	}
+
+	Expect( standIn.Count( "GetId" ) == 3,
+		"retry: " + Times( standIn, "GetId" ) );
+}
+
+// The first GetCredentialsForIdentity answers after 2 s, the hedge after
+// 200 ms wins; the user pool calls are not hedged.
+static void TestHedging( Executor & cpu )
+{
+	CognitoStandIn standIn;
+	standIn.SetDelay( "GetCredentialsForIdentity",
+		std::chrono::milliseconds( 2000 ),
+		1 );
+	standIn.SetDelay(
+		"RespondToAuthChallenge", std::chrono::milliseconds( 400 ) );
+
+	auto options = StandInOptions( standIn );
+	options.loginTimeout = std::chrono::milliseconds( 5000 );
+	options.hedging.enabled = true;
+	options.hedging.minDelay = std::chrono::milliseconds( 200 );
+
+	{
+		CognitoAuth auth( "us-east-1", "client", options );
+
+		auto start = std::chrono::steady_clock::now();
+		auto error = Fails( CoAuthenticate(
+			auth, cpu, "user", "password", "pool", "identity" ) );
+		auto elapsed = Since( start );
+
+		Expect( error.empty(), "hedging: the login succeeds, got " + error );
+		Expect( elapsed < 1900,
+			"hedging: took " + std::to_string( elapsed ) + " ms" );
+	}
+
+	Expect( standIn.Count( "GetCredentialsForIdentity" ) == 2,
+		"hedging: " + Times( standIn, "GetCredentialsForIdentity" ) );
+	Expect( standIn.Count( "GetId" ) == 1,
+		"hedging: " + Times( standIn, "GetId" ) );
+	Expect( standIn.Count( "RespondToAuthChallenge" ) == 1,
+		"hedging: " + Times( standIn, "RespondToAuthChallenge" ) );
+}
+
+// A remembered device answers DEVICE_SRP_AUTH; a new one is confirmed and
+// stored.
+static void TestDevices( Executor & cpu )
+{
+	CognitoStandIn standIn;
+	standIn.SetDevice( "stand-in-device" );
+	standIn.SetNewDevice( "new-device" );
+
+	auto store = std::make_shared<MemoryDeviceKeyStore>();
+	store->Save( "pool", "user", Device( "stand-in-device" ) );
+
+	auto options = StandInOptions( standIn );
+	options.loginTimeout = std::chrono::milliseconds( 5000 );
+	options.deviceKeyStore = store;
+
+	{
+		CognitoAuth auth( "us-east-1", "client", options );
+
+		auto error = Fails( CoAuthenticateWithUserPool(
+			auth, cpu, "user", "password", "pool" ) );
+
+		Expect( error.empty(), "device: the login succeeds, got " + error );
+	}
+
+	Expect( standIn.Count( "RespondToAuthChallenge" ) == 3,
+		"device: " + Times( standIn, "RespondToAuthChallenge" ) );
+	Expect( standIn.Count( "ConfirmDevice" ) == 1,
+		"device: " + Times( standIn, "ConfirmDevice" ) );
+
+	DeviceCredentials device;
+
+	Expect( store->Load( "pool", "user", device )
+			&& device.deviceKey == "new-device",
+		"device: the new device is remembered" );
+}
+
+// The pool does not know the stored device and the store never forgets
+// it: the login starts over once without the device.
+static void TestStaleDevice( Executor & cpu )
+{
+	CognitoStandIn standIn;
+
+	auto store = std::make_shared<StickyDeviceKeyStore>();
+	store->Save( "pool", "user", Device( "stale-device" ) );
+
+	auto options = StandInOptions( standIn );
+	options.deviceKeyStore = store;
+
+	{
+		CognitoAuth auth( "us-east-1", "client", options );
+
+		auto error = Fails( CoAuthenticateWithUserPool(
+			auth, cpu, "user", "password", "pool" ) );
+
+		Expect( error.empty(), "stale: the login succeeds, got " + error );
+	}
+
+	Expect( standIn.Count( "InitiateAuth" ) == 2,
+		"stale: " + Times( standIn, "InitiateAuth" ) );
+}
+
+
+int main( int argc, char * argv[] )
+{
+	CpuExecutorOptions cpuOptions;
+	cpuOptions.threads = 2;
+
+	CpuExecutor cpu( cpuOptions );
+
+	TestLogin( cpu );
+	TestDeadline( cpu );
+	TestRetryWithinDeadline( cpu );
+	TestHedging( cpu );
+	TestDevices( cpu );
+	TestStaleDevice( cpu );
+
+	std::cout << "coroutine login: " << s_failures << " failures"
+			  << std::endl;
+
+	return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,256 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Runs logins through the Http transport against CognitoStandIn with
+// injected latency and failures: the login deadline must cut a slow
+// InitiateAuth short without resending it, an abandoned call must not be
+// retried behind the login's back while failures within the budget are,
+// hedging must answer a slow GetCredentialsForIdentity from a second
+// request, and the stateful user pool calls must never be hedged.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "../../include/aws-cpp-cognito-auth/Auth.hpp"
+
+#include "CognitoStandIn.hpp"
+
+
+using namespace awsx;
+
+
+static int s_failures = 0;
+
+static void Expect( bool condition, const std::string & what )
+{
+	if ( !condition ) {
+		std::cerr << "FAILED: " << what << std::endl;
+		++s_failures;
+	}
+}
+
+static CognitoAuthOptions StandInOptions( const CognitoStandIn & standIn )
+{
+	CognitoAuthOptions options;
+	options.transport = TransportKind::Http;
+	options.endpointOverride = standIn.Endpoint();
+
+	return options;
+}
+
+// ", got <error>" for a failed result.
+template <typename T>
+static std::string Why( const AuthResult<T> & result )
+{
+	return result ? std::string() : ", got " + result.Error().GetMessage();
+}
+
+static long long Since( std::chrono::steady_clock::time_point start )
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - start )
+		.count();
+}
+
+// InitiateAuth answers after 3 s, the login has 300 ms.
+static void TestDeadline()
+{
+	CognitoStandIn standIn;
+	standIn.SetDelay( "InitiateAuth", std::chrono::milliseconds( 3000 ) );
+
+	auto options = StandInOptions( standIn );
+	options.loginTimeout = std::chrono::milliseconds( 300 );
+
+	{
+		CognitoAuth auth( "us-east-1", "client", options );
+
+		auto start = std::chrono::steady_clock::now();
+		auto tokens
+			= auth.TryAuthenticateWithUserPool( "user", "password", "pool" );
+		auto elapsed = Since( start );
+
+		Expect( !tokens, "deadline: the login fails" );
+		Expect( tokens.Error().GetCode() == AuthErrorCode::Timeout
+				|| tokens.Error().GetCode() == AuthErrorCode::Network,
+			"deadline: timeout or network error, got "
+				+ tokens.Error().GetMessage() );
+		Expect( elapsed < 1000,
+			"deadline: failed after " + std::to_string( elapsed ) + " ms" );
+
+		// a resent InitiateAuth would arrive meanwhile
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1000 ) );
+	}
+
+	Expect( standIn.Count( "InitiateAuth" ) == 1,
+		"deadline: InitiateAuth sent "
+			+ std::to_string( standIn.Count( "InitiateAuth" ) ) + " times" );
+	Expect( standIn.Count( "RespondToAuthChallenge" ) == 0,
+		"deadline: no RespondToAuthChallenge after the deadline" );
+}
+
+// GetCredentialsForIdentity answers after 1 s, past the deadline; nothing
+// may resend it once the login gave up.
+static void TestAbandonedNotRetried()
+{
+	CognitoStandIn standIn;
+	standIn.SetDelay(
+		"GetCredentialsForIdentity", std::chrono::milliseconds( 1000 ) );
+
+	auto options = StandInOptions( standIn );
+	options.loginTimeout = std::chrono::milliseconds( 400 );
+
+	{
+		CognitoAuth auth( "us-east-1", "client", options );
+
+		auto credentials
+			= auth.TryAuthenticate( "user", "password", "pool", "identity" );
+
+		Expect( !credentials, "abandoned: the login fails" );
+
+		// the transport's own retries would arrive meanwhile
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1500 ) );
+	}
+
+	Expect( standIn.Count( "GetCredentialsForIdentity" ) == 1,
+		"abandoned: GetCredentialsForIdentity sent "
+			+ std::to_string( standIn.Count( "GetCredentialsForIdentity" ) )
+			+ " times" );
+}
+
+// GetId fails twice with a retryable error; the login resends it within
+// its deadline.
+static void TestRetryWithinDeadline()
+{
+	CognitoStandIn standIn;
+	standIn.SetFailures( "GetId", 2 );
+
+	auto options = StandInOptions( standIn );
+	options.loginTimeout = std::chrono::milliseconds( 2000 );
+
+	{
+		CognitoAuth auth( "us-east-1", "client", options );
+
+		auto credentials
+			= auth.TryAuthenticate( "user", "password", "pool", "identity" );
+
+		Expect( static_cast<bool>( credentials ),
+			"retry: the login succeeds" + Why( credentials ) );
+	}
+
+	Expect( standIn.Count( "GetId" ) == 3,
+		"retry: GetId sent " + std::to_string( standIn.Count( "GetId" ) )
+			+ " times" );
+}
+
+// The first GetCredentialsForIdentity answers after 2 s, the hedge after
+// 200 ms wins.
+static void TestHedging()
+{
+	CognitoStandIn standIn;
+	standIn.SetDelay( "GetCredentialsForIdentity",
+		std::chrono::milliseconds( 2000 ),
+		1 );
+
+	auto options = StandInOptions( standIn );
+	options.loginTimeout = std::chrono::milliseconds( 5000 );
+	options.hedging.enabled = true;
+	options.hedging.minDelay = std::chrono::milliseconds( 200 );
+
+	{
+		CognitoAuth auth( "us-east-1", "client", options );
+
+		auto start = std::chrono::steady_clock::now();
+		auto credentials
+			= auth.TryAuthenticate( "user", "password", "pool", "identity" );
+		auto elapsed = Since( start );
+
+		Expect( static_cast<bool>( credentials ),
+			"hedging: the login succeeds" + Why( credentials ) );
+		Expect( credentials
+				&& credentials.Value().GetAWSAccessKeyId() == "ASIASTANDIN",
+			"hedging: credentials of the stand-in" );
+		Expect( elapsed < 1500,
+			"hedging: took " + std::to_string( elapsed ) + " ms" );
+	}
+
+	Expect( standIn.Count( "GetCredentialsForIdentity" ) == 2,
+		"hedging: GetCredentialsForIdentity sent "
+			+ std::to_string( standIn.Count( "GetCredentialsForIdentity" ) )
+			+ " times" );
+	Expect( standIn.Count( "GetId" ) == 1, "hedging: one GetId" );
+	Expect( standIn.Count( "InitiateAuth" ) == 1, "hedging: one InitiateAuth" );
+	Expect( standIn.Count( "RespondToAuthChallenge" ) == 1,
+		"hedging: one RespondToAuthChallenge" );
+}
+
+// Slow InitiateAuth and RespondToAuthChallenge are waited for, not hedged.
+static void TestStatefulNotHedged()
+{
+	CognitoStandIn standIn;
+	standIn.SetDelay( "InitiateAuth", std::chrono::milliseconds( 400 ) );
+	standIn.SetDelay(
+		"RespondToAuthChallenge", std::chrono::milliseconds( 400 ) );
+
+	auto options = StandInOptions( standIn );
+	options.loginTimeout = std::chrono::milliseconds( 5000 );
+	options.hedging.enabled = true;
+	options.hedging.minDelay = std::chrono::milliseconds( 200 );
+
+	{
+		CognitoAuth auth( "us-east-1", "client", options );
+
+		auto credentials
+			= auth.TryAuthenticate( "user", "password", "pool", "identity" );
+
+		Expect( static_cast<bool>( credentials ),
+			"stateful: the login succeeds" + Why( credentials ) );
+	}
+
+	Expect( standIn.Count( "InitiateAuth" ) == 1,
+		"stateful: InitiateAuth sent "
+			+ std::to_string( standIn.Count( "InitiateAuth" ) ) + " times" );
+	Expect( standIn.Count( "RespondToAuthChallenge" ) == 1,
+		"stateful: RespondToAuthChallenge sent "
+			+ std::to_string( standIn.Count( "RespondToAuthChallenge" ) )
+			+ " times" );
+	Expect( standIn.Count( "GetCredentialsForIdentity" ) == 1,
+		"stateful: one GetCredentialsForIdentity" );
+}
+
+
+int main( int argc, char * argv[] )
+{
+	TestDeadline();
+	TestAbandonedNotRetried();
+	TestRetryWithinDeadline();
+	TestHedging();
+	TestStatefulNotHedged();
+
+	std::cout << "deadline and hedging: " << s_failures << " failures"
+			  << std::endl;
+
+	return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,253 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Runs device logins through the Http transport against CognitoStandIn: a
+// remembered device answers DEVICE_SRP_AUTH, a new one is remembered, a
+// stale one restarts the login exactly once, and a device the pool forgot
+// in the middle of an MFA login surfaces as DeviceForgottenException.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "../../include/aws-cpp-cognito-auth/Auth.hpp"
+#include "../../include/aws-cpp-cognito-auth/Device.hpp"
+#include "../../include/aws-cpp-cognito-auth/Exception.hpp"
+
+#include "CognitoStandIn.hpp"
+
+
+using namespace awsx;
+
+
+static int s_failures = 0;
+
+static void Expect( bool condition, const std::string & what )
+{
+	if ( !condition ) {
+		std::cerr << "FAILED: " << what << std::endl;
+		++s_failures;
+	}
+}
+
+// A store whose Forget() does nothing, as one shared by processes that
+// keep writing the old key back.
+class StickyDeviceKeyStore : public MemoryDeviceKeyStore {
+public:
+	void Forget( const std::string & userPoolId,
+		const std::string & username ) override
+	{
+	}
+};
+
+static CognitoAuthOptions StandInOptions( const CognitoStandIn & standIn,
+	const std::shared_ptr<DeviceKeyStore> & store )
+{
+	CognitoAuthOptions options;
+	options.transport = TransportKind::Http;
+	options.endpointOverride = standIn.Endpoint();
+	options.deviceKeyStore = store;
+	options.loginTimeout = std::chrono::milliseconds( 5000 );
+
+	return options;
+}
+
+static DeviceCredentials Device( const std::string & deviceKey )
+{
+	DeviceCredentials device;
+	device.deviceKey = deviceKey;
+	device.deviceGroupKey = "stand-in-group";
+	device.devicePassword = "device-password";
+
+	return device;
+}
+
+template <typename T>
+static std::string Why( const AuthResult<T> & result )
+{
+	return result ? std::string() : ", got " + result.Error().GetMessage();
+}
+
+static std::string Times( const CognitoStandIn & standIn, const char * op )
+{
+	return std::string( op ) + " sent "
+		+ std::to_string( standIn.Count( op ) ) + " times";
+}
+
+// The pool knows the stored device: PASSWORD_VERIFIER, DEVICE_SRP_AUTH and
+// DEVICE_PASSWORD_VERIFIER.
+static void TestRememberedDevice()
+{
+	CognitoStandIn standIn;
+	standIn.SetDevice( "stand-in-device" );
+
+	auto store = std::make_shared<MemoryDeviceKeyStore>();
+	store->Save( "pool", "user", Device( "stand-in-device" ) );
+
+	{
+		CognitoAuth auth(
+			"us-east-1", "client", StandInOptions( standIn, store ) );
+
+		auto tokens
+			= auth.TryAuthenticateWithUserPool( "user", "password", "pool" );
+
+		Expect( static_cast<bool>( tokens ),
+			"remembered: the login succeeds" + Why( tokens ) );
+	}
+
+	Expect( standIn.Count( "InitiateAuth" ) == 1,
+		"remembered: " + Times( standIn, "InitiateAuth" ) );
+	Expect( standIn.Count( "RespondToAuthChallenge" ) == 3,
+		"remembered: " + Times( standIn, "RespondToAuthChallenge" ) );
+}
+
+// Tokens with NewDeviceMetadata: the device is confirmed and stored.
+static void TestNewDevice()
+{
+	CognitoStandIn standIn;
+	standIn.SetNewDevice( "new-device" );
+
+	auto store = std::make_shared<MemoryDeviceKeyStore>();
+
+	{
+		CognitoAuth auth(
+			"us-east-1", "client", StandInOptions( standIn, store ) );
+
+		auto tokens
+			= auth.TryAuthenticateWithUserPool( "user", "password", "pool" );
+
+		Expect( static_cast<bool>( tokens ),
+			"new device: the login succeeds" + Why( tokens ) );
+	}
+
+	DeviceCredentials device;
+
+	Expect( store->Load( "pool", "user", device )
+			&& device.deviceKey == "new-device"
+			&& !device.devicePassword.empty(),
+		"new device: remembered" );
+	Expect( standIn.Count( "ConfirmDevice" ) == 1,
+		"new device: " + Times( standIn, "ConfirmDevice" ) );
+}
+
+// The pool does not know the stored device and the store never forgets
+// it: the login starts over once without the device instead of looping.
+static void TestStaleDeviceRetriedOnce()
+{
+	CognitoStandIn standIn;
+
+	auto store = std::make_shared<StickyDeviceKeyStore>();
+	store->Save( "pool", "user", Device( "stale-device" ) );
+
+	{
+		CognitoAuth auth(
+			"us-east-1", "client", StandInOptions( standIn, store ) );
+
+		auto tokens
+			= auth.TryAuthenticateWithUserPool( "user", "password", "pool" );
+
+		Expect( static_cast<bool>( tokens ),
+			"stale: the login succeeds" + Why( tokens ) );
+	}
+
+	Expect( standIn.Count( "InitiateAuth" ) == 2,
+		"stale: " + Times( standIn, "InitiateAuth" ) );
+}
+
+// The device is forgotten by the pool while the user types the MFA code;
+// DEVICE_SRP_AUTH then fails and the caller is told to start over.
+static void TestForgottenAfterMfa()
+{
+	CognitoStandIn standIn;
+	standIn.SetDevice( "stand-in-device" );
+	standIn.SetMfa( true, true );
+
+	auto store = std::make_shared<MemoryDeviceKeyStore>();
+	store->Save( "pool", "user", Device( "stand-in-device" ) );
+
+	CognitoAuth auth(
+		"us-east-1", "client", StandInOptions( standIn, store ) );
+
+	auto session = auth.TryBeginAuthentication( "user", "password", "pool" );
+
+	Expect( session && session.Value().GetChallengeName()
+			== "SOFTWARE_TOKEN_MFA",
+		"forgotten: MFA challenge" + Why( session ) );
+
+	if ( !session ) {
+		return;
+	}
+
+	standIn.SetDevice( "" );
+
+	auto pending = session.Value();
+	bool thrown = false;
+
+	try {
+		auth.RespondWithMfaCode( pending, "123456" );
+	}
+	catch ( const DeviceForgottenException & ) {
+		thrown = true;
+	}
+	catch ( const std::exception & e ) {
+		Expect( false,
+			std::string( "forgotten: unexpected error " ) + e.what() );
+	}
+
+	DeviceCredentials device;
+
+	Expect( thrown, "forgotten: DeviceForgottenException" );
+	Expect( !store->Load( "pool", "user", device ),
+		"forgotten: dropped from the store" );
+
+	// the restart goes without the device
+	standIn.SetMfa( true );
+
+	auto restarted
+		= auth.TryBeginAuthentication( "user", "password", "pool" );
+
+	Expect( static_cast<bool>( restarted ),
+		"forgotten: the restart begins" + Why( restarted ) );
+
+	if ( restarted ) {
+		auto again = restarted.Value();
+		auth.RespondWithMfaCode( again, "123456" );
+
+		Expect( again.IsAuthenticated(), "forgotten: the restart succeeds" );
+	}
+}
+
+
+int main( int argc, char * argv[] )
+{
+	TestRememberedDevice();
+	TestNewDevice();
+	TestStaleDeviceRetriedOnce();
+	TestForgottenAfterMfa();
+
+	std::cout << "device login: " << s_failures << " failures" << std::endl;
+
+	return s_failures == 0 ? 0 : 1;
+}
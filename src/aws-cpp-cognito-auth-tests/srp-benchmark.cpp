@@ -0,0 +1,116 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Times the client side of an SRP login, A plus PASSWORD_CLAIM_SIGNATURE,
+// and fails when it is slower than the given number of ns per claim:
+//
+//   srp-benchmark [max ns/claim] [claims per round]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "include/Helpers.hpp"
+#include "include/Srp.hpp"
+
+#include "SrpCorpus.hpp"
+
+
+using namespace awsx;
+
+
+int main( int argc, char * argv[] )
+{
+	double maxNs = argc > 1 ? atof( argv[1] ) : 0.0;
+	int claims = argc > 2 ? atoi( argv[2] ) : 100;
+
+	// a login against a real pool: full size B and salt
+	const SrpKnownAnswer * answer = nullptr;
+
+	for ( const auto & candidate : s_srpCorpus ) {
+		if ( strcmp( candidate.name, "full size B" ) == 0 ) {
+			answer = &candidate;
+		}
+	}
+
+	if ( answer == nullptr || claims <= 0 ) {
+		std::cerr << "usage: srp-benchmark [max ns/claim] [claims per round]"
+				  << std::endl;
+
+		return 2;
+	}
+
+	std::vector<uint8_t> a;
+	Helpers::HexToBinary( a, answer->a );
+
+	auto random = [&a]( uint8_t * data, size_t size ) {
+		memcpy( data, a.data(), std::min( size, a.size() ) );
+	};
+
+	Srp::Prepare();
+
+	// the best of a few rounds, so a busy machine does not fail the gate
+	double best = 0.0;
+
+	for ( int round = 0; round < 5; round++ ) {
+		auto start = std::chrono::steady_clock::now();
+
+		for ( int i = 0; i < claims; i++ ) {
+			std::string claim = Srp( random ).GeneratePasswordClaim(
+				answer->userPoolId,
+				answer->username,
+				answer->password,
+				answer->salt,
+				answer->B,
+				answer->secretBlock,
+				answer->timestamp );
+
+			if ( claim != answer->claim ) {
+				std::cerr << "wrong claim " << claim << std::endl;
+
+				return 1;
+			}
+		}
+
+		double ns = std::chrono::duration<double, std::nano>(
+						std::chrono::steady_clock::now() - start )
+						.count()
+			/ claims;
+
+		best = round == 0 ? ns : std::min( best, ns );
+	}
+
+	std::cout << static_cast<long long>( best ) << " ns/claim";
+
+	if ( maxNs > 0.0 ) {
+		std::cout << " (limit " << static_cast<long long>( maxNs ) << ")";
+	}
+
+	std::cout << std::endl;
+
+	return maxNs > 0.0 && best > maxNs ? 1 : 0;
+}
@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+#
+# Regenerates SrpCorpus.hpp, the known answers of srp-known-answers, with a
+# plain Python implementation of the Cognito SRP flow that shares no code
+# with the library:
+#
+#   python3 srp-corpus.py > SrpCorpus.hpp
+#
+
+import base64
+import hashlib
+import hmac
+
+N = int(
+    "FFFFFFFFFFFFFFFFC90FDAA22168C234C4C6628B80DC1CD1"
+    "29024E088A67CC74020BBEA63B139B22514A08798E3404DD"
+    "EF9519B3CD3A431B302B0A6DF25F14374FE1356D6D51C245"
+    "E485B576625E7EC6F44C42E9A637ED6B0BFF5CB6F406B7ED"
+    "EE386BFB5A899FA5AE9F24117C4B1FE649286651ECE45B3D"
+    "C2007CB8A163BF0598DA48361C55D39A69163FA8FD24CF5F"
+    "83655D23DCA3AD961C62F356208552BB9ED529077096966D"
+    "670C354E4ABC9804F1746C08CA18217C32905E462E36CE3B"
+    "E39E772C180E86039B2783A2EC07A28FB5C55DF06F4C52C9"
+    "DE2BCBF6955817183995497CEA956AE515D2261898FA0510"
+    "15728E5A8AAAC42DAD33170D04507A33A85521ABDF1CBA64"
+    "ECFB850458DBEF0A8AEA71575D060C7DB3970F85A6E1E4C7"
+    "ABF5AE8CDB0933D71E8C94E04A25619DCEE3D2261AD2EE6B"
+    "F12FFA06D98A0864D87602733EC86A64521F2B18177B200C"
+    "BBE117577A615D6C770988C0BAD946E208E24FA074E5AB31"
+    "43DB5BFCE0FD108E4B82D120A93AD2CAFFFFFFFFFFFFFFFF", 16)
+g = 2
+
+
+def sha256(data):
+    return hashlib.sha256(data).digest()
+
+
+# the padding of amazon-cognito-identity-js: even length, and a leading 00
+# byte when the value would read as negative
+def pad(hex_):
+    if len(hex_) % 2 == 1:
+        return "0" + hex_
+    if hex_[0] in "89ABCDEFabcdef":
+        return "00" + hex_
+    return hex_
+
+
+def pad_int(n):
+    return pad("%x" % n)
+
+
+# the way OpenSSL's BN_bn2hex prints a value
+def bn_hex(n):
+    hex_ = "%X" % n
+    return "0" + hex_ if len(hex_) % 2 else hex_
+
+
+k = int.from_bytes(sha256(bytes.fromhex(pad_int(N) + pad_int(g))), "big")
+
+LICENSE = """/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */"""
+
+TIMESTAMP = "Mon Jan 1 00:00:00 UTC 2024"
+
+
+def compute(case):
+    a = int(case["a"], 16) % N
+    A = pow(g, a, N)
+    B = int(case["B"], 16)
+    u = int.from_bytes(sha256(bytes.fromhex(pad_int(A) + pad(case["B"]))), "big")
+    identity = hashlib.sha256(
+        (case["pool"] + case["user"] + ":" + case["password"]).encode()
+    ).hexdigest()
+    x = int.from_bytes(
+        sha256(bytes.fromhex(pad(case["salt"]) + identity)), "big")
+    S = pow(B - k * pow(g, x, N), a + u * x, N)
+    prk = hmac.new(bytes.fromhex(pad_int(u)), bytes.fromhex(pad_int(S)),
+                   hashlib.sha256).digest()
+    key = hmac.new(prk, b"Caldera Derived Key\x01",
+                   hashlib.sha256).digest()[:16]
+    message = (case["pool"].encode() + case["user"].encode()
+               + base64.b64decode(case["secretBlock"])
+               + case["timestamp"].encode())
+    claim = base64.b64encode(
+        hmac.new(key, message, hashlib.sha256).digest()).decode()
+    result = dict(A=bn_hex(A), u=bn_hex(u), S=bn_hex(S),
+                  key=key.hex().upper(), claim=claim)
+    return result, (A, u, S)
+
+
+def random_hex(tag, i, size=32):
+    out = b""
+    j = 0
+    while len(out) < size:
+        out += sha256(("%s-%d-%d" % (tag, i, j)).encode())
+        j += 1
+    return out[:size].hex().upper()
+
+
+# B = k * v + g ^ b, as the service computes it
+def server_B(i):
+    b = int(random_hex("b", i), 16)
+    v = int(random_hex("v", i, 384), 16) % N
+    return bn_hex((k * v + pow(g, b, N)) % N)
+
+
+def case(**fields):
+    result = dict(
+        a=bytes((0xF0 + i) & 0xFF for i in range(32)).hex().upper(),
+        B="ABCDEF0123", salt="f234ab", pool="us-east-1_Pool1", user="user",
+        password="pw", secretBlock="c2VjcmV0", timestamp=TIMESTAMP)
+    result.update(fields)
+    return result
+
+
+cases = [
+    ("baseline", case()),
+    ("a with leading zero bytes", case(a="0000" + random_hex("a0", 0, 30))),
+    ("odd length B", case(B="1ABCDEF01")),
+    ("odd length B with a high first digit", case(B="ABCDEF012")),
+    ("odd length salt", case(salt="abc")),
+    ("salt with a leading zero byte", case(salt="00f234ab")),
+    ("salt without the high bit", case(salt="7f34ab")),
+    ("B at least N", case(B=bn_hex(N + 5))),
+    ("empty password and secret block", case(password="", secretBlock="")),
+    ("full size B", case(a=random_hex("a", 1), B=server_B(1),
+                         salt=random_hex("s", 1, 16))),
+]
+
+# values whose padding differs, found by drawing full size cases
+wanted = [
+    ("A with the high bit", lambda A, u, S: A.bit_length() == 3072),
+    ("A without the high bit", lambda A, u, S: 3064 < A.bit_length() < 3072),
+    ("u with a leading zero byte", lambda A, u, S: u.bit_length() <= 248),
+    ("u without the high bit", lambda A, u, S: 248 < u.bit_length() < 256),
+    ("S with a leading zero byte", lambda A, u, S: S.bit_length() <= 3064),
+    ("S without the high bit", lambda A, u, S: 3064 < S.bit_length() < 3072),
+    ("S with the high bit", lambda A, u, S: S.bit_length() == 3072),
+]
+
+for index, (name, condition) in enumerate(wanted):
+    for i in range(100000):
+        draw = i + 1000 * (index + 1)
+        candidate = case(a=random_hex("a", draw), B=server_B(draw),
+                         salt=random_hex("s", draw, 16))
+        if condition(*compute(candidate)[1]):
+            cases.append((name, candidate))
+            break
+    else:
+        raise SystemExit("no case found for " + name)
+
+
+def literal(value, indent="\t\t\t"):
+    if len(value) <= 56:
+        return '"%s"' % value
+    chunks = [value[i:i + 56] for i in range(0, len(value), 56)]
+    return ("\n" + indent).join('"%s"' % chunk for chunk in chunks)
+
+
+print(LICENSE)
+print()
+print("// Generated by srp-corpus.py, do not edit.")
+print()
+print("#ifndef __AWS_CPP_COGNITO_AUTH_SRP_CORPUS_H")
+print("#define __AWS_CPP_COGNITO_AUTH_SRP_CORPUS_H")
+print()
+print()
+print("namespace awsx {")
+print()
+print("\tstruct SrpKnownAnswer {")
+for field in ["name", "a", "B", "salt", "userPoolId", "username",
+              "password", "secretBlock", "timestamp", "A", "u", "S", "key",
+              "claim"]:
+    print("\t\tconst char * %s;" % field)
+print("\t};")
+print()
+print("\tstatic const SrpKnownAnswer s_srpCorpus[] = {")
+for name, fields in cases:
+    result, _ = compute(fields)
+    values = [name, fields["a"], fields["B"], fields["salt"], fields["pool"],
+              fields["user"], fields["password"], fields["secretBlock"],
+              fields["timestamp"], result["A"], result["u"], result["S"],
+              result["key"], result["claim"]]
+    print("\t\t{")
+    print(",\n".join("\t\t\t" + literal(value) for value in values))
+    print("\t\t},")
+print("\t};")
+print()
+print("} // namespace awsx")
+print()
+print()
+print("#endif")
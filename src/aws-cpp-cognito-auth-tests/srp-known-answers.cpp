@@ -0,0 +1,384 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Replays the known answers of SrpCorpus.hpp through Srp with an injected
+// private value and checks A, u, S, the HKDF key and the password claim of
+// each, plus the padding, hex and base64 helpers they rest on.
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "include/Base64.hpp"
+#include "include/Crypt.hpp"
+#include "include/Helpers.hpp"
+#include "include/Srp.hpp"
+
+#include "SrpCorpus.hpp"
+
+
+using namespace awsx;
+
+
+static int s_failures = 0;
+
+static void Expect( bool condition, const std::string & what )
+{
+	if ( !condition ) {
+		std::cerr << "FAILED: " << what << std::endl;
+		++s_failures;
+	}
+}
+
+static void ExpectEqual( const std::string & actual,
+	const std::string & expected,
+	const std::string & what )
+{
+	if ( actual != expected ) {
+		std::cerr << "FAILED: " << what << std::endl
+				  << "  expected " << expected << std::endl
+				  << "  actual   " << actual << std::endl;
+		++s_failures;
+	}
+}
+
+// Exposes the steps of the claim.
+class SrpProbe : public Srp {
+public:
+	explicit SrpProbe( const Random & random )
+		: Srp( random )
+	{
+	}
+
+	std::string U( const std::string & sB ) const
+	{
+		BigNumber u;
+		ComputeU( u, sB );
+
+		return Hex( u );
+	}
+
+	std::string S( const std::string & id,
+		const std::string & salt,
+		const std::string & sB ) const
+	{
+		BigNumber u;
+		ComputeU( u, sB );
+
+		BigNumber S;
+		ComputeS( S, u, id, salt, sB );
+
+		return Hex( S );
+	}
+
+	std::string Key( const std::string & id,
+		const std::string & salt,
+		const std::string & sB )
+	{
+		std::vector<uint8_t> key;
+		GenerateKey( key, id, salt, sB );
+
+		return Helpers::BinaryToHex( key );
+	}
+
+	static std::string Hex( BigNumber & value )
+	{
+		BigNumberString hex;
+		value.toHex( hex );
+
+		return hex.get();
+	}
+};
+
+static std::string Upper( std::string s )
+{
+	for ( auto & c : s ) {
+		c = static_cast<char>( toupper( static_cast<unsigned char>( c ) ) );
+	}
+
+	return s;
+}
+
+static Srp::Random Replay( const std::string & hex )
+{
+	std::vector<uint8_t> bytes;
+	Helpers::HexToBinary( bytes, hex );
+
+	return [bytes]( uint8_t * data, size_t size ) {
+		if ( size != bytes.size() ) {
+			throw std::runtime_error( "unexpected random size" );
+		}
+
+		memcpy( data, bytes.data(), size );
+	};
+}
+
+static void KnownAnswers()
+{
+	for ( const auto & answer : s_srpCorpus ) {
+		std::string name = answer.name;
+		std::string id = std::string( answer.userPoolId ) + answer.username
+			+ ":" + answer.password;
+
+		try {
+			SrpProbe srp( Replay( answer.a ) );
+
+			ExpectEqual( srp.A(), answer.A, name + ": A" );
+			ExpectEqual( srp.U( answer.B ), answer.u, name + ": u" );
+			ExpectEqual( srp.S( id, answer.salt, answer.B ),
+				answer.S,
+				name + ": S" );
+			ExpectEqual( Upper( srp.Key( id, answer.salt, answer.B ) ),
+				answer.key,
+				name + ": key" );
+			ExpectEqual( srp.GeneratePasswordClaim( answer.userPoolId,
+							 answer.username,
+							 answer.password,
+							 answer.salt,
+							 answer.B,
+							 answer.secretBlock,
+							 answer.timestamp ),
+				answer.claim,
+				name + ": PASSWORD_CLAIM_SIGNATURE" );
+		}
+		catch ( const std::exception & e ) {
+			Expect( false, name + ": " + e.what() );
+		}
+	}
+}
+
+static void RejectedB()
+{
+	const auto & answer = s_srpCorpus[0];
+	const char * N = "FFFFFFFFFFFFFFFFC90FDAA22168C234C4C6628B80DC1CD1"
+					 "29024E088A67CC74020BBEA63B139B22514A08798E3404DD"
+					 "EF9519B3CD3A431B302B0A6DF25F14374FE1356D6D51C245"
+					 "E485B576625E7EC6F44C42E9A637ED6B0BFF5CB6F406B7ED"
+					 "EE386BFB5A899FA5AE9F24117C4B1FE649286651ECE45B3D"
+					 "C2007CB8A163BF0598DA48361C55D39A69163FA8FD24CF5F"
+					 "83655D23DCA3AD961C62F356208552BB9ED529077096966D"
+					 "670C354E4ABC9804F1746C08CA18217C32905E462E36CE3B"
+					 "E39E772C180E86039B2783A2EC07A28FB5C55DF06F4C52C9"
+					 "DE2BCBF6955817183995497CEA956AE515D2261898FA0510"
+					 "15728E5A8AAAC42DAD33170D04507A33A85521ABDF1CBA64"
+					 "ECFB850458DBEF0A8AEA71575D060C7DB3970F85A6E1E4C7"
+					 "ABF5AE8CDB0933D71E8C94E04A25619DCEE3D2261AD2EE6B"
+					 "F12FFA06D98A0864D87602733EC86A64521F2B18177B200C"
+					 "BBE117577A615D6C770988C0BAD946E208E24FA074E5AB31"
+					 "43DB5BFCE0FD108E4B82D120A93AD2CAFFFFFFFFFFFFFFFF";
+
+	for ( const std::string & B : { std::string( "0" ),
+			  std::string( "00" ),
+			  std::string( N ),
+			  "0" + std::string( N ) } ) {
+		bool thrown = false;
+
+		try {
+			Srp( Replay( answer.a ) )
+				.GeneratePasswordClaim( answer.userPoolId,
+					answer.username,
+					answer.password,
+					answer.salt,
+					B,
+					answer.secretBlock,
+					answer.timestamp );
+		}
+		catch ( const std::runtime_error & ) {
+			thrown = true;
+		}
+
+		Expect( thrown,
+			"B = " + B.substr( 0, 8 ) + "... (mod N = 0) rejected" );
+	}
+}
+
+static void Padding()
+{
+	ExpectEqual( Helpers::PadLeftZero( "" ), "", "PadLeftZero( \"\" )" );
+	ExpectEqual( Helpers::PadLeftZero( "1" ), "01", "PadLeftZero( 1 )" );
+	ExpectEqual( Helpers::PadLeftZero( "a" ), "0a", "PadLeftZero( a )" );
+	ExpectEqual( Helpers::PadLeftZero( "abc" ), "0abc", "PadLeftZero( abc )" );
+	ExpectEqual( Helpers::PadLeftZero( "7f" ), "7f", "PadLeftZero( 7f )" );
+	ExpectEqual( Helpers::PadLeftZero( "80" ), "0080", "PadLeftZero( 80 )" );
+	ExpectEqual( Helpers::PadLeftZero( "A0" ), "00A0", "PadLeftZero( A0 )" );
+	ExpectEqual(
+		Helpers::PadLeftZero( "0080" ), "0080", "PadLeftZero( 0080 )" );
+
+	typedef std::vector<uint8_t> Bytes;
+
+	Expect( Helpers::PadLeftZero( Bytes() ).empty(), "PadLeftZero( {} )" );
+	Expect( Helpers::PadLeftZero( Bytes{ 0x7f, 0xff } ) == Bytes{ 0x7f, 0xff },
+		"PadLeftZero( { 7f, ff } )" );
+	Expect(
+		Helpers::PadLeftZero( Bytes{ 0x80 } ) == Bytes{ 0x00, 0x80 },
+		"PadLeftZero( { 80 } )" );
+	Expect( Helpers::PadLeftZero( Bytes{ 0x00, 0x80 } ) == Bytes{ 0x00, 0x80 },
+		"PadLeftZero( { 00, 80 } )" );
+
+	Bytes bytes;
+	Helpers::HexToBinary( bytes, "" );
+	Expect( bytes.empty(), "HexToBinary( \"\" )" );
+
+	Helpers::HexToBinary( bytes, "00ff7FaB" );
+	Expect( bytes == Bytes{ 0x00, 0xff, 0x7f, 0xab },
+		"HexToBinary( 00ff7FaB )" );
+	ExpectEqual( Helpers::BinaryToHex( bytes ),
+		"00ff7fab",
+		"BinaryToHex( { 00, ff, 7f, ab } )" );
+	ExpectEqual( Helpers::BinaryToHex( Bytes() ), "", "BinaryToHex( {} )" );
+}
+
+static void Base64Codec()
+{
+	typedef std::vector<uint8_t> Bytes;
+
+	ExpectEqual( Base64().Encode( Bytes() ), "", "Encode( {} )" );
+	ExpectEqual( Base64().Encode( Bytes{ 0 } ), "AA==", "Encode( { 0 } )" );
+	ExpectEqual( Base64().Encode( Bytes{ 0xfb, 0xff } ),
+		"+/8=",
+		"Encode( { fb, ff } )" );
+	ExpectEqual( Base64().Encode( Bytes{ 's', 'r', 'p' } ),
+		"c3Jw",
+		"Encode( srp )" );
+
+	Bytes decoded;
+	Base64().Decode( decoded, "" );
+	Expect( decoded.empty(), "Decode( \"\" )" );
+
+	// across the 64 column line length OpenSSL would otherwise break at
+	for ( size_t size = 0; size < 200; size++ ) {
+		Bytes bytes( size );
+
+		for ( size_t i = 0; i < size; i++ ) {
+			bytes[i] = static_cast<uint8_t>( i * 37 + size );
+		}
+
+		std::string encoded = Base64().Encode( bytes );
+		Base64().Decode( decoded, encoded );
+
+		Expect( encoded.size() == ( size + 2 ) / 3 * 4
+				&& encoded.find( '\n' ) == std::string::npos,
+			"Encode( " + std::to_string( size ) + " bytes ) length" );
+		Expect( decoded == bytes,
+			"Decode( Encode( " + std::to_string( size ) + " bytes ) )" );
+	}
+}
+
+
+// RFC 4231 HMAC-SHA256 test cases 1 to 7, through HmacSha256Key and the
+// one-shot Hmac alike; case 5 is truncated to 128 bits.
+static void HmacVectors()
+{
+	struct {
+		std::string key;
+		std::string message;
+		const char * hmac;
+	} cases[] = {
+		{ std::string( 20, '\x0b' ),
+			"Hi There",
+			"b0344c61d8db38535ca8afceaf0bf12b"
+			"881dc200c9833da726e9376c2e32cff7" },
+		{ "Jefe",
+			"what do ya want for nothing?",
+			"5bdcc146bf60754e6a042426089575c7"
+			"5a003f089d2739839dec58b964ec3843" },
+		{ std::string( 20, '\xaa' ),
+			std::string( 50, '\xdd' ),
+			"773ea91e36800e46854db8ebd09181a7"
+			"2959098b3ef8c122d9635514ced565fe" },
+		{ "\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d"
+		  "\x0e\x0f\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19",
+			std::string( 50, '\xcd' ),
+			"82558a389a443c0ea4cc819899f2083a"
+			"85f0faa3e578f8077a2e3ff46729665b" },
+		{ std::string( 20, '\x0c' ),
+			"Test With Truncation",
+			"a3b6167473100ee06e0c796c2955552b" },
+		{ std::string( 131, '\xaa' ),
+			"Test Using Larger Than Block-Size Key - Hash Key First",
+			"60e431591ee0b67f0d8a26aacbf5b77f"
+			"8e0bc6213728c5140546040f0ee37f54" },
+		{ std::string( 131, '\xaa' ),
+			"This is a test using a larger than block-size key and a larger "
+			"than block-size data. The key needs to be hashed before being "
+			"used by the HMAC algorithm.",
+			"9b09ffa71b942fcb27635fbcd5b0e944"
+			"bfdc63644f0713938a7f51535c3a35e2" }
+	};
+
+	for ( size_t i = 0; i < sizeof( cases ) / sizeof( cases[0] ); i++ ) {
+		std::string name = "RFC 4231 case " + std::to_string( i + 1 );
+		std::string expected = cases[i].hmac;
+
+		HmacSha256Key key( cases[i].key );
+		std::vector<uint8_t> hmac;
+
+		// the second time from the absorbed key
+		for ( int pass = 0; pass < 2; pass++ ) {
+			key.Compute( hmac, cases[i].message );
+
+			ExpectEqual(
+				Helpers::BinaryToHex( hmac ).substr( 0, expected.size() ),
+				expected,
+				name + ": HmacSha256Key" );
+		}
+
+		std::vector<uint8_t> keyBytes(
+			cases[i].key.begin(), cases[i].key.end() );
+		std::vector<uint8_t> message(
+			cases[i].message.begin(), cases[i].message.end() );
+		std::vector<uint8_t> oneShot( hmac.size() );
+		Hmac::ComputeSha256( oneShot, keyBytes, message );
+
+		Expect( oneShot == hmac, name + ": Hmac::ComputeSha256" );
+	}
+
+	// SECRET_HASH of an app client with a secret: Base64( HMAC-SHA256(
+	// client secret, username + client id ) ), as CognitoAuth sends it
+	HmacSha256Key secret(
+		"1example23456789secret0abcdefghijklmnopqrstuvwxyz12" );
+	std::vector<uint8_t> hmac;
+	secret.Compute( hmac, std::string( "user" ) + "7example23456789client" );
+
+	ExpectEqual( Base64().Encode( hmac ),
+		"4hSf6ekCXTcRxNcjias9+s7HxB9HQCx6ApxdwjOphP8=",
+		"SECRET_HASH" );
+}
+
+
+int main()
+{
+	KnownAnswers();
+	RejectedB();
+	Padding();
+	Base64Codec();
+	HmacVectors();
+
+	std::cout << sizeof( s_srpCorpus ) / sizeof( s_srpCorpus[0] )
+			  << " known answers, " << s_failures << " failures" << std::endl;
+
+	return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Compares the login strategies on the SDK transport against CognitoStandIn:
+// user pool round trips and process CPU time per login, and fails unless
+// USER_PASSWORD_AUTH and ADMIN_USER_PASSWORD_AUTH take one round trip and
+// less CPU than SRP, which takes two. The stand-in runs in the process, so
+// its share of the CPU time is counted for every strategy alike.
+//
+//   strategy-benchmark [logins per strategy]
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+
+#include "aws/core/Aws.h"
+
+#include "../../include/aws-cpp-cognito-auth/Auth.hpp"
+
+#include "CognitoStandIn.hpp"
+
+
+using namespace awsx;
+
+
+struct StrategyCost {
+	bool ok;
+	double roundTrips;
+	double cpuUs;
+};
+
+static StrategyCost Measure(
+	CognitoStandIn & standIn, AuthStrategy strategy, int logins )
+{
+	CognitoAuthOptions options;
+	options.strategy = strategy;
+	options.transport = TransportKind::Sdk;
+	options.endpointOverride = standIn.Endpoint();
+
+	CognitoAuth auth( "us-east-1", "client", options );
+	auth.Warmup();
+
+	StrategyCost cost = StrategyCost();
+
+	// the first login opens the connection
+	auto tokens
+		= auth.TryAuthenticateWithUserPool( "user", "password", "pool" );
+
+	if ( !tokens ) {
+		std::cerr << "login failed: " << tokens.Error().GetMessage()
+				  << std::endl;
+
+		return cost;
+	}
+
+	standIn.ResetCounts();
+
+	std::clock_t start = std::clock();
+
+	for ( int i = 0; i < logins; i++ ) {
+		tokens
+			= auth.TryAuthenticateWithUserPool( "user", "password", "pool" );
+
+		if ( !tokens ) {
+			std::cerr << "login failed: " << tokens.Error().GetMessage()
+					  << std::endl;
+
+			return cost;
+		}
+	}
+
+	std::clock_t cpu = std::clock() - start;
+
+	size_t requests = standIn.Count( "InitiateAuth" )
+		+ standIn.Count( "AdminInitiateAuth" )
+		+ standIn.Count( "RespondToAuthChallenge" );
+
+	cost.ok = true;
+	cost.roundTrips = static_cast<double>( requests ) / logins;
+	cost.cpuUs = 1e6 * cpu / CLOCKS_PER_SEC / logins;
+
+	return cost;
+}
+
+
+int main( int argc, char * argv[] )
+{
+	int logins = argc > 1 ? atoi( argv[1] ) : 100;
+
+	if ( logins <= 0 ) {
+		std::cerr << "usage: strategy-benchmark [logins per strategy]"
+				  << std::endl;
+
+		return 2;
+	}
+
+	// AdminInitiateAuth is signed; the stand-in does not check the keys
+	setenv( "AWS_ACCESS_KEY_ID", "AKIASTANDIN", 1 );
+	setenv( "AWS_SECRET_ACCESS_KEY", "secret", 1 );
+	setenv( "AWS_EC2_METADATA_DISABLED", "true", 1 );
+
+	Aws::SDKOptions sdkOptions;
+	Aws::InitAPI( sdkOptions );
+
+	int failures = 0;
+
+	{
+		CognitoStandIn standIn;
+
+		struct {
+			const char * name;
+			AuthStrategy strategy;
+			double roundTrips;
+		} strategies[] = {
+			{ "USER_SRP_AUTH", AuthStrategy::Srp, 2.0 },
+			{ "USER_PASSWORD_AUTH", AuthStrategy::UserPassword, 1.0 },
+			{ "ADMIN_USER_PASSWORD_AUTH", AuthStrategy::AdminUserPassword, 1.0 }
+		};
+
+		double srpCpuUs = 0.0;
+
+		for ( const auto & entry : strategies ) {
+			StrategyCost cost = Measure( standIn, entry.strategy, logins );
+
+			std::cout << entry.name << ": " << cost.roundTrips
+					  << " round trips, "
+					  << static_cast<long long>( cost.cpuUs )
+					  << " us CPU per login" << std::endl;
+
+			if ( !cost.ok || cost.roundTrips != entry.roundTrips ) {
+				std::cerr << "FAILED: " << entry.name << " expected "
+						  << entry.roundTrips << " round trips" << std::endl;
+				++failures;
+			}
+
+			if ( entry.strategy == AuthStrategy::Srp ) {
+				srpCpuUs = cost.cpuUs;
+			}
+			else if ( cost.cpuUs >= srpCpuUs ) {
+				std::cerr << "FAILED: " << entry.name
+						  << " takes no less CPU than USER_SRP_AUTH"
+						  << std::endl;
+				++failures;
+			}
+		}
+	}
+
+	Aws::ShutdownAPI( sdkOptions );
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,284 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Compares the Http (HTTP/1.1) and Http2 transports under concurrency: N
+// threads send synchronous InitiateAuth calls through an H2cFront, nghttpx
+// in front of CognitoStandIn answering after 20 ms, and the table reports
+// throughput, latency percentiles, the slowest first call (cold) and the
+// connections open to the front. Exits 77, skipped, without nghttpx; the
+// Http2 rows are skipped with a libcurl that cannot multiplex HTTP/2.
+//
+//   transport-benchmark [seconds [threads...]]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aws/core/Aws.h"
+
+#include "../../include/aws-cpp-cognito-auth/Auth.hpp"
+
+#include "CognitoStandIn.hpp"
+#include "H2cFront.hpp"
+
+
+using namespace awsx;
+
+
+struct TransportResult {
+	bool ok;
+	size_t requests;
+	double perSecond;
+	double p50Ms;
+	double p99Ms;
+	double coldMs;
+	size_t connections;
+};
+
+// Established client connections to the port, from /proc/net/tcp.
+static size_t Connections( int port )
+{
+	std::ifstream table( "/proc/net/tcp" );
+	std::string line;
+	size_t count = 0;
+
+	std::getline( table, line );
+
+	while ( std::getline( table, line ) ) {
+		unsigned remotePort = 0;
+		unsigned state = 0;
+
+		if ( sscanf( line.c_str(), "%*d: %*x:%*x %*x:%x %x", &remotePort,
+				 &state )
+				== 2
+			&& static_cast<int>( remotePort ) == port && state == 1 ) {
+			++count;
+		}
+	}
+
+	return count;
+}
+
+static double Percentile( const std::vector<double> & sorted, double p )
+{
+	return sorted.empty()
+		? 0.0
+		: sorted[static_cast<size_t>( p * ( sorted.size() - 1 ) )];
+}
+
+static TransportResult Measure(
+	const H2cFront & front, TransportKind kind, int threads, int seconds )
+{
+	CognitoAuthOptions options;
+	options.strategy = AuthStrategy::UserPassword;
+	options.transport = kind;
+	options.endpointOverride = front.Endpoint();
+
+	CognitoAuth auth( "us-east-1", "client", options );
+	auto transport = auth.GetTransport();
+	auto request = auth.MakePasswordAuthRequest( "user", "password" );
+
+	std::vector<std::vector<double>> latencies( threads );
+	std::vector<double> firstMs( threads, 0.0 );
+	std::atomic<bool> go( false );
+	std::atomic<bool> stop( false );
+	std::atomic<size_t> failures( 0 );
+	std::vector<std::thread> workers;
+
+	for ( int i = 0; i < threads; i++ ) {
+		workers.emplace_back( [&, i]() {
+			while ( !go ) {
+				std::this_thread::yield();
+			}
+
+			auto begin = std::chrono::steady_clock::now();
+
+			while ( !stop ) {
+				auto start = std::chrono::steady_clock::now();
+				auto outcome = transport->InitiateAuth( request );
+				auto end = std::chrono::steady_clock::now();
+
+				if ( !outcome.IsSuccess() ) {
+					++failures;
+					continue;
+				}
+
+				if ( latencies[i].empty() ) {
+					firstMs[i] = std::chrono::duration<double, std::milli>(
+						end - begin )
+									 .count();
+				}
+
+				latencies[i].push_back(
+					std::chrono::duration<double, std::milli>( end - start )
+						.count() );
+			}
+		} );
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	go = true;
+
+	// sampled halfway, once every thread is past its first call
+	std::this_thread::sleep_for( std::chrono::milliseconds( 500 * seconds ) );
+	size_t connections = Connections( front.Port() );
+	std::this_thread::sleep_for( std::chrono::milliseconds( 500 * seconds ) );
+
+	stop = true;
+
+	for ( auto & worker : workers ) {
+		worker.join();
+	}
+
+	double elapsed = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start )
+						 .count();
+
+	std::vector<double> all;
+
+	for ( const auto & thread : latencies ) {
+		all.insert( all.end(), thread.begin(), thread.end() );
+	}
+
+	std::sort( all.begin(), all.end() );
+
+	TransportResult result = TransportResult();
+	result.ok = failures == 0 && !all.empty();
+	result.requests = all.size();
+	result.perSecond = all.size() / elapsed;
+	result.p50Ms = Percentile( all, 0.50 );
+	result.p99Ms = Percentile( all, 0.99 );
+	result.coldMs = *std::max_element( firstMs.begin(), firstMs.end() );
+	result.connections = connections;
+
+	if ( failures != 0 ) {
+		std::cerr << failures << " calls failed" << std::endl;
+	}
+
+	return result;
+}
+
+
+int main( int argc, char * argv[] )
+{
+	int seconds = argc > 1 ? atoi( argv[1] ) : 4;
+	std::vector<int> threadCounts;
+
+	for ( int i = 2; i < argc; i++ ) {
+		threadCounts.push_back( atoi( argv[i] ) );
+	}
+
+	if ( threadCounts.empty() ) {
+		threadCounts = { 64, 256 };
+	}
+
+	if ( seconds <= 0
+		|| std::any_of( threadCounts.begin(),
+			threadCounts.end(),
+			[]( int threads ) { return threads <= 0; } ) ) {
+		std::cerr << "usage: transport-benchmark [seconds [threads...]]"
+				  << std::endl;
+
+		return 2;
+	}
+
+	setenv( "AWS_EC2_METADATA_DISABLED", "true", 1 );
+
+	Aws::SDKOptions sdkOptions;
+	Aws::InitAPI( sdkOptions );
+
+	int failures = 0;
+	bool skipped = false;
+
+	{
+		CognitoStandIn standIn;
+		standIn.SetDelay( "InitiateAuth", std::chrono::milliseconds( 20 ) );
+
+		H2cFront front( standIn.Port() );
+
+		if ( !front.Available() ) {
+			std::cerr << "nghttpx not found, set NGHTTPX" << std::endl;
+			skipped = true;
+		}
+
+		struct {
+			const char * name;
+			TransportKind kind;
+		} transports[] = { { "http", TransportKind::Http },
+			{ "http2", TransportKind::Http2 } };
+
+		if ( !skipped ) {
+			std::cout << "transport threads    req/s   p50 ms   p99 ms  "
+						 "cold ms  conns"
+					  << std::endl;
+		}
+
+		for ( int threads : threadCounts ) {
+			for ( const auto & entry : transports ) {
+				if ( skipped ) {
+					break;
+				}
+
+				TransportResult result;
+
+				try {
+					result = Measure( front, entry.kind, threads, seconds );
+				}
+				catch ( const Exception & e ) {
+					// e.g. a libcurl too old for Http2
+					std::cout << entry.name << " skipped: " << e.what()
+							  << std::endl;
+					continue;
+				}
+
+				std::cout << std::fixed << std::setprecision( 1 )
+						  << std::left << std::setw( 9 ) << entry.name
+						  << std::right << std::setw( 7 ) << threads
+						  << std::setw( 9 ) << result.perSecond
+						  << std::setw( 9 ) << result.p50Ms << std::setw( 9 )
+						  << result.p99Ms << std::setw( 9 ) << result.coldMs
+						  << std::setw( 7 ) << result.connections
+						  << std::endl;
+
+				if ( !result.ok ) {
+					std::cerr << "FAILED: " << entry.name << " with "
+							  << threads << " threads" << std::endl;
+					++failures;
+				}
+			}
+		}
+	}
+
+	Aws::ShutdownAPI( sdkOptions );
+
+	return skipped ? 77 : failures == 0 ? 0 : 1;
+}
@@ -22,16 +22,26 @@
  * SOFTWARE.
  */
 
+#include <algorithm>
 #include <ctime>
 #include <iomanip>
+#include <thread>
 #include <vector>
 
+#include "aws/core/client/DefaultRetryStrategy.h"
 #include "aws/core/utils/Outcome.h"
+#include "aws/core/utils/threading/Executor.h"
 
 #include "aws/cognito-idp/CognitoIdentityProviderClient.h"
+#include "aws/cognito-idp/model/AdminInitiateAuthRequest.h"
+#include "aws/cognito-idp/model/AdminInitiateAuthResult.h"
+#include "aws/cognito-idp/model/ChallengeNameType.h"
+#include "aws/cognito-idp/model/ConfirmDeviceRequest.h"
+#include "aws/cognito-idp/model/ConfirmDeviceResult.h"
 #include "aws/cognito-idp/model/InitiateAuthRequest.h"
 #include "aws/cognito-idp/model/InitiateAuthResult.h"
 #include "aws/cognito-idp/model/RespondToAuthChallengeRequest.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusRequest.h"
 
 #include "aws/cognito-identity/CognitoIdentityClient.h"
 #include "aws/cognito-identity/model/GetCredentialsForIdentityRequest.h"
@@ -39,42 +49,28 @@
 #include "aws/cognito-identity/model/GetIdRequest.h"
 #include "aws/cognito-identity/model/GetIdResult.h"
 
+#include "include/Base64.hpp"
+#include "include/CognitoJson.hpp"
+#include "include/Crypt.hpp"
+#include "include/Hedging.hpp"
 #include "include/Helpers.hpp"
 #include "include/Srp.hpp"
 
 #include "../../include/aws-cpp-cognito-auth/Auth.hpp"
+#include "../../include/aws-cpp-cognito-auth/Http2Transport.hpp"
+#include "../../include/aws-cpp-cognito-auth/HttpTransport.hpp"
+#include "../../include/aws-cpp-cognito-auth/NegativeCache.hpp"
+#include "../../include/aws-cpp-cognito-auth/RateLimit.hpp"
+#include "../../include/aws-cpp-cognito-auth/Startup.hpp"
 
 
 using namespace awsx;
 
 
-CognitoTokens awsx::CognitoAuth::AuthenticateWithUserPoolInternal(
-	Aws::Client::ClientConfiguration & clientConfig,
-	const std::string & username,
-	const std::string & userPoolId,
-	const std::string & password )
+// Timestamp signed into the SRP password claims, e.g.
+// "Tue Sep 3 11:03:05 UTC 2019".
+static std::string SrpTimestamp()
 {
-	Srp srp;
-
-	Aws::Map<Aws::String, Aws::String> authParameters;
-	authParameters["USERNAME"] = username.c_str();
-	authParameters["SRP_A"] = srp.A();
-
-	Aws::CognitoIdentityProvider::CognitoIdentityProviderClient cipClient(
-		clientConfig );
-
-	Aws::CognitoIdentityProvider::Model::InitiateAuthRequest authRequest;
-	authRequest.SetClientId( m_clientId.c_str() );
-	authRequest.SetAuthFlow(
-		Aws::CognitoIdentityProvider::Model::AuthFlowType::USER_SRP_AUTH );
-
-	authRequest.SetAuthParameters( authParameters );
-
-	auto authResult = cipClient.InitiateAuth( authRequest );
-	ThrowIf<Exception>( authResult );
-
-	auto challengeParameters = authResult.GetResult().GetChallengeParameters();
-
 	auto now = time( nullptr );
 	struct tm tm;
 
@@ -90,7 +86,531 @@ CognitoTokens awsx::CognitoAuth::AuthenticateWithUserPoolInternal(
 			+ "%e %H:%M:%S UTC %Y" )
 			.c_str() );
 
-	std::string timestamp( ss.str() );
+	return ss.str();
+}
+
+// The pool no longer knows the remembered device (forgotten or expired), the
+// login has to start over without it.
+template <typename TOutcome>
+static bool IsStaleDevice( const TOutcome & outcome )
+{
+	return !outcome.IsSuccess()
+		&& outcome.GetError().GetErrorType()
+		== Aws::CognitoIdentityProvider::CognitoIdentityProviderErrors::
+			RESOURCE_NOT_FOUND;
+}
+
+template <typename TResult>
+static CognitoTokens TokensFromResult( const TResult & authResult )
+{
+	using namespace Aws::CognitoIdentityProvider::Model;
+
+	if ( authResult.GetChallengeName() != ChallengeNameType::NOT_SET ) {
+		auto name = ChallengeNameTypeMapper::GetNameForChallengeNameType(
+			authResult.GetChallengeName() );
+
+		throw Exception( std::string( name.c_str() )
+			+ ": challenge pending, see CognitoAuth::BeginAuthentication()" );
+	}
+
+	auto & result = authResult.GetAuthenticationResult();
+
+	return CognitoTokens( std::string( result.GetAccessToken().c_str() ),
+		std::string( result.GetIdToken().c_str() ),
+		std::string( result.GetRefreshToken().c_str() ),
+		result.GetExpiresIn() );
+}
+
+CognitoTokens awsx::CognitoAuthSession::GetTokens() const
+{
+	if ( m_state != State::Authenticated ) {
+		throw Exception( m_challengeName
+			+ ": challenge pending, see CognitoAuth::RespondToChallenge()" );
+	}
+
+	return m_tokens;
+}
+
+// Runs a call synchronously, or through the async API when it has to finish
+// before a deadline, resending retryable failures within it. Returns false
+// when the deadline passed first.
+template <typename TRequest, typename TOutcome>
+static bool CallUntil( TOutcome & outcome,
+	const CognitoAuth & auth,
+	const CognitoTransport & transport,
+	TOutcome ( CognitoTransport::*call )( const TRequest & ) const,
+	std::future<TOutcome> ( CognitoTransport::*callable )(
+		const TRequest & ) const,
+	const TRequest & request,
+	Deadline deadline )
+{
+	if ( deadline == Deadline::max() ) {
+		outcome = ( transport.*call )( request );
+
+		return true;
+	}
+
+	for ( long attempt = 0;; attempt++ ) {
+		auto future = ( transport.*callable )( request );
+
+		if ( !AwaitUntil( future, deadline, outcome ) ) {
+			return false;
+		}
+
+		Deadline retryAt;
+
+		if ( outcome.IsSuccess()
+			|| !auth.RetryBefore( deadline,
+				attempt,
+				outcome.GetError().ShouldRetry(),
+				retryAt ) ) {
+			return true;
+		}
+
+		std::this_thread::sleep_until( retryAt );
+	}
+}
+
+// Runs an idempotent cognito-identity call, sending a second attempt when the
+// first one is slower than the policy's latency percentile. Returns false
+// when the deadline passed first.
+template <typename TOutcome, typename TLaunch>
+static bool HedgedAttempt( TOutcome & outcome,
+	const CognitoAuth & auth,
+	HedgedApi api,
+	TLaunch launch,
+	Deadline deadline )
+{
+	auto call = std::make_shared<HedgedCall<TOutcome>>();
+	auto started = std::chrono::steady_clock::now();
+
+	call->Started();
+	launch( call );
+
+	auto hedgeAt
+		= std::min( Deadline( started + auth.HedgeDelay( api ) ), deadline );
+
+	if ( !call->WaitUntil( hedgeAt ) && hedgeAt < deadline ) {
+		call->Started();
+		launch( call );
+	}
+
+	if ( !call->WaitUntil( deadline ) ) {
+		return false;
+	}
+
+	if ( call->GetOutcome().IsSuccess() ) {
+		auth.RecordHedgedLatency( api,
+			std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - started ) );
+	}
+
+	outcome = call->GetOutcome();
+
+	return true;
+}
+
+// HedgedAttempt(), resending retryable failures within the deadline.
+template <typename TOutcome, typename TLaunch>
+static bool Hedged( TOutcome & outcome,
+	const CognitoAuth & auth,
+	HedgedApi api,
+	TLaunch launch,
+	Deadline deadline )
+{
+	for ( long attempt = 0;; attempt++ ) {
+		if ( !HedgedAttempt( outcome, auth, api, launch, deadline ) ) {
+			return false;
+		}
+
+		Deadline retryAt;
+
+		if ( outcome.IsSuccess()
+			|| !auth.RetryBefore( deadline,
+				attempt,
+				outcome.GetError().ShouldRetry(),
+				retryAt ) ) {
+			return true;
+		}
+
+		std::this_thread::sleep_until( retryAt );
+	}
+}
+
+// Sorts the error of a failed call into the codes callers tell apart. The
+// usual messages become literals; any other text is moved out of error and
+// kept by the AuthError.
+template <typename TError>
+static AuthError TakeError( TError & error )
+{
+	static const struct {
+		const char * name;
+		AuthErrorCode code;
+		// what Cognito usually says, or null
+		const char * message;
+	} known[] = {
+		{ "NotAuthorizedException",
+			AuthErrorCode::NotAuthorized,
+			"Incorrect username or password." },
+		{ "UserNotFoundException",
+			AuthErrorCode::UserNotFound,
+			"User does not exist." },
+		{ "UserNotConfirmedException",
+			AuthErrorCode::UserNotConfirmed,
+			"User is not confirmed." },
+		{ "PasswordResetRequiredException",
+			AuthErrorCode::PasswordResetRequired,
+			"Password reset required for the user" },
+		{ "InvalidParameterException",
+			AuthErrorCode::InvalidParameter,
+			nullptr },
+		{ "TooManyRequestsException", AuthErrorCode::Throttled, nullptr },
+		{ "ThrottlingException", AuthErrorCode::Throttled, "Rate exceeded" },
+	};
+
+	bool retryable = error.ShouldRetry();
+
+	for ( auto & entry : known ) {
+		if ( error.GetExceptionName() != entry.name ) {
+			continue;
+		}
+
+		retryable = retryable || entry.code == AuthErrorCode::Throttled;
+
+		if ( entry.message && error.GetMessage() == entry.message ) {
+			return AuthError(
+				entry.code, entry.name, entry.message, retryable );
+		}
+
+		auto kept = std::make_shared<const TError>( std::move( error ) );
+
+		return AuthError( entry.code,
+			entry.name,
+			kept->GetMessage().c_str(),
+			retryable,
+			kept );
+	}
+
+	bool network = static_cast<int>( error.GetErrorType() )
+		== static_cast<int>( Aws::Client::CoreErrors::NETWORK_CONNECTION );
+
+	auto kept = std::make_shared<const TError>( std::move( error ) );
+
+	return AuthError( network ? AuthErrorCode::Network : AuthErrorCode::Service,
+		kept->GetExceptionName().c_str(),
+		kept->GetMessage().c_str(),
+		network || retryable,
+		kept );
+}
+
+// The outcome is left without its error.
+template <typename TOutcome>
+static AuthError ErrorOf( TOutcome & outcome )
+{
+	auto && error = outcome.GetErrorWithOwnership();
+
+	return TakeError( error );
+}
+
+
+awsx::CognitoAuth::CognitoAuth( const std::string & regionId,
+	const std::string & clientId,
+	bool warmup )
+	: CognitoAuth( regionId, clientId, CognitoAuthOptions() )
+{
+	if ( warmup ) {
+		Warmup();
+	}
+}
+
+awsx::CognitoAuth::CognitoAuth( const std::string & regionId,
+	const std::string & clientId,
+	const CognitoAuthOptions & options )
+	: CognitoAuth(
+		  regionId, clientId, MakeTransport( regionId, options ), options )
+{
+}
+
+awsx::CognitoAuth::CognitoAuth( const std::string & regionId,
+	const std::string & clientId,
+	std::shared_ptr<CognitoTransport> transport,
+	const CognitoAuthOptions & options )
+	: m_regionId( regionId )
+	, m_clientId( clientId )
+	, m_options( options )
+	, m_transport( transport )
+{
+	if ( m_options.hedging.enabled ) {
+		m_getIdLatency = std::make_shared<LatencyTracker>();
+		m_getCredentialsLatency = std::make_shared<LatencyTracker>();
+	}
+
+	if ( !m_options.clientSecret.empty() ) {
+		m_secretHash
+			= std::make_shared<HmacSha256Key>( m_options.clientSecret );
+	}
+
+	if ( m_options.lazyStart ) {
+		if ( m_options.strategy == AuthStrategy::Srp ) {
+			m_firstSrp = std::async( std::launch::async, []() {
+				Srp::Prepare();
+
+				return std::make_shared<Srp>();
+			} );
+		}
+	}
+	else if ( m_options.warmup ) {
+		Warmup();
+	}
+}
+
+Aws::Client::ClientConfiguration awsx::CognitoAuth::MakeClientConfig(
+	const std::string & regionId, const CognitoAuthOptions & options )
+{
+	Aws::Client::ClientConfiguration clientConfig;
+	clientConfig.region = Aws::String( regionId.c_str() );
+	clientConfig.enableTcpKeepAlive = true;
+
+	if ( !options.endpointOverride.empty() ) {
+		std::string endpoint = options.endpointOverride;
+		auto schemeEnd = endpoint.find( "://" );
+
+		if ( schemeEnd != std::string::npos ) {
+			clientConfig.scheme = endpoint.compare( 0, schemeEnd, "http" ) == 0
+				? Aws::Http::Scheme::HTTP
+				: Aws::Http::Scheme::HTTPS;
+
+			endpoint = endpoint.substr( schemeEnd + 3 );
+		}
+
+		clientConfig.endpointOverride = endpoint.c_str();
+	}
+
+	if ( options.loginTimeout.count() > 0 ) {
+		// no single attempt may outlive the whole login, and none is
+		// resent once the login gave up on it: the login retries itself,
+		// see RetryBefore()
+		long timeoutMs = static_cast<long>( options.loginTimeout.count() );
+
+		clientConfig.requestTimeoutMs = timeoutMs;
+		clientConfig.connectTimeoutMs
+			= std::min( clientConfig.connectTimeoutMs, timeoutMs );
+		clientConfig.retryStrategy
+			= std::make_shared<Aws::Client::DefaultRetryStrategy>( 0 );
+	}
+	else if ( options.maxRetries >= 0 ) {
+		clientConfig.retryStrategy
+			= std::make_shared<Aws::Client::DefaultRetryStrategy>(
+				options.maxRetries );
+	}
+
+	if ( options.maxConnections > 0 ) {
+		clientConfig.maxConnections = options.maxConnections;
+	}
+
+	if ( options.asyncThreads > 0 || options.loginTimeout.count() > 0
+		|| options.hedging.enabled ) {
+		// deadline waits and hedges go through the async API, keep its
+		// threads around instead of spawning one per call
+		clientConfig.executor = std::make_shared<
+			Aws::Utils::Threading::PooledThreadExecutor>(
+			options.asyncThreads > 0 ? options.asyncThreads : 4 );
+	}
+
+	return clientConfig;
+}
+
+std::shared_ptr<CognitoTransport> awsx::CognitoAuth::MakeTransport(
+	const std::string & regionId, const CognitoAuthOptions & options )
+{
+	if ( options.transport != TransportKind::Sdk
+		&& options.strategy == AuthStrategy::AdminUserPassword ) {
+		throw Exception(
+			"AuthStrategy::AdminUserPassword needs TransportKind::Sdk" );
+	}
+
+	if ( options.lazyStart ) {
+		CognitoAuthOptions eager = options;
+		eager.lazyStart = false;
+
+		return std::make_shared<LazyTransport>(
+			[regionId, eager]() { return MakeTransport( regionId, eager ); },
+			options.sdkStartup,
+			options.warmup );
+	}
+
+	std::shared_ptr<CognitoTransport> transport;
+
+	if ( options.transport == TransportKind::Http ) {
+		transport = std::make_shared<HttpTransport>( regionId, options );
+	}
+	else if ( options.transport == TransportKind::Http2 ) {
+		transport = std::make_shared<Http2Transport>( regionId, options );
+	}
+	else {
+		transport = std::make_shared<CognitoClients>(
+			MakeClientConfig( regionId, options ) );
+	}
+
+	if ( options.rateLimit.enabled ) {
+		// waiting past the login deadline would only start abandoned calls
+		RateLimitPolicy policy = options.rateLimit;
+
+		if ( options.loginTimeout.count() > 0 ) {
+			policy.maxWait = std::min( policy.maxWait, options.loginTimeout );
+		}
+
+		transport = std::make_shared<RateLimitedTransport>( transport, policy );
+	}
+
+	return transport;
+}
+
+std::chrono::steady_clock::time_point awsx::CognitoAuth::LoginDeadline() const
+{
+	if ( m_options.loginTimeout.count() > 0 ) {
+		return std::chrono::steady_clock::now() + m_options.loginTimeout;
+	}
+
+	return Deadline::max();
+}
+
+std::chrono::microseconds awsx::CognitoAuth::HedgeDelay(
+	HedgedApi api ) const
+{
+	auto & latency = api == HedgedApi::GetId
+		? m_getIdLatency
+		: m_getCredentialsLatency;
+
+	std::chrono::microseconds delay( m_options.hedging.minDelay );
+	std::chrono::microseconds observed;
+
+	if ( latency
+		&& latency->Percentile( observed, m_options.hedging.percentile ) ) {
+		delay = std::max( delay, observed );
+	}
+
+	return delay;
+}
+
+void awsx::CognitoAuth::RecordHedgedLatency(
+	HedgedApi api, std::chrono::microseconds latency ) const
+{
+	auto & tracker = api == HedgedApi::GetId
+		? m_getIdLatency
+		: m_getCredentialsLatency;
+
+	if ( tracker ) {
+		tracker->Add( latency );
+	}
+}
+
+bool awsx::CognitoAuth::RetryBefore(
+	std::chrono::steady_clock::time_point deadline,
+	long attempt,
+	bool retryable,
+	std::chrono::steady_clock::time_point & at ) const
+{
+	long retries = m_options.maxRetries >= 0 ? m_options.maxRetries : 3;
+
+	if ( !retryable || deadline == Deadline::max() || attempt >= retries ) {
+		return false;
+	}
+
+	at = std::chrono::steady_clock::now() + CognitoJson::Backoff( attempt );
+
+	return at < deadline;
+}
+
+void awsx::CognitoAuth::Warmup()
+{
+	Srp::Prepare();
+	m_transport->Warmup();
+}
+
+void awsx::CognitoAuth::StartKeepAlive( std::chrono::seconds interval )
+{
+	m_transport->StartKeepAlive( interval );
+}
+
+void awsx::CognitoAuth::StopKeepAlive()
+{
+	m_transport->StopKeepAlive();
+}
+
+std::string awsx::CognitoAuth::LoginProvider(
+	const std::string & userPoolId ) const
+{
+	return "cognito-idp." + m_regionId + ".amazonaws.com/" + m_regionId + "_"
+		+ userPoolId;
+}
+
+std::string awsx::CognitoAuth::SecretHash( const std::string & username ) const
+{
+	if ( !m_secretHash ) {
+		return std::string();
+	}
+
+	std::vector<uint8_t> hmac;
+	m_secretHash->Compute( hmac, username + m_clientId );
+
+	return Base64().Encode( hmac );
+}
+
+std::shared_ptr<Srp> awsx::CognitoAuth::BeginSrp() const
+{
+	std::future<std::shared_ptr<Srp>> first;
+
+	{
+		std::lock_guard<std::mutex> lock( m_firstSrpMutex );
+		first = std::move( m_firstSrp );
+	}
+
+	if ( first.valid() ) {
+		return first.get();
+	}
+
+	return std::make_shared<Srp>();
+}
+
+Aws::CognitoIdentityProvider::Model::InitiateAuthRequest
+awsx::CognitoAuth::MakeInitiateAuthRequest( const Srp & srp,
+	const std::string & username,
+	const DeviceCredentials * device ) const
+{
+	Aws::Map<Aws::String, Aws::String> authParameters;
+	authParameters["USERNAME"] = username.c_str();
+	authParameters["SRP_A"] = srp.A();
+
+	if ( m_secretHash ) {
+		authParameters["SECRET_HASH"] = SecretHash( username ).c_str();
+	}
+
+	if ( device != nullptr ) {
+		authParameters["DEVICE_KEY"] = device->deviceKey.c_str();
+	}
+
+	Aws::CognitoIdentityProvider::Model::InitiateAuthRequest authRequest;
+	authRequest.SetClientId( m_clientId.c_str() );
+	authRequest.SetAuthFlow(
+		Aws::CognitoIdentityProvider::Model::AuthFlowType::USER_SRP_AUTH );
+
+	authRequest.SetAuthParameters( authParameters );
+
+	return authRequest;
+}
+
+Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeRequest
+awsx::CognitoAuth::MakePasswordVerifierRequest( Srp & srp,
+	const std::string & username,
+	const std::string & userPoolId,
+	const std::string & password,
+	const Aws::CognitoIdentityProvider::Model::InitiateAuthResult & authResult,
+	const DeviceCredentials * device ) const
+{
+	auto challengeParameters = authResult.GetChallengeParameters();
+
+	std::string timestamp( SrpTimestamp() );
 
 	const Aws::String salt = challengeParameters["SALT"];
 	const Aws::String srpB = challengeParameters["SRP_B"];
@@ -109,8 +629,7 @@ CognitoTokens awsx::CognitoAuth::AuthenticateWithUserPoolInternal(
 		challengeRequest;
 
 	challengeRequest.SetClientId( m_clientId.c_str() );
-	challengeRequest.SetChallengeName(
-		authResult.GetResult().GetChallengeName() );
+	challengeRequest.SetChallengeName( authResult.GetChallengeName() );
 
 	challengeRequest.AddChallengeResponses(
 		"PASSWORD_CLAIM_SECRET_BLOCK", secretBlock );
@@ -119,72 +638,1163 @@ CognitoTokens awsx::CognitoAuth::AuthenticateWithUserPoolInternal(
 		"PASSWORD_CLAIM_SIGNATURE", claim.c_str() );
 
 	challengeRequest.AddChallengeResponses( "USERNAME", username.c_str() );
+
+	if ( m_secretHash ) {
+		challengeRequest.AddChallengeResponses(
+			"SECRET_HASH", SecretHash( username ).c_str() );
+	}
 	challengeRequest.AddChallengeResponses( "TIMESTAMP", timestamp.c_str() );
 
-	auto challengeResult = cipClient.RespondToAuthChallenge( challengeRequest );
-	ThrowIf<Exception>( challengeResult );
+	if ( device != nullptr ) {
+		challengeRequest.AddChallengeResponses(
+			"DEVICE_KEY", device->deviceKey.c_str() );
+	}
 
-	Aws::CognitoIdentityProvider::Model::AuthenticationResultType result
-		= challengeResult.GetResult().GetAuthenticationResult();
+	return challengeRequest;
+}
 
-	return CognitoTokens( std::string( result.GetAccessToken().c_str() ),
-		std::string( result.GetIdToken().c_str() ),
-		std::string( result.GetRefreshToken().c_str() ),
-		result.GetExpiresIn() );
+Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeRequest
+awsx::CognitoAuth::MakeDeviceSrpRequest( const Srp & srp,
+	const DeviceCredentials & device,
+	const Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeResult &
+		challengeResult ) const
+{
+	auto challengeParameters = challengeResult.GetChallengeParameters();
+
+	Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeRequest
+		challengeRequest;
+
+	challengeRequest.SetClientId( m_clientId.c_str() );
+	challengeRequest.SetChallengeName( challengeResult.GetChallengeName() );
+	challengeRequest.SetSession( challengeResult.GetSession() );
+
+	challengeRequest.AddChallengeResponses(
+		"USERNAME", challengeParameters["USERNAME"] );
+
+	if ( m_secretHash ) {
+		challengeRequest.AddChallengeResponses( "SECRET_HASH",
+			SecretHash( challengeParameters["USERNAME"].c_str() ).c_str() );
+	}
+	challengeRequest.AddChallengeResponses(
+		"DEVICE_KEY", device.deviceKey.c_str() );
+	challengeRequest.AddChallengeResponses( "SRP_A", srp.A() );
+
+	return challengeRequest;
 }
 
-Aws::Auth::AWSCredentials CognitoAuth::Authenticate(
-	const std::string & username,
-	const std::string & password,
-	const std::string & userPoolId,
-	const std::string & identityPoolId )
+Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeRequest
+awsx::CognitoAuth::MakeDevicePasswordVerifierRequest( Srp & srp,
+	const DeviceCredentials & device,
+	const Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeResult &
+		challengeResult ) const
 {
-	Aws::Client::ClientConfiguration clientConfig;
-	clientConfig.region = Aws::String( m_regionId.c_str() );
+	auto challengeParameters = challengeResult.GetChallengeParameters();
 
-	std::string token = AuthenticateWithUserPoolInternal(
-		clientConfig, username, userPoolId, password )
-							.GetIdToken();
+	std::string timestamp( SrpTimestamp() );
+
+	const Aws::String salt = challengeParameters["SALT"];
+	const Aws::String srpB = challengeParameters["SRP_B"];
+	const Aws::String secretBlock = challengeParameters["SECRET_BLOCK"];
 
-	std::string login = ( "cognito-idp." + m_regionId + ".amazonaws.com/"
-						  + m_regionId + "_" + userPoolId );
+	// same claim as the user's, with the device group standing in for the
+	// pool and the device key for the user
+	auto claim = srp.GeneratePasswordClaim( device.deviceGroupKey,
+		device.deviceKey,
+		device.devicePassword,
+		salt.c_str(),
+		srpB.c_str(),
+		secretBlock.c_str(),
+		timestamp );
 
-	Aws::CognitoIdentity::CognitoIdentityClient ciClient( clientConfig );
+	Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeRequest
+		challengeRequest;
 
-	Aws::CognitoIdentity::Model::GetIdRequest idRequest;
-	idRequest.SetIdentityPoolId( identityPoolId.c_str() );
-	idRequest.AddLogins( login.c_str(), token );
-	idRequest.SetIdentityPoolId(
-		( m_regionId + ":" + identityPoolId ).c_str() );
+	challengeRequest.SetClientId( m_clientId.c_str() );
+	challengeRequest.SetChallengeName( challengeResult.GetChallengeName() );
+	challengeRequest.SetSession( challengeResult.GetSession() );
 
-	auto idResult = ciClient.GetId( idRequest );
-	ThrowIf<Exception>( idResult );
+	challengeRequest.AddChallengeResponses(
+		"PASSWORD_CLAIM_SECRET_BLOCK", secretBlock );
 
-	Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest
-		credForIdRequest;
+	challengeRequest.AddChallengeResponses(
+		"PASSWORD_CLAIM_SIGNATURE", claim.c_str() );
 
-	credForIdRequest.SetIdentityId( idResult.GetResult().GetIdentityId() );
-	credForIdRequest.AddLogins( login.c_str(), token );
+	challengeRequest.AddChallengeResponses(
+		"USERNAME", challengeParameters["USERNAME"] );
 
-	auto credForIdResult
-		= ciClient.GetCredentialsForIdentity( credForIdRequest );
+	if ( m_secretHash ) {
+		challengeRequest.AddChallengeResponses( "SECRET_HASH",
+			SecretHash( challengeParameters["USERNAME"].c_str() ).c_str() );
+	}
+	challengeRequest.AddChallengeResponses(
+		"DEVICE_KEY", device.deviceKey.c_str() );
+	challengeRequest.AddChallengeResponses( "TIMESTAMP", timestamp.c_str() );
 
-	ThrowIf<Exception>( credForIdResult );
+	return challengeRequest;
+}
 
-	auto & cred = credForIdResult.GetResult().GetCredentials();
+CognitoTokens awsx::CognitoAuth::MakeTokens(
+	const Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeResult &
+		challengeResult ) const
+{
+	return TokensFromResult( challengeResult );
+}
 
-	return Aws::Auth::AWSCredentials(
-		cred.GetAccessKeyId(), cred.GetSecretKey(), cred.GetSessionToken() );
+Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeRequest
+awsx::CognitoAuth::MakeChallengeResponseRequest(
+	const CognitoAuthSession & session,
+	const std::map<std::string, std::string> & responses ) const
+{
+	if ( session.IsAuthenticated() ) {
+		throw Exception( "no challenge pending" );
+	}
+
+	// the pool's own user name when the login used an alias
+	auto & parameters = session.m_challengeParameters;
+	auto username = session.m_username;
+	auto found = parameters.find( "USER_ID_FOR_SRP" );
+
+	if ( found == parameters.end() ) {
+		found = parameters.find( "USERNAME" );
+	}
+
+	if ( found != parameters.end() && !found->second.empty() ) {
+		username = found->second;
+	}
+
+	Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeRequest
+		challengeRequest;
+
+	challengeRequest.SetClientId( m_clientId.c_str() );
+	challengeRequest.SetChallengeName(
+		Aws::CognitoIdentityProvider::Model::ChallengeNameTypeMapper::
+			GetChallengeNameTypeForName( session.m_challengeName.c_str() ) );
+	challengeRequest.SetSession( session.m_session.c_str() );
+
+	challengeRequest.AddChallengeResponses( "USERNAME", username.c_str() );
+
+	if ( m_secretHash ) {
+		challengeRequest.AddChallengeResponses(
+			"SECRET_HASH", SecretHash( username ).c_str() );
+	}
+
+	for ( auto & response : responses ) {
+		challengeRequest.AddChallengeResponses(
+			response.first.c_str(), response.second.c_str() );
+	}
+
+	return challengeRequest;
 }
 
-CognitoTokens awsx::CognitoAuth::AuthenticateWithUserPool(
-	const std::string & username,
-	const std::string & password,
-	const std::string & userPoolId )
+Aws::CognitoIdentityProvider::Model::InitiateAuthRequest
+awsx::CognitoAuth::MakePasswordAuthRequest(
+	const std::string & username, const std::string & password ) const
 {
-	Aws::Client::ClientConfiguration clientConfig;
-	clientConfig.region = Aws::String( m_regionId.c_str() );
+	Aws::Map<Aws::String, Aws::String> authParameters;
+	authParameters["USERNAME"] = username.c_str();
+	authParameters["PASSWORD"] = password.c_str();
 
-	return AuthenticateWithUserPoolInternal(
-		clientConfig, username, userPoolId, password );
+	if ( m_secretHash ) {
+		authParameters["SECRET_HASH"] = SecretHash( username ).c_str();
+	}
+
+	Aws::CognitoIdentityProvider::Model::InitiateAuthRequest authRequest;
+	authRequest.SetClientId( m_clientId.c_str() );
+	authRequest.SetAuthFlow( Aws::CognitoIdentityProvider::Model::
+			AuthFlowType::USER_PASSWORD_AUTH );
+
+	authRequest.SetAuthParameters( authParameters );
+
+	return authRequest;
+}
+
+Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest
+awsx::CognitoAuth::MakeAdminPasswordAuthRequest( const std::string & username,
+	const std::string & userPoolId,
+	const std::string & password ) const
+{
+	Aws::Map<Aws::String, Aws::String> authParameters;
+	authParameters["USERNAME"] = username.c_str();
+	authParameters["PASSWORD"] = password.c_str();
+
+	if ( m_secretHash ) {
+		authParameters["SECRET_HASH"] = SecretHash( username ).c_str();
+	}
+
+	Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest authRequest;
+	authRequest.SetClientId( m_clientId.c_str() );
+	authRequest.SetUserPoolId( ( m_regionId + "_" + userPoolId ).c_str() );
+	authRequest.SetAuthFlow( Aws::CognitoIdentityProvider::Model::
+			AuthFlowType::ADMIN_USER_PASSWORD_AUTH );
+
+	authRequest.SetAuthParameters( authParameters );
+
+	return authRequest;
+}
+
+CognitoTokens awsx::CognitoAuth::MakeTokens(
+	const Aws::CognitoIdentityProvider::Model::InitiateAuthResult & authResult )
+	const
+{
+	return TokensFromResult( authResult );
+}
+
+CognitoTokens awsx::CognitoAuth::MakeTokens(
+	const Aws::CognitoIdentityProvider::Model::AdminInitiateAuthResult &
+		authResult ) const
+{
+	return TokensFromResult( authResult );
+}
+
+Aws::CognitoIdentityProvider::Model::InitiateAuthRequest
+awsx::CognitoAuth::MakeRefreshRequest( const std::string & refreshToken,
+	const std::string & username,
+	const DeviceCredentials * device ) const
+{
+	Aws::Map<Aws::String, Aws::String> authParameters;
+	authParameters["REFRESH_TOKEN"] = refreshToken.c_str();
+
+	if ( device != nullptr ) {
+		authParameters["DEVICE_KEY"] = device->deviceKey.c_str();
+	}
+
+	if ( m_secretHash ) {
+		authParameters["SECRET_HASH"] = SecretHash( username ).c_str();
+	}
+
+	Aws::CognitoIdentityProvider::Model::InitiateAuthRequest authRequest;
+	authRequest.SetClientId( m_clientId.c_str() );
+	authRequest.SetAuthFlow( Aws::CognitoIdentityProvider::Model::
+			AuthFlowType::REFRESH_TOKEN_AUTH );
+
+	authRequest.SetAuthParameters( authParameters );
+
+	return authRequest;
+}
+
+Aws::CognitoIdentity::Model::GetIdRequest awsx::CognitoAuth::MakeGetIdRequest(
+	const std::string & idToken,
+	const std::string & userPoolId,
+	const std::string & identityPoolId ) const
+{
+	Aws::CognitoIdentity::Model::GetIdRequest idRequest;
+	idRequest.AddLogins( LoginProvider( userPoolId ).c_str(), idToken.c_str() );
+	idRequest.SetIdentityPoolId(
+		( m_regionId + ":" + identityPoolId ).c_str() );
+
+	return idRequest;
+}
+
+Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest
+awsx::CognitoAuth::MakeGetCredentialsRequest( const std::string & identityId,
+	const std::string & idToken,
+	const std::string & userPoolId ) const
+{
+	Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest
+		credForIdRequest;
+
+	credForIdRequest.SetIdentityId( identityId.c_str() );
+	credForIdRequest.AddLogins(
+		LoginProvider( userPoolId ).c_str(), idToken.c_str() );
+
+	return credForIdRequest;
+}
+
+Aws::Auth::AWSCredentials awsx::CognitoAuth::MakeCredentials(
+	const Aws::CognitoIdentity::Model::GetCredentialsForIdentityResult &
+		credForIdResult )
+{
+	auto & cred = credForIdResult.GetCredentials();
+
+	return Aws::Auth::AWSCredentials(
+		cred.GetAccessKeyId(), cred.GetSecretKey(), cred.GetSessionToken() );
+}
+
+IdentityCredentials awsx::CognitoAuth::MakeIdentityCredentials(
+	const Aws::CognitoIdentity::Model::GetCredentialsForIdentityResult &
+		credForIdResult )
+{
+	IdentityCredentials identity;
+	identity.identityId = credForIdResult.GetIdentityId().c_str();
+	identity.credentials = MakeCredentials( credForIdResult );
+	identity.expiration = std::chrono::system_clock::time_point(
+		std::chrono::milliseconds(
+			credForIdResult.GetCredentials().GetExpiration().Millis() ) );
+
+	return identity;
+}
+
+bool awsx::CognitoAuth::LoadDevice( const std::string & userPoolId,
+	const std::string & username,
+	DeviceCredentials & device ) const
+{
+	return m_options.deviceKeyStore
+		&& m_options.deviceKeyStore->Load( userPoolId, username, device );
+}
+
+void awsx::CognitoAuth::ForgetDevice(
+	const std::string & userPoolId, const std::string & username ) const
+{
+	if ( m_options.deviceKeyStore ) {
+		m_options.deviceKeyStore->Forget( userPoolId, username );
+	}
+}
+
+void awsx::CognitoAuth::SaveDevice( const std::string & userPoolId,
+	const std::string & username,
+	const DeviceCredentials & device ) const
+{
+	if ( m_options.deviceKeyStore ) {
+		m_options.deviceKeyStore->Save( userPoolId, username, device );
+	}
+}
+
+bool awsx::CognitoAuth::MakeConfirmDeviceRequest(
+	const Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeResult &
+		challengeResult,
+	Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest & request,
+	DeviceCredentials & device ) const
+{
+	using namespace Aws::CognitoIdentityProvider::Model;
+
+	auto & result = challengeResult.GetAuthenticationResult();
+	auto & metadata = result.GetNewDeviceMetadata();
+
+	if ( !m_options.deviceKeyStore || metadata.GetDeviceKey().empty() ) {
+		return false;
+	}
+
+	device.deviceKey = metadata.GetDeviceKey().c_str();
+	device.deviceGroupKey = metadata.GetDeviceGroupKey().c_str();
+
+	std::string salt;
+	std::string verifier;
+
+	Srp::GenerateDeviceVerifier( device.deviceGroupKey,
+		device.deviceKey,
+		device.devicePassword,
+		salt,
+		verifier );
+
+	DeviceSecretVerifierConfigType verifierConfig;
+	verifierConfig.SetPasswordVerifier( verifier.c_str() );
+	verifierConfig.SetSalt( salt.c_str() );
+
+	request.SetAccessToken( result.GetAccessToken() );
+	request.SetDeviceKey( metadata.GetDeviceKey() );
+	request.SetDeviceSecretVerifierConfig( verifierConfig );
+
+	if ( !m_options.deviceName.empty() ) {
+		request.SetDeviceName( m_options.deviceName.c_str() );
+	}
+
+	return true;
+}
+
+Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusRequest
+awsx::CognitoAuth::MakeRememberDeviceRequest(
+	const Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeResult &
+		challengeResult ) const
+{
+	using namespace Aws::CognitoIdentityProvider::Model;
+
+	auto & result = challengeResult.GetAuthenticationResult();
+
+	// pools set to "user opt-in" only track the device once it is marked
+	// as remembered
+	UpdateDeviceStatusRequest request;
+	request.SetAccessToken( result.GetAccessToken() );
+	request.SetDeviceKey( result.GetNewDeviceMetadata().GetDeviceKey() );
+	request.SetDeviceRememberedStatus(
+		DeviceRememberedStatusType::remembered );
+
+	return request;
+}
+
+void awsx::CognitoAuth::RememberDevice( const std::string & userPoolId,
+	const std::string & username,
+	const Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeResult &
+		challengeResult,
+	std::chrono::steady_clock::time_point deadline )
+{
+	using namespace Aws::CognitoIdentityProvider::Model;
+
+	ConfirmDeviceRequest confirmRequest;
+	DeviceCredentials device;
+
+	if ( !MakeConfirmDeviceRequest(
+			 challengeResult, confirmRequest, device ) ) {
+		return;
+	}
+
+	ConfirmDeviceOutcome confirmResult;
+
+	if ( !CallUntil( confirmResult,
+			 *this,
+			 *m_transport,
+			 &CognitoTransport::ConfirmDevice,
+			 &CognitoTransport::ConfirmDeviceCallable,
+			 confirmRequest,
+			 deadline )
+		|| !confirmResult.IsSuccess() ) {
+		return;
+	}
+
+	if ( confirmResult.GetResult().GetUserConfirmationNecessary() ) {
+		UpdateDeviceStatusOutcome statusResult;
+
+		if ( !CallUntil( statusResult,
+				 *this,
+				 *m_transport,
+				 &CognitoTransport::UpdateDeviceStatus,
+				 &CognitoTransport::UpdateDeviceStatusCallable,
+				 MakeRememberDeviceRequest( challengeResult ),
+				 deadline )
+			|| !statusResult.IsSuccess() ) {
+			return;
+		}
+	}
+
+	SaveDevice( userPoolId, username, device );
+}
+
+AuthResult<Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeResult>
+awsx::CognitoAuth::DeviceSrpInternal( const std::string & userPoolId,
+	const std::string & username,
+	const DeviceCredentials & device,
+	const Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeResult &
+		challengeResult,
+	std::chrono::steady_clock::time_point deadline,
+	bool & forgotten )
+{
+	using namespace Aws::CognitoIdentityProvider;
+
+	forgotten = false;
+
+	// second SRP round, proving the device instead of the password
+	auto deviceSrp = BeginSrp();
+
+	Model::RespondToAuthChallengeOutcome deviceResult;
+
+	if ( !CallUntil( deviceResult,
+			 *this,
+			 *m_transport,
+			 &CognitoTransport::RespondToAuthChallenge,
+			 &CognitoTransport::RespondToAuthChallengeCallable,
+			 MakeDeviceSrpRequest( *deviceSrp, device, challengeResult ),
+			 deadline ) ) {
+		return AuthError::Timeout( "RespondToAuthChallenge" );
+	}
+
+	if ( IsStaleDevice( deviceResult ) ) {
+		ForgetDevice( userPoolId, username );
+		forgotten = true;
+	}
+
+	if ( !deviceResult.IsSuccess() ) {
+		return ErrorOf( deviceResult );
+	}
+
+	Model::RespondToAuthChallengeOutcome verifierResult;
+
+	if ( !CallUntil( verifierResult,
+			 *this,
+			 *m_transport,
+			 &CognitoTransport::RespondToAuthChallenge,
+			 &CognitoTransport::RespondToAuthChallengeCallable,
+			 MakeDevicePasswordVerifierRequest(
+				 *deviceSrp, device, deviceResult.GetResult() ),
+			 deadline ) ) {
+		return AuthError::Timeout( "RespondToAuthChallenge" );
+	}
+
+	if ( IsStaleDevice( verifierResult )
+		|| ( !verifierResult.IsSuccess()
+			&& verifierResult.GetError().GetErrorType()
+				== CognitoIdentityProviderErrors::NOT_AUTHORIZED ) ) {
+		// the stored device password no longer matches
+		ForgetDevice( userPoolId, username );
+		forgotten = true;
+	}
+
+	if ( !verifierResult.IsSuccess() ) {
+		return ErrorOf( verifierResult );
+	}
+
+	return verifierResult.GetResult();
+}
+
+template <typename TResult>
+void awsx::CognitoAuth::Advance(
+	CognitoAuthSession & session, const TResult & result )
+{
+	using namespace Aws::CognitoIdentityProvider::Model;
+
+	if ( result.GetChallengeName() == ChallengeNameType::NOT_SET ) {
+		session.m_state = CognitoAuthSession::State::Authenticated;
+		session.m_tokens = TokensFromResult( result );
+		session.m_challengeName.clear();
+		session.m_session.clear();
+		session.m_challengeParameters.clear();
+
+		return;
+	}
+
+	auto name = ChallengeNameTypeMapper::GetNameForChallengeNameType(
+		result.GetChallengeName() );
+
+	session.m_state = CognitoAuthSession::State::ChallengeRequired;
+	session.m_challengeName = name.c_str();
+	session.m_session = result.GetSession().c_str();
+	session.m_challengeParameters.clear();
+
+	for ( auto & parameter : result.GetChallengeParameters() ) {
+		session.m_challengeParameters[parameter.first.c_str()]
+			= parameter.second.c_str();
+	}
+}
+
+AuthResult<CognitoAuthSession> awsx::CognitoAuth::SrpAuthInternal(
+	const std::string & username,
+	const std::string & userPoolId,
+	const std::string & password,
+	std::chrono::steady_clock::time_point deadline,
+	bool deviceDropped )
+{
+	using namespace Aws::CognitoIdentityProvider::Model;
+
+	// after a stale device the login starts over once, without a device,
+	// even when the store still (or again) has one
+	DeviceCredentials device;
+	bool hasDevice
+		= !deviceDropped && LoadDevice( userPoolId, username, device );
+
+	auto srp = BeginSrp();
+
+	InitiateAuthOutcome authResult;
+
+	if ( !CallUntil( authResult,
+			 *this,
+			 *m_transport,
+			 &CognitoTransport::InitiateAuth,
+			 &CognitoTransport::InitiateAuthCallable,
+			 MakeInitiateAuthRequest(
+				 *srp, username, hasDevice ? &device : nullptr ),
+			 deadline ) ) {
+		return AuthError::Timeout( "InitiateAuth" );
+	}
+
+	if ( hasDevice && IsStaleDevice( authResult ) ) {
+		ForgetDevice( userPoolId, username );
+
+		return SrpAuthInternal(
+			username, userPoolId, password, deadline, true );
+	}
+
+	if ( !authResult.IsSuccess() ) {
+		return ErrorOf( authResult );
+	}
+
+	RespondToAuthChallengeOutcome challengeResult;
+
+	if ( !CallUntil( challengeResult,
+			 *this,
+			 *m_transport,
+			 &CognitoTransport::RespondToAuthChallenge,
+			 &CognitoTransport::RespondToAuthChallengeCallable,
+			 MakePasswordVerifierRequest( *srp,
+				 username,
+				 userPoolId,
+				 password,
+				 authResult.GetResult(),
+				 hasDevice ? &device : nullptr ),
+			 deadline ) ) {
+		return AuthError::Timeout( "RespondToAuthChallenge" );
+	}
+
+	if ( hasDevice && IsStaleDevice( challengeResult ) ) {
+		ForgetDevice( userPoolId, username );
+
+		return SrpAuthInternal(
+			username, userPoolId, password, deadline, true );
+	}
+
+	if ( !challengeResult.IsSuccess() ) {
+		return ErrorOf( challengeResult );
+	}
+
+	if ( challengeResult.GetResult().GetChallengeName()
+		== ChallengeNameType::DEVICE_SRP_AUTH ) {
+		if ( !hasDevice ) {
+			return AuthError( AuthErrorCode::Service,
+				nullptr,
+				"DEVICE_SRP_AUTH: no remembered device" );
+		}
+
+		bool forgotten;
+		auto deviceResult = DeviceSrpInternal( userPoolId,
+			username,
+			device,
+			challengeResult.GetResult(),
+			deadline,
+			forgotten );
+
+		// a NOT_AUTHORIZED about the device must not reach the negative
+		// cache as a wrong password
+		if ( forgotten ) {
+			return SrpAuthInternal(
+				username, userPoolId, password, deadline, true );
+		}
+
+		if ( !deviceResult ) {
+			return deviceResult.Error();
+		}
+
+		challengeResult = deviceResult.Value();
+	}
+
+	m_transport->Touch();
+
+	CognitoAuthSession session( userPoolId, username );
+	Advance( session, challengeResult.GetResult() );
+
+	if ( session.IsAuthenticated() ) {
+		RememberDevice(
+			userPoolId, username, challengeResult.GetResult(), deadline );
+	}
+
+	return session;
+}
+
+AuthResult<CognitoAuthSession> awsx::CognitoAuth::PasswordAuthInternal(
+	const std::string & username,
+	const std::string & userPoolId,
+	const std::string & password,
+	std::chrono::steady_clock::time_point deadline )
+{
+	using namespace Aws::CognitoIdentityProvider::Model;
+
+	CognitoAuthSession session( userPoolId, username );
+
+	if ( m_options.strategy == AuthStrategy::AdminUserPassword ) {
+		AdminInitiateAuthOutcome authResult;
+
+		if ( !CallUntil( authResult,
+				 *this,
+				 *m_transport,
+				 &CognitoTransport::AdminInitiateAuth,
+				 &CognitoTransport::AdminInitiateAuthCallable,
+				 MakeAdminPasswordAuthRequest(
+					 username, userPoolId, password ),
+				 deadline ) ) {
+			return AuthError::Timeout( "AdminInitiateAuth" );
+		}
+
+		if ( !authResult.IsSuccess() ) {
+			return ErrorOf( authResult );
+		}
+
+		Advance( session, authResult.GetResult() );
+	}
+	else {
+		InitiateAuthOutcome authResult;
+
+		if ( !CallUntil( authResult,
+				 *this,
+				 *m_transport,
+				 &CognitoTransport::InitiateAuth,
+				 &CognitoTransport::InitiateAuthCallable,
+				 MakePasswordAuthRequest( username, password ),
+				 deadline ) ) {
+			return AuthError::Timeout( "InitiateAuth" );
+		}
+
+		if ( !authResult.IsSuccess() ) {
+			return ErrorOf( authResult );
+		}
+
+		Advance( session, authResult.GetResult() );
+	}
+
+	m_transport->Touch();
+
+	return session;
+}
+
+AuthResult<CognitoAuthSession>
+awsx::CognitoAuth::AuthenticateWithUserPoolInternal(
+	const std::string & username,
+	const std::string & userPoolId,
+	const std::string & password,
+	std::chrono::steady_clock::time_point deadline )
+{
+	AuthError rejected;
+
+	if ( IsRejected( userPoolId, username, password, rejected ) ) {
+		return rejected;
+	}
+
+	auto session = m_options.strategy == AuthStrategy::Srp
+		? SrpAuthInternal( username, userPoolId, password, deadline, false )
+		: PasswordAuthInternal( username, userPoolId, password, deadline );
+
+	RecordLogin( userPoolId,
+		username,
+		password,
+		session ? nullptr : &session.Error() );
+
+	return session;
+}
+
+bool awsx::CognitoAuth::IsRejected( const std::string & userPoolId,
+	const std::string & username,
+	const std::string & password,
+	AuthError & error ) const
+{
+	auto & cache = m_options.negativeCache;
+
+	return cache && cache->IsRejected( userPoolId, username, password, error );
+}
+
+void awsx::CognitoAuth::RecordLogin( const std::string & userPoolId,
+	const std::string & username,
+	const std::string & password,
+	const AuthError * error ) const
+{
+	auto & cache = m_options.negativeCache;
+
+	if ( !cache ) {
+		return;
+	}
+
+	if ( !error ) {
+		cache->Accept( userPoolId, username, password );
+	}
+	else if ( error->GetCode() == AuthErrorCode::NotAuthorized
+		|| error->GetCode() == AuthErrorCode::UserNotFound ) {
+		cache->Reject( userPoolId, username, password, *error );
+	}
+}
+
+AuthError awsx::CognitoAuth::MakeError(
+	Aws::Client::AWSError<
+		Aws::CognitoIdentityProvider::CognitoIdentityProviderErrors> &&
+		error )
+{
+	return TakeError( error );
+}
+
+AuthError awsx::CognitoAuth::MakeError(
+	Aws::Client::AWSError<Aws::CognitoIdentity::CognitoIdentityErrors> &&
+		error )
+{
+	return TakeError( error );
+}
+
+AuthResult<CognitoLogin> awsx::CognitoAuth::TryLogin(
+	const std::string & username,
+	const std::string & password,
+	const std::string & userPoolId,
+	const std::string & identityPoolId )
+{
+	auto deadline = LoginDeadline();
+
+	auto session = AuthenticateWithUserPoolInternal(
+		username, userPoolId, password, deadline );
+
+	if ( !session ) {
+		return session.Error();
+	}
+
+	if ( !session.Value().IsAuthenticated() ) {
+		return AuthError::ChallengePending(
+			session.Value().GetChallengeName() );
+	}
+
+	auto identity = CredentialsInternal( session.Value().m_tokens.GetIdToken(),
+		userPoolId,
+		identityPoolId,
+		std::string(),
+		deadline );
+
+	if ( !identity ) {
+		return identity.Error();
+	}
+
+	CognitoLogin login;
+	login.tokens = std::move( session.Value().m_tokens );
+	login.identity = std::move( identity.Value() );
+
+	return login;
+}
+
+CognitoLogin awsx::CognitoAuth::Login( const std::string & username,
+	const std::string & password,
+	const std::string & userPoolId,
+	const std::string & identityPoolId )
+{
+	return TryLogin( username, password, userPoolId, identityPoolId ).Value();
+}
+
+AuthResult<IdentityCredentials>
+awsx::CognitoAuth::TryGetIdentityCredentials( const std::string & idToken,
+	const std::string & userPoolId,
+	const std::string & identityPoolId,
+	const std::string & identityId )
+{
+	return CredentialsInternal(
+		idToken, userPoolId, identityPoolId, identityId, LoginDeadline() );
+}
+
+IdentityCredentials awsx::CognitoAuth::GetIdentityCredentials(
+	const std::string & idToken,
+	const std::string & userPoolId,
+	const std::string & identityPoolId,
+	const std::string & identityId )
+{
+	return TryGetIdentityCredentials(
+		idToken, userPoolId, identityPoolId, identityId )
+		.Value();
+}
+
+AuthResult<Aws::Auth::AWSCredentials> awsx::CognitoAuth::TryAuthenticate(
+	const std::string & username,
+	const std::string & password,
+	const std::string & userPoolId,
+	const std::string & identityPoolId )
+{
+	auto login = TryLogin( username, password, userPoolId, identityPoolId );
+
+	if ( !login ) {
+		return login.Error();
+	}
+
+	return login.Value().identity.credentials;
+}
+
+AuthResult<Aws::Auth::AWSCredentials> awsx::CognitoAuth::TryAuthenticate(
+	const CognitoAuthSession & session, const std::string & identityPoolId )
+{
+	if ( !session.IsAuthenticated() ) {
+		return AuthError::ChallengePending( session.GetChallengeName() );
+	}
+
+	auto identity = CredentialsInternal( session.GetTokens().GetIdToken(),
+		session.GetUserPoolId(),
+		identityPoolId,
+		std::string(),
+		LoginDeadline() );
+
+	if ( !identity ) {
+		return identity.Error();
+	}
+
+	return identity.Value().credentials;
+}
+
+AuthResult<CognitoTokens> awsx::CognitoAuth::TryAuthenticateWithUserPool(
+	const std::string & username,
+	const std::string & password,
+	const std::string & userPoolId )
+{
+	auto session = AuthenticateWithUserPoolInternal(
+		username, userPoolId, password, LoginDeadline() );
+
+	if ( !session ) {
+		return session.Error();
+	}
+
+	if ( !session.Value().IsAuthenticated() ) {
+		return AuthError::ChallengePending(
+			session.Value().GetChallengeName() );
+	}
+
+	return session.Value().m_tokens;
+}
+
+AuthResult<CognitoAuthSession> awsx::CognitoAuth::TryBeginAuthentication(
+	const std::string & username,
+	const std::string & password,
+	const std::string & userPoolId )
+{
+	return AuthenticateWithUserPoolInternal(
+		username, userPoolId, password, LoginDeadline() );
+}
+
+Aws::Auth::AWSCredentials CognitoAuth::Authenticate(
+	const std::string & username,
+	const std::string & password,
+	const std::string & userPoolId,
+	const std::string & identityPoolId )
+{
+	return TryAuthenticate( username, password, userPoolId, identityPoolId )
+		.Value();
+}
+
+Aws::Auth::AWSCredentials awsx::CognitoAuth::Authenticate(
+	const CognitoAuthSession & session, const std::string & identityPoolId )
+{
+	return TryAuthenticate( session, identityPoolId ).Value();
+}
+
+AuthResult<IdentityCredentials> awsx::CognitoAuth::CredentialsInternal(
+	const std::string & idToken,
+	const std::string & userPoolId,
+	const std::string & identityPoolId,
+	const std::string & identityId,
+	std::chrono::steady_clock::time_point deadline )
+{
+	std::string resolvedId = identityId;
+	bool inTime;
+
+	if ( resolvedId.empty() ) {
+		auto idRequest
+			= MakeGetIdRequest( idToken, userPoolId, identityPoolId );
+
+		typedef Aws::CognitoIdentity::Model::GetIdOutcome IdOutcome;
+		IdOutcome idResult;
+
+		if ( m_options.hedging.enabled ) {
+			inTime = Hedged( idResult,
+				*this,
+				HedgedApi::GetId,
+				[&]( std::shared_ptr<HedgedCall<IdOutcome>> call ) {
+					m_transport->GetIdAsync( idRequest,
+						[call]( const IdOutcome & outcome ) {
+							call->Complete( outcome );
+						} );
+				},
+				deadline );
+		}
+		else {
+			inTime = CallUntil( idResult,
+				*this,
+				*m_transport,
+				&CognitoTransport::GetId,
+				&CognitoTransport::GetIdCallable,
+				idRequest,
+				deadline );
+		}
+
+		if ( !inTime ) {
+			return AuthError::Timeout( "GetId" );
+		}
+
+		if ( !idResult.IsSuccess() ) {
+			return ErrorOf( idResult );
+		}
+
+		resolvedId = idResult.GetResult().GetIdentityId().c_str();
+	}
+
+	auto credForIdRequest
+		= MakeGetCredentialsRequest( resolvedId, idToken, userPoolId );
+
+	typedef Aws::CognitoIdentity::Model::GetCredentialsForIdentityOutcome
+		CredentialsOutcome;
+
+	CredentialsOutcome credForIdResult;
+
+	if ( m_options.hedging.enabled ) {
+		inTime = Hedged( credForIdResult,
+			*this,
+			HedgedApi::GetCredentialsForIdentity,
+			[&]( std::shared_ptr<HedgedCall<CredentialsOutcome>> call ) {
+				m_transport->GetCredentialsForIdentityAsync(
+					credForIdRequest,
+					[call]( const CredentialsOutcome & outcome ) {
+						call->Complete( outcome );
+					} );
+			},
+			deadline );
+	}
+	else {
+		inTime = CallUntil( credForIdResult,
+			*this,
+			*m_transport,
+			&CognitoTransport::GetCredentialsForIdentity,
+			&CognitoTransport::GetCredentialsForIdentityCallable,
+			credForIdRequest,
+			deadline );
+	}
+
+	if ( !inTime ) {
+		return AuthError::Timeout( "GetCredentialsForIdentity" );
+	}
+
+	if ( !credForIdResult.IsSuccess() ) {
+		return ErrorOf( credForIdResult );
+	}
+
+	m_transport->Touch();
+
+	auto identity = MakeIdentityCredentials( credForIdResult.GetResult() );
+
+	if ( identity.identityId.empty() ) {
+		identity.identityId = resolvedId;
+	}
+
+	return identity;
+}
+
+CognitoTokens awsx::CognitoAuth::AuthenticateWithUserPool(
+	const std::string & username,
+	const std::string & password,
+	const std::string & userPoolId )
+{
+	return TryAuthenticateWithUserPool( username, password, userPoolId )
+		.Value();
+}
+
+CognitoAuthSession awsx::CognitoAuth::BeginAuthentication(
+	const std::string & username,
+	const std::string & password,
+	const std::string & userPoolId )
+{
+	return TryBeginAuthentication( username, password, userPoolId ).Value();
+}
+
+void awsx::CognitoAuth::RespondToChallenge( CognitoAuthSession & session,
+	const std::map<std::string, std::string> & responses )
+{
+	using namespace Aws::CognitoIdentityProvider::Model;
+
+	if ( m_options.strategy == AuthStrategy::AdminUserPassword ) {
+		throw Exception( "AuthStrategy::AdminUserPassword challenges need "
+			"AdminRespondToAuthChallenge" );
+	}
+
+	auto deadline = LoginDeadline();
+
+	RespondToAuthChallengeOutcome challengeResult;
+
+	if ( !CallUntil( challengeResult,
+			 *this,
+			 *m_transport,
+			 &CognitoTransport::RespondToAuthChallenge,
+			 &CognitoTransport::RespondToAuthChallengeCallable,
+			 MakeChallengeResponseRequest( session, responses ),
+			 deadline ) ) {
+		AuthError::Timeout( "RespondToAuthChallenge" ).Throw();
+	}
+
+	if ( !challengeResult.IsSuccess() ) {
+		ErrorOf( challengeResult ).Throw();
+	}
+
+	if ( challengeResult.GetResult().GetChallengeName()
+		== ChallengeNameType::DEVICE_SRP_AUTH ) {
+		DeviceCredentials device;
+
+		if ( !LoadDevice( session.m_userPoolId, session.m_username, device ) ) {
+			throw Exception( "DEVICE_SRP_AUTH: no remembered device" );
+		}
+
+		bool forgotten;
+		auto deviceResult = DeviceSrpInternal( session.m_userPoolId,
+			session.m_username,
+			device,
+			challengeResult.GetResult(),
+			deadline,
+			forgotten );
+
+		// the pool's session went with the device
+		if ( forgotten ) {
+			throw DeviceForgottenException(
+				"DEVICE_SRP_AUTH: the pool no longer knows the remembered "
+				"device, it was forgotten; restart the login" );
+		}
+
+		challengeResult = deviceResult.Value();
+	}
+
+	m_transport->Touch();
+
+	Advance( session, challengeResult.GetResult() );
+
+	if ( session.IsAuthenticated() ) {
+		RememberDevice( session.m_userPoolId,
+			session.m_username,
+			challengeResult.GetResult(),
+			deadline );
+	}
+}
+
+void awsx::CognitoAuth::RespondWithNewPassword( CognitoAuthSession & session,
+	const std::string & newPassword,
+	const std::map<std::string, std::string> & attributes )
+{
+	if ( session.m_challengeName != "NEW_PASSWORD_REQUIRED" ) {
+		throw Exception(
+			session.m_challengeName + ": not a new password challenge" );
+	}
+
+	std::map<std::string, std::string> responses;
+	responses["NEW_PASSWORD"] = newPassword;
+
+	for ( auto & attribute : attributes ) {
+		responses["userAttributes." + attribute.first] = attribute.second;
+	}
+
+	RespondToChallenge( session, responses );
+}
+
+void awsx::CognitoAuth::RespondWithMfaCode(
+	CognitoAuthSession & session, const std::string & code )
+{
+	std::map<std::string, std::string> responses;
+
+	if ( session.m_challengeName == "SMS_MFA" ) {
+		responses["SMS_MFA_CODE"] = code;
+	}
+	else if ( session.m_challengeName == "SOFTWARE_TOKEN_MFA" ) {
+		responses["SOFTWARE_TOKEN_MFA_CODE"] = code;
+	}
+	else {
+		throw Exception(
+			session.m_challengeName + ": not an MFA code challenge" );
+	}
+
+	RespondToChallenge( session, responses );
+}
+
+CognitoTokens awsx::CognitoAuth::RefreshWithUserPool(
+	const std::string & username,
+	const std::string & refreshToken,
+	const std::string & userPoolId )
+{
+	DeviceCredentials device;
+	bool hasDevice = LoadDevice( userPoolId, username, device );
+
+
+	Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome authResult;
+
+	if ( !CallUntil( authResult,
+			 *this,
+			 *m_transport,
+			 &CognitoTransport::InitiateAuth,
+			 &CognitoTransport::InitiateAuthCallable,
+			 MakeRefreshRequest(
+				 refreshToken, username, hasDevice ? &device : nullptr ),
+			 LoginDeadline() ) ) {
+		AuthError::Timeout( "InitiateAuth" ).Throw();
+	}
+
+	if ( !authResult.IsSuccess() ) {
+		ErrorOf( authResult ).Throw();
+	}
+
+	m_transport->Touch();
+
+	auto tokens = MakeTokens( authResult.GetResult() );
+
+	if ( tokens.GetRefreshToken().empty() ) {
+		// the pool only hands out a new refresh token when rotation is on
+		tokens = CognitoTokens( tokens.GetAccessToken(),
+			tokens.GetIdToken(),
+			refreshToken,
+			tokens.GetExpiresIn() );
+	}
+
+	return tokens;
 }
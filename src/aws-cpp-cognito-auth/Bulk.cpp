@@ -0,0 +1,580 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "aws/cognito-idp/CognitoIdentityProviderClient.h"
+#include "aws/cognito-idp/model/AdminInitiateAuthRequest.h"
+#include "aws/cognito-idp/model/InitiateAuthRequest.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeRequest.h"
+
+#include "aws/cognito-identity/CognitoIdentityClient.h"
+#include "aws/cognito-identity/model/GetCredentialsForIdentityRequest.h"
+#include "aws/cognito-identity/model/GetIdRequest.h"
+
+#include "include/Srp.hpp"
+
+#include "../../include/aws-cpp-cognito-auth/Bulk.hpp"
+
+
+using namespace awsx;
+
+
+// Hands out a fixed number of request slots, queueing the starts that do
+// not get one. A released slot goes straight to the oldest waiter.
+class InFlightLimiter {
+protected:
+	std::mutex m_mutex;
+	size_t m_limit;
+	size_t m_inFlight;
+	std::deque<std::function<void()>> m_waiting;
+
+public:
+	InFlightLimiter( size_t limit )
+		: m_limit( limit > 0 ? limit : 1 )
+		, m_inFlight( 0 )
+	{
+	}
+
+	void Acquire( std::function<void()> start )
+	{
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+
+			if ( m_inFlight == m_limit ) {
+				m_waiting.push_back( std::move( start ) );
+				return;
+			}
+
+			++m_inFlight;
+		}
+
+		start();
+	}
+
+	void Release()
+	{
+		std::function<void()> next;
+
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+
+			if ( m_waiting.empty() ) {
+				--m_inFlight;
+				return;
+			}
+
+			next = std::move( m_waiting.front() );
+			m_waiting.pop_front();
+		}
+
+		next();
+	}
+};
+
+struct BulkJob {
+	size_t index;
+	const BulkLoginEntry * entry;
+	std::chrono::steady_clock::time_point started;
+	std::chrono::steady_clock::time_point deadline;
+
+	// the negative cache knows how the user pool login went
+	bool recorded;
+
+	std::shared_ptr<Srp> srp;
+	BulkLoginResult result;
+};
+
+// A failure outside the service, e.g. of the SRP math or a challenge the
+// login cannot answer.
+static AuthError LocalError( const std::exception & x )
+{
+	return AuthError(
+		AuthErrorCode::Service, nullptr, std::string( x.what() ) );
+}
+
+// State of one BulkAuthenticator::Run() call. Every login is a chain of
+// CPU steps on the worker pool and SDK async calls whose handlers pick up
+// the next step.
+class BulkRun : public std::enable_shared_from_this<BulkRun> {
+protected:
+	CognitoAuth & m_auth;
+	Executor & m_cpu;
+	InFlightLimiter m_limiter;
+	BulkAuthenticator::ResultHandler m_onResult;
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	size_t m_remaining;
+	size_t m_failed;
+	std::vector<std::chrono::microseconds> m_latencies;
+
+protected:
+	void Finish( std::shared_ptr<BulkJob> job, const AuthError * error )
+	{
+		job->result.index = job->index;
+		job->result.success = error == nullptr;
+
+		if ( error ) {
+			job->result.error = *error;
+
+			if ( !job->recorded ) {
+				m_auth.RecordLogin( job->entry->userPoolId,
+					job->entry->username,
+					job->entry->password,
+					error );
+			}
+		}
+
+		job->result.latency
+			= std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - job->started );
+
+		std::lock_guard<std::mutex> lock( m_mutex );
+
+		m_latencies.push_back( job->result.latency );
+
+		if ( !job->result.success ) {
+			++m_failed;
+		}
+
+		if ( m_onResult ) {
+			m_onResult( job->result );
+		}
+
+		if ( --m_remaining == 0 ) {
+			m_condition.notify_all();
+		}
+	}
+
+	void Fail( std::shared_ptr<BulkJob> job, const AuthError & error )
+	{
+		Finish( job, &error );
+	}
+
+	// Whether the login may go on after the call: false, with the job
+	// failed, when the call failed or the login ran past its deadline.
+	template <typename TOutcome>
+	bool Succeeded( std::shared_ptr<BulkJob> job,
+		const char * operation,
+		const TOutcome & outcome )
+	{
+		if ( std::chrono::steady_clock::now() > job->deadline ) {
+			Fail( job, AuthError::Timeout( operation ) );
+			return false;
+		}
+
+		if ( !outcome.IsSuccess() ) {
+			auto error = outcome.GetError();
+			Fail( job, CognitoAuth::MakeError( std::move( error ) ) );
+			return false;
+		}
+
+		return true;
+	}
+
+	// Runs a CPU step on the worker pool, turning exceptions into a failed
+	// login.
+	void OnCpu( std::shared_ptr<BulkJob> job,
+		std::function<void( std::shared_ptr<BulkJob> )> step )
+	{
+		auto self = shared_from_this();
+
+		m_cpu.Submit( [self, job, step]() {
+			try {
+				step( job );
+			}
+			catch ( const std::exception & x ) {
+				self->Fail( job, LocalError( x ) );
+			}
+		} );
+	}
+
+	// Sends a call once a request slot is free. Without a deadline the
+	// transport retries it; with one the transport sends it once and a
+	// retryable failure is resent here while the budget lasts.
+	template <typename TOutcome>
+	void Send( std::shared_ptr<BulkJob> job,
+		std::function<void( std::function<void( const TOutcome & )> )> launch,
+		std::function<void( const TOutcome & )> done,
+		long attempt = 0 )
+	{
+		auto self = shared_from_this();
+
+		m_limiter.Acquire( [self, job, launch, done, attempt]() {
+			launch( [self, job, launch, done, attempt](
+						const TOutcome & outcome ) {
+				self->m_limiter.Release();
+
+				std::chrono::steady_clock::time_point retryAt;
+
+				if ( !outcome.IsSuccess()
+					&& self->m_auth.RetryBefore( job->deadline,
+						attempt,
+						outcome.GetError().ShouldRetry(),
+						retryAt ) ) {
+					// on the transport thread, as its own backoff
+					std::this_thread::sleep_until( retryAt );
+					self->Send( job, launch, done, attempt + 1 );
+					return;
+				}
+
+				done( outcome );
+			} );
+		} );
+	}
+
+	void InitiateAuth( std::shared_ptr<BulkJob> job )
+	{
+		using Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome;
+
+		job->started = std::chrono::steady_clock::now();
+		job->srp = m_auth.BeginSrp();
+
+		auto self = shared_from_this();
+		auto request = m_auth.MakeInitiateAuthRequest(
+			*job->srp, job->entry->username );
+
+		Send<InitiateAuthOutcome>( job,
+			[self, request](
+				std::function<void( const InitiateAuthOutcome & )> done ) {
+				self->m_auth.GetTransport()->InitiateAuthAsync( request, done );
+			},
+			[self, job]( const InitiateAuthOutcome & outcome ) {
+				if ( !self->Succeeded( job, "InitiateAuth", outcome ) ) {
+					return;
+				}
+
+				auto authResult = outcome.GetResult();
+
+				self->OnCpu(
+					job, [self, authResult]( std::shared_ptr<BulkJob> job ) {
+						self->RespondToAuthChallenge( job, authResult );
+					} );
+			} );
+	}
+
+	void RespondToAuthChallenge( std::shared_ptr<BulkJob> job,
+		const Aws::CognitoIdentityProvider::Model::InitiateAuthResult &
+			authResult )
+	{
+		using Aws::CognitoIdentityProvider::Model::
+			RespondToAuthChallengeOutcome;
+
+		auto self = shared_from_this();
+		auto request = m_auth.MakePasswordVerifierRequest( *job->srp,
+			job->entry->username,
+			job->entry->userPoolId,
+			job->entry->password,
+			authResult );
+
+		job->srp.reset();
+
+		Send<RespondToAuthChallengeOutcome>( job,
+			[self, request](
+				std::function<void( const RespondToAuthChallengeOutcome & )>
+					done ) {
+				self->m_auth.GetTransport()->RespondToAuthChallengeAsync(
+					request, done );
+			},
+			[self, job]( const RespondToAuthChallengeOutcome & outcome ) {
+				self->UserPoolDone( job, "RespondToAuthChallenge", outcome );
+			} );
+	}
+
+	// AuthStrategy::UserPassword, the whole user pool login is one call
+	void PasswordAuth( std::shared_ptr<BulkJob> job )
+	{
+		using Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome;
+
+		job->started = std::chrono::steady_clock::now();
+
+		auto self = shared_from_this();
+		auto request = m_auth.MakePasswordAuthRequest(
+			job->entry->username, job->entry->password );
+
+		Send<InitiateAuthOutcome>( job,
+			[self, request](
+				std::function<void( const InitiateAuthOutcome & )> done ) {
+				self->m_auth.GetTransport()->InitiateAuthAsync( request, done );
+			},
+			[self, job]( const InitiateAuthOutcome & outcome ) {
+				self->UserPoolDone( job, "InitiateAuth", outcome );
+			} );
+	}
+
+	// AuthStrategy::AdminUserPassword
+	void AdminPasswordAuth( std::shared_ptr<BulkJob> job )
+	{
+		using Aws::CognitoIdentityProvider::Model::AdminInitiateAuthOutcome;
+
+		job->started = std::chrono::steady_clock::now();
+
+		auto self = shared_from_this();
+		auto request = m_auth.MakeAdminPasswordAuthRequest( job->entry->username,
+			job->entry->userPoolId,
+			job->entry->password );
+
+		Send<AdminInitiateAuthOutcome>( job,
+			[self, request](
+				std::function<void( const AdminInitiateAuthOutcome & )> done ) {
+				self->m_auth.GetTransport()->AdminInitiateAuthAsync(
+					request, done );
+			},
+			[self, job]( const AdminInitiateAuthOutcome & outcome ) {
+				self->UserPoolDone( job, "AdminInitiateAuth", outcome );
+			} );
+	}
+
+	// The last call of the user pool login.
+	template <typename TOutcome>
+	void UserPoolDone( std::shared_ptr<BulkJob> job,
+		const char * operation,
+		const TOutcome & outcome )
+	{
+		if ( !Succeeded( job, operation, outcome ) ) {
+			return;
+		}
+
+		CognitoTokens tokens;
+
+		try {
+			tokens = m_auth.MakeTokens( outcome.GetResult() );
+		}
+		catch ( const std::exception & x ) {
+			// e.g. an MFA challenge, bulk logins cannot answer it
+			Fail( job, LocalError( x ) );
+			return;
+		}
+
+		Authenticated( job, tokens );
+	}
+
+	void Authenticated(
+		std::shared_ptr<BulkJob> job, const CognitoTokens & tokens )
+	{
+		job->result.tokens = tokens;
+
+		m_auth.RecordLogin( job->entry->userPoolId,
+			job->entry->username,
+			job->entry->password,
+			nullptr );
+		job->recorded = true;
+
+		if ( job->entry->identityPoolId.empty() ) {
+			Finish( job, nullptr );
+		}
+		else {
+			GetId( job );
+		}
+	}
+
+	void GetId( std::shared_ptr<BulkJob> job )
+	{
+		using Aws::CognitoIdentity::Model::GetIdOutcome;
+
+		auto self = shared_from_this();
+		auto request = m_auth.MakeGetIdRequest( job->result.tokens.GetIdToken(),
+			job->entry->userPoolId,
+			job->entry->identityPoolId );
+
+		Send<GetIdOutcome>( job,
+			[self, request](
+				std::function<void( const GetIdOutcome & )> done ) {
+				self->m_auth.GetTransport()->GetIdAsync( request, done );
+			},
+			[self, job]( const GetIdOutcome & outcome ) {
+				if ( !self->Succeeded( job, "GetId", outcome ) ) {
+					return;
+				}
+
+				self->GetCredentialsForIdentity(
+					job, outcome.GetResult().GetIdentityId().c_str() );
+			} );
+	}
+
+	void GetCredentialsForIdentity(
+		std::shared_ptr<BulkJob> job, const std::string & identityId )
+	{
+		using Aws::CognitoIdentity::Model::GetCredentialsForIdentityOutcome;
+
+		auto self = shared_from_this();
+		auto request = m_auth.MakeGetCredentialsRequest( identityId,
+			job->result.tokens.GetIdToken(),
+			job->entry->userPoolId );
+
+		Send<GetCredentialsForIdentityOutcome>( job,
+			[self, request]( std::function<void(
+					const GetCredentialsForIdentityOutcome & )> done ) {
+				self->m_auth.GetTransport()->GetCredentialsForIdentityAsync(
+					request, done );
+			},
+			[self, job]( const GetCredentialsForIdentityOutcome & outcome ) {
+				if ( !self->Succeeded(
+						 job, "GetCredentialsForIdentity", outcome ) ) {
+					return;
+				}
+
+				job->result.credentials
+					= CognitoAuth::MakeCredentials( outcome.GetResult() );
+
+				self->Finish( job, nullptr );
+			} );
+	}
+
+public:
+	BulkRun( CognitoAuth & auth,
+		Executor & cpu,
+		size_t maxInFlight,
+		const BulkAuthenticator::ResultHandler & onResult,
+		size_t count )
+		: m_auth( auth )
+		, m_cpu( cpu )
+		, m_limiter( maxInFlight )
+		, m_onResult( onResult )
+		, m_remaining( count )
+		, m_failed( 0 )
+	{
+		m_latencies.reserve( count );
+	}
+
+	void Start( size_t index, const BulkLoginEntry & entry )
+	{
+		auto job = std::make_shared<BulkJob>();
+		job->index = index;
+		job->entry = &entry;
+		job->started = std::chrono::steady_clock::now();
+		job->recorded = false;
+
+		auto timeout = m_auth.GetOptions().loginTimeout;
+		job->deadline = timeout.count() > 0
+			? job->started + timeout
+			: std::chrono::steady_clock::time_point::max();
+
+		AuthError rejected;
+
+		if ( m_auth.IsRejected( entry.userPoolId,
+				 entry.username,
+				 entry.password,
+				 rejected ) ) {
+			job->recorded = true;
+			Fail( job, rejected );
+			return;
+		}
+
+		if ( m_auth.GetStrategy() == AuthStrategy::UserPassword ) {
+			PasswordAuth( job );
+		}
+		else if ( m_auth.GetStrategy() == AuthStrategy::AdminUserPassword ) {
+			AdminPasswordAuth( job );
+		}
+		else {
+			// SRP A generation is CPU work, start on the worker pool
+			auto self = shared_from_this();
+
+			OnCpu( job, [self]( std::shared_ptr<BulkJob> job ) {
+				self->InitiateAuth( job );
+			} );
+		}
+	}
+
+	BulkLoginStats Wait( std::chrono::steady_clock::time_point started )
+	{
+		std::unique_lock<std::mutex> lock( m_mutex );
+		m_condition.wait( lock, [this]() { return m_remaining == 0; } );
+
+		BulkLoginStats stats;
+		stats.succeeded = m_latencies.size() - m_failed;
+		stats.failed = m_failed;
+		stats.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - started );
+
+		stats.loginsPerSecond = stats.elapsed.count() > 0
+			? m_latencies.size() * 1e6 / stats.elapsed.count()
+			: 0.0;
+
+		stats.p50Latency = stats.p99Latency = stats.maxLatency
+			= std::chrono::microseconds( 0 );
+
+		if ( !m_latencies.empty() ) {
+			std::sort( m_latencies.begin(), m_latencies.end() );
+
+			stats.p50Latency = m_latencies[( m_latencies.size() - 1 ) / 2];
+			stats.p99Latency
+				= m_latencies[( m_latencies.size() - 1 ) * 99 / 100];
+			stats.maxLatency = m_latencies.back();
+		}
+
+		return stats;
+	}
+};
+
+
+static CognitoAuthOptions BulkAuthOptions( const BulkOptions & options )
+{
+	CognitoAuthOptions authOptions( options.authOptions );
+
+	// every in-flight request blocks one SDK executor thread
+	authOptions.asyncThreads = options.maxInFlight;
+	authOptions.maxConnections = static_cast<unsigned>( options.maxInFlight );
+
+	return authOptions;
+}
+
+static CpuExecutorOptions BulkCpuOptions( const BulkOptions & options )
+{
+	CpuExecutorOptions cpuOptions;
+	cpuOptions.threads = options.cpuWorkers;
+	cpuOptions.cpus = options.cpuAffinity;
+
+	return cpuOptions;
+}
+
+awsx::BulkAuthenticator::BulkAuthenticator( const std::string & regionId,
+	const std::string & clientId,
+	const BulkOptions & options )
+	: m_options( options )
+	, m_auth( regionId, clientId, BulkAuthOptions( options ) )
+	, m_cpu( BulkCpuOptions( options ) )
+{
+}
+
+BulkLoginStats awsx::BulkAuthenticator::Run(
+	const std::vector<BulkLoginEntry> & entries, const ResultHandler & onResult )
+{
+	auto started = std::chrono::steady_clock::now();
+	auto run = std::make_shared<BulkRun>(
+		m_auth, m_cpu, m_options.maxInFlight, onResult, entries.size() );
+
+	for ( size_t i = 0; i < entries.size(); i++ ) {
+		run->Start( i, entries[i] );
+	}
+
+	return run->Wait( started );
+}
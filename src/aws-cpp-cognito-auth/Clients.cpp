@@ -0,0 +1,251 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "aws/core/http/HttpTypes.h"
+#include "aws/core/http/URI.h"
+
+#include "aws/cognito-idp/CognitoIdentityProviderEndpoint.h"
+#include "aws/cognito-idp/model/AdminInitiateAuthRequest.h"
+#include "aws/cognito-idp/model/ConfirmDeviceRequest.h"
+#include "aws/cognito-idp/model/InitiateAuthRequest.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeRequest.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusRequest.h"
+
+#include "aws/cognito-identity/CognitoIdentityEndpoint.h"
+#include "aws/cognito-identity/model/GetCredentialsForIdentityRequest.h"
+#include "aws/cognito-identity/model/GetIdRequest.h"
+
+#include "../../include/aws-cpp-cognito-auth/Clients.hpp"
+
+
+using namespace awsx;
+using namespace Aws::CognitoIdentityProvider::Model;
+using namespace Aws::CognitoIdentity::Model;
+
+
+typedef Aws::CognitoIdentityProvider::CognitoIdentityProviderClient IdpClient;
+typedef Aws::CognitoIdentity::CognitoIdentityClient IdentityClient;
+
+// SDK client that can also send a request naming no operation. Such a GET
+// of the service root reaches no API, so it counts against no request
+// quota, yet leaves a connection in the client's own pool.
+template <typename TClient>
+class WarmableClient : public TClient {
+public:
+	WarmableClient( const Aws::Client::ClientConfiguration & config )
+		: TClient( config )
+	{
+	}
+
+	void Ping( const Aws::Client::ClientConfiguration & config,
+		const Aws::String & endpoint ) const
+	{
+		// endpointOverride is used the way the SDK clients use it
+		Aws::String uri = config.endpointOverride.empty()
+			? endpoint
+			: config.endpointOverride;
+
+		if ( uri.find( "://" ) == Aws::String::npos ) {
+			uri = Aws::String(
+					  Aws::Http::SchemeMapper::ToString( config.scheme ) )
+				+ "://" + uri;
+		}
+
+		// the reply is an error, the round trip is what counts
+		this->MakeRequest(
+			Aws::Http::URI( uri ), Aws::Http::HttpMethod::HTTP_GET );
+	}
+};
+
+// Adapts a transport handler to the four argument handler of the SDK.
+template <typename TClient, typename TRequest, typename TOutcome>
+static std::function<void( const TClient *,
+	const TRequest &,
+	const TOutcome &,
+	const std::shared_ptr<const Aws::Client::AsyncCallerContext> & )>
+SdkHandler( const std::function<void( const TOutcome & )> & handler )
+{
+	return [handler]( const TClient *,
+			   const TRequest &,
+			   const TOutcome & outcome,
+			   const std::shared_ptr<
+				   const Aws::Client::AsyncCallerContext> & ) {
+		handler( outcome );
+	};
+}
+
+
+awsx::CognitoClients::CognitoClients(
+	const Aws::Client::ClientConfiguration & clientConfig )
+	: m_clientConfig( clientConfig )
+{
+}
+
+awsx::CognitoClients::~CognitoClients()
+{
+	StopKeepAlive();
+}
+
+const std::shared_ptr<IdpClient> & awsx::CognitoClients::IdentityProvider()
+	const
+{
+	std::call_once( m_cipOnce, [this]() {
+		m_cipClient = std::make_shared<WarmableClient<IdpClient>>(
+			m_clientConfig );
+	} );
+
+	return m_cipClient;
+}
+
+const std::shared_ptr<IdentityClient> & awsx::CognitoClients::Identity() const
+{
+	std::call_once( m_ciOnce, [this]() {
+		m_ciClient = std::make_shared<WarmableClient<IdentityClient>>(
+			m_clientConfig );
+	} );
+
+	return m_ciClient;
+}
+
+void awsx::CognitoClients::Warmup()
+{
+	// both clients are always made as WarmableClient
+	auto cipClient = std::static_pointer_cast<const WarmableClient<IdpClient>>(
+		IdentityProvider() );
+	auto ciClient
+		= std::static_pointer_cast<const WarmableClient<IdentityClient>>(
+			Identity() );
+
+	auto cipPing = std::async( std::launch::async, [this, cipClient]() {
+		cipClient->Ping( m_clientConfig,
+			Aws::CognitoIdentityProvider::CognitoIdentityProviderEndpoint::
+				ForRegion( m_clientConfig.region ) );
+	} );
+
+	ciClient->Ping( m_clientConfig,
+		Aws::CognitoIdentity::CognitoIdentityEndpoint::ForRegion(
+			m_clientConfig.region ) );
+	cipPing.wait();
+
+	Touch();
+}
+
+InitiateAuthOutcome awsx::CognitoClients::InitiateAuth(
+	const InitiateAuthRequest & request ) const
+{
+	return IdentityProvider()->InitiateAuth( request );
+}
+
+void awsx::CognitoClients::InitiateAuthAsync(
+	const InitiateAuthRequest & request,
+	const InitiateAuthHandler & handler ) const
+{
+	IdentityProvider()->InitiateAuthAsync( request,
+		SdkHandler<IdpClient, InitiateAuthRequest>( handler ) );
+}
+
+AdminInitiateAuthOutcome awsx::CognitoClients::AdminInitiateAuth(
+	const AdminInitiateAuthRequest & request ) const
+{
+	return IdentityProvider()->AdminInitiateAuth( request );
+}
+
+void awsx::CognitoClients::AdminInitiateAuthAsync(
+	const AdminInitiateAuthRequest & request,
+	const AdminInitiateAuthHandler & handler ) const
+{
+	IdentityProvider()->AdminInitiateAuthAsync( request,
+		SdkHandler<IdpClient, AdminInitiateAuthRequest>( handler ) );
+}
+
+RespondToAuthChallengeOutcome awsx::CognitoClients::RespondToAuthChallenge(
+	const RespondToAuthChallengeRequest & request ) const
+{
+	return IdentityProvider()->RespondToAuthChallenge( request );
+}
+
+void awsx::CognitoClients::RespondToAuthChallengeAsync(
+	const RespondToAuthChallengeRequest & request,
+	const RespondToAuthChallengeHandler & handler ) const
+{
+	IdentityProvider()->RespondToAuthChallengeAsync( request,
+		SdkHandler<IdpClient, RespondToAuthChallengeRequest>( handler ) );
+}
+
+ConfirmDeviceOutcome awsx::CognitoClients::ConfirmDevice(
+	const ConfirmDeviceRequest & request ) const
+{
+	return IdentityProvider()->ConfirmDevice( request );
+}
+
+void awsx::CognitoClients::ConfirmDeviceAsync(
+	const ConfirmDeviceRequest & request,
+	const ConfirmDeviceHandler & handler ) const
+{
+	IdentityProvider()->ConfirmDeviceAsync( request,
+		SdkHandler<IdpClient, ConfirmDeviceRequest>( handler ) );
+}
+
+UpdateDeviceStatusOutcome awsx::CognitoClients::UpdateDeviceStatus(
+	const UpdateDeviceStatusRequest & request ) const
+{
+	return IdentityProvider()->UpdateDeviceStatus( request );
+}
+
+void awsx::CognitoClients::UpdateDeviceStatusAsync(
+	const UpdateDeviceStatusRequest & request,
+	const UpdateDeviceStatusHandler & handler ) const
+{
+	IdentityProvider()->UpdateDeviceStatusAsync( request,
+		SdkHandler<IdpClient, UpdateDeviceStatusRequest>( handler ) );
+}
+
+GetIdOutcome awsx::CognitoClients::GetId(
+	const GetIdRequest & request ) const
+{
+	return Identity()->GetId( request );
+}
+
+void awsx::CognitoClients::GetIdAsync( const GetIdRequest & request,
+	const GetIdHandler & handler ) const
+{
+	Identity()->GetIdAsync( request,
+		SdkHandler<IdentityClient, GetIdRequest>( handler ) );
+}
+
+GetCredentialsForIdentityOutcome
+awsx::CognitoClients::GetCredentialsForIdentity(
+	const GetCredentialsForIdentityRequest & request ) const
+{
+	return Identity()->GetCredentialsForIdentity( request );
+}
+
+void awsx::CognitoClients::GetCredentialsForIdentityAsync(
+	const GetCredentialsForIdentityRequest & request,
+	const GetCredentialsForIdentityHandler & handler ) const
+{
+	Identity()->GetCredentialsForIdentityAsync( request,
+		SdkHandler<IdentityClient, GetCredentialsForIdentityRequest>(
+			handler ) );
+}
@@ -0,0 +1,575 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "aws/core/client/CoreErrors.h"
+
+#include "aws/cognito-idp/CognitoIdentityProviderErrors.h"
+#include "aws/cognito-idp/model/AuthFlowType.h"
+#include "aws/cognito-idp/model/ChallengeNameType.h"
+#include "aws/cognito-idp/model/ConfirmDeviceRequest.h"
+#include "aws/cognito-idp/model/ConfirmDeviceResult.h"
+#include "aws/cognito-idp/model/DeviceRememberedStatusType.h"
+#include "aws/cognito-idp/model/InitiateAuthRequest.h"
+#include "aws/cognito-idp/model/InitiateAuthResult.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeRequest.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeResult.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusRequest.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusResult.h"
+
+#include "aws/cognito-identity/CognitoIdentityErrors.h"
+#include "aws/cognito-identity/model/GetCredentialsForIdentityRequest.h"
+#include "aws/cognito-identity/model/GetCredentialsForIdentityResult.h"
+#include "aws/cognito-identity/model/GetIdRequest.h"
+#include "aws/cognito-identity/model/GetIdResult.h"
+
+#include "include/CognitoJson.hpp"
+#include "include/Json.hpp"
+
+
+using namespace awsx;
+using namespace Aws::CognitoIdentityProvider::Model;
+using namespace Aws::CognitoIdentity::Model;
+
+
+// Result members, one key at a time; false leaves the value to be skipped.
+
+template <typename T>
+static T ReadObject( JsonReader & json );
+
+static Aws::String ReadString( JsonReader & json )
+{
+	return Aws::String( json.String().c_str() );
+}
+
+static Aws::Map<Aws::String, Aws::String> ReadStringMap( JsonReader & json )
+{
+	Aws::Map<Aws::String, Aws::String> result;
+
+	if ( json.IsNull() ) {
+		json.SkipValue();
+		return result;
+	}
+
+	std::string key;
+	json.BeginObject();
+
+	while ( json.NextKey( key ) ) {
+		result[Aws::String( key.c_str() )] = ReadString( json );
+	}
+
+	return result;
+}
+
+static bool ReadMember(
+	JsonReader & json, const std::string & key, NewDeviceMetadataType & v )
+{
+	if ( key == "DeviceKey" ) {
+		v.SetDeviceKey( ReadString( json ) );
+	}
+	else if ( key == "DeviceGroupKey" ) {
+		v.SetDeviceGroupKey( ReadString( json ) );
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+static bool ReadMember(
+	JsonReader & json, const std::string & key, AuthenticationResultType & v )
+{
+	if ( key == "AccessToken" ) {
+		v.SetAccessToken( ReadString( json ) );
+	}
+	else if ( key == "IdToken" ) {
+		v.SetIdToken( ReadString( json ) );
+	}
+	else if ( key == "RefreshToken" ) {
+		v.SetRefreshToken( ReadString( json ) );
+	}
+	else if ( key == "TokenType" ) {
+		v.SetTokenType( ReadString( json ) );
+	}
+	else if ( key == "ExpiresIn" ) {
+		v.SetExpiresIn( static_cast<int>( json.Number() ) );
+	}
+	else if ( key == "NewDeviceMetadata" ) {
+		v.SetNewDeviceMetadata( ReadObject<NewDeviceMetadataType>( json ) );
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+template <typename TResult>
+static bool ReadChallengeMember(
+	JsonReader & json, const std::string & key, TResult & v )
+{
+	if ( key == "ChallengeName" ) {
+		v.SetChallengeName(
+			ChallengeNameTypeMapper::GetChallengeNameTypeForName(
+				ReadString( json ) ) );
+	}
+	else if ( key == "Session" ) {
+		v.SetSession( ReadString( json ) );
+	}
+	else if ( key == "ChallengeParameters" ) {
+		v.SetChallengeParameters( ReadStringMap( json ) );
+	}
+	else if ( key == "AuthenticationResult" ) {
+		v.SetAuthenticationResult(
+			ReadObject<AuthenticationResultType>( json ) );
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+static bool ReadMember(
+	JsonReader & json, const std::string & key, InitiateAuthResult & v )
+{
+	return ReadChallengeMember( json, key, v );
+}
+
+static bool ReadMember( JsonReader & json,
+	const std::string & key,
+	RespondToAuthChallengeResult & v )
+{
+	return ReadChallengeMember( json, key, v );
+}
+
+static bool ReadMember(
+	JsonReader & json, const std::string & key, ConfirmDeviceResult & v )
+{
+	if ( key == "UserConfirmationNecessary" ) {
+		v.SetUserConfirmationNecessary( json.Bool() );
+		return true;
+	}
+
+	return false;
+}
+
+static bool ReadMember(
+	JsonReader &, const std::string &, UpdateDeviceStatusResult & )
+{
+	return false;
+}
+
+static bool ReadMember(
+	JsonReader & json, const std::string & key, GetIdResult & v )
+{
+	if ( key == "IdentityId" ) {
+		v.SetIdentityId( ReadString( json ) );
+		return true;
+	}
+
+	return false;
+}
+
+static bool ReadMember( JsonReader & json,
+	const std::string & key,
+	Aws::CognitoIdentity::Model::Credentials & v )
+{
+	if ( key == "AccessKeyId" ) {
+		v.SetAccessKeyId( ReadString( json ) );
+	}
+	else if ( key == "SecretKey" ) {
+		v.SetSecretKey( ReadString( json ) );
+	}
+	else if ( key == "SessionToken" ) {
+		v.SetSessionToken( ReadString( json ) );
+	}
+	else if ( key == "Expiration" ) {
+		// epoch seconds
+		v.SetExpiration( Aws::Utils::DateTime( json.Number() ) );
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+static bool ReadMember( JsonReader & json,
+	const std::string & key,
+	GetCredentialsForIdentityResult & v )
+{
+	if ( key == "IdentityId" ) {
+		v.SetIdentityId( ReadString( json ) );
+	}
+	else if ( key == "Credentials" ) {
+		v.SetCredentials(
+			ReadObject<Aws::CognitoIdentity::Model::Credentials>( json ) );
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+template <typename T>
+static T ReadObject( JsonReader & json )
+{
+	T result;
+
+	if ( json.IsNull() ) {
+		json.SkipValue();
+		return result;
+	}
+
+	std::string key;
+	json.BeginObject();
+
+	while ( json.NextKey( key ) ) {
+		if ( !ReadMember( json, key, result ) ) {
+			json.SkipValue();
+		}
+	}
+
+	return result;
+}
+
+
+template <typename T>
+static void ReadDocument( const std::string & body, T & result )
+{
+	// some operations answer with an empty body
+	if ( !body.empty() ) {
+		JsonReader json( body );
+		result = ReadObject<T>( json );
+	}
+}
+
+
+const char * const awsx::CognitoJson::IdentityProviderService
+	= "AWSCognitoIdentityProviderService";
+
+const char * const awsx::CognitoJson::IdentityService
+	= "AWSCognitoIdentityService";
+
+void awsx::CognitoJson::Endpoints( const std::string & regionId,
+	const std::string & endpointOverride,
+	HttpEndpoint & identityProvider,
+	HttpEndpoint & identity )
+{
+	identityProvider = HttpEndpoint();
+	identityProvider.host = "cognito-idp." + regionId + ".amazonaws.com";
+
+	identity = HttpEndpoint();
+	identity.host = "cognito-identity." + regionId + ".amazonaws.com";
+
+	if ( !endpointOverride.empty() ) {
+		auto url = endpointOverride;
+
+		if ( url.find( "://" ) == std::string::npos ) {
+			url = "https://" + url;
+		}
+
+		if ( !HttpEndpoint::Parse( url, identityProvider ) ) {
+			throw Exception( "invalid endpoint override: " + url );
+		}
+
+		identity = identityProvider;
+	}
+}
+
+CognitoJson::Error awsx::CognitoJson::IdentityProviderError(
+	const char * name )
+{
+	return Aws::CognitoIdentityProvider::CognitoIdentityProviderErrorMapper::
+		GetErrorForName( name );
+}
+
+CognitoJson::Error awsx::CognitoJson::IdentityError( const char * name )
+{
+	return Aws::CognitoIdentity::CognitoIdentityErrorMapper::GetErrorForName(
+		name );
+}
+
+std::vector<std::pair<std::string, std::string>> awsx::CognitoJson::Headers(
+	const char * service, const char * operation )
+{
+	return {
+		{ "Content-Type", "application/x-amz-json-1.1" },
+		{ "X-Amz-Target", std::string( service ) + "." + operation },
+	};
+}
+
+std::string awsx::CognitoJson::Write( const InitiateAuthRequest & request )
+{
+	JsonWriter json;
+	json.BeginObject();
+	json.Key( "AuthFlow" );
+	json.String( AuthFlowTypeMapper::GetNameForAuthFlowType(
+		request.GetAuthFlow() )
+			.c_str() );
+	json.StringMap( "AuthParameters", request.GetAuthParameters() );
+	json.Key( "ClientId" );
+	json.String( request.GetClientId().c_str() );
+	json.EndObject();
+
+	return json.Str();
+}
+
+std::string awsx::CognitoJson::Write(
+	const RespondToAuthChallengeRequest & request )
+{
+	JsonWriter json;
+	json.BeginObject();
+	json.Key( "ChallengeName" );
+	json.String( ChallengeNameTypeMapper::GetNameForChallengeNameType(
+		request.GetChallengeName() )
+			.c_str() );
+	json.StringMap( "ChallengeResponses", request.GetChallengeResponses() );
+	json.Key( "ClientId" );
+	json.String( request.GetClientId().c_str() );
+
+	if ( request.SessionHasBeenSet() ) {
+		json.Key( "Session" );
+		json.String( request.GetSession().c_str() );
+	}
+
+	json.EndObject();
+
+	return json.Str();
+}
+
+std::string awsx::CognitoJson::Write( const ConfirmDeviceRequest & request )
+{
+	auto & verifier = request.GetDeviceSecretVerifierConfig();
+
+	JsonWriter json;
+	json.BeginObject();
+	json.Key( "AccessToken" );
+	json.String( request.GetAccessToken().c_str() );
+	json.Key( "DeviceKey" );
+	json.String( request.GetDeviceKey().c_str() );
+
+	if ( request.DeviceNameHasBeenSet() ) {
+		json.Key( "DeviceName" );
+		json.String( request.GetDeviceName().c_str() );
+	}
+
+	json.Key( "DeviceSecretVerifierConfig" );
+	json.BeginObject();
+	json.Key( "PasswordVerifier" );
+	json.String( verifier.GetPasswordVerifier().c_str() );
+	json.Key( "Salt" );
+	json.String( verifier.GetSalt().c_str() );
+	json.EndObject();
+	json.EndObject();
+
+	return json.Str();
+}
+
+std::string awsx::CognitoJson::Write(
+	const UpdateDeviceStatusRequest & request )
+{
+	JsonWriter json;
+	json.BeginObject();
+	json.Key( "AccessToken" );
+	json.String( request.GetAccessToken().c_str() );
+	json.Key( "DeviceKey" );
+	json.String( request.GetDeviceKey().c_str() );
+	json.Key( "DeviceRememberedStatus" );
+	json.String( DeviceRememberedStatusTypeMapper::
+			GetNameForDeviceRememberedStatusType(
+				request.GetDeviceRememberedStatus() )
+				.c_str() );
+	json.EndObject();
+
+	return json.Str();
+}
+
+std::string awsx::CognitoJson::Write( const GetIdRequest & request )
+{
+	JsonWriter json;
+	json.BeginObject();
+
+	if ( request.AccountIdHasBeenSet() ) {
+		json.Key( "AccountId" );
+		json.String( request.GetAccountId().c_str() );
+	}
+
+	json.Key( "IdentityPoolId" );
+	json.String( request.GetIdentityPoolId().c_str() );
+	json.StringMap( "Logins", request.GetLogins() );
+	json.EndObject();
+
+	return json.Str();
+}
+
+std::string awsx::CognitoJson::Write(
+	const GetCredentialsForIdentityRequest & request )
+{
+	JsonWriter json;
+	json.BeginObject();
+
+	if ( request.CustomRoleArnHasBeenSet() ) {
+		json.Key( "CustomRoleArn" );
+		json.String( request.GetCustomRoleArn().c_str() );
+	}
+
+	json.Key( "IdentityId" );
+	json.String( request.GetIdentityId().c_str() );
+	json.StringMap( "Logins", request.GetLogins() );
+	json.EndObject();
+
+	return json.Str();
+}
+
+
+void awsx::CognitoJson::Read(
+	const std::string & body, InitiateAuthResult & result )
+{
+	ReadDocument( body, result );
+}
+
+void awsx::CognitoJson::Read(
+	const std::string & body, RespondToAuthChallengeResult & result )
+{
+	ReadDocument( body, result );
+}
+
+void awsx::CognitoJson::Read(
+	const std::string & body, ConfirmDeviceResult & result )
+{
+	ReadDocument( body, result );
+}
+
+void awsx::CognitoJson::Read(
+	const std::string & body, UpdateDeviceStatusResult & result )
+{
+	ReadDocument( body, result );
+}
+
+void awsx::CognitoJson::Read( const std::string & body, GetIdResult & result )
+{
+	ReadDocument( body, result );
+}
+
+void awsx::CognitoJson::Read(
+	const std::string & body, GetCredentialsForIdentityResult & result )
+{
+	ReadDocument( body, result );
+}
+
+CognitoJson::Error awsx::CognitoJson::ServiceError(
+	const HttpResponse & response, ErrorMapper mapper )
+{
+	std::string type;
+	std::string message;
+
+	try {
+		std::string key;
+		JsonReader json( response.body );
+		json.BeginObject();
+
+		while ( json.NextKey( key ) ) {
+			if ( key == "__type" ) {
+				type = json.String();
+			}
+			else if ( key == "message" || key == "Message" ) {
+				message = json.String();
+			}
+			else {
+				json.SkipValue();
+			}
+		}
+	}
+	catch ( const Exception & ) {
+		// not JSON, e.g. from a proxy; the status decides
+	}
+
+	if ( type.empty() ) {
+		auto header = response.headers.find( "x-amzn-errortype" );
+
+		if ( header != response.headers.end() ) {
+			type = header->second.substr( 0, header->second.find( ':' ) );
+		}
+	}
+
+	auto hash = type.find( '#' );
+
+	if ( hash != std::string::npos ) {
+		type = type.substr( hash + 1 );
+	}
+
+	auto error = mapper( type.c_str() );
+
+	if ( error.GetErrorType() == Aws::Client::CoreErrors::UNKNOWN ) {
+		error = Aws::Client::CoreErrorsMapper::GetErrorForName( type.c_str() );
+	}
+
+	if ( message.empty() ) {
+		message = "HTTP " + std::to_string( response.status );
+	}
+
+	return Error( error.GetErrorType(),
+		Aws::String( type.c_str() ),
+		Aws::String( message.c_str() ),
+		error.ShouldRetry() || response.status >= 500
+			|| response.status == 429 );
+}
+
+CognitoJson::Error awsx::CognitoJson::NetworkError(
+	const std::string & message, bool retryable )
+{
+	return Error( Aws::Client::CoreErrors::NETWORK_CONNECTION,
+		"NetworkConnection",
+		Aws::String( message.c_str() ),
+		retryable );
+}
+
+CognitoJson::Error awsx::CognitoJson::ResponseError(
+	const std::string & message )
+{
+	return Error( Aws::Client::CoreErrors::UNKNOWN,
+		"InvalidResponse",
+		Aws::String( message.c_str() ),
+		false );
+}
+
+std::chrono::milliseconds awsx::CognitoJson::Backoff( long attempt )
+{
+	return std::chrono::milliseconds( 25 << std::min( attempt, 8L ) );
+}
+
+long awsx::CognitoJson::Retries(
+	long maxRetries, std::chrono::milliseconds loginTimeout )
+{
+	if ( loginTimeout.count() > 0 ) {
+		return 0;
+	}
+
+	return maxRetries >= 0 ? maxRetries : 3;
+}
@@ -0,0 +1,178 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+
+#include "../../include/aws-cpp-cognito-auth/CredentialsCache.hpp"
+
+
+using namespace awsx;
+
+
+awsx::CredentialsCache::CredentialsCache( CognitoAuth & auth,
+	const std::string & username,
+	const std::string & password,
+	const std::string & userPoolId,
+	const std::string & identityPoolId,
+	std::chrono::seconds refreshAhead )
+	: m_auth( auth )
+	, m_username( username )
+	, m_password( password )
+	, m_userPoolId( userPoolId )
+	, m_identityPoolId( identityPoolId )
+	, m_refreshAhead( refreshAhead )
+	, m_stop( false )
+{
+}
+
+awsx::CredentialsCache::~CredentialsCache()
+{
+	Stop();
+}
+
+void awsx::CredentialsCache::RefreshLoop( Listener listener )
+{
+	// credentials of an identity pool last one hour, for responses
+	// without an expiration
+	static const std::chrono::seconds s_credentialsLifetime( 3600 );
+
+	uint64_t generation = 0;
+	std::chrono::seconds backoff( 1 );
+	std::unique_lock<std::mutex> lock( m_mutex );
+
+	while ( !m_stop ) {
+		lock.unlock();
+
+		std::chrono::seconds wait = backoff;
+		std::shared_ptr<Login> login;
+		std::string error;
+
+		try {
+			auto result = m_auth.Login(
+				m_username, m_password, m_userPoolId, m_identityPoolId );
+			auto now = std::chrono::system_clock::now();
+
+			login = std::make_shared<Login>();
+			login->tokens = result.tokens;
+			login->identityId = result.identity.identityId;
+			login->credentials = result.identity.credentials;
+			login->generation = ++generation;
+			login->expiration = result.identity.expiration > now
+				? result.identity.expiration
+				: now + s_credentialsLifetime;
+
+			std::chrono::seconds tokensLifetime( login->tokens.GetExpiresIn() );
+
+			if ( tokensLifetime.count() > 0 ) {
+				login->expiration
+					= std::min( login->expiration, now + tokensLifetime );
+			}
+
+			if ( listener ) {
+				listener( *login );
+			}
+
+			auto lifetime = std::chrono::duration_cast<std::chrono::seconds>(
+				login->expiration - now );
+
+			wait = std::max(
+				lifetime - m_refreshAhead, std::chrono::seconds( 1 ) );
+			backoff = std::chrono::seconds( 1 );
+		}
+		catch ( const std::exception & x ) {
+			login.reset();
+			error = x.what();
+			backoff = std::min( backoff * 2, std::chrono::seconds( 60 ) );
+		}
+
+		lock.lock();
+
+		if ( login ) {
+			m_login = login;
+			m_condition.notify_all();
+		}
+
+		m_lastError = error;
+		m_condition.wait_for( lock, wait, [this]() { return m_stop; } );
+	}
+}
+
+void awsx::CredentialsCache::Start( const Listener & listener )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	if ( m_thread.joinable() ) {
+		throw Exception( "CredentialsCache: already started" );
+	}
+
+	m_stop = false;
+	m_thread = std::thread( &CredentialsCache::RefreshLoop, this, listener );
+}
+
+void awsx::CredentialsCache::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_stop = true;
+	}
+
+	m_condition.notify_all();
+
+	if ( m_thread.joinable() ) {
+		m_thread.join();
+	}
+}
+
+bool awsx::CredentialsCache::WaitReady( std::chrono::milliseconds timeout )
+{
+	std::unique_lock<std::mutex> lock( m_mutex );
+
+	return m_condition.wait_for(
+		lock, timeout, [this]() { return m_login != nullptr; } );
+}
+
+std::shared_ptr<const CredentialsCache::Login>
+awsx::CredentialsCache::GetLogin() const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	return m_login;
+}
+
+std::string awsx::CredentialsCache::GetLastError() const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	return m_lastError;
+}
+
+Aws::Auth::AWSCredentials awsx::CredentialsCache::GetAWSCredentials()
+{
+	auto login = GetLogin();
+
+	if ( !login || login->expiration <= std::chrono::system_clock::now() ) {
+		return Aws::Auth::AWSCredentials();
+	}
+
+	return login->credentials;
+}
@@ -0,0 +1,177 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "../../include/aws-cpp-cognito-auth/Device.hpp"
+#include "../../include/aws-cpp-cognito-auth/Exception.hpp"
+
+
+using namespace awsx;
+
+
+awsx::FileDeviceKeyStore::FileDeviceKeyStore( const std::string & path )
+	: m_path( path )
+{
+	std::ifstream in( m_path );
+	std::string line;
+
+	while ( std::getline( in, line ) ) {
+		std::vector<std::string> fields;
+		std::stringstream ss( line );
+		std::string field;
+
+		while ( std::getline( ss, field, '\t' ) ) {
+			fields.push_back( field );
+		}
+
+		if ( fields.size() != 5 ) {
+			continue;
+		}
+
+		DeviceCredentials device;
+		device.deviceKey = fields[2];
+		device.deviceGroupKey = fields[3];
+		device.devicePassword = fields[4];
+
+		m_devices[Key( fields[0], fields[1] )] = device;
+	}
+}
+
+void awsx::FileDeviceKeyStore::Write()
+{
+	std::ostringstream out;
+
+	for ( auto & entry : m_devices ) {
+		out << entry.first.first << '\t' << entry.first.second << '\t'
+			<< entry.second.deviceKey << '\t' << entry.second.deviceGroupKey
+			<< '\t' << entry.second.devicePassword << '\n';
+	}
+
+	std::string content = out.str();
+
+	// write a sibling file and swap it in, so a crash never leaves a
+	// truncated store behind
+	std::string tmpPath = m_path + ".tmp";
+
+#ifdef _WIN32
+	bool written;
+
+	{
+		std::ofstream file( tmpPath, std::ios::binary | std::ios::trunc );
+		file.write( content.data(), content.size() );
+		file.flush();
+		written = file.good();
+	}
+
+	if ( !written ) {
+		std::remove( tmpPath.c_str() );
+		throw Exception( "device store " + tmpPath + ": write failed" );
+	}
+
+	if ( !MoveFileExA( tmpPath.c_str(),
+			 m_path.c_str(),
+			 MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) ) {
+		auto error = GetLastError();
+		std::remove( tmpPath.c_str() );
+
+		throw Exception( "device store " + m_path + ": error "
+			+ std::to_string( error ) );
+	}
+#else
+	// private from the start, whatever the umask; an older temp file gets
+	// its mode fixed too
+	int fd = open( tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600 );
+
+	if ( fd < 0 ) {
+		throw Exception( "device store " + tmpPath + ": " + strerror( errno ) );
+	}
+
+	bool written = fchmod( fd, 0600 ) == 0;
+
+	for ( size_t done = 0; written && done < content.size(); ) {
+		auto n = write( fd, content.data() + done, content.size() - done );
+
+		if ( n < 0 && errno == EINTR ) {
+			continue;
+		}
+
+		written = n > 0;
+		done += written ? static_cast<size_t>( n ) : 0;
+	}
+
+	written = written && fsync( fd ) == 0;
+	int error = errno;
+
+	if ( close( fd ) != 0 && written ) {
+		written = false;
+		error = errno;
+	}
+
+	// rename() replaces the old store atomically, there is no moment
+	// without one
+	if ( written && rename( tmpPath.c_str(), m_path.c_str() ) != 0 ) {
+		written = false;
+		error = errno;
+	}
+
+	if ( !written ) {
+		unlink( tmpPath.c_str() );
+		throw Exception( "device store " + m_path + ": " + strerror( error ) );
+	}
+#endif
+}
+
+void awsx::FileDeviceKeyStore::Save( const std::string & userPoolId,
+	const std::string & username,
+	const DeviceCredentials & device )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	m_devices[Key( userPoolId, username )] = device;
+	Write();
+}
+
+void awsx::FileDeviceKeyStore::Forget(
+	const std::string & userPoolId, const std::string & username )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	if ( m_devices.erase( Key( userPoolId, username ) ) > 0 ) {
+		Write();
+	}
+}
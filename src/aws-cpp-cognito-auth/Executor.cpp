@@ -0,0 +1,309 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined( __linux__ )
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+
+#include "../../include/aws-cpp-cognito-auth/Exception.hpp"
+#include "../../include/aws-cpp-cognito-auth/Executor.hpp"
+
+
+using namespace awsx;
+
+
+// Worker of the CpuExecutor running on this thread, if any.
+static thread_local const CpuExecutor * t_executor = nullptr;
+static thread_local size_t t_worker = 0;
+
+static void PinThread( std::thread & thread, unsigned cpu )
+{
+#ifdef _WIN32
+	SetThreadAffinityMask( thread.native_handle(), DWORD_PTR( 1 ) << cpu );
+#elif defined( __linux__ )
+	cpu_set_t set;
+	CPU_ZERO( &set );
+	CPU_SET( cpu, &set );
+
+	pthread_setaffinity_np( thread.native_handle(), sizeof( set ), &set );
+#else
+	( void )thread;
+	( void )cpu;
+#endif
+}
+
+// False when the task broke the contract of Executor::Submit() and threw.
+static bool RunTask( const std::function<void()> & task )
+{
+	try {
+		task();
+
+		return true;
+	}
+	catch ( ... ) {
+		assert( !"an Executor task threw" );
+
+		return false;
+	}
+}
+
+
+awsx::ThreadPool::ThreadPool( size_t threads )
+	: m_stop( false )
+	, m_failed( 0 )
+{
+	if ( threads == 0 ) {
+		threads = 1;
+	}
+
+	m_threads.reserve( threads );
+
+	for ( size_t i = 0; i < threads; i++ ) {
+		m_threads.emplace_back( &ThreadPool::Run, this );
+	}
+}
+
+awsx::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_stop = true;
+	}
+
+	m_condition.notify_all();
+
+	for ( auto & thread : m_threads ) {
+		thread.join();
+	}
+}
+
+void awsx::ThreadPool::Submit( std::function<void()> task )
+{
+	// notified under the lock: the task may finish, and its owner destroy
+	// the pool, before an unlocked notify_one() returned
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_tasks.push_back( std::move( task ) );
+	m_condition.notify_one();
+}
+
+void awsx::ThreadPool::Run()
+{
+	for ( ;; ) {
+		std::function<void()> task;
+
+		{
+			std::unique_lock<std::mutex> lock( m_mutex );
+			m_condition.wait(
+				lock, [this]() { return m_stop || !m_tasks.empty(); } );
+
+			if ( m_tasks.empty() ) {
+				return;
+			}
+
+			task = std::move( m_tasks.front() );
+			m_tasks.pop_front();
+		}
+
+		if ( !RunTask( task ) ) {
+			++m_failed;
+		}
+	}
+}
+
+
+awsx::CpuExecutor::CpuExecutor( const CpuExecutorOptions & options )
+	: m_options( options )
+	, m_stop( false )
+	, m_queued( 0 )
+	, m_next( 0 )
+	, m_executed( 0 )
+	, m_rejected( 0 )
+	, m_failed( 0 )
+	, m_stolen( 0 )
+	, m_totalWait( 0 )
+	, m_maxWait( 0 )
+{
+	size_t threads = m_options.threads;
+
+	if ( threads == 0 ) {
+		threads = std::max( 1u, std::thread::hardware_concurrency() );
+	}
+
+	m_workers.reserve( threads );
+
+	for ( size_t i = 0; i < threads; i++ ) {
+		m_workers.emplace_back( new Worker() );
+	}
+
+	// the workers look at each other's queues, so start them only once
+	// all of them exist
+	for ( size_t i = 0; i < threads; i++ ) {
+		auto & thread = m_workers[i]->thread;
+		thread = std::thread( &CpuExecutor::Run, this, i );
+
+		if ( !m_options.cpus.empty() ) {
+			PinThread( thread, m_options.cpus[i % m_options.cpus.size()] );
+		}
+	}
+}
+
+awsx::CpuExecutor::~CpuExecutor()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_stop = true;
+	}
+
+	m_condition.notify_all();
+
+	for ( auto & worker : m_workers ) {
+		worker->thread.join();
+	}
+}
+
+void awsx::CpuExecutor::Submit( std::function<void()> task )
+{
+	if ( m_queued.fetch_add( 1 ) >= m_options.maxQueued
+		&& m_options.maxQueued != 0 ) {
+		--m_queued;
+		++m_rejected;
+
+		throw Exception( "CpuExecutor: queue full" );
+	}
+
+	size_t index = t_executor == this
+		? t_worker
+		: m_next.fetch_add( 1, std::memory_order_relaxed ) % m_workers.size();
+
+	auto & worker = *m_workers[index];
+
+	{
+		std::lock_guard<std::mutex> lock( worker.mutex );
+
+		Task queued;
+		queued.run = std::move( task );
+		queued.queued = std::chrono::steady_clock::now();
+
+		worker.tasks.push_back( std::move( queued ) );
+	}
+
+	// pairs with the check in Run(), so the wakeup cannot fall between a
+	// worker's check and its wait; notified under the lock as in
+	// ThreadPool::Submit()
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_condition.notify_one();
+}
+
+bool awsx::CpuExecutor::Take( size_t index, Task & task )
+{
+	for ( size_t i = 0; i < m_workers.size(); i++ ) {
+		auto & worker = *m_workers[( index + i ) % m_workers.size()];
+		std::lock_guard<std::mutex> lock( worker.mutex );
+
+		if ( !worker.tasks.empty() ) {
+			task = std::move( worker.tasks.front() );
+			worker.tasks.pop_front();
+
+			if ( i != 0 ) {
+				++m_stolen;
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void awsx::CpuExecutor::Execute( Task & task )
+{
+	auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - task.queued );
+	int64_t wait = waited.count();
+
+	--m_queued;
+	m_totalWait += wait;
+
+	int64_t max = m_maxWait.load();
+
+	while ( wait > max && !m_maxWait.compare_exchange_weak( max, wait ) ) {
+	}
+
+	if ( !RunTask( task.run ) ) {
+		++m_failed;
+	}
+
+	++m_executed;
+}
+
+void awsx::CpuExecutor::Run( size_t index )
+{
+	t_executor = this;
+	t_worker = index;
+
+	for ( ;; ) {
+		Task task;
+
+		if ( Take( index, task ) ) {
+			Execute( task );
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock( m_mutex );
+
+		if ( m_queued == 0 ) {
+			if ( m_stop ) {
+				return;
+			}
+
+			m_condition.wait(
+				lock, [this]() { return m_stop || m_queued != 0; } );
+		}
+		else {
+			// counted but not yet on a queue, Submit() is about to push it
+			lock.unlock();
+			std::this_thread::yield();
+		}
+	}
+}
+
+CpuExecutorStats awsx::CpuExecutor::GetStats() const
+{
+	CpuExecutorStats stats;
+	stats.queued = m_queued;
+	stats.executed = m_executed;
+	stats.rejected = m_rejected;
+	stats.failed = m_failed;
+	stats.stolen = m_stolen;
+	stats.totalQueueWait = std::chrono::microseconds( m_totalWait.load() );
+	stats.maxQueueWait = std::chrono::microseconds( m_maxWait.load() );
+
+	return stats;
+}
@@ -0,0 +1,731 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+
+#include "openssl/x509v3.h"
+
+#include "include/Http.hpp"
+
+
+using namespace awsx;
+
+
+#ifdef _WIN32
+typedef SOCKET NativeSocket;
+static const HttpConnection::Socket s_invalidSocket = INVALID_SOCKET;
+#else
+typedef int NativeSocket;
+static const HttpConnection::Socket s_invalidSocket = -1;
+#endif
+
+#ifdef MSG_NOSIGNAL
+static const int s_sendFlags = MSG_NOSIGNAL;
+#else
+static const int s_sendFlags = 0;
+#endif
+
+
+static void CloseSocket( HttpConnection::Socket socket )
+{
+#ifdef _WIN32
+	closesocket( static_cast<NativeSocket>( socket ) );
+#else
+	close( socket );
+#endif
+}
+
+static void SetTimeout( HttpConnection::Socket socket,
+	int option,
+	std::chrono::milliseconds timeout )
+{
+#ifdef _WIN32
+	DWORD value = static_cast<DWORD>( timeout.count() );
+#else
+	timeval value;
+	value.tv_sec = static_cast<long>( timeout.count() / 1000 );
+	value.tv_usec = static_cast<long>( ( timeout.count() % 1000 ) * 1000 );
+#endif
+
+	setsockopt( static_cast<NativeSocket>( socket ),
+		SOL_SOCKET,
+		option,
+		reinterpret_cast<const char *>( &value ),
+		sizeof( value ) );
+}
+
+static std::string ToLower( std::string s )
+{
+	std::transform( s.begin(), s.end(), s.begin(), []( char ch ) {
+		return ( ch >= 'A' && ch <= 'Z' ) ? static_cast<char>( ch + 32 ) : ch;
+	} );
+
+	return s;
+}
+
+static std::string Trim( const std::string & s )
+{
+	auto begin = s.find_first_not_of( " \t" );
+
+	if ( begin == std::string::npos ) {
+		return std::string();
+	}
+
+	return s.substr( begin, s.find_last_not_of( " \t" ) - begin + 1 );
+}
+
+
+bool awsx::HttpEndpoint::Parse(
+	const std::string & url, HttpEndpoint & endpoint )
+{
+	std::string rest;
+
+	if ( url.compare( 0, 8, "https://" ) == 0 ) {
+		endpoint.tls = true;
+		endpoint.port = 443;
+		rest = url.substr( 8 );
+	}
+	else if ( url.compare( 0, 7, "http://" ) == 0 ) {
+		endpoint.tls = false;
+		endpoint.port = 80;
+		rest = url.substr( 7 );
+	}
+	else {
+		return false;
+	}
+
+	rest = rest.substr( 0, rest.find( '/' ) );
+
+	auto bracket = rest.rfind( ']' );
+	auto colon = rest.rfind( ':' );
+
+	if ( colon != std::string::npos
+		&& ( bracket == std::string::npos || colon > bracket ) ) {
+		int port = std::atoi( rest.c_str() + colon + 1 );
+
+		if ( port <= 0 || port > 65535 ) {
+			return false;
+		}
+
+		endpoint.port = static_cast<unsigned short>( port );
+		rest.resize( colon );
+	}
+
+	if ( rest.size() > 1 && rest.front() == '[' && rest.back() == ']' ) {
+		rest = rest.substr( 1, rest.size() - 2 );
+	}
+
+	endpoint.host = rest;
+
+	return !rest.empty();
+}
+
+
+void awsx::HttpResponse::AddHeader( const std::string & line )
+{
+	auto colon = line.find( ':' );
+
+	if ( colon != std::string::npos ) {
+		headers[ToLower( line.substr( 0, colon ) )]
+			= Trim( line.substr( colon + 1 ) );
+	}
+}
+
+awsx::TlsContext::TlsContext()
+{
+	m_context = SSL_CTX_new( TLS_client_method() );
+
+	if ( m_context == nullptr ) {
+		throw HttpException( "SSL_CTX_new failed" );
+	}
+
+	SSL_CTX_set_min_proto_version( m_context, TLS1_2_VERSION );
+	SSL_CTX_set_default_verify_paths( m_context );
+	SSL_CTX_set_verify( m_context, SSL_VERIFY_PEER, nullptr );
+	SSL_CTX_set_session_cache_mode( m_context, SSL_SESS_CACHE_CLIENT );
+}
+
+awsx::TlsContext::~TlsContext()
+{
+	SSL_CTX_free( m_context );
+}
+
+
+awsx::HttpConnection::HttpConnection( const HttpEndpoint & endpoint,
+	const TlsContext * tls,
+	SSL_SESSION * session,
+	std::chrono::milliseconds timeout )
+	: m_endpoint( endpoint )
+	, m_socket( s_invalidSocket )
+	, m_ssl( nullptr )
+	, m_in( nullptr )
+	, m_out( nullptr )
+	, m_closed( false )
+{
+#ifdef _WIN32
+	static std::once_flag s_wsaInit;
+	std::call_once( s_wsaInit, []() {
+		WSADATA data;
+		WSAStartup( MAKEWORD( 2, 2 ), &data );
+	} );
+#endif
+
+	addrinfo hints = addrinfo();
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	addrinfo * addresses = nullptr;
+	auto port = std::to_string( endpoint.port );
+
+	if ( getaddrinfo(
+			 endpoint.host.c_str(), port.c_str(), &hints, &addresses )
+		!= 0 ) {
+		throw HttpException( "cannot resolve " + endpoint.host, true );
+	}
+
+	for ( auto a = addresses; a != nullptr; a = a->ai_next ) {
+		HttpConnection::Socket s
+			= socket( a->ai_family, a->ai_socktype, a->ai_protocol );
+
+		if ( s == s_invalidSocket ) {
+			continue;
+		}
+
+		if ( timeout.count() > 0 ) {
+			SetTimeout( s, SO_RCVTIMEO, timeout );
+			SetTimeout( s, SO_SNDTIMEO, timeout );
+		}
+
+		if ( connect( static_cast<NativeSocket>( s ),
+				 a->ai_addr, static_cast<int>( a->ai_addrlen ) )
+			== 0 ) {
+			m_socket = s;
+			break;
+		}
+
+		CloseSocket( s );
+	}
+
+	freeaddrinfo( addresses );
+
+	if ( m_socket == s_invalidSocket ) {
+		throw HttpException( "cannot connect to " + endpoint.host, true );
+	}
+
+	int noDelay = 1;
+	setsockopt( static_cast<NativeSocket>( m_socket ),
+		IPPROTO_TCP,
+		TCP_NODELAY,
+		reinterpret_cast<const char *>( &noDelay ),
+		sizeof( noDelay ) );
+
+	if ( !endpoint.tls ) {
+		return;
+	}
+
+	m_ssl = SSL_new( tls->Get() );
+	m_in = BIO_new( BIO_s_mem() );
+	m_out = BIO_new( BIO_s_mem() );
+
+	if ( m_ssl == nullptr || m_in == nullptr || m_out == nullptr ) {
+		BIO_free( m_in );
+		BIO_free( m_out );
+		m_in = m_out = nullptr;
+		Close();
+
+		throw HttpException( "SSL_new failed", true );
+	}
+
+	// the SSL object owns both BIOs from here on
+	SSL_set_bio( m_ssl, m_in, m_out );
+	SSL_set_connect_state( m_ssl );
+	SSL_set_tlsext_host_name( m_ssl, endpoint.host.c_str() );
+	SSL_set1_host( m_ssl, endpoint.host.c_str() );
+
+	if ( session != nullptr ) {
+		SSL_set_session( m_ssl, session );
+	}
+
+	try {
+		while ( true ) {
+			int result = SSL_connect( m_ssl );
+			Flush();
+
+			if ( result == 1 ) {
+				break;
+			}
+
+			if ( SSL_get_error( m_ssl, result ) != SSL_ERROR_WANT_READ
+				|| !Fill() ) {
+				throw HttpException(
+					"TLS handshake with " + endpoint.host + " failed" );
+			}
+		}
+	}
+	catch ( const HttpException & e ) {
+		Close();
+
+		// nothing is sent before the handshake completes
+		throw HttpException( e.what(), true );
+	}
+	catch ( ... ) {
+		Close();
+		throw;
+	}
+}
+
+awsx::HttpConnection::~HttpConnection()
+{
+	Close();
+}
+
+void awsx::HttpConnection::Close()
+{
+	if ( m_ssl != nullptr ) {
+		SSL_free( m_ssl );
+		m_ssl = nullptr;
+	}
+
+	if ( m_socket != s_invalidSocket ) {
+		CloseSocket( m_socket );
+		m_socket = s_invalidSocket;
+	}
+}
+
+void awsx::HttpConnection::SendRaw( const char * data, size_t size )
+{
+	while ( size > 0 ) {
+		auto sent = send( static_cast<NativeSocket>( m_socket ),
+			data,
+			static_cast<int>( std::min<size_t>( size, 1 << 20 ) ),
+			s_sendFlags );
+
+		if ( sent <= 0 ) {
+			throw HttpException( "send to " + m_endpoint.host + " failed" );
+		}
+
+		data += sent;
+		size -= static_cast<size_t>( sent );
+	}
+}
+
+size_t awsx::HttpConnection::RecvRaw( char * data, size_t size )
+{
+	auto received = recv( static_cast<NativeSocket>( m_socket ),
+		data,
+		static_cast<int>( size ),
+		0 );
+
+	if ( received < 0 ) {
+#ifdef _WIN32
+		int error = WSAGetLastError();
+		m_closed = error == WSAECONNRESET || error == WSAECONNABORTED;
+#else
+		m_closed = errno == ECONNRESET;
+#endif
+
+		throw HttpException( m_closed
+				? "connection reset by " + m_endpoint.host
+				: "receive from " + m_endpoint.host + " failed or timed out" );
+	}
+
+	m_closed = received == 0;
+
+	return static_cast<size_t>( received );
+}
+
+void awsx::HttpConnection::Flush()
+{
+	char chunk[16384];
+
+	while ( BIO_ctrl_pending( m_out ) > 0 ) {
+		int size = BIO_read( m_out, chunk, sizeof( chunk ) );
+
+		if ( size <= 0 ) {
+			break;
+		}
+
+		SendRaw( chunk, static_cast<size_t>( size ) );
+	}
+}
+
+bool awsx::HttpConnection::Fill()
+{
+	char chunk[16384];
+	auto size = RecvRaw( chunk, sizeof( chunk ) );
+
+	if ( size == 0 ) {
+		return false;
+	}
+
+	BIO_write( m_in, chunk, static_cast<int>( size ) );
+
+	return true;
+}
+
+void awsx::HttpConnection::Write( const std::string & data )
+{
+	if ( m_ssl == nullptr ) {
+		SendRaw( data.data(), data.size() );
+		return;
+	}
+
+	size_t offset = 0;
+
+	while ( offset < data.size() ) {
+		int written = SSL_write( m_ssl,
+			data.data() + offset,
+			static_cast<int>( data.size() - offset ) );
+
+		if ( written <= 0 ) {
+			throw HttpException( "TLS write failed" );
+		}
+
+		offset += static_cast<size_t>( written );
+	}
+
+	Flush();
+}
+
+bool awsx::HttpConnection::Read()
+{
+	char chunk[16384];
+
+	if ( m_ssl == nullptr ) {
+		auto size = RecvRaw( chunk, sizeof( chunk ) );
+		m_buffer.append( chunk, size );
+
+		return size > 0;
+	}
+
+	while ( true ) {
+		int size = SSL_read( m_ssl, chunk, sizeof( chunk ) );
+
+		if ( size > 0 ) {
+			m_buffer.append( chunk, static_cast<size_t>( size ) );
+			return true;
+		}
+
+		int error = SSL_get_error( m_ssl, size );
+
+		// reads may produce records of their own, e.g. key updates
+		Flush();
+
+		if ( error == SSL_ERROR_WANT_READ ) {
+			if ( !Fill() ) {
+				return false;
+			}
+		}
+		else if ( error == SSL_ERROR_ZERO_RETURN ) {
+			m_closed = true;
+			return false;
+		}
+		else {
+			throw HttpException( "TLS read failed" );
+		}
+	}
+}
+
+std::string awsx::HttpConnection::ReadLine()
+{
+	size_t end;
+
+	while ( ( end = m_buffer.find( "\r\n" ) ) == std::string::npos ) {
+		if ( !Read() ) {
+			throw HttpException( "connection closed by " + m_endpoint.host );
+		}
+	}
+
+	std::string line = m_buffer.substr( 0, end );
+	m_buffer.erase( 0, end + 2 );
+
+	return line;
+}
+
+void awsx::HttpConnection::ReadBody( std::string & body, size_t size )
+{
+	while ( m_buffer.size() < size ) {
+		if ( !Read() ) {
+			throw HttpException( "connection closed by " + m_endpoint.host );
+		}
+	}
+
+	body.append( m_buffer, 0, size );
+	m_buffer.erase( 0, size );
+}
+
+HttpResponse awsx::HttpConnection::Exchange( const std::string & request )
+{
+	try {
+		Write( request );
+	}
+	catch ( const HttpException & e ) {
+		// the server did not get the whole request
+		throw HttpException( e.what(), true );
+	}
+
+	HttpResponse response;
+	std::string statusLine;
+
+	try {
+		statusLine = ReadLine();
+	}
+	catch ( const HttpException & e ) {
+		// closed before the first byte of the response: the server gave up
+		// on the idle connection instead of taking the request
+		if ( m_closed && m_buffer.empty() ) {
+			throw HttpException( e.what(), true );
+		}
+
+		throw;
+	}
+
+	if ( statusLine.compare( 0, 5, "HTTP/" ) != 0
+		|| statusLine.size() < 12 ) {
+		throw HttpException( "bad status line from " + m_endpoint.host );
+	}
+
+	response.status = std::atoi( statusLine.c_str() + 9 );
+
+	while ( true ) {
+		auto line = ReadLine();
+
+		if ( line.empty() ) {
+			break;
+		}
+
+		response.AddHeader( line );
+	}
+
+	auto connection = ToLower( response.headers["connection"] );
+	response.keepAlive = statusLine.compare( 0, 8, "HTTP/1.1" ) == 0
+		? connection != "close"
+		: connection == "keep-alive";
+
+	auto transferEncoding = response.headers.find( "transfer-encoding" );
+	auto contentLength = response.headers.find( "content-length" );
+
+	if ( transferEncoding != response.headers.end()
+		&& ToLower( transferEncoding->second ) == "chunked" ) {
+		while ( true ) {
+			auto size = std::strtoul( ReadLine().c_str(), nullptr, 16 );
+
+			if ( size == 0 ) {
+				break;
+			}
+
+			ReadBody( response.body, size );
+			ReadLine();
+		}
+
+		// trailers
+		while ( !ReadLine().empty() ) {
+		}
+	}
+	else if ( contentLength != response.headers.end() ) {
+		ReadBody( response.body,
+			std::strtoul( contentLength->second.c_str(), nullptr, 10 ) );
+	}
+	else {
+		while ( Read() ) {
+		}
+
+		response.body.swap( m_buffer );
+		response.keepAlive = false;
+	}
+
+	return response;
+}
+
+SSL_SESSION * awsx::HttpConnection::Session() const
+{
+	return m_ssl != nullptr ? SSL_get1_session( m_ssl ) : nullptr;
+}
+
+
+awsx::HttpConnectionPool::HttpConnectionPool( const HttpEndpoint & endpoint,
+	std::shared_ptr<TlsContext> tls,
+	std::chrono::milliseconds timeout,
+	size_t maxIdle )
+	: m_endpoint( endpoint )
+	, m_tls( tls )
+	, m_timeout( timeout )
+	, m_maxIdle( maxIdle )
+	, m_session( nullptr )
+{
+}
+
+awsx::HttpConnectionPool::~HttpConnectionPool()
+{
+	m_idle.clear();
+
+	if ( m_session != nullptr ) {
+		SSL_SESSION_free( m_session );
+	}
+}
+
+std::unique_ptr<HttpConnection> awsx::HttpConnectionPool::Open()
+{
+	SSL_SESSION * session = nullptr;
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+
+		if ( m_session != nullptr ) {
+			SSL_SESSION_up_ref( m_session );
+			session = m_session;
+		}
+	}
+
+	std::unique_ptr<HttpConnection> connection;
+
+	try {
+		connection.reset(
+			new HttpConnection( m_endpoint, m_tls.get(), session, m_timeout ) );
+	}
+	catch ( ... ) {
+		SSL_SESSION_free( session );
+		throw;
+	}
+
+	SSL_SESSION_free( session );
+
+	return connection;
+}
+
+std::unique_ptr<HttpConnection> awsx::HttpConnectionPool::Acquire(
+	bool & reused )
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+
+		if ( !m_idle.empty() ) {
+			auto connection = std::move( m_idle.back() );
+			m_idle.pop_back();
+			reused = true;
+
+			return connection;
+		}
+	}
+
+	reused = false;
+
+	return Open();
+}
+
+void awsx::HttpConnectionPool::Release(
+	std::unique_ptr<HttpConnection> connection )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	// TLS 1.3 tickets only arrive with the first response
+	if ( m_session == nullptr ) {
+		auto session = connection->Session();
+
+		if ( session != nullptr && SSL_SESSION_is_resumable( session ) ) {
+			m_session = session;
+		}
+		else if ( session != nullptr ) {
+			SSL_SESSION_free( session );
+		}
+	}
+
+	if ( m_idle.size() < m_maxIdle ) {
+		m_idle.push_back( std::move( connection ) );
+	}
+}
+
+HttpResponse awsx::HttpConnectionPool::Post(
+	const std::vector<std::pair<std::string, std::string>> & headers,
+	const std::string & body )
+{
+	std::string request = "POST / HTTP/1.1\r\nHost: " + m_endpoint.host;
+
+	if ( m_endpoint.port != ( m_endpoint.tls ? 443 : 80 ) ) {
+		request += ":" + std::to_string( m_endpoint.port );
+	}
+
+	request += "\r\n";
+
+	for ( auto & header : headers ) {
+		request += header.first + ": " + header.second + "\r\n";
+	}
+
+	request += "Content-Length: " + std::to_string( body.size() ) + "\r\n\r\n";
+	request += body;
+
+	for ( int attempt = 0;; attempt++ ) {
+		bool reused = false;
+		auto connection = Acquire( reused );
+		HttpResponse response;
+
+		try {
+			response = connection->Exchange( request );
+		}
+		catch ( const HttpException & e ) {
+			if ( !reused || attempt > 0 || !e.Retryable() ) {
+				throw;
+			}
+
+			// the other idle connections are likely just as stale
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_idle.clear();
+
+			continue;
+		}
+
+		if ( response.keepAlive ) {
+			Release( std::move( connection ) );
+		}
+
+		return response;
+	}
+}
+
+void awsx::HttpConnectionPool::Connect()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+
+		if ( !m_idle.empty() ) {
+			return;
+		}
+	}
+
+	Release( Open() );
+}
@@ -0,0 +1,342 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "include/Http2.hpp"
+
+
+using namespace awsx;
+
+
+static const char * const s_shutDown = "transport shut down";
+
+// poll at least this often; Post() wakes the loop up anyway
+static const long s_maxWaitMs = 1000;
+
+
+// Whether the transfer failed before the server could act on the request:
+// only when there was no connection to send it on. A send error or a
+// stream closed without a response may come after the server processed
+// the stream on a multiplexed connection; a replayed
+// RespondToAuthChallenge then gets an "Invalid session" NotAuthorized,
+// which the negative cache would hold against a correct password.
+static bool Retryable( CURLcode result )
+{
+	return result == CURLE_COULDNT_RESOLVE_HOST
+		|| result == CURLE_COULDNT_RESOLVE_PROXY
+		|| result == CURLE_COULDNT_CONNECT
+		|| result == CURLE_SSL_CONNECT_ERROR;
+}
+
+
+awsx::Http2Client::Http2Client(
+	long maxConnections, std::chrono::milliseconds timeout )
+	: m_timeout( timeout )
+	, m_multi( nullptr )
+	, m_stop( false )
+{
+	static std::once_flag s_curlInit;
+	std::call_once(
+		s_curlInit, []() { curl_global_init( CURL_GLOBAL_DEFAULT ); } );
+
+	auto version = curl_version_info( CURLVERSION_NOW );
+
+	if ( ( version->features & CURL_VERSION_HTTP2 ) == 0 ) {
+		throw Exception( "libcurl was built without HTTP/2" );
+	}
+
+	// 7.88 fails every request after the first on a reused HTTP/2
+	// connection with "Error in the HTTP2 framing layer"
+	if ( ( version->version_num >> 8 ) == 0x0758 ) {
+		throw Exception( std::string( "libcurl " ) + version->version
+			+ " cannot reuse HTTP/2 connections" );
+	}
+
+	m_multi = curl_multi_init();
+
+	if ( m_multi == nullptr ) {
+		throw Exception( "curl_multi_init failed" );
+	}
+
+	curl_multi_setopt( m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX );
+	curl_multi_setopt(
+		m_multi, CURLMOPT_MAX_HOST_CONNECTIONS, maxConnections );
+
+	m_thread = std::thread( &Http2Client::Loop, this );
+}
+
+awsx::Http2Client::~Http2Client()
+{
+	Stop();
+	curl_multi_cleanup( m_multi );
+}
+
+void awsx::Http2Client::Post( std::shared_ptr<const Http2Request> request,
+	std::chrono::milliseconds delay,
+	Handler handler )
+{
+	auto transfer = std::make_shared<Transfer>();
+	transfer->request = std::move( request );
+	transfer->handler = std::move( handler );
+	transfer->notBefore = std::chrono::steady_clock::now() + delay;
+	transfer->easy = nullptr;
+	transfer->headers = nullptr;
+	transfer->error[0] = 0;
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+
+		if ( !m_stop ) {
+			m_queue.push_back( transfer );
+			curl_multi_wakeup( m_multi );
+			return;
+		}
+	}
+
+	transfer->handler( transfer->response, s_shutDown, false );
+}
+
+void awsx::Http2Client::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_stop = true;
+	}
+
+	curl_multi_wakeup( m_multi );
+
+	if ( m_thread.joinable() ) {
+		m_thread.join();
+	}
+}
+
+size_t awsx::Http2Client::OnBody(
+	char * data, size_t size, size_t n, void * user )
+{
+	static_cast<Transfer *>( user )->response.body.append( data, size * n );
+	return size * n;
+}
+
+size_t awsx::Http2Client::OnHeader(
+	char * data, size_t size, size_t n, void * user )
+{
+	auto & response = static_cast<Transfer *>( user )->response;
+	std::string line( data, size * n );
+
+	while ( !line.empty()
+		&& ( line.back() == '\r' || line.back() == '\n' ) ) {
+		line.pop_back();
+	}
+
+	// a new status line, e.g. after "100 Continue", starts over
+	if ( line.compare( 0, 5, "HTTP/" ) == 0 ) {
+		response.headers.clear();
+	}
+	else {
+		response.AddHeader( line );
+	}
+
+	return size * n;
+}
+
+void awsx::Http2Client::Loop()
+{
+	for ( ;; ) {
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+
+			if ( m_stop ) {
+				break;
+			}
+		}
+
+		long wait = Start( std::chrono::steady_clock::now() );
+
+		int running = 0;
+		curl_multi_perform( m_multi, &running );
+
+		int left = 0;
+		CURLMsg * message;
+
+		while ( ( message = curl_multi_info_read( m_multi, &left ) )
+			!= nullptr ) {
+			if ( message->msg == CURLMSG_DONE ) {
+				Finish( message->easy_handle, message->data.result );
+			}
+		}
+
+		curl_multi_poll(
+			m_multi, nullptr, 0, static_cast<int>( wait ), nullptr );
+	}
+
+	std::vector<std::shared_ptr<Transfer>> failed;
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		failed.swap( m_queue );
+	}
+
+	for ( auto & active : m_active ) {
+		curl_multi_remove_handle( m_multi, active.first );
+		Release( *active.second );
+		failed.push_back( active.second );
+	}
+
+	m_active.clear();
+
+	for ( auto & transfer : failed ) {
+		transfer->handler( transfer->response, s_shutDown, false );
+	}
+
+	for ( auto easy : m_idle ) {
+		curl_easy_cleanup( easy );
+	}
+
+	m_idle.clear();
+}
+
+long awsx::Http2Client::Start( std::chrono::steady_clock::time_point now )
+{
+	std::vector<std::shared_ptr<Transfer>> ready;
+	long wait = s_maxWaitMs;
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+
+		auto delayed = std::partition( m_queue.begin(),
+			m_queue.end(),
+			[now]( const std::shared_ptr<Transfer> & transfer ) {
+				return transfer->notBefore > now;
+			} );
+
+		ready.assign( delayed, m_queue.end() );
+		m_queue.erase( delayed, m_queue.end() );
+
+		for ( const auto & transfer : m_queue ) {
+			auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+				transfer->notBefore - now ).count() + 1;
+			wait = std::min( wait, static_cast<long>( ms ) );
+		}
+	}
+
+	for ( auto & transfer : ready ) {
+		const auto & request = *transfer->request;
+		const auto & endpoint = request.endpoint;
+
+		if ( !m_idle.empty() ) {
+			transfer->easy = m_idle.back();
+			m_idle.pop_back();
+		}
+		else {
+			transfer->easy = curl_easy_init();
+		}
+
+		if ( transfer->easy == nullptr ) {
+			transfer->handler(
+				transfer->response, "curl_easy_init failed", true );
+			continue;
+		}
+
+		for ( const auto & header : request.headers ) {
+			transfer->headers = curl_slist_append( transfer->headers,
+				( header.first + ": " + header.second ).c_str() );
+		}
+
+		auto url = std::string( endpoint.tls ? "https://" : "http://" )
+			+ endpoint.host + ":" + std::to_string( endpoint.port ) + "/";
+
+		// h2c has no upgrade step worth waiting for
+		long version = endpoint.tls
+			? CURL_HTTP_VERSION_2TLS
+			: CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE;
+
+		CURL * easy = transfer->easy;
+		curl_easy_setopt( easy, CURLOPT_URL, url.c_str() );
+		curl_easy_setopt( easy, CURLOPT_HTTP_VERSION, version );
+		// wait for a connection that can take one more stream rather than
+		// opening another
+		curl_easy_setopt( easy, CURLOPT_PIPEWAIT, 1L );
+		curl_easy_setopt( easy, CURLOPT_NOSIGNAL, 1L );
+		curl_easy_setopt( easy,
+			CURLOPT_TIMEOUT_MS,
+			static_cast<long>( m_timeout.count() ) );
+		curl_easy_setopt( easy, CURLOPT_HTTPHEADER, transfer->headers );
+		curl_easy_setopt( easy, CURLOPT_POSTFIELDS, request.body.data() );
+		curl_easy_setopt( easy,
+			CURLOPT_POSTFIELDSIZE,
+			static_cast<long>( request.body.size() ) );
+		curl_easy_setopt( easy, CURLOPT_WRITEFUNCTION, &Http2Client::OnBody );
+		curl_easy_setopt( easy, CURLOPT_WRITEDATA, transfer.get() );
+		curl_easy_setopt(
+			easy, CURLOPT_HEADERFUNCTION, &Http2Client::OnHeader );
+		curl_easy_setopt( easy, CURLOPT_HEADERDATA, transfer.get() );
+		curl_easy_setopt( easy, CURLOPT_ERRORBUFFER, transfer->error );
+
+		m_active[easy] = transfer;
+		curl_multi_add_handle( m_multi, easy );
+	}
+
+	return wait;
+}
+
+void awsx::Http2Client::Finish( CURL * easy, CURLcode result )
+{
+	auto found = m_active.find( easy );
+
+	if ( found == m_active.end() ) {
+		return;
+	}
+
+	auto transfer = found->second;
+	m_active.erase( found );
+	curl_multi_remove_handle( m_multi, easy );
+
+	std::string error;
+
+	if ( result == CURLE_OK ) {
+		long status = 0;
+		curl_easy_getinfo( easy, CURLINFO_RESPONSE_CODE, &status );
+		transfer->response.status = static_cast<int>( status );
+		transfer->response.keepAlive = true;
+	}
+	else {
+		error = transfer->error[0] != 0
+			? transfer->error
+			: curl_easy_strerror( result );
+	}
+
+	Release( *transfer );
+	transfer->handler( transfer->response, error, Retryable( result ) );
+}
+
+void awsx::Http2Client::Release( Transfer & transfer )
+{
+	curl_easy_reset( transfer.easy );
+	m_idle.push_back( transfer.easy );
+	curl_slist_free_all( transfer.headers );
+
+	transfer.easy = nullptr;
+	transfer.headers = nullptr;
+}
@@ -0,0 +1,367 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <future>
+
+#include "aws/cognito-idp/CognitoIdentityProviderErrors.h"
+#include "aws/cognito-idp/model/AdminInitiateAuthRequest.h"
+#include "aws/cognito-idp/model/ConfirmDeviceRequest.h"
+#include "aws/cognito-idp/model/ConfirmDeviceResult.h"
+#include "aws/cognito-idp/model/InitiateAuthRequest.h"
+#include "aws/cognito-idp/model/InitiateAuthResult.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeRequest.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeResult.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusRequest.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusResult.h"
+
+#include "aws/cognito-identity/model/GetCredentialsForIdentityRequest.h"
+#include "aws/cognito-identity/model/GetCredentialsForIdentityResult.h"
+#include "aws/cognito-identity/model/GetIdRequest.h"
+#include "aws/cognito-identity/model/GetIdResult.h"
+
+#include "include/CognitoJson.hpp"
+#include "include/Http2.hpp"
+
+#include "../../include/aws-cpp-cognito-auth/Executor.hpp"
+#include "../../include/aws-cpp-cognito-auth/Http2Transport.hpp"
+
+
+using namespace awsx;
+using namespace Aws::CognitoIdentityProvider::Model;
+using namespace Aws::CognitoIdentity::Model;
+
+
+namespace awsx {
+
+	// One of the two services, reached through the shared client.
+	struct Http2Service {
+		Http2Client * client;
+		HttpEndpoint endpoint;
+		const char * name;
+		CognitoJson::ErrorMapper mapper;
+		long maxRetries;
+		// whether a request the server may have acted on can be resent
+		bool idempotent;
+	};
+
+} // namespace awsx
+
+
+// Sends the request and, while the error allows it, sends it again after a
+// backoff delay the client waits out; done gets the final outcome on the
+// client thread.
+template <typename TOutcome, typename TResult>
+static void Send( const Http2Service & service,
+	std::shared_ptr<const Http2Request> request,
+	long attempt,
+	std::function<void( const TOutcome & )> done )
+{
+	auto delay = attempt > 0
+		? CognitoJson::Backoff( attempt - 1 )
+		: std::chrono::milliseconds( 0 );
+
+	service.client->Post( request,
+		delay,
+		[&service, request, attempt, done](
+			const HttpResponse & response,
+			const std::string & error,
+			bool retryable ) {
+			auto outcome = error.empty()
+				? CognitoJson::MakeOutcome<TOutcome, TResult>(
+					response, service.mapper )
+				: CognitoJson::ErrorOutcome<TOutcome>(
+					CognitoJson::NetworkError(
+						error, service.idempotent || retryable ) );
+
+			if ( outcome.IsSuccess() || !outcome.GetError().ShouldRetry()
+				|| attempt >= service.maxRetries ) {
+				done( outcome );
+			}
+			else {
+				Send<TOutcome, TResult>( service, request, attempt + 1, done );
+			}
+		} );
+}
+
+template <typename TOutcome, typename TResult>
+static void Start( const Http2Service & service,
+	const char * operation,
+	std::string body,
+	std::function<void( const TOutcome & )> done )
+{
+	auto request = std::make_shared<Http2Request>();
+	request->endpoint = service.endpoint;
+	request->headers = CognitoJson::Headers( service.name, operation );
+	request->body = std::move( body );
+
+	Send<TOutcome, TResult>( service, request, 0, done );
+}
+
+template <typename TOutcome, typename TResult>
+static TOutcome Wait( const Http2Service & service,
+	const char * operation,
+	std::string body )
+{
+	auto promise = std::make_shared<std::promise<TOutcome>>();
+	auto future = promise->get_future();
+
+	Start<TOutcome, TResult>( service,
+		operation,
+		std::move( body ),
+		[promise]( const TOutcome & outcome ) {
+			promise->set_value( outcome );
+		} );
+
+	return future.get();
+}
+
+// The handler runs on the executor, off the client thread, so it may do
+// the SRP math of the next step.
+template <typename TOutcome, typename TResult>
+static void Dispatch( const Http2Service & service,
+	ThreadPool & executor,
+	const char * operation,
+	std::string body,
+	std::function<void( const TOutcome & )> handler )
+{
+	Start<TOutcome, TResult>( service,
+		operation,
+		std::move( body ),
+		[&executor, handler]( const TOutcome & outcome ) {
+			executor.Submit( [handler, outcome]() { handler( outcome ); } );
+		} );
+}
+
+
+awsx::Http2Transport::Http2Transport(
+	const std::string & regionId, const CognitoAuthOptions & options )
+{
+	std::chrono::milliseconds timeout( 3000 );
+
+	if ( options.loginTimeout.count() > 0 ) {
+		timeout = options.loginTimeout;
+	}
+
+	long maxRetries
+		= CognitoJson::Retries( options.maxRetries, options.loginTimeout );
+
+	m_client.reset( new Http2Client(
+		options.maxConnections > 0 ? options.maxConnections : 2, timeout ) );
+
+	m_identityProvider.reset( new Http2Service() );
+	m_identityProvider->client = m_client.get();
+	m_identityProvider->name = CognitoJson::IdentityProviderService;
+	m_identityProvider->mapper = &CognitoJson::IdentityProviderError;
+	m_identityProvider->maxRetries = maxRetries;
+	m_identityProvider->idempotent = false;
+
+	m_identity.reset( new Http2Service() );
+	m_identity->client = m_client.get();
+	m_identity->name = CognitoJson::IdentityService;
+	m_identity->mapper = &CognitoJson::IdentityError;
+	m_identity->maxRetries = maxRetries;
+	m_identity->idempotent = true;
+
+	CognitoJson::Endpoints( regionId,
+		options.endpointOverride,
+		m_identityProvider->endpoint,
+		m_identity->endpoint );
+
+	m_executor.reset( new ThreadPool(
+		options.asyncThreads > 0 ? options.asyncThreads : 4 ) );
+}
+
+awsx::Http2Transport::~Http2Transport()
+{
+	StopKeepAlive();
+
+	// calls still queued fail now; the ones their handlers start fail
+	// right away
+	m_client->Stop();
+}
+
+void awsx::Http2Transport::Warmup()
+{
+	std::vector<std::future<void>> done;
+
+	for ( const auto * service :
+		{ m_identityProvider.get(), m_identity.get() } ) {
+		auto request = std::make_shared<Http2Request>();
+		request->endpoint = service->endpoint;
+
+		auto promise = std::make_shared<std::promise<void>>();
+		done.push_back( promise->get_future() );
+
+		// any answer, even an error, leaves the connection open; failures
+		// surface again, with a proper outcome, on the first login
+		m_client->Post( request,
+			std::chrono::milliseconds( 0 ),
+			[promise]( const HttpResponse &, const std::string &, bool ) {
+				promise->set_value();
+			} );
+	}
+
+	for ( auto & future : done ) {
+		future.wait();
+	}
+
+	Touch();
+}
+
+InitiateAuthOutcome awsx::Http2Transport::InitiateAuth(
+	const InitiateAuthRequest & request ) const
+{
+	return Wait<InitiateAuthOutcome, InitiateAuthResult>( *m_identityProvider,
+		"InitiateAuth",
+		CognitoJson::Write( request ) );
+}
+
+void awsx::Http2Transport::InitiateAuthAsync(
+	const InitiateAuthRequest & request,
+	const InitiateAuthHandler & handler ) const
+{
+	Dispatch<InitiateAuthOutcome, InitiateAuthResult>( *m_identityProvider,
+		*m_executor,
+		"InitiateAuth",
+		CognitoJson::Write( request ),
+		handler );
+}
+
+AdminInitiateAuthOutcome awsx::Http2Transport::AdminInitiateAuth(
+	const AdminInitiateAuthRequest & ) const
+{
+	return AdminInitiateAuthOutcome(
+		Aws::Client::AWSError<
+			Aws::CognitoIdentityProvider::CognitoIdentityProviderErrors>(
+			Aws::CognitoIdentityProvider::CognitoIdentityProviderErrors::
+				INVALID_PARAMETER,
+			"NotSupported",
+			"AdminInitiateAuth needs signed requests, use TransportKind::Sdk",
+			false ) );
+}
+
+void awsx::Http2Transport::AdminInitiateAuthAsync(
+	const AdminInitiateAuthRequest & request,
+	const AdminInitiateAuthHandler & handler ) const
+{
+	handler( AdminInitiateAuth( request ) );
+}
+
+RespondToAuthChallengeOutcome awsx::Http2Transport::RespondToAuthChallenge(
+	const RespondToAuthChallengeRequest & request ) const
+{
+	return Wait<RespondToAuthChallengeOutcome, RespondToAuthChallengeResult>(
+		*m_identityProvider,
+		"RespondToAuthChallenge",
+		CognitoJson::Write( request ) );
+}
+
+void awsx::Http2Transport::RespondToAuthChallengeAsync(
+	const RespondToAuthChallengeRequest & request,
+	const RespondToAuthChallengeHandler & handler ) const
+{
+	Dispatch<RespondToAuthChallengeOutcome, RespondToAuthChallengeResult>(
+		*m_identityProvider,
+		*m_executor,
+		"RespondToAuthChallenge",
+		CognitoJson::Write( request ),
+		handler );
+}
+
+ConfirmDeviceOutcome awsx::Http2Transport::ConfirmDevice(
+	const ConfirmDeviceRequest & request ) const
+{
+	return Wait<ConfirmDeviceOutcome, ConfirmDeviceResult>(
+		*m_identityProvider, "ConfirmDevice", CognitoJson::Write( request ) );
+}
+
+void awsx::Http2Transport::ConfirmDeviceAsync(
+	const ConfirmDeviceRequest & request,
+	const ConfirmDeviceHandler & handler ) const
+{
+	Dispatch<ConfirmDeviceOutcome, ConfirmDeviceResult>( *m_identityProvider,
+		*m_executor,
+		"ConfirmDevice",
+		CognitoJson::Write( request ),
+		handler );
+}
+
+UpdateDeviceStatusOutcome awsx::Http2Transport::UpdateDeviceStatus(
+	const UpdateDeviceStatusRequest & request ) const
+{
+	return Wait<UpdateDeviceStatusOutcome, UpdateDeviceStatusResult>(
+		*m_identityProvider,
+		"UpdateDeviceStatus",
+		CognitoJson::Write( request ) );
+}
+
+void awsx::Http2Transport::UpdateDeviceStatusAsync(
+	const UpdateDeviceStatusRequest & request,
+	const UpdateDeviceStatusHandler & handler ) const
+{
+	Dispatch<UpdateDeviceStatusOutcome, UpdateDeviceStatusResult>(
+		*m_identityProvider,
+		*m_executor,
+		"UpdateDeviceStatus",
+		CognitoJson::Write( request ),
+		handler );
+}
+
+GetIdOutcome awsx::Http2Transport::GetId( const GetIdRequest & request ) const
+{
+	return Wait<GetIdOutcome, GetIdResult>(
+		*m_identity, "GetId", CognitoJson::Write( request ) );
+}
+
+void awsx::Http2Transport::GetIdAsync(
+	const GetIdRequest & request, const GetIdHandler & handler ) const
+{
+	Dispatch<GetIdOutcome, GetIdResult>( *m_identity,
+		*m_executor,
+		"GetId",
+		CognitoJson::Write( request ),
+		handler );
+}
+
+GetCredentialsForIdentityOutcome
+awsx::Http2Transport::GetCredentialsForIdentity(
+	const GetCredentialsForIdentityRequest & request ) const
+{
+	return Wait<GetCredentialsForIdentityOutcome,
+		GetCredentialsForIdentityResult>( *m_identity,
+		"GetCredentialsForIdentity",
+		CognitoJson::Write( request ) );
+}
+
+void awsx::Http2Transport::GetCredentialsForIdentityAsync(
+	const GetCredentialsForIdentityRequest & request,
+	const GetCredentialsForIdentityHandler & handler ) const
+{
+	Dispatch<GetCredentialsForIdentityOutcome,
+		GetCredentialsForIdentityResult>( *m_identity,
+		*m_executor,
+		"GetCredentialsForIdentity",
+		CognitoJson::Write( request ),
+		handler );
+}
@@ -0,0 +1,295 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thread>
+
+#include "aws/cognito-idp/CognitoIdentityProviderErrors.h"
+#include "aws/cognito-idp/model/AdminInitiateAuthRequest.h"
+#include "aws/cognito-idp/model/ConfirmDeviceRequest.h"
+#include "aws/cognito-idp/model/ConfirmDeviceResult.h"
+#include "aws/cognito-idp/model/InitiateAuthRequest.h"
+#include "aws/cognito-idp/model/InitiateAuthResult.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeRequest.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeResult.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusRequest.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusResult.h"
+
+#include "aws/cognito-identity/model/GetCredentialsForIdentityRequest.h"
+#include "aws/cognito-identity/model/GetCredentialsForIdentityResult.h"
+#include "aws/cognito-identity/model/GetIdRequest.h"
+#include "aws/cognito-identity/model/GetIdResult.h"
+
+#include "include/CognitoJson.hpp"
+#include "include/Http.hpp"
+
+#include "../../include/aws-cpp-cognito-auth/Executor.hpp"
+#include "../../include/aws-cpp-cognito-auth/HttpTransport.hpp"
+
+
+using namespace awsx;
+using namespace Aws::CognitoIdentityProvider::Model;
+using namespace Aws::CognitoIdentity::Model;
+
+
+// One JSON 1.1 operation, retried with exponential backoff while the error
+// allows it. Only idempotent operations are resent after a network error
+// the server may have acted on, e.g. a timeout.
+template <typename TOutcome, typename TResult>
+static TOutcome Call( HttpConnectionPool & pool,
+	long maxRetries,
+	const char * service,
+	const char * operation,
+	CognitoJson::ErrorMapper mapper,
+	bool idempotent,
+	const std::string & body )
+{
+	const auto headers = CognitoJson::Headers( service, operation );
+
+	for ( long attempt = 0;; attempt++ ) {
+		TOutcome outcome;
+
+		try {
+			outcome = CognitoJson::MakeOutcome<TOutcome, TResult>(
+				pool.Post( headers, body ), mapper );
+		}
+		catch ( const HttpException & e ) {
+			outcome = CognitoJson::ErrorOutcome<TOutcome>(
+				CognitoJson::NetworkError(
+					e.what(), idempotent || e.Retryable() ) );
+		}
+
+		if ( outcome.IsSuccess() || !outcome.GetError().ShouldRetry()
+			|| attempt >= maxRetries ) {
+			return outcome;
+		}
+
+		std::this_thread::sleep_for( CognitoJson::Backoff( attempt ) );
+	}
+}
+
+template <typename TOutcome, typename TResult>
+static TOutcome IdentityProviderCall( HttpConnectionPool & pool,
+	long maxRetries,
+	const char * operation,
+	const std::string & body )
+{
+	return Call<TOutcome, TResult>( pool,
+		maxRetries,
+		CognitoJson::IdentityProviderService,
+		operation,
+		&CognitoJson::IdentityProviderError,
+		false,
+		body );
+}
+
+template <typename TOutcome, typename TResult>
+static TOutcome IdentityCall( HttpConnectionPool & pool,
+	long maxRetries,
+	const char * operation,
+	const std::string & body )
+{
+	return Call<TOutcome, TResult>( pool,
+		maxRetries,
+		CognitoJson::IdentityService,
+		operation,
+		&CognitoJson::IdentityError,
+		true,
+		body );
+}
+
+
+awsx::HttpTransport::HttpTransport(
+	const std::string & regionId, const CognitoAuthOptions & options )
+	: m_maxRetries(
+		  CognitoJson::Retries( options.maxRetries, options.loginTimeout ) )
+{
+	HttpEndpoint identityProvider;
+	HttpEndpoint identity;
+	CognitoJson::Endpoints(
+		regionId, options.endpointOverride, identityProvider, identity );
+
+	std::chrono::milliseconds timeout( 3000 );
+
+	if ( options.loginTimeout.count() > 0 ) {
+		timeout = options.loginTimeout;
+	}
+
+	size_t maxIdle = options.maxConnections > 0 ? options.maxConnections : 25;
+	std::shared_ptr<TlsContext> tls;
+
+	if ( identityProvider.tls || identity.tls ) {
+		tls = std::make_shared<TlsContext>();
+	}
+
+	m_identityProvider.reset(
+		new HttpConnectionPool( identityProvider, tls, timeout, maxIdle ) );
+	m_identity.reset(
+		new HttpConnectionPool( identity, tls, timeout, maxIdle ) );
+	m_executor.reset( new ThreadPool(
+		options.asyncThreads > 0 ? options.asyncThreads : 4 ) );
+}
+
+awsx::HttpTransport::~HttpTransport()
+{
+	StopKeepAlive();
+}
+
+void awsx::HttpTransport::Warmup()
+{
+	// failures surface again, with a proper outcome, on the first login
+	try {
+		m_identityProvider->Connect();
+		m_identity->Connect();
+	}
+	catch ( const HttpException & ) {
+	}
+
+	Touch();
+}
+
+InitiateAuthOutcome awsx::HttpTransport::InitiateAuth(
+	const InitiateAuthRequest & request ) const
+{
+	return IdentityProviderCall<InitiateAuthOutcome, InitiateAuthResult>(
+		*m_identityProvider,
+		m_maxRetries,
+		"InitiateAuth",
+		CognitoJson::Write( request ) );
+}
+
+void awsx::HttpTransport::InitiateAuthAsync(
+	const InitiateAuthRequest & request,
+	const InitiateAuthHandler & handler ) const
+{
+	m_executor->Submit(
+		[this, request, handler]() { handler( InitiateAuth( request ) ); } );
+}
+
+AdminInitiateAuthOutcome awsx::HttpTransport::AdminInitiateAuth(
+	const AdminInitiateAuthRequest & ) const
+{
+	return AdminInitiateAuthOutcome(
+		Aws::Client::AWSError<
+			Aws::CognitoIdentityProvider::CognitoIdentityProviderErrors>(
+			Aws::CognitoIdentityProvider::CognitoIdentityProviderErrors::
+				INVALID_PARAMETER,
+			"NotSupported",
+			"AdminInitiateAuth needs signed requests, use TransportKind::Sdk",
+			false ) );
+}
+
+void awsx::HttpTransport::AdminInitiateAuthAsync(
+	const AdminInitiateAuthRequest & request,
+	const AdminInitiateAuthHandler & handler ) const
+{
+	handler( AdminInitiateAuth( request ) );
+}
+
+RespondToAuthChallengeOutcome awsx::HttpTransport::RespondToAuthChallenge(
+	const RespondToAuthChallengeRequest & request ) const
+{
+	return IdentityProviderCall<RespondToAuthChallengeOutcome,
+		RespondToAuthChallengeResult>( *m_identityProvider,
+		m_maxRetries,
+		"RespondToAuthChallenge",
+		CognitoJson::Write( request ) );
+}
+
+void awsx::HttpTransport::RespondToAuthChallengeAsync(
+	const RespondToAuthChallengeRequest & request,
+	const RespondToAuthChallengeHandler & handler ) const
+{
+	m_executor->Submit( [this, request, handler]() {
+		handler( RespondToAuthChallenge( request ) );
+	} );
+}
+
+ConfirmDeviceOutcome awsx::HttpTransport::ConfirmDevice(
+	const ConfirmDeviceRequest & request ) const
+{
+	return IdentityProviderCall<ConfirmDeviceOutcome, ConfirmDeviceResult>(
+		*m_identityProvider,
+		m_maxRetries,
+		"ConfirmDevice",
+		CognitoJson::Write( request ) );
+}
+
+void awsx::HttpTransport::ConfirmDeviceAsync(
+	const ConfirmDeviceRequest & request,
+	const ConfirmDeviceHandler & handler ) const
+{
+	m_executor->Submit(
+		[this, request, handler]() { handler( ConfirmDevice( request ) ); } );
+}
+
+UpdateDeviceStatusOutcome awsx::HttpTransport::UpdateDeviceStatus(
+	const UpdateDeviceStatusRequest & request ) const
+{
+	return IdentityProviderCall<UpdateDeviceStatusOutcome,
+		UpdateDeviceStatusResult>( *m_identityProvider,
+		m_maxRetries,
+		"UpdateDeviceStatus",
+		CognitoJson::Write( request ) );
+}
+
+void awsx::HttpTransport::UpdateDeviceStatusAsync(
+	const UpdateDeviceStatusRequest & request,
+	const UpdateDeviceStatusHandler & handler ) const
+{
+	m_executor->Submit( [this, request, handler]() {
+		handler( UpdateDeviceStatus( request ) );
+	} );
+}
+
+GetIdOutcome awsx::HttpTransport::GetId( const GetIdRequest & request ) const
+{
+	return IdentityCall<GetIdOutcome, GetIdResult>(
+		*m_identity, m_maxRetries, "GetId", CognitoJson::Write( request ) );
+}
+
+void awsx::HttpTransport::GetIdAsync(
+	const GetIdRequest & request, const GetIdHandler & handler ) const
+{
+	m_executor->Submit(
+		[this, request, handler]() { handler( GetId( request ) ); } );
+}
+
+GetCredentialsForIdentityOutcome awsx::HttpTransport::GetCredentialsForIdentity(
+	const GetCredentialsForIdentityRequest & request ) const
+{
+	return IdentityCall<GetCredentialsForIdentityOutcome,
+		GetCredentialsForIdentityResult>( *m_identity,
+		m_maxRetries,
+		"GetCredentialsForIdentity",
+		CognitoJson::Write( request ) );
+}
+
+void awsx::HttpTransport::GetCredentialsForIdentityAsync(
+	const GetCredentialsForIdentityRequest & request,
+	const GetCredentialsForIdentityHandler & handler ) const
+{
+	m_executor->Submit( [this, request, handler]() {
+		handler( GetCredentialsForIdentity( request ) );
+	} );
+}
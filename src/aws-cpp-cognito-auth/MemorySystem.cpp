@@ -0,0 +1,382 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "../../include/aws-cpp-cognito-auth/MemorySystem.hpp"
+
+
+using namespace awsx;
+
+
+static const size_t s_classCount = 32;
+static const size_t s_maxPooled = 8192;
+static const size_t s_slabSize = 64 * 1024;
+
+// size class of blocks from malloc
+static const uint32_t s_large = UINT32_MAX;
+
+// Precedes every block, keeping it 16 byte aligned.
+struct BlockHeader {
+	// malloc'ed memory of a large block
+	void * raw;
+	uint32_t sizeClass;
+	uint32_t reserved;
+};
+
+static_assert( sizeof( BlockHeader ) == 16, "block header must be 16 bytes" );
+
+struct FreeBlock {
+	FreeBlock * next;
+};
+
+// 16 byte steps up to 128, then four classes per power of two: 16, 32, ...
+// 128, 160, 192, 224, 256, 320, ... 8192.
+static size_t ClassSize( size_t sizeClass )
+{
+	if ( sizeClass < 8 ) {
+		return ( sizeClass + 1 ) * 16;
+	}
+
+	size_t power = 128 << ( ( sizeClass - 8 ) / 4 );
+
+	return power + power / 4 * ( ( sizeClass - 8 ) % 4 + 1 );
+}
+
+static size_t SizeClass( size_t size )
+{
+	static const struct Table {
+		uint8_t classes[s_maxPooled / 16 + 1];
+
+		Table()
+		{
+			size_t sizeClass = 0;
+
+			for ( size_t i = 0; i <= s_maxPooled / 16; i++ ) {
+				while ( ClassSize( sizeClass ) < i * 16 ) {
+					++sizeClass;
+				}
+
+				classes[i] = static_cast<uint8_t>( sizeClass );
+			}
+		}
+	} table;
+
+	return table.classes[( size + 15 ) / 16];
+}
+
+// blocks moved between a thread and the shared pool at once
+static size_t BatchSize( size_t sizeClass )
+{
+	size_t stride = ClassSize( sizeClass ) + sizeof( BlockHeader );
+
+	return std::max<size_t>(
+		4, std::min<size_t>( 64, s_slabSize / 4 / stride ) );
+}
+
+
+class awsx::PooledMemorySystem::Central {
+public:
+	std::mutex mutex;
+	FreeBlock * heads[s_classCount];
+	std::vector<void *> slabs;
+	size_t slabBytes;
+	uint64_t refills;
+	std::atomic<uint64_t> largeAllocations;
+
+	Central()
+		: slabBytes( 0 )
+		, refills( 0 )
+		, largeAllocations( 0 )
+	{
+		std::fill( heads, heads + s_classCount, nullptr );
+	}
+
+	~Central()
+	{
+		for ( auto slab : slabs ) {
+			free( slab );
+		}
+	}
+
+	// Takes up to count blocks of the class, carving a new slab when the
+	// free list is empty. Returns the chain and its length.
+	FreeBlock * Take( size_t sizeClass, size_t count, size_t & taken )
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+
+		++refills;
+
+		if ( !heads[sizeClass] ) {
+			Carve( sizeClass );
+		}
+
+		FreeBlock * first = heads[sizeClass];
+		FreeBlock * last = first;
+		taken = 1;
+
+		while ( taken < count && last->next ) {
+			last = last->next;
+			++taken;
+		}
+
+		heads[sizeClass] = last->next;
+		last->next = nullptr;
+
+		return first;
+	}
+
+	void Give( size_t sizeClass, FreeBlock * first, FreeBlock * last )
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+
+		last->next = heads[sizeClass];
+		heads[sizeClass] = first;
+	}
+
+protected:
+	void Carve( size_t sizeClass )
+	{
+		size_t stride = sizeof( BlockHeader ) + ClassSize( sizeClass );
+		size_t count = std::max<size_t>( s_slabSize / stride, 1 );
+		auto slab = static_cast<uint8_t *>( malloc( stride * count ) );
+
+		if ( !slab ) {
+			throw std::bad_alloc();
+		}
+
+		slabs.push_back( slab );
+		slabBytes += stride * count;
+
+		FreeBlock * head = nullptr;
+
+		for ( size_t i = count; i-- > 0; ) {
+			auto header = reinterpret_cast<BlockHeader *>( slab + i * stride );
+			header->raw = nullptr;
+			header->sizeClass = static_cast<uint32_t>( sizeClass );
+
+			auto block = reinterpret_cast<FreeBlock *>( header + 1 );
+			block->next = head;
+			head = block;
+		}
+
+		heads[sizeClass] = head;
+	}
+};
+
+// Free lists of one thread. Holds on to the shared pool, so blocks freed by
+// the thread after the memory system is gone still have somewhere to go.
+struct ThreadCache {
+	std::shared_ptr<PooledMemorySystem::Central> central;
+	FreeBlock * heads[s_classCount];
+	size_t counts[s_classCount];
+
+	ThreadCache()
+	{
+		std::fill( heads, heads + s_classCount, nullptr );
+		std::fill( counts, counts + s_classCount, 0 );
+	}
+
+	~ThreadCache();
+
+	// Returns count blocks of the class to the shared pool.
+	void Release( size_t sizeClass, size_t count )
+	{
+		FreeBlock * first = heads[sizeClass];
+		FreeBlock * last = first;
+
+		for ( size_t i = 1; i < count; i++ ) {
+			last = last->next;
+		}
+
+		heads[sizeClass] = last->next;
+		counts[sizeClass] -= count;
+
+		central->Give( sizeClass, first, last );
+	}
+
+	void Flush()
+	{
+		if ( !central ) {
+			return;
+		}
+
+		for ( size_t i = 0; i < s_classCount; i++ ) {
+			if ( counts[i] > 0 ) {
+				Release( i, counts[i] );
+			}
+		}
+	}
+};
+
+static thread_local ThreadCache t_cache;
+
+// set once the thread's cache is destroyed, for blocks freed by thread_local
+// destructors running after it
+static thread_local bool t_cacheGone = false;
+
+ThreadCache::~ThreadCache()
+{
+	Flush();
+	t_cacheGone = true;
+}
+
+// Returns the calling thread's cache, or nullptr when blocks have to go
+// through the shared pool.
+static ThreadCache * CacheFor(
+	const std::shared_ptr<PooledMemorySystem::Central> & central )
+{
+	if ( t_cacheGone ) {
+		return nullptr;
+	}
+
+	auto & cache = t_cache;
+
+	if ( !cache.central ) {
+		cache.central = central;
+	}
+
+	// the thread's lists may belong to another memory system
+	return cache.central == central ? &cache : nullptr;
+}
+
+
+awsx::PooledMemorySystem::PooledMemorySystem()
+	: m_central( std::make_shared<Central>() )
+{
+}
+
+awsx::PooledMemorySystem::~PooledMemorySystem()
+{
+}
+
+void awsx::PooledMemorySystem::Begin()
+{
+}
+
+void awsx::PooledMemorySystem::End()
+{
+	if ( !t_cacheGone && t_cache.central == m_central ) {
+		t_cache.Flush();
+	}
+}
+
+void * awsx::PooledMemorySystem::AllocateMemory(
+	std::size_t blockSize, std::size_t alignment, const char * allocationTag )
+{
+	( void )allocationTag;
+
+	if ( blockSize > s_maxPooled || alignment > sizeof( BlockHeader ) ) {
+		++m_central->largeAllocations;
+
+		size_t padding = std::max( alignment, sizeof( BlockHeader ) );
+		auto raw = static_cast<uint8_t *>(
+			malloc( blockSize + padding + sizeof( BlockHeader ) ) );
+
+		if ( !raw ) {
+			throw std::bad_alloc();
+		}
+
+		uintptr_t start = reinterpret_cast<uintptr_t>( raw )
+			+ sizeof( BlockHeader ) + padding - 1;
+		auto block = reinterpret_cast<uint8_t *>( start - start % padding );
+
+		auto header = reinterpret_cast<BlockHeader *>( block ) - 1;
+		header->raw = raw;
+		header->sizeClass = s_large;
+
+		return block;
+	}
+
+	size_t sizeClass = SizeClass( blockSize );
+	auto cache = CacheFor( m_central );
+
+	if ( !cache ) {
+		size_t taken;
+
+		return m_central->Take( sizeClass, 1, taken );
+	}
+
+	if ( !cache->heads[sizeClass] ) {
+		cache->heads[sizeClass] = m_central->Take(
+			sizeClass, BatchSize( sizeClass ), cache->counts[sizeClass] );
+	}
+
+	FreeBlock * block = cache->heads[sizeClass];
+	cache->heads[sizeClass] = block->next;
+	--cache->counts[sizeClass];
+
+	return block;
+}
+
+void awsx::PooledMemorySystem::FreeMemory( void * memoryPtr )
+{
+	if ( !memoryPtr ) {
+		return;
+	}
+
+	auto header = static_cast<BlockHeader *>( memoryPtr ) - 1;
+
+	if ( header->sizeClass == s_large ) {
+		free( header->raw );
+		return;
+	}
+
+	size_t sizeClass = header->sizeClass;
+	auto block = static_cast<FreeBlock *>( memoryPtr );
+	auto cache = CacheFor( m_central );
+
+	if ( !cache ) {
+		m_central->Give( sizeClass, block, block );
+		return;
+	}
+
+	block->next = cache->heads[sizeClass];
+	cache->heads[sizeClass] = block;
+
+	// keep up to two batches, so a thread freeing what others allocate
+	// does not pile up blocks
+	size_t batch = BatchSize( sizeClass );
+
+	if ( ++cache->counts[sizeClass] > 2 * batch ) {
+		cache->Release( sizeClass, batch );
+	}
+}
+
+PooledMemoryStats awsx::PooledMemorySystem::GetStats() const
+{
+	std::lock_guard<std::mutex> lock( m_central->mutex );
+
+	PooledMemoryStats stats;
+	stats.slabBytes = m_central->slabBytes;
+	stats.refills = m_central->refills;
+	stats.largeAllocations = m_central->largeAllocations;
+
+	return stats;
+}
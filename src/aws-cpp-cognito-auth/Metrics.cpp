@@ -0,0 +1,406 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include "aws/core/monitoring/CoreMetrics.h"
+#include "aws/core/monitoring/HttpClientMetrics.h"
+#include "aws/core/monitoring/MonitoringFactory.h"
+#include "aws/core/monitoring/MonitoringInterface.h"
+
+#include "../../include/aws-cpp-cognito-auth/Metrics.hpp"
+
+
+using namespace awsx;
+
+
+static const char * s_apiNames[CognitoMetrics::ApiCount] = { "InitiateAuth",
+	"AdminInitiateAuth",
+	"RespondToAuthChallenge",
+	"ConfirmDevice",
+	"UpdateDeviceStatus",
+	"GetId",
+	"GetCredentialsForIdentity" };
+
+static void AddAtomic( std::atomic<uint64_t> & counter, uint64_t value = 1 )
+{
+	counter.fetch_add( value, std::memory_order_relaxed );
+}
+
+static uint64_t LoadAtomic( const std::atomic<uint64_t> & counter )
+{
+	return counter.load( std::memory_order_relaxed );
+}
+
+// "cognito-idp" or "Cognito Identity Provider", depending on the SDK version
+static bool IsCognito( const Aws::String & serviceName )
+{
+	static const char prefix[] = "cognito";
+
+	if ( serviceName.size() < sizeof( prefix ) - 1 ) {
+		return false;
+	}
+
+	for ( size_t i = 0; i + 1 < sizeof( prefix ); i++ ) {
+		if ( tolower( static_cast<unsigned char>( serviceName[i] ) )
+			!= prefix[i] ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Adds a metric of the SDK's HTTP client, reported in milliseconds.
+static void AddMetric( LatencyCounter & counter,
+	const Aws::Monitoring::CoreMetricsCollection & metrics,
+	Aws::Monitoring::HttpClientMetricsType type,
+	bool addZero = false )
+{
+	auto found = metrics.httpClientMetrics.find(
+		Aws::Monitoring::GetHttpClientMetricNameByType( type ) );
+
+	if ( found == metrics.httpClientMetrics.end() || found->second < 0
+		|| ( found->second == 0 && !addZero ) ) {
+		return;
+	}
+
+	counter.Add( std::chrono::milliseconds( found->second ) );
+}
+
+
+// State of one request between OnRequestStarted and OnFinish.
+struct MonitoredRequest {
+	CognitoMetrics::Api api;
+	std::chrono::steady_clock::time_point attemptStarted;
+};
+
+class CognitoMonitor : public Aws::Monitoring::MonitoringInterface {
+protected:
+	std::shared_ptr<CognitoMetrics> m_metrics;
+
+protected:
+	void OnAttempt( const Aws::Monitoring::CoreMetricsCollection & metrics,
+		void * context,
+		bool failed ) const
+	{
+		if ( !context ) {
+			return;
+		}
+
+		auto request = static_cast<MonitoredRequest *>( context );
+		auto & counters = m_metrics->Of( request->api );
+
+		counters.attempt.Add(
+			std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - request->attemptStarted ) );
+
+		if ( failed ) {
+			AddAtomic( counters.failures );
+		}
+
+		using Aws::Monitoring::HttpClientMetricsType;
+
+		// zero when the attempt reused a connection
+		AddMetric( counters.dns, metrics, HttpClientMetricsType::DnsLatency );
+		AddMetric(
+			counters.connect, metrics, HttpClientMetricsType::TcpLatency );
+		AddMetric( counters.tls, metrics, HttpClientMetricsType::SslLatency );
+
+		AddMetric( counters.firstByte,
+			metrics,
+			HttpClientMetricsType::ConnectLatency,
+			true );
+
+		auto reused = metrics.httpClientMetrics.find(
+			Aws::Monitoring::GetHttpClientMetricNameByType(
+				HttpClientMetricsType::ConnectionReused ) );
+
+		if ( reused != metrics.httpClientMetrics.end() && reused->second ) {
+			AddAtomic( counters.reusedConnections );
+		}
+	}
+
+public:
+	explicit CognitoMonitor( std::shared_ptr<CognitoMetrics> metrics )
+		: m_metrics( metrics )
+	{
+	}
+
+	void * OnRequestStarted( const Aws::String & serviceName,
+		const Aws::String & requestName,
+		const std::shared_ptr<const Aws::Http::HttpRequest> & ) const override
+	{
+		if ( !IsCognito( serviceName ) ) {
+			return nullptr;
+		}
+
+		auto api = CognitoMetrics::Find( requestName.c_str() );
+
+		if ( api == CognitoMetrics::ApiCount ) {
+			return nullptr;
+		}
+
+		AddAtomic( m_metrics->Of( api ).requests );
+
+		return new MonitoredRequest{ api, std::chrono::steady_clock::now() };
+	}
+
+	void OnRequestSucceeded( const Aws::String &,
+		const Aws::String &,
+		const std::shared_ptr<const Aws::Http::HttpRequest> &,
+		const Aws::Client::HttpResponseOutcome &,
+		const Aws::Monitoring::CoreMetricsCollection & metrics,
+		void * context ) const override
+	{
+		OnAttempt( metrics, context, false );
+	}
+
+	void OnRequestFailed( const Aws::String &,
+		const Aws::String &,
+		const std::shared_ptr<const Aws::Http::HttpRequest> &,
+		const Aws::Client::HttpResponseOutcome &,
+		const Aws::Monitoring::CoreMetricsCollection & metrics,
+		void * context ) const override
+	{
+		OnAttempt( metrics, context, true );
+	}
+
+	void OnRequestRetry( const Aws::String &,
+		const Aws::String &,
+		const std::shared_ptr<const Aws::Http::HttpRequest> &,
+		void * context ) const override
+	{
+		if ( !context ) {
+			return;
+		}
+
+		auto request = static_cast<MonitoredRequest *>( context );
+		request->attemptStarted = std::chrono::steady_clock::now();
+
+		AddAtomic( m_metrics->Of( request->api ).retries );
+	}
+
+	void OnFinish( const Aws::String &,
+		const Aws::String &,
+		const std::shared_ptr<const Aws::Http::HttpRequest> &,
+		void * context ) const override
+	{
+		delete static_cast<MonitoredRequest *>( context );
+	}
+};
+
+class CognitoMonitorFactory : public Aws::Monitoring::MonitoringFactory {
+protected:
+	std::shared_ptr<CognitoMetrics> m_metrics;
+
+public:
+	explicit CognitoMonitorFactory( std::shared_ptr<CognitoMetrics> metrics )
+		: m_metrics( metrics )
+	{
+	}
+
+	Aws::UniquePtr<Aws::Monitoring::MonitoringInterface>
+	CreateMonitoringInstance() const override
+	{
+		return Aws::MakeUnique<CognitoMonitor>( "CognitoMonitor", m_metrics );
+	}
+};
+
+
+std::chrono::microseconds awsx::LatencySnapshot::Percentile(
+	double percentile ) const
+{
+	if ( count == 0 ) {
+		return std::chrono::microseconds( 0 );
+	}
+
+	uint64_t rank = static_cast<uint64_t>( count * percentile / 100.0 );
+	uint64_t seen = 0;
+
+	for ( size_t i = 0; i < buckets.size(); i++ ) {
+		seen += buckets[i];
+
+		if ( seen > rank ) {
+			return std::min( max,
+				std::chrono::microseconds( static_cast<int64_t>(
+					LatencyCounter::ValueAt( i ) ) ) );
+		}
+	}
+
+	return max;
+}
+
+
+awsx::LatencyCounter::LatencyCounter()
+	: m_count( 0 )
+	, m_total( 0 )
+	, m_max( 0 )
+{
+	for ( auto & bucket : m_buckets ) {
+		bucket = 0;
+	}
+}
+
+size_t awsx::LatencyCounter::Index( uint64_t value )
+{
+	const uint64_t subCount = 1 << s_subBits;
+
+	if ( value < 2 * subCount ) {
+		return static_cast<size_t>( value );
+	}
+
+	int msb = s_subBits;
+
+	while ( msb < s_maxBits && ( value >> ( msb + 1 ) ) != 0 ) {
+		msb++;
+	}
+
+	int shift = msb - s_subBits;
+
+	// clamped into the last bucket
+	value = std::min( value, ( uint64_t( 2 ) << msb ) - 1 );
+
+	return static_cast<size_t>( 2 * subCount + ( shift - 1 ) * subCount
+		+ ( value >> shift ) - subCount );
+}
+
+uint64_t awsx::LatencyCounter::ValueAt( size_t index )
+{
+	const uint64_t subCount = 1 << s_subBits;
+
+	if ( index < 2 * subCount ) {
+		return index;
+	}
+
+	int shift = static_cast<int>( ( index - 2 * subCount ) / subCount ) + 1;
+	uint64_t mantissa = ( index - 2 * subCount ) % subCount + subCount;
+
+	return ( ( mantissa + 1 ) << shift ) - 1;
+}
+
+void awsx::LatencyCounter::Add( std::chrono::microseconds latency )
+{
+	int64_t value = std::max<int64_t>( latency.count(), 0 );
+
+	AddAtomic( m_buckets[Index( static_cast<uint64_t>( value ) )] );
+	AddAtomic( m_count );
+	m_total.fetch_add( value, std::memory_order_relaxed );
+
+	int64_t max = m_max.load( std::memory_order_relaxed );
+
+	while ( value > max
+		&& !m_max.compare_exchange_weak(
+			max, value, std::memory_order_relaxed ) ) {
+	}
+}
+
+LatencySnapshot awsx::LatencyCounter::Snapshot() const
+{
+	LatencySnapshot snapshot;
+	snapshot.buckets.resize( s_bucketCount );
+
+	for ( size_t i = 0; i < s_bucketCount; i++ ) {
+		snapshot.buckets[i] = LoadAtomic( m_buckets[i] );
+		snapshot.count += snapshot.buckets[i];
+	}
+
+	// the buckets decide the count, so percentiles add up
+	snapshot.total = std::chrono::microseconds(
+		m_total.load( std::memory_order_relaxed ) );
+	snapshot.max = std::chrono::microseconds(
+		m_max.load( std::memory_order_relaxed ) );
+
+	return snapshot;
+}
+
+
+awsx::CognitoMetrics::Counters::Counters()
+	: requests( 0 )
+	, retries( 0 )
+	, failures( 0 )
+	, reusedConnections( 0 )
+{
+}
+
+awsx::CognitoMetrics::CognitoMetrics()
+	: m_counters( new Counters[ApiCount] )
+{
+}
+
+void awsx::CognitoMetrics::Install(
+	const std::shared_ptr<CognitoMetrics> & metrics,
+	Aws::SDKOptions & options )
+{
+	options.monitoringOptions.customizedMonitoringFactory_create_fn.push_back(
+		[metrics]() {
+			return Aws::UniquePtr<Aws::Monitoring::MonitoringFactory>(
+				Aws::New<CognitoMonitorFactory>(
+					"CognitoMonitorFactory", metrics ) );
+		} );
+}
+
+const char * awsx::CognitoMetrics::Name( Api api )
+{
+	return api < ApiCount ? s_apiNames[api] : "";
+}
+
+CognitoMetrics::Api awsx::CognitoMetrics::Find( const char * requestName )
+{
+	for ( int i = 0; i < ApiCount; i++ ) {
+		if ( strcmp( requestName, s_apiNames[i] ) == 0 ) {
+			return static_cast<Api>( i );
+		}
+	}
+
+	return ApiCount;
+}
+
+std::map<std::string, ApiMetrics> awsx::CognitoMetrics::Snapshot() const
+{
+	std::map<std::string, ApiMetrics> snapshot;
+
+	for ( int i = 0; i < ApiCount; i++ ) {
+		const Counters & counters = m_counters[i];
+
+		if ( LoadAtomic( counters.requests ) == 0 ) {
+			continue;
+		}
+
+		ApiMetrics & api = snapshot[s_apiNames[i]];
+		api.requests = LoadAtomic( counters.requests );
+		api.retries = LoadAtomic( counters.retries );
+		api.failures = LoadAtomic( counters.failures );
+		api.reusedConnections = LoadAtomic( counters.reusedConnections );
+		api.attempt = counters.attempt.Snapshot();
+		api.dns = counters.dns.Snapshot();
+		api.connect = counters.connect.Snapshot();
+		api.tls = counters.tls.Snapshot();
+		api.firstByte = counters.firstByte.Snapshot();
+	}
+
+	return snapshot;
+}
@@ -0,0 +1,187 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <openssl/rand.h>
+
+#include "include/Crypt.hpp"
+
+#include "../../include/aws-cpp-cognito-auth/NegativeCache.hpp"
+
+
+using namespace awsx;
+
+
+static std::string RandomKey()
+{
+	std::vector<uint8_t> key( 32 );
+
+	if ( RAND_bytes( key.data(), static_cast<int>( key.size() ) ) != 1 ) {
+		throw std::runtime_error( "RAND_bytes failed" );
+	}
+
+	return std::string( key.begin(), key.end() );
+}
+
+
+awsx::NegativeCache::NegativeCache( const NegativeCachePolicy & policy )
+	: m_policy( policy )
+	, m_key( new HmacSha256Key( RandomKey() ) )
+	, m_hits( 0 )
+	, m_rejections( 0 )
+{
+}
+
+awsx::NegativeCache::~NegativeCache()
+{
+}
+
+std::string awsx::NegativeCache::MakeKey( const std::string & userPoolId,
+	const std::string & username,
+	const std::string & password ) const
+{
+	std::vector<uint8_t> fingerprint;
+	m_key->Compute( fingerprint, password );
+
+	std::string key = userPoolId;
+	key += '\0';
+	key += username;
+	key += '\0';
+	key.append( fingerprint.begin(), fingerprint.end() );
+
+	return key;
+}
+
+void awsx::NegativeCache::MakeRoom()
+{
+	m_entries.erase( m_order.front() );
+	m_order.pop_front();
+}
+
+bool awsx::NegativeCache::IsRejected( const std::string & userPoolId,
+	const std::string & username,
+	const std::string & password,
+	AuthError & error )
+{
+	auto key = MakeKey( userPoolId, username, password );
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	auto it = m_entries.find( key );
+
+	if ( it == m_entries.end()
+		|| it->second.until <= std::chrono::steady_clock::now() ) {
+		return false;
+	}
+
+	++m_hits;
+	error = it->second.error;
+
+	return true;
+}
+
+void awsx::NegativeCache::Reject( const std::string & userPoolId,
+	const std::string & username,
+	const std::string & password,
+	const AuthError & error )
+{
+	if ( m_policy.maxEntries == 0 ) {
+		return;
+	}
+
+	auto key = MakeKey( userPoolId, username, password );
+	auto now = std::chrono::steady_clock::now();
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	++m_rejections;
+
+	auto it = m_entries.find( key );
+
+	if ( it == m_entries.end() ) {
+		if ( m_entries.size() >= m_policy.maxEntries ) {
+			MakeRoom();
+		}
+
+		it = m_entries.insert( std::make_pair( key, Entry() ) ).first;
+		it->second.rejections = 0;
+		it->second.position = m_order.insert( m_order.end(), key );
+	}
+	else {
+		if ( it->second.until + m_policy.maxTtl <= now ) {
+			it->second.rejections = 0;
+		}
+
+		m_order.splice( m_order.end(), m_order, it->second.position );
+	}
+
+	auto & entry = it->second;
+
+	double ttl = m_policy.initialTtl.count()
+		* std::pow( m_policy.multiplier, entry.rejections );
+	ttl = std::min( ttl, static_cast<double>( m_policy.maxTtl.count() ) );
+
+	++entry.rejections;
+	entry.until = now
+		+ std::chrono::milliseconds( static_cast<long long>( ttl ) );
+	entry.error = error;
+}
+
+void awsx::NegativeCache::Accept( const std::string & userPoolId,
+	const std::string & username,
+	const std::string & password )
+{
+	auto key = MakeKey( userPoolId, username, password );
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	auto it = m_entries.find( key );
+
+	if ( it != m_entries.end() ) {
+		m_order.erase( it->second.position );
+		m_entries.erase( it );
+	}
+}
+
+void awsx::NegativeCache::Clear()
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_entries.clear();
+	m_order.clear();
+}
+
+NegativeCacheStats awsx::NegativeCache::GetStats() const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	NegativeCacheStats stats;
+	stats.hits = m_hits;
+	stats.rejections = m_rejections;
+	stats.entries = m_entries.size();
+
+	return stats;
+}
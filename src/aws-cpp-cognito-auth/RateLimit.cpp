@@ -0,0 +1,459 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "aws/core/client/AWSError.h"
+#include "aws/core/client/CoreErrors.h"
+
+#include "aws/cognito-idp/model/AdminInitiateAuthRequest.h"
+#include "aws/cognito-idp/model/ConfirmDeviceRequest.h"
+#include "aws/cognito-idp/model/InitiateAuthRequest.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeRequest.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusRequest.h"
+
+#include "aws/cognito-identity/model/GetCredentialsForIdentityRequest.h"
+#include "aws/cognito-identity/model/GetIdRequest.h"
+
+#include "../../include/aws-cpp-cognito-auth/RateLimit.hpp"
+
+
+using namespace awsx;
+using namespace Aws::CognitoIdentityProvider::Model;
+using namespace Aws::CognitoIdentity::Model;
+
+
+// TooManyRequestsException is what Cognito sends when a quota is exceeded,
+// the SDK reports its own throttling errors as CoreErrors::THROTTLING.
+template <typename TOutcome>
+static bool IsThrottled( const TOutcome & outcome )
+{
+	if ( outcome.IsSuccess() ) {
+		return false;
+	}
+
+	const auto & error = outcome.GetError();
+	const auto & name = error.GetExceptionName();
+
+	return name == "TooManyRequestsException" || name == "ThrottlingException"
+		|| static_cast<int>( error.GetErrorType() )
+		== static_cast<int>( Aws::Client::CoreErrors::THROTTLING );
+}
+
+template <typename TOutcome>
+static TOutcome Dropped( std::chrono::milliseconds maxWait )
+{
+	typedef typename std::decay<decltype(
+		std::declval<TOutcome>().GetError() )>::type TError;
+
+	std::string message = "no client side rate limit slot within "
+		+ std::to_string( maxWait.count() ) + " ms";
+
+	return TOutcome( TError( Aws::Client::AWSError<Aws::Client::CoreErrors>(
+		Aws::Client::CoreErrors::THROTTLING,
+		"TooManyRequestsException",
+		message.c_str(),
+		false ) ) );
+}
+
+template <typename TOutcome, typename TRequest, typename THandler>
+static void Limit( const std::shared_ptr<AdaptiveLimiter> & limiter,
+	const std::shared_ptr<CognitoTransport> & transport,
+	void ( CognitoTransport::*async )( const TRequest &, const THandler & )
+		const,
+	const TRequest & request,
+	const THandler & handler,
+	std::chrono::milliseconds maxWait )
+{
+	limiter->Submit(
+		[limiter, transport, async, request, handler](
+			AdaptiveLimiter::Ticket ticket ) {
+			( transport.get()->*async )( request,
+				[limiter, ticket, handler]( const TOutcome & outcome ) {
+					limiter->Complete( ticket, IsThrottled( outcome ) );
+					handler( outcome );
+				} );
+		},
+		[handler, maxWait]() { handler( Dropped<TOutcome>( maxWait ) ); } );
+}
+
+
+awsx::AdaptiveLimiter::AdaptiveLimiter(
+	const RateLimit & limit, std::chrono::milliseconds maxWait )
+	: m_limit( limit )
+	, m_maxWait( maxWait )
+	, m_stop( false )
+	, m_tokens( std::max( limit.burst, 1.0 ) )
+	, m_refilled( std::chrono::steady_clock::now() )
+	, m_inFlight( 0 )
+	, m_decreased( Ticket::min() )
+	, m_started( 0 )
+	, m_throttled( 0 )
+	, m_expired( 0 )
+{
+	m_limit.minConcurrency = std::max<size_t>( m_limit.minConcurrency, 1 );
+	m_limit.maxConcurrency
+		= std::max( m_limit.maxConcurrency, m_limit.minConcurrency );
+	m_window = static_cast<double>( m_limit.maxConcurrency );
+}
+
+awsx::AdaptiveLimiter::~AdaptiveLimiter()
+{
+	Stop();
+}
+
+void awsx::AdaptiveLimiter::Refill( std::chrono::steady_clock::time_point now )
+{
+	if ( m_limit.rate > 0.0 ) {
+		std::chrono::duration<double> elapsed = now - m_refilled;
+		m_tokens = std::min( std::max( m_limit.burst, 1.0 ),
+			m_tokens + elapsed.count() * m_limit.rate );
+	}
+
+	m_refilled = now;
+}
+
+bool awsx::AdaptiveLimiter::CanStart() const
+{
+	return m_inFlight < static_cast<size_t>( m_window )
+		&& ( m_limit.rate <= 0.0 || m_tokens >= 1.0 );
+}
+
+void awsx::AdaptiveLimiter::Take()
+{
+	if ( m_limit.rate > 0.0 ) {
+		m_tokens -= 1.0;
+	}
+
+	++m_inFlight;
+	++m_started;
+}
+
+void awsx::AdaptiveLimiter::Run()
+{
+	std::unique_lock<std::mutex> lock( m_mutex );
+
+	for ( ;; ) {
+		auto now = std::chrono::steady_clock::now();
+		Refill( now );
+
+		std::vector<Start> starts;
+		std::vector<Expire> expires;
+
+		while ( !m_stop && !m_queue.empty() && CanStart() ) {
+			Take();
+			starts.push_back( std::move( m_queue.front().start ) );
+			m_queue.pop_front();
+		}
+
+		// all requests wait the same maxWait, so the oldest expire first
+		while ( !m_queue.empty()
+			&& ( m_stop || m_queue.front().deadline <= now ) ) {
+			++m_expired;
+			expires.push_back( std::move( m_queue.front().expire ) );
+			m_queue.pop_front();
+		}
+
+		if ( !starts.empty() || !expires.empty() ) {
+			lock.unlock();
+
+			for ( auto & start : starts ) {
+				start( now );
+			}
+
+			for ( auto & expire : expires ) {
+				expire();
+			}
+
+			lock.lock();
+			continue;
+		}
+
+		if ( m_stop ) {
+			break;
+		}
+
+		if ( m_queue.empty() ) {
+			m_condition.wait( lock );
+			continue;
+		}
+
+		// a free slot waits for the next token, a full window for Complete()
+		auto wake = m_queue.front().deadline;
+
+		if ( m_inFlight < static_cast<size_t>( m_window ) ) {
+			auto refill = std::chrono::duration_cast<
+				std::chrono::steady_clock::duration>(
+				std::chrono::duration<double>(
+					( 1.0 - m_tokens ) / m_limit.rate ) );
+			wake = std::min( wake, now + refill );
+		}
+
+		m_condition.wait_until( lock, wake );
+	}
+}
+
+void awsx::AdaptiveLimiter::Submit( const Start & start, const Expire & expire )
+{
+	std::unique_lock<std::mutex> lock( m_mutex );
+
+	if ( m_stop ) {
+		lock.unlock();
+		expire();
+		return;
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	Refill( now );
+
+	if ( m_queue.empty() && CanStart() ) {
+		Take();
+		lock.unlock();
+		start( now );
+		return;
+	}
+
+	m_queue.push_back( Waiter{ start, expire, now + m_maxWait } );
+
+	if ( !m_thread.joinable() ) {
+		m_thread = std::thread( [this]() { Run(); } );
+	}
+	else {
+		m_condition.notify_one();
+	}
+}
+
+void awsx::AdaptiveLimiter::Complete( Ticket ticket, bool throttled )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	--m_inFlight;
+
+	if ( throttled ) {
+		++m_throttled;
+
+		if ( ticket >= m_decreased ) {
+			m_window = std::max( m_window / 2.0,
+				static_cast<double>( m_limit.minConcurrency ) );
+			m_decreased = std::chrono::steady_clock::now();
+		}
+	}
+	else {
+		m_window = std::min( m_window + 1.0 / m_window,
+			static_cast<double>( m_limit.maxConcurrency ) );
+	}
+
+	if ( !m_queue.empty() ) {
+		m_condition.notify_one();
+	}
+}
+
+void awsx::AdaptiveLimiter::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_stop = true;
+	}
+
+	m_condition.notify_one();
+
+	if ( m_thread.joinable() ) {
+		m_thread.join();
+	}
+}
+
+RateLimitStats awsx::AdaptiveLimiter::GetStats() const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	RateLimitStats stats;
+	stats.queued = m_queue.size();
+	stats.inFlight = m_inFlight;
+	stats.concurrency = m_window;
+	stats.started = m_started;
+	stats.throttled = m_throttled;
+	stats.expired = m_expired;
+
+	return stats;
+}
+
+
+awsx::RateLimitedTransport::RateLimitedTransport(
+	std::shared_ptr<CognitoTransport> transport,
+	const RateLimitPolicy & policy )
+	: m_authentication( std::make_shared<AdaptiveLimiter>(
+		  policy.authentication, policy.maxWait ) )
+	, m_devices(
+		  std::make_shared<AdaptiveLimiter>( policy.devices, policy.maxWait ) )
+	, m_identity(
+		  std::make_shared<AdaptiveLimiter>( policy.identity, policy.maxWait ) )
+	, m_maxWait( policy.maxWait )
+	, m_transport( transport )
+{
+}
+
+awsx::RateLimitedTransport::~RateLimitedTransport()
+{
+	StopKeepAlive();
+
+	// no new calls reach the transport once the limiters stopped
+	m_authentication->Stop();
+	m_devices->Stop();
+	m_identity->Stop();
+}
+
+void awsx::RateLimitedTransport::Warmup()
+{
+	m_transport->Warmup();
+}
+
+InitiateAuthOutcome awsx::RateLimitedTransport::InitiateAuth(
+	const InitiateAuthRequest & request ) const
+{
+	return InitiateAuthCallable( request ).get();
+}
+
+void awsx::RateLimitedTransport::InitiateAuthAsync(
+	const InitiateAuthRequest & request,
+	const InitiateAuthHandler & handler ) const
+{
+	Limit<InitiateAuthOutcome>( m_authentication,
+		m_transport,
+		&CognitoTransport::InitiateAuthAsync,
+		request,
+		handler,
+		m_maxWait );
+}
+
+AdminInitiateAuthOutcome awsx::RateLimitedTransport::AdminInitiateAuth(
+	const AdminInitiateAuthRequest & request ) const
+{
+	return AdminInitiateAuthCallable( request ).get();
+}
+
+void awsx::RateLimitedTransport::AdminInitiateAuthAsync(
+	const AdminInitiateAuthRequest & request,
+	const AdminInitiateAuthHandler & handler ) const
+{
+	Limit<AdminInitiateAuthOutcome>( m_authentication,
+		m_transport,
+		&CognitoTransport::AdminInitiateAuthAsync,
+		request,
+		handler,
+		m_maxWait );
+}
+
+RespondToAuthChallengeOutcome
+awsx::RateLimitedTransport::RespondToAuthChallenge(
+	const RespondToAuthChallengeRequest & request ) const
+{
+	return RespondToAuthChallengeCallable( request ).get();
+}
+
+void awsx::RateLimitedTransport::RespondToAuthChallengeAsync(
+	const RespondToAuthChallengeRequest & request,
+	const RespondToAuthChallengeHandler & handler ) const
+{
+	Limit<RespondToAuthChallengeOutcome>( m_authentication,
+		m_transport,
+		&CognitoTransport::RespondToAuthChallengeAsync,
+		request,
+		handler,
+		m_maxWait );
+}
+
+ConfirmDeviceOutcome awsx::RateLimitedTransport::ConfirmDevice(
+	const ConfirmDeviceRequest & request ) const
+{
+	return ConfirmDeviceCallable( request ).get();
+}
+
+void awsx::RateLimitedTransport::ConfirmDeviceAsync(
+	const ConfirmDeviceRequest & request,
+	const ConfirmDeviceHandler & handler ) const
+{
+	Limit<ConfirmDeviceOutcome>( m_devices,
+		m_transport,
+		&CognitoTransport::ConfirmDeviceAsync,
+		request,
+		handler,
+		m_maxWait );
+}
+
+UpdateDeviceStatusOutcome awsx::RateLimitedTransport::UpdateDeviceStatus(
+	const UpdateDeviceStatusRequest & request ) const
+{
+	return UpdateDeviceStatusCallable( request ).get();
+}
+
+void awsx::RateLimitedTransport::UpdateDeviceStatusAsync(
+	const UpdateDeviceStatusRequest & request,
+	const UpdateDeviceStatusHandler & handler ) const
+{
+	Limit<UpdateDeviceStatusOutcome>( m_devices,
+		m_transport,
+		&CognitoTransport::UpdateDeviceStatusAsync,
+		request,
+		handler,
+		m_maxWait );
+}
+
+GetIdOutcome awsx::RateLimitedTransport::GetId(
+	const GetIdRequest & request ) const
+{
+	return GetIdCallable( request ).get();
+}
+
+void awsx::RateLimitedTransport::GetIdAsync(
+	const GetIdRequest & request,
+	const GetIdHandler & handler ) const
+{
+	Limit<GetIdOutcome>( m_identity,
+		m_transport,
+		&CognitoTransport::GetIdAsync,
+		request,
+		handler,
+		m_maxWait );
+}
+
+GetCredentialsForIdentityOutcome
+awsx::RateLimitedTransport::GetCredentialsForIdentity(
+	const GetCredentialsForIdentityRequest & request ) const
+{
+	return GetCredentialsForIdentityCallable( request ).get();
+}
+
+void awsx::RateLimitedTransport::GetCredentialsForIdentityAsync(
+	const GetCredentialsForIdentityRequest & request,
+	const GetCredentialsForIdentityHandler & handler ) const
+{
+	Limit<GetCredentialsForIdentityOutcome>( m_identity,
+		m_transport,
+		&CognitoTransport::GetCredentialsForIdentityAsync,
+		request,
+		handler,
+		m_maxWait );
+}
@@ -0,0 +1,450 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "include/TimerWheel.hpp"
+
+#include "../../include/aws-cpp-cognito-auth/Executor.hpp"
+#include "../../include/aws-cpp-cognito-auth/RefreshScheduler.hpp"
+
+
+using namespace awsx;
+
+
+// Ends with the tokens or the credentials, whichever expire first.
+static std::chrono::system_clock::time_point ExpirationOf(
+	const CognitoLogin & login,
+	bool hasCredentials,
+	std::chrono::system_clock::time_point now )
+{
+	// lifetime of identity pool credentials and of the tokens by default,
+	// for responses without one
+	static const std::chrono::seconds s_lifetime( 3600 );
+
+	std::chrono::seconds tokensLifetime( login.tokens.GetExpiresIn() );
+	auto expiration
+		= now + ( tokensLifetime.count() > 0 ? tokensLifetime : s_lifetime );
+
+	if ( hasCredentials ) {
+		expiration = std::min( expiration,
+			login.identity.expiration > now ? login.identity.expiration
+											: now + s_lifetime );
+	}
+
+	return expiration;
+}
+
+
+awsx::RefreshScheduler::RefreshScheduler(
+	CognitoAuth & auth, const RefreshSchedulerOptions & options )
+	: m_auth( auth )
+	, m_options( options )
+	, m_stop( true )
+	, m_started( std::chrono::steady_clock::now() )
+	, m_wheel( new TimerWheel() )
+	, m_random( std::random_device()() )
+	, m_tokens( 1.0 )
+	, m_refilled( m_started )
+	, m_wakeTick( 0 )
+	, m_stats()
+{
+	m_options.threads = std::max<size_t>( m_options.threads, 1 );
+}
+
+awsx::RefreshScheduler::~RefreshScheduler()
+{
+	Stop();
+}
+
+uint64_t awsx::RefreshScheduler::Tick(
+	std::chrono::steady_clock::time_point time ) const
+{
+	return static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::seconds>( time - m_started )
+			.count() );
+}
+
+const RefreshScheduler::Session * awsx::RefreshScheduler::Find(
+	SessionId id ) const
+{
+	uint32_t index = static_cast<uint32_t>( id );
+	uint32_t generation = static_cast<uint32_t>( id >> 32 );
+
+	if ( index >= m_sessions.size() || !m_sessions[index].live
+		|| m_sessions[index].generation != generation ) {
+		return nullptr;
+	}
+
+	return &m_sessions[index];
+}
+
+RefreshScheduler::Session * awsx::RefreshScheduler::Find( SessionId id )
+{
+	return const_cast<Session *>(
+		static_cast<const RefreshScheduler *>( this )->Find( id ) );
+}
+
+void awsx::RefreshScheduler::Schedule(
+	SessionId id, std::chrono::seconds delay )
+{
+	uint64_t tick = Tick( std::chrono::steady_clock::now() )
+		+ static_cast<uint64_t>( std::max<int64_t>( delay.count(), 0 ) );
+
+	Find( id )->timer = m_wheel->Insert( tick, id );
+
+	// the timer is due before the scheduler thread wakes up
+	if ( tick < m_wakeTick ) {
+		m_condition.notify_one();
+	}
+}
+
+void awsx::RefreshScheduler::ScheduleRenewal( SessionId id )
+{
+	const Session & session = *Find( id );
+
+	auto now = std::chrono::system_clock::now();
+	auto lifetime = std::chrono::duration_cast<std::chrono::seconds>(
+		session.expiration - now );
+
+	auto ahead = std::min( m_options.refreshAhead, lifetime / 2 );
+	std::uniform_int_distribution<int64_t> jitter(
+		0, std::max<int64_t>( m_options.jitter.count(), 0 ) );
+
+	Schedule(
+		id, lifetime - ahead - std::chrono::seconds( jitter( m_random ) ) );
+}
+
+void awsx::RefreshScheduler::Run()
+{
+	std::vector<uint64_t> expired;
+	std::unique_lock<std::mutex> lock( m_mutex );
+
+	while ( !m_stop ) {
+		auto now = std::chrono::steady_clock::now();
+
+		expired.clear();
+		m_wheel->Advance( Tick( now ), expired );
+
+		for ( auto id : expired ) {
+			Session * session = Find( id );
+
+			if ( session ) {
+				session->timer = TimerWheel::s_none;
+				m_due.push( Due{ session->expiration, now, id } );
+			}
+		}
+
+		if ( m_options.maxRate > 0.0 ) {
+			std::chrono::duration<double> elapsed = now - m_refilled;
+			m_tokens = std::min( std::max( m_options.maxRate, 1.0 ),
+				m_tokens + elapsed.count() * m_options.maxRate );
+		}
+
+		m_refilled = now;
+
+		while ( !m_due.empty()
+			&& ( m_options.maxRate <= 0.0 || m_tokens >= 1.0 ) ) {
+			Due due = m_due.top();
+			m_due.pop();
+
+			// removed while it waited
+			if ( !Find( due.id ) ) {
+				continue;
+			}
+
+			m_tokens -= 1.0;
+			m_stats.maxWait = std::max( m_stats.maxWait,
+				std::chrono::duration_cast<std::chrono::milliseconds>(
+					now - due.since ) );
+
+			SessionId id = due.id;
+			m_workers->Submit( [this, id]() { Renew( id ); } );
+		}
+
+		m_wakeTick = m_wheel->NextTick();
+		auto wake = m_started + std::chrono::seconds( m_wakeTick );
+
+		if ( !m_due.empty() && m_options.maxRate > 0.0 ) {
+			// the next rate limit slot
+			wake = std::min( wake,
+				now
+					+ std::chrono::duration_cast<
+						std::chrono::steady_clock::duration>(
+						std::chrono::duration<double>(
+							( 1.0 - m_tokens ) / m_options.maxRate ) ) );
+		}
+
+		m_condition.wait_until( lock, wake );
+	}
+}
+
+void awsx::RefreshScheduler::Renew( SessionId id )
+{
+	std::string username;
+	std::string password;
+	std::string userPoolId;
+	std::string identityPoolId;
+	std::string refreshToken;
+	std::string identityId;
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		const Session * session = Find( id );
+
+		if ( !session ) {
+			return;
+		}
+
+		if ( m_stop ) {
+			// due again once Start() runs the queue
+			m_due.push( Due{ session->expiration,
+				std::chrono::steady_clock::now(),
+				id } );
+
+			return;
+		}
+
+		username = session->username;
+		password = session->password;
+		userPoolId = session->userPoolId;
+		identityPoolId = session->identityPoolId;
+		refreshToken = session->login.tokens.GetRefreshToken();
+		identityId = session->login.identity.identityId;
+	}
+
+	CognitoLogin login;
+	bool renewed = false;
+	bool loggedIn = false;
+
+	try {
+		login.tokens
+			= m_auth.RefreshWithUserPool( username, refreshToken, userPoolId );
+		renewed = true;
+	}
+	catch ( const NotAuthorizedException & ) {
+		// the refresh token expired or was revoked
+		if ( !password.empty() && identityPoolId.empty() ) {
+			auto tokens = m_auth.TryAuthenticateWithUserPool(
+				username, password, userPoolId );
+
+			if ( tokens ) {
+				login.tokens = tokens.Value();
+				renewed = loggedIn = true;
+			}
+		}
+		else if ( !password.empty() ) {
+			auto result = m_auth.TryLogin(
+				username, password, userPoolId, identityPoolId );
+
+			if ( result ) {
+				login = result.Value();
+				renewed = loggedIn = true;
+			}
+		}
+	}
+	catch ( const std::exception & ) {
+	}
+
+	if ( renewed && !loggedIn && !identityPoolId.empty() ) {
+		auto identity = m_auth.TryGetIdentityCredentials(
+			login.tokens.GetIdToken(), userPoolId, identityPoolId, identityId );
+
+		if ( identity ) {
+			login.identity = identity.Value();
+		}
+		else {
+			renewed = false;
+		}
+	}
+
+	auto now = std::chrono::system_clock::now();
+	std::chrono::system_clock::time_point missedExpiration;
+	bool missed = false;
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		Session * session = Find( id );
+
+		if ( !session ) {
+			return;
+		}
+
+		if ( now >= session->expiration && !session->missed ) {
+			session->missed = true;
+			missed = true;
+			missedExpiration = session->expiration;
+			++m_stats.missedDeadlines;
+		}
+
+		if ( renewed ) {
+			session->login = login;
+			session->expiration
+				= ExpirationOf( login, !identityPoolId.empty(), now );
+			session->backoff = std::chrono::seconds( 1 );
+			session->missed = false;
+
+			++( loggedIn ? m_stats.loggedIn : m_stats.refreshed );
+
+			ScheduleRenewal( id );
+		}
+		else {
+			++m_stats.failed;
+
+			Schedule( id, session->backoff );
+			session->backoff = std::min(
+				session->backoff * 2, std::chrono::seconds( 60 ) );
+		}
+	}
+
+	if ( missed && m_missListener ) {
+		m_missListener( id, username, missedExpiration );
+	}
+
+	if ( renewed && m_listener ) {
+		m_listener( id, login );
+	}
+}
+
+void awsx::RefreshScheduler::Start(
+	const Listener & listener, const MissListener & missListener )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	if ( m_thread.joinable() ) {
+		throw Exception( "RefreshScheduler: already started" );
+	}
+
+	m_listener = listener;
+	m_missListener = missListener;
+	m_stop = false;
+	m_workers.reset( new ThreadPool( m_options.threads ) );
+	m_thread = std::thread( &RefreshScheduler::Run, this );
+}
+
+void awsx::RefreshScheduler::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_stop = true;
+	}
+
+	m_condition.notify_all();
+
+	if ( m_thread.joinable() ) {
+		m_thread.join();
+	}
+
+	// waits for the running renewals, the queued ones go back to m_due
+	m_workers.reset();
+}
+
+RefreshScheduler::SessionId awsx::RefreshScheduler::Add(
+	const std::string & username,
+	const std::string & password,
+	const std::string & userPoolId,
+	const std::string & identityPoolId,
+	const CognitoLogin & login )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	uint32_t index;
+
+	if ( !m_freeSessions.empty() ) {
+		index = m_freeSessions.back();
+		m_freeSessions.pop_back();
+	}
+	else {
+		index = static_cast<uint32_t>( m_sessions.size() );
+		m_sessions.push_back( Session() );
+		m_sessions.back().generation = 0;
+	}
+
+	Session & session = m_sessions[index];
+	session.live = true;
+	session.username = username;
+	session.password = password;
+	session.userPoolId = userPoolId;
+	session.identityPoolId = identityPoolId;
+	session.login = login;
+	session.expiration = ExpirationOf(
+		login, !identityPoolId.empty(), std::chrono::system_clock::now() );
+	session.timer = TimerWheel::s_none;
+	session.backoff = std::chrono::seconds( 1 );
+	session.missed = false;
+
+	SessionId id = ( SessionId( session.generation ) << 32 ) | index;
+
+	ScheduleRenewal( id );
+	++m_stats.sessions;
+
+	return id;
+}
+
+bool awsx::RefreshScheduler::Remove( SessionId id )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	Session * session = Find( id );
+
+	if ( !session ) {
+		return false;
+	}
+
+	m_wheel->Cancel( session->timer );
+
+	// stale ids, and a renewal still running, no longer find it
+	++session->generation;
+	session->live = false;
+	session->password.clear();
+	session->login = CognitoLogin();
+
+	m_freeSessions.push_back( static_cast<uint32_t>( id ) );
+	--m_stats.sessions;
+
+	return true;
+}
+
+bool awsx::RefreshScheduler::Get( SessionId id, CognitoLogin & login ) const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	const Session * session = Find( id );
+
+	if ( !session ) {
+		return false;
+	}
+
+	login = session->login;
+
+	return true;
+}
+
+RefreshSchedulerStats awsx::RefreshScheduler::GetStats() const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	RefreshSchedulerStats stats = m_stats;
+	stats.waiting = m_due.size();
+
+	return stats;
+}
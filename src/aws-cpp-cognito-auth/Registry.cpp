@@ -0,0 +1,190 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <functional>
+
+#include "include/Srp.hpp"
+
+#include "../../include/aws-cpp-cognito-auth/Registry.hpp"
+
+
+using namespace awsx;
+
+
+awsx::CognitoAuthRegistry::CognitoAuthRegistry(
+	const CognitoAuthOptions & options, size_t shards )
+	: m_options( options )
+{
+	// tenants come and go at runtime, warm the regions explicitly instead
+	m_options.warmup = false;
+
+	m_shards.resize( shards > 0 ? shards : 1 );
+
+	for ( auto & shard : m_shards ) {
+		shard.reset( new Shard() );
+	}
+}
+
+CognitoAuthRegistry::Shard & awsx::CognitoAuthRegistry::ShardOf(
+	const std::string & tenantId ) const
+{
+	return *m_shards[std::hash<std::string>()( tenantId ) % m_shards.size()];
+}
+
+bool awsx::CognitoAuthRegistry::Find(
+	const std::string & tenantId, Entry & out ) const
+{
+	Shard & shard = ShardOf( tenantId );
+	std::lock_guard<std::mutex> lock( shard.mutex );
+
+	auto it = shard.tenants.find( tenantId );
+
+	if ( it == shard.tenants.end() ) {
+		return false;
+	}
+
+	out = it->second;
+
+	return true;
+}
+
+std::shared_ptr<CognitoTransport> awsx::CognitoAuthRegistry::GetTransport(
+	const std::string & regionId )
+{
+	std::lock_guard<std::mutex> lock( m_regionsMutex );
+
+	auto & transport = m_regions[regionId];
+
+	if ( !transport ) {
+		transport = CognitoAuth::MakeTransport( regionId, m_options );
+	}
+
+	return transport;
+}
+
+void awsx::CognitoAuthRegistry::Register(
+	const std::string & tenantId, const CognitoTenant & tenant )
+{
+	CognitoAuthOptions options( m_options );
+	options.clientSecret = tenant.clientSecret;
+
+	// lazyStart stays with the shared regional transports; per tenant it
+	// would start a thread and an SRP modexp for every registration
+	options.lazyStart = false;
+
+	Entry entry;
+	entry.tenant = tenant;
+	entry.auth = std::make_shared<CognitoAuth>( tenant.regionId,
+		tenant.clientId,
+		GetTransport( tenant.regionId ),
+		options );
+
+	Shard & shard = ShardOf( tenantId );
+	std::lock_guard<std::mutex> lock( shard.mutex );
+
+	shard.tenants[tenantId] = entry;
+}
+
+bool awsx::CognitoAuthRegistry::Remove( const std::string & tenantId )
+{
+	Shard & shard = ShardOf( tenantId );
+	std::lock_guard<std::mutex> lock( shard.mutex );
+
+	return shard.tenants.erase( tenantId ) > 0;
+}
+
+std::shared_ptr<CognitoAuth> awsx::CognitoAuthRegistry::Get(
+	const std::string & tenantId ) const
+{
+	Entry entry;
+
+	if ( !Find( tenantId, entry ) ) {
+		return nullptr;
+	}
+
+	return entry.auth;
+}
+
+size_t awsx::CognitoAuthRegistry::Size() const
+{
+	size_t size = 0;
+
+	for ( auto & shard : m_shards ) {
+		std::lock_guard<std::mutex> lock( shard->mutex );
+		size += shard->tenants.size();
+	}
+
+	return size;
+}
+
+void awsx::CognitoAuthRegistry::Warmup()
+{
+	Srp::Prepare();
+
+	std::vector<std::shared_ptr<CognitoTransport>> regions;
+
+	{
+		std::lock_guard<std::mutex> lock( m_regionsMutex );
+
+		for ( auto & region : m_regions ) {
+			regions.push_back( region.second );
+		}
+	}
+
+	for ( auto & transport : regions ) {
+		transport->Warmup();
+	}
+}
+
+Aws::Auth::AWSCredentials awsx::CognitoAuthRegistry::Authenticate(
+	const std::string & tenantId,
+	const std::string & username,
+	const std::string & password ) const
+{
+	Entry entry;
+
+	if ( !Find( tenantId, entry ) ) {
+		throw Exception( "unknown tenant: " + tenantId );
+	}
+
+	return entry.auth->Authenticate( username,
+		password,
+		entry.tenant.userPoolId,
+		entry.tenant.identityPoolId );
+}
+
+CognitoTokens awsx::CognitoAuthRegistry::AuthenticateWithUserPool(
+	const std::string & tenantId,
+	const std::string & username,
+	const std::string & password ) const
+{
+	Entry entry;
+
+	if ( !Find( tenantId, entry ) ) {
+		throw Exception( "unknown tenant: " + tenantId );
+	}
+
+	return entry.auth->AuthenticateWithUserPool(
+		username, password, entry.tenant.userPoolId );
+}
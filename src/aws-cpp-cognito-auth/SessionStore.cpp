@@ -0,0 +1,492 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <openssl/rand.h>
+
+#include "../../include/aws-cpp-cognito-auth/SessionStore.hpp"
+
+
+using namespace awsx;
+
+
+static const uint32_t s_empty = UINT32_MAX;
+static const uint32_t s_tombstone = UINT32_MAX - 1;
+
+// Precedes the fields of a record: user pool id, username, access, id and
+// refresh token, access key id, secret key and session token, each a 32 bit
+// length and the bytes.
+struct RecordHeader {
+	// bytes after the header, of which size are in use
+	uint32_t capacity;
+	uint32_t size;
+	// milliseconds since the epoch
+	int64_t expiration;
+	int32_t expiresIn;
+	uint32_t live;
+};
+
+static const size_t s_fieldCount = 8;
+
+static size_t RoundUp( size_t bytes )
+{
+	return ( bytes + 7 ) & ~size_t( 7 );
+}
+
+static size_t RecordBytes( const RecordHeader & header )
+{
+	return sizeof( RecordHeader ) + header.capacity;
+}
+
+static int64_t Milliseconds( std::chrono::system_clock::time_point time )
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		time.time_since_epoch() )
+		.count();
+}
+
+static uint64_t RandomSeed()
+{
+	uint64_t seed;
+
+	if ( RAND_bytes( reinterpret_cast<uint8_t *>( &seed ), sizeof( seed ) )
+		!= 1 ) {
+		throw std::runtime_error( "RAND_bytes failed" );
+	}
+
+	return seed;
+}
+
+static uint8_t * PutField( uint8_t * out, const char * data, size_t size )
+{
+	uint32_t length = static_cast<uint32_t>( size );
+
+	memcpy( out, &length, sizeof( length ) );
+	memcpy( out + sizeof( length ), data, size );
+
+	return out + sizeof( length ) + size;
+}
+
+static const uint8_t * GetField(
+	const uint8_t * in, const char *& data, size_t & size )
+{
+	uint32_t length;
+	memcpy( &length, in, sizeof( length ) );
+
+	data = reinterpret_cast<const char *>( in + sizeof( length ) );
+	size = length;
+
+	return in + sizeof( length ) + length;
+}
+
+static bool FieldEquals( const uint8_t *& in, const std::string & value )
+{
+	const char * data;
+	size_t size;
+	in = GetField( in, data, size );
+
+	return size == value.size() && memcmp( data, value.data(), size ) == 0;
+}
+
+
+awsx::SessionStore::SessionStore( size_t expectedSessions, size_t chunkSize )
+	: m_chunkSize( chunkSize )
+	, m_seed( RandomSeed() )
+	, m_sessions( 0 )
+	, m_tombstones( 0 )
+	, m_usedBytes( 0 )
+	, m_liveBytes( 0 )
+	, m_replacedInPlace( 0 )
+	, m_relocated( 0 )
+{
+	size_t capacity = 16;
+
+	while ( capacity * 3 / 4 < expectedSessions ) {
+		capacity *= 2;
+	}
+
+	Slot empty = { 0, s_empty, 0 };
+	m_slots.assign( capacity, empty );
+}
+
+uint64_t awsx::SessionStore::Hash(
+	const std::string & userPoolId, const std::string & username ) const
+{
+	// FNV-1a from a random basis, so colliding usernames cannot be picked
+	// ahead of time, with a final mix for the low bits the table uses
+	uint64_t hash = m_seed;
+
+	for ( unsigned char c : userPoolId ) {
+		hash = ( hash ^ c ) * 0x100000001b3ULL;
+	}
+
+	// a zero byte between the two
+	hash *= 0x100000001b3ULL;
+
+	for ( unsigned char c : username ) {
+		hash = ( hash ^ c ) * 0x100000001b3ULL;
+	}
+
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+uint8_t * awsx::SessionStore::RecordAt( const Slot & slot ) const
+{
+	return m_chunks[slot.chunk].data.get() + slot.offset;
+}
+
+size_t awsx::SessionStore::Find( uint64_t hash,
+	const std::string & userPoolId,
+	const std::string & username,
+	bool & found ) const
+{
+	size_t mask = m_slots.size() - 1;
+	size_t insert = SIZE_MAX;
+
+	for ( size_t i = hash & mask;; i = ( i + 1 ) & mask ) {
+		auto & slot = m_slots[i];
+
+		if ( slot.chunk == s_empty ) {
+			found = false;
+
+			return insert != SIZE_MAX ? insert : i;
+		}
+
+		if ( slot.chunk == s_tombstone ) {
+			if ( insert == SIZE_MAX ) {
+				insert = i;
+			}
+
+			continue;
+		}
+
+		if ( slot.hash != hash ) {
+			continue;
+		}
+
+		const uint8_t * fields = RecordAt( slot ) + sizeof( RecordHeader );
+
+		if ( FieldEquals( fields, userPoolId )
+			&& FieldEquals( fields, username ) ) {
+			found = true;
+
+			return i;
+		}
+	}
+}
+
+SessionStore::Slot awsx::SessionStore::Allocate( size_t bytes )
+{
+	if ( m_chunks.empty()
+		|| m_chunks.back().used + bytes > m_chunks.back().size ) {
+		Chunk chunk;
+		chunk.size = std::max( m_chunkSize, bytes );
+		chunk.data.reset( new uint8_t[chunk.size] );
+		chunk.used = 0;
+
+		m_chunks.push_back( std::move( chunk ) );
+	}
+
+	auto & chunk = m_chunks.back();
+
+	Slot slot;
+	slot.hash = 0;
+	slot.chunk = static_cast<uint32_t>( m_chunks.size() - 1 );
+	slot.offset = static_cast<uint32_t>( chunk.used );
+
+	chunk.used += bytes;
+	m_usedBytes += bytes;
+	m_liveBytes += bytes;
+
+	return slot;
+}
+
+void awsx::SessionStore::Drop( Slot & slot )
+{
+	auto header = reinterpret_cast<RecordHeader *>( RecordAt( slot ) );
+
+	header->live = 0;
+	m_liveBytes -= RecordBytes( *header );
+
+	slot.chunk = s_tombstone;
+	--m_sessions;
+	++m_tombstones;
+}
+
+void awsx::SessionStore::Rehash( size_t capacity )
+{
+	Slot empty = { 0, s_empty, 0 };
+	std::vector<Slot> slots( capacity, empty );
+
+	for ( auto & slot : m_slots ) {
+		if ( slot.chunk == s_empty || slot.chunk == s_tombstone ) {
+			continue;
+		}
+
+		size_t i = slot.hash & ( capacity - 1 );
+
+		while ( slots[i].chunk != s_empty ) {
+			i = ( i + 1 ) & ( capacity - 1 );
+		}
+
+		slots[i] = slot;
+	}
+
+	m_slots.swap( slots );
+	m_tombstones = 0;
+}
+
+void awsx::SessionStore::Compact()
+{
+	std::vector<Chunk> chunks;
+	chunks.swap( m_chunks );
+
+	m_usedBytes = 0;
+	m_liveBytes = 0;
+
+	for ( auto & slot : m_slots ) {
+		if ( slot.chunk == s_empty || slot.chunk == s_tombstone ) {
+			continue;
+		}
+
+		auto from = chunks[slot.chunk].data.get() + slot.offset;
+		auto header = reinterpret_cast<const RecordHeader *>( from );
+		size_t bytes = RecordBytes( *header );
+
+		Slot moved = Allocate( bytes );
+		memcpy( RecordAt( moved ), from, bytes );
+
+		slot.chunk = moved.chunk;
+		slot.offset = moved.offset;
+	}
+}
+
+void awsx::SessionStore::Put( const std::string & userPoolId,
+	const std::string & username,
+	const CognitoTokens & tokens,
+	const Aws::Auth::AWSCredentials & credentials,
+	std::chrono::system_clock::time_point expiration )
+{
+	auto & accessKeyId = credentials.GetAWSAccessKeyId();
+	auto & secretKey = credentials.GetAWSSecretKey();
+	auto & sessionToken = credentials.GetSessionToken();
+
+	size_t size = s_fieldCount * sizeof( uint32_t ) + userPoolId.size()
+		+ username.size() + tokens.GetAccessToken().size()
+		+ tokens.GetIdToken().size() + tokens.GetRefreshToken().size()
+		+ accessKeyId.size() + secretKey.size() + sessionToken.size();
+
+	uint64_t hash = Hash( userPoolId, username );
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	bool found;
+	size_t index = Find( hash, userPoolId, username, found );
+	RecordHeader * header = nullptr;
+
+	if ( found ) {
+		header = reinterpret_cast<RecordHeader *>( RecordAt( m_slots[index] ) );
+
+		if ( size <= header->capacity ) {
+			++m_replacedInPlace;
+		}
+		else {
+			Drop( m_slots[index] );
+			++m_relocated;
+
+			header = nullptr;
+		}
+	}
+	else if ( ( m_sessions + m_tombstones + 1 ) * 4 > m_slots.size() * 3 ) {
+		Rehash( ( m_sessions + 1 ) * 2 > m_slots.size()
+				? m_slots.size() * 2
+				: m_slots.size() );
+
+		index = Find( hash, userPoolId, username, found );
+	}
+
+	if ( !header ) {
+		// room for tokens a few bytes longer after a refresh
+		size_t capacity = RoundUp( size + size / 64 + 16 );
+		Slot slot = Allocate( sizeof( RecordHeader ) + capacity );
+		slot.hash = hash;
+
+		if ( m_slots[index].chunk == s_tombstone ) {
+			--m_tombstones;
+		}
+
+		m_slots[index] = slot;
+		++m_sessions;
+
+		header = reinterpret_cast<RecordHeader *>( RecordAt( slot ) );
+		header->capacity = static_cast<uint32_t>( capacity );
+	}
+
+	header->size = static_cast<uint32_t>( size );
+	header->expiration = Milliseconds( expiration );
+	header->expiresIn = tokens.GetExpiresIn();
+	header->live = 1;
+
+	auto out = reinterpret_cast<uint8_t *>( header + 1 );
+	out = PutField( out, userPoolId.data(), userPoolId.size() );
+	out = PutField( out, username.data(), username.size() );
+	out = PutField( out,
+		tokens.GetAccessToken().data(),
+		tokens.GetAccessToken().size() );
+	out = PutField(
+		out, tokens.GetIdToken().data(), tokens.GetIdToken().size() );
+	out = PutField( out,
+		tokens.GetRefreshToken().data(),
+		tokens.GetRefreshToken().size() );
+	out = PutField( out, accessKeyId.data(), accessKeyId.size() );
+	out = PutField( out, secretKey.data(), secretKey.size() );
+	PutField( out, sessionToken.data(), sessionToken.size() );
+}
+
+bool awsx::SessionStore::Get( const std::string & userPoolId,
+	const std::string & username,
+	CognitoTokens & tokens,
+	Aws::Auth::AWSCredentials & credentials ) const
+{
+	uint64_t hash = Hash( userPoolId, username );
+	auto now = Milliseconds( std::chrono::system_clock::now() );
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	bool found;
+	size_t index = Find( hash, userPoolId, username, found );
+
+	if ( !found ) {
+		return false;
+	}
+
+	auto record = RecordAt( m_slots[index] );
+	auto header = reinterpret_cast<const RecordHeader *>( record );
+
+	if ( header->expiration <= now ) {
+		return false;
+	}
+
+	const char * data[s_fieldCount];
+	size_t size[s_fieldCount];
+	const uint8_t * in = record + sizeof( RecordHeader );
+
+	for ( size_t i = 0; i < s_fieldCount; i++ ) {
+		in = GetField( in, data[i], size[i] );
+	}
+
+	tokens = CognitoTokens( std::string( data[2], size[2] ),
+		std::string( data[3], size[3] ),
+		std::string( data[4], size[4] ),
+		header->expiresIn );
+
+	credentials = Aws::Auth::AWSCredentials( Aws::String( data[5], size[5] ),
+		Aws::String( data[6], size[6] ),
+		Aws::String( data[7], size[7] ) );
+
+	return true;
+}
+
+bool awsx::SessionStore::Erase(
+	const std::string & userPoolId, const std::string & username )
+{
+	uint64_t hash = Hash( userPoolId, username );
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	bool found;
+	size_t index = Find( hash, userPoolId, username, found );
+
+	if ( found ) {
+		Drop( m_slots[index] );
+	}
+
+	return found;
+}
+
+size_t awsx::SessionStore::Expire( std::chrono::system_clock::time_point now )
+{
+	auto limit = Milliseconds( now );
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	size_t dropped = 0;
+
+	for ( auto & slot : m_slots ) {
+		if ( slot.chunk == s_empty || slot.chunk == s_tombstone ) {
+			continue;
+		}
+
+		auto header
+			= reinterpret_cast<const RecordHeader *>( RecordAt( slot ) );
+
+		if ( header->expiration <= limit ) {
+			Drop( slot );
+			++dropped;
+		}
+	}
+
+	if ( m_tombstones * 4 > m_slots.size() ) {
+		Rehash( m_slots.size() );
+	}
+
+	if ( m_usedBytes - m_liveBytes > m_liveBytes ) {
+		Compact();
+	}
+
+	return dropped;
+}
+
+size_t awsx::SessionStore::Size() const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	return m_sessions;
+}
+
+SessionStoreStats awsx::SessionStore::GetStats() const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	SessionStoreStats stats;
+	stats.sessions = m_sessions;
+	stats.arenaBytes = 0;
+	stats.liveBytes = m_liveBytes;
+	stats.indexBytes = m_slots.size() * sizeof( Slot );
+	stats.replacedInPlace = m_replacedInPlace;
+	stats.relocated = m_relocated;
+
+	for ( auto & chunk : m_chunks ) {
+		stats.arenaBytes += chunk.size;
+	}
+
+	return stats;
+}
@@ -0,0 +1,425 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include "../../include/aws-cpp-cognito-auth/SharedCredentials.hpp"
+
+
+using namespace awsx;
+
+
+static_assert( ATOMIC_LLONG_LOCK_FREE == 2,
+	"the seqlock needs lock free 64 bit atomics in shared memory" );
+
+static const uint32_t s_magic = 0x31434341; // "ACC1"
+
+// 32 KiB, a login with large tokens takes about 6 KiB
+static const size_t s_payloadWords = 4096;
+
+// attempts of a Read() racing with Publish() calls before giving up
+static const int s_readAttempts = 1000;
+
+// Layout of the segment. The payload is copied with relaxed atomic loads
+// and stores, the sequence orders them: odd while a Publish() writes,
+// generation times two after.
+struct Segment {
+	std::atomic<uint32_t> magic;
+	std::atomic<uint64_t> sequence;
+	std::atomic<uint64_t> size;
+	std::atomic<uint64_t> payload[s_payloadWords];
+};
+
+
+class awsx::SharedMemory {
+protected:
+#ifdef _WIN32
+	HANDLE m_handle;
+#endif
+	void * m_address;
+
+public:
+	SharedMemory( const std::string & name, bool create )
+	{
+#ifdef _WIN32
+		m_handle = create
+			? CreateFileMappingA( INVALID_HANDLE_VALUE,
+				  nullptr,
+				  PAGE_READWRITE,
+				  0,
+				  static_cast<DWORD>( sizeof( Segment ) ),
+				  name.c_str() )
+			: OpenFileMappingA( FILE_MAP_READ, FALSE, name.c_str() );
+
+		if ( m_handle == nullptr ) {
+			throw Exception( "shared memory " + name + ": error "
+				+ std::to_string( GetLastError() ) );
+		}
+
+		m_address = MapViewOfFile( m_handle,
+			create ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ,
+			0,
+			0,
+			sizeof( Segment ) );
+
+		if ( m_address == nullptr ) {
+			auto error = GetLastError();
+			CloseHandle( m_handle );
+
+			throw Exception( "shared memory " + name + ": error "
+				+ std::to_string( error ) );
+		}
+#else
+		int fd = shm_open(
+			name.c_str(), create ? O_CREAT | O_RDWR : O_RDONLY, 0600 );
+
+		if ( fd < 0 ) {
+			throw Exception(
+				"shared memory " + name + ": " + strerror( errno ) );
+		}
+
+		struct stat status;
+		bool sized = create
+			? ftruncate( fd, sizeof( Segment ) ) == 0
+			: fstat( fd, &status ) == 0
+				&& static_cast<size_t>( status.st_size ) >= sizeof( Segment );
+
+		if ( !sized ) {
+			close( fd );
+			throw Exception( "shared memory " + name + ": not a segment" );
+		}
+
+		m_address = mmap( nullptr,
+			sizeof( Segment ),
+			create ? PROT_READ | PROT_WRITE : PROT_READ,
+			MAP_SHARED,
+			fd,
+			0 );
+
+		close( fd );
+
+		if ( m_address == MAP_FAILED ) {
+			throw Exception(
+				"shared memory " + name + ": " + strerror( errno ) );
+		}
+#endif
+	}
+
+	SharedMemory( const SharedMemory & ) = delete;
+
+	~SharedMemory()
+	{
+#ifdef _WIN32
+		UnmapViewOfFile( m_address );
+		CloseHandle( m_handle );
+#else
+		munmap( m_address, sizeof( Segment ) );
+#endif
+	}
+
+	Segment & Get() const
+	{
+		return *static_cast<Segment *>( m_address );
+	}
+};
+
+
+static void Append( std::string & out, const std::string & field )
+{
+	uint32_t size = static_cast<uint32_t>( field.size() );
+
+	out.append( reinterpret_cast<const char *>( &size ), sizeof( size ) );
+	out += field;
+}
+
+static bool Take( const std::string & in, size_t & at, std::string & field )
+{
+	uint32_t size = 0;
+
+	if ( in.size() - at < sizeof( size ) ) {
+		return false;
+	}
+
+	memcpy( &size, in.data() + at, sizeof( size ) );
+	at += sizeof( size );
+
+	if ( in.size() - at < size ) {
+		return false;
+	}
+
+	field.assign( in, at, size );
+	at += size;
+
+	return true;
+}
+
+
+awsx::SharedCredentialsPublisher::SharedCredentialsPublisher(
+	const std::string & name )
+	: m_memory( new SharedMemory( name, true ) )
+{
+	auto & segment = m_memory->Get();
+
+	if ( segment.magic.load( std::memory_order_acquire ) != s_magic ) {
+		segment.sequence.store( 0, std::memory_order_relaxed );
+		segment.size.store( 0, std::memory_order_relaxed );
+		segment.magic.store( s_magic, std::memory_order_release );
+	}
+	else if ( segment.sequence.load( std::memory_order_relaxed ) & 1 ) {
+		// a previous publisher died in Publish(), its login is torn
+		segment.sequence.fetch_add( 1, std::memory_order_release );
+	}
+}
+
+awsx::SharedCredentialsPublisher::~SharedCredentialsPublisher()
+{
+	Stop();
+}
+
+void awsx::SharedCredentialsPublisher::Publish( CognitoTokens tokens,
+	const Aws::Auth::AWSCredentials & credentials,
+	std::chrono::system_clock::time_point expiration )
+{
+	int64_t expiresAt = std::chrono::duration_cast<std::chrono::milliseconds>(
+		expiration.time_since_epoch() ).count();
+
+	std::string payload(
+		reinterpret_cast<const char *>( &expiresAt ), sizeof( expiresAt ) );
+	Append( payload, credentials.GetAWSAccessKeyId().c_str() );
+	Append( payload, credentials.GetAWSSecretKey().c_str() );
+	Append( payload, credentials.GetSessionToken().c_str() );
+	Append( payload, tokens.GetIdToken() );
+	Append( payload, tokens.GetAccessToken() );
+
+	if ( payload.size() > s_payloadWords * sizeof( uint64_t ) ) {
+		throw Exception( "SharedCredentialsPublisher: login of "
+			+ std::to_string( payload.size() )
+			+ " bytes does not fit the segment" );
+	}
+
+	// whole words
+	payload.resize( ( payload.size() + 7 ) / 8 * 8, '\0' );
+
+	auto & segment = m_memory->Get();
+
+	std::lock_guard<std::mutex> lock( m_publishMutex );
+
+	auto sequence = segment.sequence.load( std::memory_order_relaxed );
+	segment.sequence.store( sequence + 1, std::memory_order_relaxed );
+	std::atomic_thread_fence( std::memory_order_release );
+
+	segment.size.store( payload.size(), std::memory_order_relaxed );
+
+	for ( size_t i = 0; i * sizeof( uint64_t ) < payload.size(); i++ ) {
+		uint64_t word;
+		memcpy( &word, payload.data() + i * sizeof( word ), sizeof( word ) );
+		segment.payload[i].store( word, std::memory_order_relaxed );
+	}
+
+	segment.sequence.store( sequence + 2, std::memory_order_release );
+}
+
+void awsx::SharedCredentialsPublisher::Start( CognitoAuth & auth,
+	const std::string & username,
+	const std::string & password,
+	const std::string & userPoolId,
+	const std::string & identityPoolId,
+	std::chrono::seconds refreshAhead )
+{
+	if ( m_cache ) {
+		throw Exception( "SharedCredentialsPublisher: already started" );
+	}
+
+	m_cache.reset( new CredentialsCache( auth,
+		username,
+		password,
+		userPoolId,
+		identityPoolId,
+		refreshAhead ) );
+
+	m_cache->Start( [this]( const CredentialsCache::Login & login ) {
+		Publish( login.tokens, login.credentials, login.expiration );
+	} );
+}
+
+void awsx::SharedCredentialsPublisher::Stop()
+{
+	if ( m_cache ) {
+		m_cache->Stop();
+		m_cache.reset();
+	}
+}
+
+std::string awsx::SharedCredentialsPublisher::GetLastError() const
+{
+	return m_cache ? m_cache->GetLastError() : std::string();
+}
+
+void awsx::SharedCredentialsPublisher::Remove( const std::string & name )
+{
+#ifdef _WIN32
+	// a file mapping goes away with its last handle
+	(void)name;
+#else
+	shm_unlink( name.c_str() );
+#endif
+}
+
+
+awsx::SharedCredentialsReader::SharedCredentialsReader(
+	const std::string & name )
+	: m_memory( new SharedMemory( name, false ) )
+{
+}
+
+awsx::SharedCredentialsReader::~SharedCredentialsReader()
+{
+}
+
+uint64_t awsx::SharedCredentialsReader::GetGeneration() const
+{
+	auto & segment = m_memory->Get();
+
+	if ( segment.magic.load( std::memory_order_acquire ) != s_magic ) {
+		return 0;
+	}
+
+	return segment.sequence.load( std::memory_order_acquire ) / 2;
+}
+
+bool awsx::SharedCredentialsReader::Read( SharedLogin & login ) const
+{
+	auto & segment = m_memory->Get();
+
+	if ( segment.magic.load( std::memory_order_acquire ) != s_magic ) {
+		return false;
+	}
+
+	std::string payload;
+
+	for ( int attempt = 0; attempt < s_readAttempts; attempt++ ) {
+		auto sequence = segment.sequence.load( std::memory_order_acquire );
+
+		if ( sequence == 0 ) {
+			return false;
+		}
+
+		if ( sequence & 1 ) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		size_t size = static_cast<size_t>( std::min<uint64_t>(
+			segment.size.load( std::memory_order_relaxed ),
+			s_payloadWords * sizeof( uint64_t ) ) );
+
+		payload.resize( size );
+
+		for ( size_t i = 0; i * sizeof( uint64_t ) < size; i++ ) {
+			uint64_t word
+				= segment.payload[i].load( std::memory_order_relaxed );
+			memcpy( &payload[i * sizeof( word )], &word, sizeof( word ) );
+		}
+
+		std::atomic_thread_fence( std::memory_order_acquire );
+
+		if ( segment.sequence.load( std::memory_order_relaxed ) != sequence ) {
+			continue;
+		}
+
+		int64_t expiresAt = 0;
+		size_t at = sizeof( expiresAt );
+
+		if ( size < at ) {
+			return false;
+		}
+
+		memcpy( &expiresAt, payload.data(), sizeof( expiresAt ) );
+
+		login.generation = sequence / 2;
+		login.expiration = std::chrono::system_clock::time_point(
+			std::chrono::duration_cast<std::chrono::system_clock::duration>(
+				std::chrono::milliseconds( expiresAt ) ) );
+
+		return Take( payload, at, login.accessKeyId )
+			&& Take( payload, at, login.secretKey )
+			&& Take( payload, at, login.sessionToken )
+			&& Take( payload, at, login.idToken )
+			&& Take( payload, at, login.accessToken );
+	}
+
+	return false;
+}
+
+
+awsx::SharedCredentialsProvider::SharedCredentialsProvider(
+	const std::string & name )
+	: m_reader( name )
+{
+}
+
+Aws::Auth::AWSCredentials awsx::SharedCredentialsProvider::GetAWSCredentials()
+{
+	std::shared_ptr<const Snapshot> snapshot;
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		snapshot = m_snapshot;
+	}
+
+	if ( !snapshot || snapshot->generation != m_reader.GetGeneration() ) {
+		SharedLogin login;
+
+		if ( m_reader.Read( login ) ) {
+			auto fresh = std::make_shared<Snapshot>();
+			fresh->generation = login.generation;
+			fresh->expiration = login.expiration;
+			fresh->credentials = Aws::Auth::AWSCredentials(
+				login.accessKeyId.c_str(),
+				login.secretKey.c_str(),
+				login.sessionToken.c_str() );
+
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_snapshot = snapshot = fresh;
+		}
+	}
+
+	if ( !snapshot
+		|| snapshot->expiration <= std::chrono::system_clock::now() ) {
+		return Aws::Auth::AWSCredentials();
+	}
+
+	return snapshot->credentials;
+}
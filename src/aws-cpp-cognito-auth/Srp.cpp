@@ -23,6 +23,9 @@
  */
 
 #include <iostream>
+#include <stdexcept>
+
+#include <openssl/rand.h>
 
 #include "include/Base64.hpp"
 #include "include/Crypt.hpp"
@@ -87,38 +90,128 @@ static const std::vector<uint8_t> s_nPrimeDigest{ 0x53,
 	0xe6 };
 
 
-void Srp::GenerateSrpA()
+awsx::SrpGroup::SrpGroup()
 {
-	m_random.rand( 256, 1, 1 );
 	m_N.fromHex( __awsAuthSrpPrimeN );
 	m_g.fromHex( "2" );
 
 	m_k.fromBin( s_nPrimeDigest );
 
+	BigNumberContext context;
+	m_mont.set( m_N.get(), context );
+}
+
+const SrpGroup & awsx::SrpGroup::Instance()
+{
+	static const SrpGroup s_group;
+
+	return s_group;
+}
+
+void Srp::Prepare()
+{
+	SrpGroup::Instance();
+
+	std::vector<uint8_t> digest;
+	Digest().Sha256( digest, std::string() );
+
+	std::vector<uint8_t> key;
+	Key().HkdfSha256( key, digest, digest, digest );
+}
+
+void Srp::GenerateDeviceVerifier( const std::string & deviceGroupKey,
+	const std::string & deviceKey,
+	std::string & password,
+	std::string & salt,
+	std::string & verifier )
+{
+	std::vector<uint8_t> random( 40 );
+	std::vector<uint8_t> saltBin( 16 );
+
+	if ( RAND_bytes( random.data(), static_cast<int>( random.size() ) ) != 1
+		|| RAND_bytes( saltBin.data(), static_cast<int>( saltBin.size() ) )
+			!= 1 ) {
+		throw std::runtime_error( "RAND_bytes failed" );
+	}
+
+	password = Base64().Encode( random );
+
+	Digest d;
+
+	std::vector<uint8_t> idDigest;
+	d.Sha256( idDigest, deviceGroupKey + deviceKey + ":" + password );
+
+	std::vector<uint8_t> x_array;
+	Helpers::HexToBinary(
+		x_array, Helpers::PadLeftZero( Helpers::BinaryToHex( saltBin ) ) );
+
+	std::vector<uint8_t> paddedSalt( x_array );
+
+	x_array.insert( x_array.end(), idDigest.begin(), idDigest.end() );
+
+	std::vector<uint8_t> x_digest;
+	d.Sha256( x_digest, x_array );
+
+	BigNumber x;
+	x.fromBin( Helpers::PadLeftZero( x_digest ) );
+
+	const SrpGroup & group = SrpGroup::Instance();
+
+	BigNumberContext context;
+	BigNumber v;
+	v.modExp( group.g(), x, group.N(), group.Mont(), context );
+
+	BigNumberString v_str;
+	v.toHex( v_str );
+
+	std::vector<uint8_t> verifierBin;
+	Helpers::HexToBinary( verifierBin, Helpers::PadLeftZero( v_str.get() ) );
+
+	salt = Base64().Encode( paddedSalt );
+	verifier = Base64().Encode( verifierBin );
+}
+
+void Srp::GenerateSrpA( const Random & random )
+{
+	if ( random ) {
+		std::vector<uint8_t> bytes( 32 );
+		random( bytes.data(), bytes.size() );
+
+		m_random.fromBin( bytes );
+	}
+	else {
+		m_random.rand( 256, 1, 1 );
+	}
+
 	BigNumberContext context;
 	BigNumber a;
 	BigNumber A;
 
-	a.mod( m_random, m_N, context );
-	A.modExp( m_g, a, m_N, context );
+	a.mod( m_random, m_group.N(), context );
+	A.modExp( m_group.g(), a, m_group.N(), m_group.Mont(), context );
 
 	A.toHex( m_A );
 }
 
-void Srp::GenerateKey( std::vector<uint8_t> & out,
-	const std::string & id,
-	const std::string & sSaltIn,
-	const std::string & sB )
+void Srp::ComputeU( BigNumber & u, const std::string & sB ) const
 {
-	Digest d;
-
 	std::vector<uint8_t> ab;
 	Helpers::HexToBinary(
 		ab, Helpers::PadLeftZero( m_A.get() ) + Helpers::PadLeftZero( sB ) );
 
 	std::vector<uint8_t> ab_digest;
-	d.Sha256( ab_digest, ab );
-	ab_digest = Helpers::PadLeftZero( ab_digest );
+	Digest().Sha256( ab_digest, ab );
+
+	u.fromBin( ab_digest );
+}
+
+void Srp::ComputeS( BigNumber & S,
+	const BigNumber & u,
+	const std::string & id,
+	const std::string & sSaltIn,
+	const std::string & sB ) const
+{
+	Digest d;
 
 	std::vector<uint8_t> idDigest;
 	d.Sha256( idDigest, id );
@@ -132,35 +225,57 @@ void Srp::GenerateKey( std::vector<uint8_t> & out,
 
 	std::vector<uint8_t> x_digest;
 	d.Sha256( x_digest, x_array );
-	x_digest = Helpers::PadLeftZero( x_digest );
 
 	BigNumber x;
-	BigNumber u;
 	BigNumber B;
 
 	x.fromBin( x_digest );
-	u.fromBin( ab_digest );
 	B.fromHex( sB );
 
+	BigNumberContext context;
+	BigNumber B_mod;
+	B_mod.mod( B, m_group.N(), context );
+
+	// a malicious or broken server could force S to a known value
+	if ( B_mod.isZero() ) {
+		throw std::runtime_error( "SRP_B mod N is zero" );
+	}
+
 	BigNumber g_mod_xn;
 	BigNumber k_mult;
 	BigNumber b_sub;
 	BigNumber u_x;
 	BigNumber a_add;
 	BigNumber b_sub_modpow;
-	BigNumber S;
 	BigNumber a;
 
-	BigNumberContext context;
-	a.mod( m_random, m_N, context );
+	const BigNumber & N = m_group.N();
+
+	a.mod( m_random, N, context );
 
-	g_mod_xn.modExp( m_g, x, m_N, context );
-	k_mult.mul( m_k, g_mod_xn, context );
+	g_mod_xn.modExp( m_group.g(), x, N, m_group.Mont(), context );
+	k_mult.mul( m_group.k(), g_mod_xn, context );
 	b_sub.sub( B, k_mult );
 	u_x.mul( u, x, context );
 	a_add.add( a, u_x );
-	b_sub_modpow.modExp( b_sub, a_add, m_N, context );
-	S.mod( b_sub_modpow, m_N, context );
+	b_sub_modpow.modExp( b_sub, a_add, N, m_group.Mont(), context );
+	S.mod( b_sub_modpow, N, context );
+}
+
+void Srp::GenerateKey( std::vector<uint8_t> & out,
+	const std::string & id,
+	const std::string & sSaltIn,
+	const std::string & sB )
+{
+	BigNumber u;
+	ComputeU( u, sB );
+
+	if ( u.isZero() ) {
+		throw std::runtime_error( "SRP u is zero" );
+	}
+
+	BigNumber S;
+	ComputeS( S, u, id, sSaltIn, sB );
 
 	BigNumberString u_str;
 	u.toHex( u_str );
@@ -0,0 +1,330 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <type_traits>
+
+#include "aws/core/client/AWSError.h"
+#include "aws/core/client/CoreErrors.h"
+
+#include "aws/cognito-idp/model/AdminInitiateAuthRequest.h"
+#include "aws/cognito-idp/model/ConfirmDeviceRequest.h"
+#include "aws/cognito-idp/model/InitiateAuthRequest.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeRequest.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusRequest.h"
+
+#include "aws/cognito-identity/model/GetCredentialsForIdentityRequest.h"
+#include "aws/cognito-identity/model/GetIdRequest.h"
+
+#include "../../include/aws-cpp-cognito-auth/Exception.hpp"
+#include "../../include/aws-cpp-cognito-auth/Startup.hpp"
+
+
+using namespace awsx;
+using namespace Aws::CognitoIdentityProvider::Model;
+using namespace Aws::CognitoIdentity::Model;
+
+
+template <typename TOutcome>
+static TOutcome Failed( const std::string & error )
+{
+	typedef typename std::decay<decltype(
+		std::declval<TOutcome>().GetError() )>::type TError;
+
+	std::string message = "transport setup failed: " + error;
+
+	return TOutcome( TError( Aws::Client::AWSError<Aws::Client::CoreErrors>(
+		Aws::Client::CoreErrors::INTERNAL_FAILURE,
+		"InternalFailure",
+		message.c_str(),
+		false ) ) );
+}
+
+template <typename TOutcome, typename TRequest, typename THandler>
+static LazyTransport::Call Forward(
+	void ( CognitoTransport::*async )( const TRequest &, const THandler & )
+		const,
+	const TRequest & request,
+	const THandler & handler )
+{
+	return [async, request, handler](
+			   const CognitoTransport * transport, const std::string & error ) {
+		if ( transport ) {
+			( transport->*async )( request, handler );
+		}
+		else {
+			handler( Failed<TOutcome>( error ) );
+		}
+	};
+}
+
+
+awsx::SdkStartup::SdkStartup( const Aws::SDKOptions & options )
+	: m_options( options )
+{
+	m_ready = std::async( std::launch::async, [this]() {
+		Aws::InitAPI( m_options );
+	} ).share();
+}
+
+awsx::SdkStartup::~SdkStartup()
+{
+	try {
+		m_ready.get();
+	}
+	catch ( const std::exception & ) {
+		return;
+	}
+
+	Aws::ShutdownAPI( m_options );
+}
+
+void awsx::SdkStartup::Wait() const
+{
+	m_ready.get();
+}
+
+
+awsx::LazyTransport::LazyTransport( Factory factory,
+	std::shared_ptr<SdkStartup> startup,
+	bool warmup )
+	: m_ready( false )
+{
+	m_thread = std::thread(
+		&LazyTransport::Build, this, factory, startup, warmup );
+}
+
+awsx::LazyTransport::~LazyTransport()
+{
+	StopKeepAlive();
+
+	if ( m_thread.joinable() ) {
+		m_thread.join();
+	}
+}
+
+void awsx::LazyTransport::Build( Factory factory,
+	std::shared_ptr<SdkStartup> startup,
+	bool warmup )
+{
+	std::shared_ptr<CognitoTransport> transport;
+	std::string error;
+
+	try {
+		if ( startup ) {
+			startup->Wait();
+		}
+
+		transport = factory();
+	}
+	catch ( const std::exception & x ) {
+		error = x.what();
+	}
+
+	std::vector<Call> waiting;
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+
+		m_transport = transport;
+		m_error = error;
+		m_ready = true;
+		waiting.swap( m_waiting );
+	}
+
+	m_condition.notify_all();
+
+	for ( auto & call : waiting ) {
+		call( transport.get(), error );
+	}
+
+	// after the queued calls, which open connections of their own
+	if ( transport && warmup ) {
+		transport->Warmup();
+	}
+
+	Touch();
+}
+
+void awsx::LazyTransport::WhenReady( Call call ) const
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+
+		if ( !m_ready ) {
+			m_waiting.push_back( call );
+			return;
+		}
+	}
+
+	// m_transport and m_error no longer change once ready
+	call( m_transport.get(), m_error );
+}
+
+const CognitoTransport * awsx::LazyTransport::Ready() const
+{
+	std::unique_lock<std::mutex> lock( m_mutex );
+	m_condition.wait( lock, [this]() { return m_ready; } );
+
+	return m_transport.get();
+}
+
+std::shared_ptr<CognitoTransport> awsx::LazyTransport::GetTransport() const
+{
+	if ( !Ready() ) {
+		throw Exception( "transport setup failed: " + m_error );
+	}
+
+	return m_transport;
+}
+
+void awsx::LazyTransport::Warmup()
+{
+	GetTransport()->Warmup();
+	Touch();
+}
+
+InitiateAuthOutcome awsx::LazyTransport::InitiateAuth(
+	const InitiateAuthRequest & request ) const
+{
+	auto transport = Ready();
+
+	return transport
+		? transport->InitiateAuth( request )
+		: Failed<InitiateAuthOutcome>( m_error );
+}
+
+void awsx::LazyTransport::InitiateAuthAsync(
+	const InitiateAuthRequest & request,
+	const InitiateAuthHandler & handler ) const
+{
+	WhenReady( Forward<InitiateAuthOutcome>(
+		&CognitoTransport::InitiateAuthAsync, request, handler ) );
+}
+
+AdminInitiateAuthOutcome awsx::LazyTransport::AdminInitiateAuth(
+	const AdminInitiateAuthRequest & request ) const
+{
+	auto transport = Ready();
+
+	return transport
+		? transport->AdminInitiateAuth( request )
+		: Failed<AdminInitiateAuthOutcome>( m_error );
+}
+
+void awsx::LazyTransport::AdminInitiateAuthAsync(
+	const AdminInitiateAuthRequest & request,
+	const AdminInitiateAuthHandler & handler ) const
+{
+	WhenReady( Forward<AdminInitiateAuthOutcome>(
+		&CognitoTransport::AdminInitiateAuthAsync, request, handler ) );
+}
+
+RespondToAuthChallengeOutcome awsx::LazyTransport::RespondToAuthChallenge(
+	const RespondToAuthChallengeRequest & request ) const
+{
+	auto transport = Ready();
+
+	return transport
+		? transport->RespondToAuthChallenge( request )
+		: Failed<RespondToAuthChallengeOutcome>( m_error );
+}
+
+void awsx::LazyTransport::RespondToAuthChallengeAsync(
+	const RespondToAuthChallengeRequest & request,
+	const RespondToAuthChallengeHandler & handler ) const
+{
+	WhenReady( Forward<RespondToAuthChallengeOutcome>(
+		&CognitoTransport::RespondToAuthChallengeAsync, request, handler ) );
+}
+
+ConfirmDeviceOutcome awsx::LazyTransport::ConfirmDevice(
+	const ConfirmDeviceRequest & request ) const
+{
+	auto transport = Ready();
+
+	return transport
+		? transport->ConfirmDevice( request )
+		: Failed<ConfirmDeviceOutcome>( m_error );
+}
+
+void awsx::LazyTransport::ConfirmDeviceAsync(
+	const ConfirmDeviceRequest & request,
+	const ConfirmDeviceHandler & handler ) const
+{
+	WhenReady( Forward<ConfirmDeviceOutcome>(
+		&CognitoTransport::ConfirmDeviceAsync, request, handler ) );
+}
+
+UpdateDeviceStatusOutcome awsx::LazyTransport::UpdateDeviceStatus(
+	const UpdateDeviceStatusRequest & request ) const
+{
+	auto transport = Ready();
+
+	return transport
+		? transport->UpdateDeviceStatus( request )
+		: Failed<UpdateDeviceStatusOutcome>( m_error );
+}
+
+void awsx::LazyTransport::UpdateDeviceStatusAsync(
+	const UpdateDeviceStatusRequest & request,
+	const UpdateDeviceStatusHandler & handler ) const
+{
+	WhenReady( Forward<UpdateDeviceStatusOutcome>(
+		&CognitoTransport::UpdateDeviceStatusAsync, request, handler ) );
+}
+
+GetIdOutcome awsx::LazyTransport::GetId( const GetIdRequest & request ) const
+{
+	auto transport = Ready();
+
+	return transport
+		? transport->GetId( request )
+		: Failed<GetIdOutcome>( m_error );
+}
+
+void awsx::LazyTransport::GetIdAsync(
+	const GetIdRequest & request, const GetIdHandler & handler ) const
+{
+	WhenReady( Forward<GetIdOutcome>(
+		&CognitoTransport::GetIdAsync, request, handler ) );
+}
+
+GetCredentialsForIdentityOutcome
+awsx::LazyTransport::GetCredentialsForIdentity(
+	const GetCredentialsForIdentityRequest & request ) const
+{
+	auto transport = Ready();
+
+	return transport
+		? transport->GetCredentialsForIdentity( request )
+		: Failed<GetCredentialsForIdentityOutcome>( m_error );
+}
+
+void awsx::LazyTransport::GetCredentialsForIdentityAsync(
+	const GetCredentialsForIdentityRequest & request,
+	const GetCredentialsForIdentityHandler & handler ) const
+{
+	WhenReady( Forward<GetCredentialsForIdentityOutcome>(
+		&CognitoTransport::GetCredentialsForIdentityAsync, request, handler ) );
+}
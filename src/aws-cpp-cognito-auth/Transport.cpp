@@ -0,0 +1,177 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "aws/cognito-idp/model/AdminInitiateAuthRequest.h"
+#include "aws/cognito-idp/model/ConfirmDeviceRequest.h"
+#include "aws/cognito-idp/model/InitiateAuthRequest.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeRequest.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusRequest.h"
+
+#include "aws/cognito-identity/model/GetCredentialsForIdentityRequest.h"
+#include "aws/cognito-identity/model/GetIdRequest.h"
+
+#include "../../include/aws-cpp-cognito-auth/Transport.hpp"
+
+
+using namespace awsx;
+
+
+template <typename TOutcome, typename TRequest, typename THandler>
+static std::future<TOutcome> Callable( const CognitoTransport & transport,
+	void ( CognitoTransport::*async )( const TRequest &, const THandler & )
+		const,
+	const TRequest & request )
+{
+	auto promise = std::make_shared<std::promise<TOutcome>>();
+
+	( transport.*async )( request, [promise]( const TOutcome & outcome ) {
+		promise->set_value( outcome );
+	} );
+
+	return promise->get_future();
+}
+
+
+awsx::CognitoTransport::CognitoTransport()
+	: m_lastUse( 0 )
+	, m_keepAliveStop( false )
+{
+}
+
+awsx::CognitoTransport::~CognitoTransport()
+{
+	StopKeepAlive();
+}
+
+void awsx::CognitoTransport::KeepAliveLoop( std::chrono::seconds interval )
+{
+	std::unique_lock<std::mutex> lock( m_keepAliveMutex );
+
+	while ( !m_keepAliveStop ) {
+		m_keepAliveCondition.wait_for( lock, interval );
+
+		if ( m_keepAliveStop ) {
+			break;
+		}
+
+		auto idle = std::chrono::steady_clock::now().time_since_epoch()
+			- std::chrono::steady_clock::duration( m_lastUse.load() );
+
+		if ( idle >= interval ) {
+			lock.unlock();
+			Warmup();
+			lock.lock();
+		}
+	}
+}
+
+void awsx::CognitoTransport::StartKeepAlive( std::chrono::seconds interval )
+{
+	StopKeepAlive();
+
+	m_keepAliveStop = false;
+	m_keepAliveThread
+		= std::thread( &CognitoTransport::KeepAliveLoop, this, interval );
+}
+
+void awsx::CognitoTransport::StopKeepAlive()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_keepAliveMutex );
+		m_keepAliveStop = true;
+	}
+
+	m_keepAliveCondition.notify_all();
+
+	if ( m_keepAliveThread.joinable() ) {
+		m_keepAliveThread.join();
+	}
+}
+
+std::future<Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome>
+awsx::CognitoTransport::InitiateAuthCallable(
+	const Aws::CognitoIdentityProvider::Model::InitiateAuthRequest & request )
+	const
+{
+	return Callable<Aws::CognitoIdentityProvider::Model::InitiateAuthOutcome>(
+		*this, &CognitoTransport::InitiateAuthAsync, request );
+}
+
+std::future<Aws::CognitoIdentityProvider::Model::AdminInitiateAuthOutcome>
+awsx::CognitoTransport::AdminInitiateAuthCallable(
+	const Aws::CognitoIdentityProvider::Model::AdminInitiateAuthRequest &
+		request ) const
+{
+	return Callable<
+		Aws::CognitoIdentityProvider::Model::AdminInitiateAuthOutcome>(
+		*this, &CognitoTransport::AdminInitiateAuthAsync, request );
+}
+
+std::future<Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeOutcome>
+awsx::CognitoTransport::RespondToAuthChallengeCallable(
+	const Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeRequest &
+		request ) const
+{
+	return Callable<
+		Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeOutcome>(
+		*this, &CognitoTransport::RespondToAuthChallengeAsync, request );
+}
+
+std::future<Aws::CognitoIdentityProvider::Model::ConfirmDeviceOutcome>
+awsx::CognitoTransport::ConfirmDeviceCallable(
+	const Aws::CognitoIdentityProvider::Model::ConfirmDeviceRequest & request )
+	const
+{
+	return Callable<Aws::CognitoIdentityProvider::Model::ConfirmDeviceOutcome>(
+		*this, &CognitoTransport::ConfirmDeviceAsync, request );
+}
+
+std::future<Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusOutcome>
+awsx::CognitoTransport::UpdateDeviceStatusCallable(
+	const Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusRequest &
+		request ) const
+{
+	return Callable<
+		Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusOutcome>(
+		*this, &CognitoTransport::UpdateDeviceStatusAsync, request );
+}
+
+std::future<Aws::CognitoIdentity::Model::GetIdOutcome>
+awsx::CognitoTransport::GetIdCallable(
+	const Aws::CognitoIdentity::Model::GetIdRequest & request ) const
+{
+	return Callable<Aws::CognitoIdentity::Model::GetIdOutcome>(
+		*this, &CognitoTransport::GetIdAsync, request );
+}
+
+std::future<Aws::CognitoIdentity::Model::GetCredentialsForIdentityOutcome>
+awsx::CognitoTransport::GetCredentialsForIdentityCallable(
+	const Aws::CognitoIdentity::Model::GetCredentialsForIdentityRequest &
+		request ) const
+{
+	return Callable<
+		Aws::CognitoIdentity::Model::GetCredentialsForIdentityOutcome>( *this,
+		&CognitoTransport::GetCredentialsForIdentityAsync,
+		request );
+}
@@ -75,7 +75,7 @@ namespace awsx {
 			uint8_t * data;
 			auto len = BIO_get_mem_data( m_bio, &data );
 
-			return std::string( data, data + len - 1 );
+			return std::string( data, data + len );
 		}
 
 		void read( std::vector<uint8_t> & out )
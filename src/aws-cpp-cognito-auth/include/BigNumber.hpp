@@ -57,6 +57,34 @@ namespace awsx {
 		}
 	};
 
+	class BigNumberMontContext {
+	protected:
+		BN_MONT_CTX * m_context;
+
+	public:
+		BigNumberMontContext()
+			: m_context( BN_MONT_CTX_new() )
+		{
+		}
+
+		BigNumberMontContext( const BigNumberMontContext & ) = delete;
+
+		virtual ~BigNumberMontContext()
+		{
+			BN_MONT_CTX_free( m_context );
+		}
+
+		void set( const BIGNUM * m, BigNumberContext & context )
+		{
+			BN_MONT_CTX_set( m_context, m, context.get() );
+		}
+
+		BN_MONT_CTX * get() const
+		{
+			return m_context;
+		}
+	};
+
 	class BigNumberString {
 	protected:
 		char * m_ptr;
@@ -117,6 +145,11 @@ namespace awsx {
 			BN_rand( m_value, bits, top, bottom );
 		}
 
+		bool isZero() const
+		{
+			return BN_is_zero( m_value ) != 0;
+		}
+
 		void mod( const BigNumber & m,
 			const BigNumber & d,
 			BigNumberContext & context )
@@ -132,6 +165,21 @@ namespace awsx {
 			BN_mod_exp( m_value, a.get(), p.get(), m.get(), context.get() );
 		}
 
+		// same as above, reusing Montgomery parameters precomputed for m
+		void modExp( const BigNumber & a,
+			const BigNumber & p,
+			const BigNumber & m,
+			const BigNumberMontContext & mont,
+			BigNumberContext & context )
+		{
+			BN_mod_exp_mont( m_value,
+				a.get(),
+				p.get(),
+				m.get(),
+				context.get(),
+				mont.get() );
+		}
+
 		void mul( const BigNumber & a,
 			const BigNumber & b,
 			BigNumberContext & context )
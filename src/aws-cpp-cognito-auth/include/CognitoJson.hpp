@@ -0,0 +1,162 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_COGNITO_JSON_H
+#define __AWS_CPP_COGNITO_AUTH_COGNITO_JSON_H
+
+
+#include <chrono>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "aws/core/client/AWSError.h"
+#include "aws/core/client/CoreErrors.h"
+
+#include "aws/cognito-idp/model/ConfirmDeviceRequest.h"
+#include "aws/cognito-idp/model/ConfirmDeviceResult.h"
+#include "aws/cognito-idp/model/InitiateAuthRequest.h"
+#include "aws/cognito-idp/model/InitiateAuthResult.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeRequest.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeResult.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusRequest.h"
+#include "aws/cognito-idp/model/UpdateDeviceStatusResult.h"
+
+#include "aws/cognito-identity/model/GetCredentialsForIdentityRequest.h"
+#include "aws/cognito-identity/model/GetCredentialsForIdentityResult.h"
+#include "aws/cognito-identity/model/GetIdRequest.h"
+#include "aws/cognito-identity/model/GetIdResult.h"
+
+#include "Http.hpp"
+
+
+namespace awsx {
+
+	// Cognito JSON 1.1 protocol: request bodies, replies and error
+	// outcomes, for the transports that do their own HTTP.
+	class CognitoJson {
+	public:
+		typedef Aws::Client::AWSError<Aws::Client::CoreErrors> Error;
+		typedef Error ( *ErrorMapper )( const char * );
+
+		// X-Amz-Target prefixes
+		static const char * const IdentityProviderService;
+		static const char * const IdentityService;
+
+		// Regional endpoints, or endpointOverride for both ("https://" when
+		// it has no scheme). Throws Exception on a bad override.
+		static void Endpoints( const std::string & regionId,
+			const std::string & endpointOverride,
+			HttpEndpoint & identityProvider,
+			HttpEndpoint & identity );
+
+		static Error IdentityProviderError( const char * name );
+		static Error IdentityError( const char * name );
+
+		static std::vector<std::pair<std::string, std::string>> Headers(
+			const char * service, const char * operation );
+
+		static std::string Write( const Aws::CognitoIdentityProvider::Model::
+				InitiateAuthRequest & request );
+		static std::string Write( const Aws::CognitoIdentityProvider::Model::
+				RespondToAuthChallengeRequest & request );
+		static std::string Write( const Aws::CognitoIdentityProvider::Model::
+				ConfirmDeviceRequest & request );
+		static std::string Write( const Aws::CognitoIdentityProvider::Model::
+				UpdateDeviceStatusRequest & request );
+		static std::string Write(
+			const Aws::CognitoIdentity::Model::GetIdRequest & request );
+		static std::string Write( const Aws::CognitoIdentity::Model::
+				GetCredentialsForIdentityRequest & request );
+
+		// Throw Exception on a malformed body.
+		static void Read( const std::string & body,
+			Aws::CognitoIdentityProvider::Model::InitiateAuthResult & result );
+		static void Read( const std::string & body,
+			Aws::CognitoIdentityProvider::Model::RespondToAuthChallengeResult &
+				result );
+		static void Read( const std::string & body,
+			Aws::CognitoIdentityProvider::Model::ConfirmDeviceResult & result );
+		static void Read( const std::string & body,
+			Aws::CognitoIdentityProvider::Model::UpdateDeviceStatusResult &
+				result );
+		static void Read( const std::string & body,
+			Aws::CognitoIdentity::Model::GetIdResult & result );
+		static void Read( const std::string & body,
+			Aws::CognitoIdentity::Model::GetCredentialsForIdentityResult &
+				result );
+
+		// Error from the "__type" and "message" of an error reply; the type
+		// may carry a namespace prefix ("...#NotAuthorizedException").
+		static Error ServiceError(
+			const HttpResponse & response, ErrorMapper mapper );
+		// Retryable when resending cannot run the operation twice.
+		static Error NetworkError(
+			const std::string & message, bool retryable );
+		// Not retryable.
+		static Error ResponseError( const std::string & message );
+
+		static std::chrono::milliseconds Backoff( long attempt );
+
+		// Resends of a failed call by the transport itself: maxRetries,
+		// three when negative, and none with a loginTimeout, where the
+		// login retries within its budget instead.
+		static long Retries(
+			long maxRetries, std::chrono::milliseconds loginTimeout );
+
+		template <typename TOutcome>
+		static TOutcome ErrorOutcome( const Error & error )
+		{
+			typedef typename std::decay<decltype(
+				std::declval<TOutcome>().GetError() )>::type TError;
+
+			return TOutcome( TError( error ) );
+		}
+
+		template <typename TOutcome, typename TResult>
+		static TOutcome MakeOutcome(
+			const HttpResponse & response, ErrorMapper mapper )
+		{
+			if ( response.status / 100 != 2 ) {
+				return ErrorOutcome<TOutcome>(
+					ServiceError( response, mapper ) );
+			}
+
+			TResult result;
+
+			try {
+				Read( response.body, result );
+			}
+			catch ( const Exception & e ) {
+				return ErrorOutcome<TOutcome>( ResponseError( e.what() ) );
+			}
+
+			return TOutcome( result );
+		}
+	};
+} // namespace awsx
+
+
+#endif
@@ -26,12 +26,18 @@
 #define __AWS_CPP_COGNITO_AUTH_CRYPT_H
 
 
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include "openssl/evp.h"
 #include "openssl/hmac.h"
 #include "openssl/kdf.h"
 
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include "openssl/core_names.h"
+#endif
+
 
 namespace awsx {
 
@@ -140,6 +146,87 @@ namespace awsx {
 		}
 	};
 
+	// Hmac with a fixed key. OpenSSL absorbs the key into the inner and
+	// outer digest states once and cleanses its padded copies; Compute()
+	// restarts from those states and hashes only the message. The context
+	// is locked meanwhile, so Compute() is safe to call from several
+	// threads.
+	class HmacSha256Key : public Hmac {
+	protected:
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+		EVP_MAC * m_mac;
+		EVP_MAC_CTX * m_context;
+#else
+		HMAC_CTX * m_context;
+#endif
+		mutable std::mutex m_mutex;
+
+	public:
+		HmacSha256Key( const std::string & key )
+		{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+			char digest[] = "SHA256";
+			OSSL_PARAM params[] = {
+				OSSL_PARAM_construct_utf8_string(
+					OSSL_MAC_PARAM_DIGEST, digest, 0 ),
+				OSSL_PARAM_construct_end()
+			};
+
+			m_mac = EVP_MAC_fetch( NULL, "HMAC", NULL );
+			m_context = EVP_MAC_CTX_new( m_mac );
+			EVP_MAC_init( m_context,
+				reinterpret_cast<const unsigned char *>( key.data() ),
+				key.size(),
+				params );
+#else
+			m_context = HMAC_CTX_new();
+			HMAC_Init_ex( m_context,
+				key.data(),
+				static_cast<int>( key.size() ),
+				EVP_sha256(),
+				NULL );
+#endif
+		}
+
+		HmacSha256Key( const HmacSha256Key & ) = delete;
+
+		~HmacSha256Key()
+		{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+			EVP_MAC_CTX_free( m_context );
+			EVP_MAC_free( m_mac );
+#else
+			HMAC_CTX_free( m_context );
+#endif
+		}
+
+		void Compute(
+			std::vector<uint8_t> & out, const std::string & message ) const
+		{
+			const unsigned char * data
+				= reinterpret_cast<const unsigned char *>( message.data() );
+
+			out.resize( EVP_MD_size( EVP_sha256() ) );
+
+			std::lock_guard<std::mutex> lock( m_mutex );
+
+			// no key: reuses the one absorbed above
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+			size_t size = 0;
+
+			EVP_MAC_init( m_context, NULL, 0, NULL );
+			EVP_MAC_update( m_context, data, message.size() );
+			EVP_MAC_final( m_context, out.data(), &size, out.size() );
+#else
+			unsigned int size = 0;
+
+			HMAC_Init_ex( m_context, NULL, 0, NULL, NULL );
+			HMAC_Update( m_context, data, message.size() );
+			HMAC_Final( m_context, out.data(), &size );
+#endif
+		}
+	};
+
 } // namespace awsx
 
 
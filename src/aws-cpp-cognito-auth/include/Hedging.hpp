@@ -0,0 +1,182 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_HEDGING_H
+#define __AWS_CPP_COGNITO_AUTH_HEDGING_H
+
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace awsx {
+
+	// Deadline::max() stands for no deadline.
+	typedef std::chrono::steady_clock::time_point Deadline;
+
+	// Keeps the latencies of the last calls of one API.
+	class LatencyTracker {
+	protected:
+		std::mutex m_mutex;
+		std::vector<std::chrono::microseconds> m_samples;
+		size_t m_next;
+		bool m_full;
+
+	public:
+		LatencyTracker( size_t capacity = 256 )
+			: m_samples( capacity )
+			, m_next( 0 )
+			, m_full( false )
+		{
+		}
+
+		LatencyTracker( const LatencyTracker & ) = delete;
+
+		void Add( std::chrono::microseconds latency )
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+
+			m_samples[m_next++] = latency;
+
+			if ( m_next == m_samples.size() ) {
+				m_next = 0;
+				m_full = true;
+			}
+		}
+
+		// Returns false while there are too few samples to tell.
+		bool Percentile( std::chrono::microseconds & out, double percentile )
+		{
+			std::vector<std::chrono::microseconds> samples;
+
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				samples.assign( m_samples.begin(),
+					m_samples.begin() + ( m_full ? m_samples.size() : m_next ) );
+			}
+
+			if ( samples.size() < 16 ) {
+				return false;
+			}
+
+			auto nth = samples.begin()
+				+ static_cast<size_t>(
+					  ( samples.size() - 1 ) * percentile / 100.0 );
+
+			std::nth_element( samples.begin(), nth, samples.end() );
+			out = *nth;
+
+			return true;
+		}
+	};
+
+	// Shared state of the attempts of one hedged call; completes with the
+	// first successful outcome, or with the last error once all attempts
+	// failed.
+	template <typename TOutcome>
+	class HedgedCall {
+	protected:
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		int m_pending;
+		bool m_done;
+		TOutcome m_outcome;
+
+	public:
+		HedgedCall()
+			: m_pending( 0 )
+			, m_done( false )
+		{
+		}
+
+		HedgedCall( const HedgedCall & ) = delete;
+
+		void Started()
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			++m_pending;
+		}
+
+		void Complete( const TOutcome & outcome )
+		{
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				--m_pending;
+
+				if ( m_done || ( !outcome.IsSuccess() && m_pending > 0 ) ) {
+					return;
+				}
+
+				m_outcome = outcome;
+				m_done = true;
+			}
+
+			m_condition.notify_all();
+		}
+
+		bool WaitUntil( Deadline deadline )
+		{
+			std::unique_lock<std::mutex> lock( m_mutex );
+
+			if ( deadline == Deadline::max() ) {
+				m_condition.wait( lock, [this]() { return m_done; } );
+
+				return true;
+			}
+
+			return m_condition.wait_until(
+				lock, deadline, [this]() { return m_done; } );
+		}
+
+		const TOutcome & GetOutcome() const
+		{
+			return m_outcome;
+		}
+	};
+
+	// Returns false when the deadline passed first.
+	template <typename TOutcome>
+	bool AwaitUntil( std::future<TOutcome> & future,
+		Deadline deadline,
+		TOutcome & outcome )
+	{
+		if ( deadline != Deadline::max()
+			&& future.wait_until( deadline ) == std::future_status::timeout ) {
+			return false;
+		}
+
+		outcome = future.get();
+
+		return true;
+	}
+
+} // namespace awsx
+
+
+#endif
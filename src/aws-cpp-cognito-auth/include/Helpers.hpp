@@ -92,7 +92,10 @@ namespace awsx {
 		{
 			std::string result;
 
-			if ( ( hex.size() & 1 ) == 1 ) {
+			if ( hex.empty() ) {
+				result = hex;
+			}
+			else if ( ( hex.size() & 1 ) == 1 ) {
 				result = "0" + hex;
 			}
 			else if ( hex[0] > '7' ) {
@@ -108,7 +111,7 @@ namespace awsx {
 		static std::vector<uint8_t> PadLeftZero(
 			const std::vector<uint8_t> & v )
 		{
-			if ( v.front() > 0x7f ) {
+			if ( !v.empty() && v.front() > 0x7f ) {
 				std::vector<uint8_t> result( v );
 				result.insert( result.begin(), 0 );
 
@@ -0,0 +1,224 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_HTTP_H
+#define __AWS_CPP_COGNITO_AUTH_HTTP_H
+
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "openssl/ssl.h"
+
+#include "../../../include/aws-cpp-cognito-auth/Exception.hpp"
+
+
+namespace awsx {
+
+	// Connection level failure: resolve, connect, TLS or a broken stream.
+	// Retryable ones happened before the server could act on the request:
+	// no connection, a failed send, or a close before any of the response.
+	// A timeout never is, the request may still be running.
+	class HttpException : public Exception {
+	protected:
+		bool m_retryable;
+
+	public:
+		HttpException( const std::string & message, bool retryable = false )
+			: Exception( message )
+			, m_retryable( retryable )
+		{
+		}
+
+		bool Retryable() const
+		{
+			return m_retryable;
+		}
+	};
+
+	struct HttpEndpoint {
+		std::string host;
+		unsigned short port;
+		bool tls;
+
+		HttpEndpoint()
+			: port( 443 )
+			, tls( true )
+		{
+		}
+
+		// "https://host[:port]" or "http://host[:port]", false otherwise
+		static bool Parse( const std::string & url, HttpEndpoint & endpoint );
+	};
+
+	struct HttpResponse {
+		int status;
+
+		// header names are lower case
+		std::map<std::string, std::string> headers;
+
+		std::string body;
+
+		bool keepAlive;
+
+		HttpResponse()
+			: status( 0 )
+			, keepAlive( false )
+		{
+		}
+
+		// "Name: value", lines without a colon are ignored
+		void AddHeader( const std::string & line );
+	};
+
+	// Client side TLS settings shared by the connections of a transport;
+	// peers are verified against the default trust store.
+	class TlsContext {
+	protected:
+		SSL_CTX * m_context;
+
+	public:
+		TlsContext();
+
+		TlsContext( const TlsContext & ) = delete;
+
+		~TlsContext();
+
+		SSL_CTX * Get() const
+		{
+			return m_context;
+		}
+	};
+
+	// One keep-alive HTTP/1.1 connection. TLS runs over memory BIOs so
+	// every byte goes through send()/recv() and a peer reset cannot raise
+	// SIGPIPE.
+	class HttpConnection {
+	public:
+#ifdef _WIN32
+		typedef uintptr_t Socket;
+#else
+		typedef int Socket;
+#endif
+
+	protected:
+		HttpEndpoint m_endpoint;
+		Socket m_socket;
+		SSL * m_ssl;
+		BIO * m_in;
+		BIO * m_out;
+
+		std::string m_buffer;
+
+		// the peer closed or reset the connection
+		bool m_closed;
+
+	protected:
+		void Close();
+
+		void SendRaw( const char * data, size_t size );
+		size_t RecvRaw( char * data, size_t size );
+
+		void Flush();
+		bool Fill();
+
+		void Write( const std::string & data );
+		bool Read();
+
+		std::string ReadLine();
+		void ReadBody( std::string & body, size_t size );
+
+	public:
+		// Connects and, for https, completes the handshake, resuming the
+		// given session when possible. Throws HttpException.
+		HttpConnection( const HttpEndpoint & endpoint,
+			const TlsContext * tls,
+			SSL_SESSION * session,
+			std::chrono::milliseconds timeout );
+
+		HttpConnection( const HttpConnection & ) = delete;
+
+		~HttpConnection();
+
+		// Sends a complete request and reads its response.
+		HttpResponse Exchange( const std::string & request );
+
+		// New reference to the TLS session, null without TLS.
+		SSL_SESSION * Session() const;
+	};
+
+	// Keep-alive connections to one endpoint. Requests check out an idle
+	// connection or open a new one, so concurrent requests never wait for
+	// each other; at most maxIdle connections are kept afterwards.
+	class HttpConnectionPool {
+	protected:
+		HttpEndpoint m_endpoint;
+		std::shared_ptr<TlsContext> m_tls;
+		std::chrono::milliseconds m_timeout;
+		size_t m_maxIdle;
+
+		std::mutex m_mutex;
+		std::vector<std::unique_ptr<HttpConnection>> m_idle;
+		SSL_SESSION * m_session;
+
+	protected:
+		std::unique_ptr<HttpConnection> Acquire( bool & reused );
+		std::unique_ptr<HttpConnection> Open();
+		void Release( std::unique_ptr<HttpConnection> connection );
+
+	public:
+		HttpConnectionPool( const HttpEndpoint & endpoint,
+			std::shared_ptr<TlsContext> tls,
+			std::chrono::milliseconds timeout,
+			size_t maxIdle );
+
+		HttpConnectionPool( const HttpConnectionPool & ) = delete;
+
+		~HttpConnectionPool();
+
+		const HttpEndpoint & GetEndpoint() const
+		{
+			return m_endpoint;
+		}
+
+		// POSTs the body to "/". A reused connection the server closed
+		// before taking the request is retried once on a new one; a timeout
+		// never is. Throws HttpException.
+		HttpResponse Post(
+			const std::vector<std::pair<std::string, std::string>> & headers,
+			const std::string & body );
+
+		// Opens a connection into the idle list unless one is there.
+		void Connect();
+	};
+
+} // namespace awsx
+
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_HTTP2_H
+#define __AWS_CPP_COGNITO_AUTH_HTTP2_H
+
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "curl/curl.h"
+
+#include "Http.hpp"
+
+
+namespace awsx {
+
+	struct Http2Request {
+		HttpEndpoint endpoint;
+		std::vector<std::pair<std::string, std::string>> headers;
+		std::string body;
+	};
+
+	// POSTs multiplexed as HTTP/2 streams over at most maxConnections
+	// connections per host: TLS with ALPN for https, prior knowledge (h2c)
+	// for http. One thread drives all transfers through a libcurl multi
+	// handle and calls the handlers, so they must not block.
+	class Http2Client {
+	public:
+		// error is empty when a response arrived, whatever its status;
+		// retryable only for resolve, connect and TLS handshake failures
+		typedef std::function<void( const HttpResponse & response,
+			const std::string & error,
+			bool retryable )>
+			Handler;
+
+	protected:
+		struct Transfer {
+			std::shared_ptr<const Http2Request> request;
+			Handler handler;
+			std::chrono::steady_clock::time_point notBefore;
+
+			CURL * easy;
+			curl_slist * headers;
+			char error[CURL_ERROR_SIZE];
+
+			HttpResponse response;
+		};
+
+		std::chrono::milliseconds m_timeout;
+		CURLM * m_multi;
+
+		std::mutex m_mutex;
+		std::vector<std::shared_ptr<Transfer>> m_queue;
+		bool m_stop;
+
+		// loop thread only; finished easy handles are reset and reused
+		std::map<CURL *, std::shared_ptr<Transfer>> m_active;
+		std::vector<CURL *> m_idle;
+
+		std::thread m_thread;
+
+	protected:
+		static size_t OnBody( char * data, size_t size, size_t n, void * user );
+		static size_t OnHeader(
+			char * data, size_t size, size_t n, void * user );
+
+		void Loop();
+		long Start( std::chrono::steady_clock::time_point now );
+		void Finish( CURL * easy, CURLcode result );
+		void Release( Transfer & transfer );
+
+	public:
+		Http2Client( long maxConnections, std::chrono::milliseconds timeout );
+
+		Http2Client( const Http2Client & ) = delete;
+
+		// Stop()s.
+		~Http2Client();
+
+		// Queues the request, to start no sooner than after the delay.
+		// Once stopped, fails it right away on the calling thread.
+		void Post( std::shared_ptr<const Http2Request> request,
+			std::chrono::milliseconds delay,
+			Handler handler );
+
+		// Fails the queued and running requests and ends the thread.
+		void Stop();
+	};
+} // namespace awsx
+
+
+#endif
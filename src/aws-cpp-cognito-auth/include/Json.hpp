@@ -0,0 +1,494 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_JSON_H
+#define __AWS_CPP_COGNITO_AUTH_JSON_H
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "../../../include/aws-cpp-cognito-auth/Exception.hpp"
+
+
+namespace awsx {
+
+	// Appends JSON text to a string. Commas are inserted as values are
+	// written; the caller is responsible for the nesting being balanced.
+	class JsonWriter {
+	protected:
+		std::string m_out;
+		std::vector<bool> m_first;
+		bool m_afterKey;
+
+	protected:
+		void Separator()
+		{
+			if ( !m_first.empty() ) {
+				if ( !m_first.back() ) {
+					m_out += ',';
+				}
+
+				m_first.back() = false;
+			}
+		}
+
+		// a value directly after Key() takes no comma
+		void Value()
+		{
+			if ( m_afterKey ) {
+				m_afterKey = false;
+			}
+			else {
+				Separator();
+			}
+		}
+
+		void Quoted( const std::string & value )
+		{
+			static const char * s_digits = "0123456789abcdef";
+
+			m_out += '"';
+
+			for ( size_t i = 0; i < value.size(); i++ ) {
+				unsigned char ch = static_cast<unsigned char>( value[i] );
+
+				if ( ch == '"' || ch == '\\' ) {
+					m_out += '\\';
+					m_out += static_cast<char>( ch );
+				}
+				else if ( ch == '\n' ) {
+					m_out += "\\n";
+				}
+				else if ( ch == '\r' ) {
+					m_out += "\\r";
+				}
+				else if ( ch == '\t' ) {
+					m_out += "\\t";
+				}
+				else if ( ch < 0x20 ) {
+					m_out += "\\u00";
+					m_out += s_digits[ch >> 4];
+					m_out += s_digits[ch & 0x0f];
+				}
+				else {
+					m_out += static_cast<char>( ch );
+				}
+			}
+
+			m_out += '"';
+		}
+
+	public:
+		JsonWriter()
+			: m_afterKey( false )
+		{
+		}
+
+		void BeginObject()
+		{
+			Value();
+			m_out += '{';
+			m_first.push_back( true );
+		}
+
+		void EndObject()
+		{
+			m_first.pop_back();
+			m_out += '}';
+		}
+
+		// The value written next belongs to this key.
+		void Key( const std::string & key )
+		{
+			Separator();
+			Quoted( key );
+			m_out += ':';
+			m_afterKey = true;
+		}
+
+		void String( const std::string & value )
+		{
+			Value();
+			Quoted( value );
+		}
+
+		void Number( long long value )
+		{
+			Value();
+			m_out += std::to_string( value );
+		}
+
+		void Bool( bool value )
+		{
+			Value();
+			m_out += value ? "true" : "false";
+		}
+
+		template <typename TMap>
+		void StringMap( const std::string & key, const TMap & map )
+		{
+			Key( key );
+			BeginObject();
+
+			for ( auto it = map.begin(); it != map.end(); ++it ) {
+				Key( it->first.c_str() );
+				String( it->second.c_str() );
+			}
+
+			EndObject();
+		}
+
+		const std::string & Str() const
+		{
+			return m_out;
+		}
+	};
+
+	// Pull parser over a JSON document; values are read or skipped in
+	// document order, nothing is built beyond the strings handed out.
+	// Malformed input throws awsx::Exception.
+	class JsonReader {
+	protected:
+		const char * m_pos;
+		const char * m_end;
+
+	protected:
+		void Fail() const
+		{
+			throw Exception( "malformed JSON" );
+		}
+
+		void SkipSpace()
+		{
+			while ( m_pos < m_end
+				&& ( *m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n'
+					|| *m_pos == '\r' ) ) {
+				m_pos++;
+			}
+		}
+
+		char Peek()
+		{
+			SkipSpace();
+
+			if ( m_pos == m_end ) {
+				Fail();
+			}
+
+			return *m_pos;
+		}
+
+		void Expect( char ch )
+		{
+			if ( Peek() != ch ) {
+				Fail();
+			}
+
+			m_pos++;
+		}
+
+		bool Literal( const char * text )
+		{
+			const char * p = m_pos;
+
+			for ( ; *text != '\0'; text++, p++ ) {
+				if ( p == m_end || *p != *text ) {
+					return false;
+				}
+			}
+
+			m_pos = p;
+
+			return true;
+		}
+
+		unsigned Hex4()
+		{
+			unsigned result = 0;
+
+			for ( int i = 0; i < 4; i++, m_pos++ ) {
+				if ( m_pos == m_end ) {
+					Fail();
+				}
+
+				char ch = *m_pos;
+				result <<= 4;
+
+				if ( ch >= '0' && ch <= '9' ) {
+					result |= ch - '0';
+				}
+				else if ( ch >= 'a' && ch <= 'f' ) {
+					result |= ch - 'a' + 10;
+				}
+				else if ( ch >= 'A' && ch <= 'F' ) {
+					result |= ch - 'A' + 10;
+				}
+				else {
+					Fail();
+				}
+			}
+
+			return result;
+		}
+
+		static void Utf8( std::string & out, unsigned cp )
+		{
+			if ( cp < 0x80 ) {
+				out += static_cast<char>( cp );
+			}
+			else if ( cp < 0x800 ) {
+				out += static_cast<char>( 0xc0 | ( cp >> 6 ) );
+				out += static_cast<char>( 0x80 | ( cp & 0x3f ) );
+			}
+			else if ( cp < 0x10000 ) {
+				out += static_cast<char>( 0xe0 | ( cp >> 12 ) );
+				out += static_cast<char>( 0x80 | ( ( cp >> 6 ) & 0x3f ) );
+				out += static_cast<char>( 0x80 | ( cp & 0x3f ) );
+			}
+			else {
+				out += static_cast<char>( 0xf0 | ( cp >> 18 ) );
+				out += static_cast<char>( 0x80 | ( ( cp >> 12 ) & 0x3f ) );
+				out += static_cast<char>( 0x80 | ( ( cp >> 6 ) & 0x3f ) );
+				out += static_cast<char>( 0x80 | ( cp & 0x3f ) );
+			}
+		}
+
+		void Quoted( std::string & out )
+		{
+			Expect( '"' );
+
+			while ( true ) {
+				if ( m_pos == m_end ) {
+					Fail();
+				}
+
+				char ch = *m_pos++;
+
+				if ( ch == '"' ) {
+					break;
+				}
+
+				if ( ch != '\\' ) {
+					out += ch;
+					continue;
+				}
+
+				if ( m_pos == m_end ) {
+					Fail();
+				}
+
+				ch = *m_pos++;
+
+				if ( ch == 'n' ) {
+					out += '\n';
+				}
+				else if ( ch == 't' ) {
+					out += '\t';
+				}
+				else if ( ch == 'r' ) {
+					out += '\r';
+				}
+				else if ( ch == 'b' ) {
+					out += '\b';
+				}
+				else if ( ch == 'f' ) {
+					out += '\f';
+				}
+				else if ( ch == 'u' ) {
+					unsigned cp = Hex4();
+
+					// surrogate pair
+					if ( cp >= 0xd800 && cp < 0xdc00 && Literal( "\\u" ) ) {
+						unsigned low = Hex4();
+
+						if ( low < 0xdc00 || low >= 0xe000 ) {
+							Fail();
+						}
+
+						cp = 0x10000 + ( ( cp - 0xd800 ) << 10 )
+							+ ( low - 0xdc00 );
+					}
+
+					Utf8( out, cp );
+				}
+				else {
+					out += ch;
+				}
+			}
+		}
+
+	public:
+		JsonReader( const std::string & text )
+			: m_pos( text.data() )
+			, m_end( text.data() + text.size() )
+		{
+		}
+
+		void BeginObject()
+		{
+			Expect( '{' );
+		}
+
+		// Reads the next key of the current object, false once it is closed.
+		bool NextKey( std::string & key )
+		{
+			char ch = Peek();
+
+			if ( ch == '}' ) {
+				m_pos++;
+				return false;
+			}
+
+			if ( ch == ',' ) {
+				m_pos++;
+			}
+
+			key.clear();
+			Quoted( key );
+			Expect( ':' );
+
+			return true;
+		}
+
+		void BeginArray()
+		{
+			Expect( '[' );
+		}
+
+		// Positions at the next array element, false once it is closed.
+		bool NextElement()
+		{
+			char ch = Peek();
+
+			if ( ch == ']' ) {
+				m_pos++;
+				return false;
+			}
+
+			if ( ch == ',' ) {
+				m_pos++;
+			}
+
+			return true;
+		}
+
+		bool IsNull()
+		{
+			return Peek() == 'n';
+		}
+
+		// null reads as an empty string
+		std::string String()
+		{
+			std::string result;
+
+			if ( IsNull() ) {
+				SkipValue();
+			}
+			else {
+				Quoted( result );
+			}
+
+			return result;
+		}
+
+		double Number()
+		{
+			Peek();
+
+			char * end = nullptr;
+			std::string text( m_pos,
+				std::min<size_t>( m_end - m_pos, 64 ) );
+			double result = std::strtod( text.c_str(), &end );
+
+			if ( end == text.c_str() ) {
+				Fail();
+			}
+
+			m_pos += end - text.c_str();
+
+			return result;
+		}
+
+		bool Bool()
+		{
+			Peek();
+
+			if ( Literal( "true" ) ) {
+				return true;
+			}
+
+			if ( Literal( "false" ) ) {
+				return false;
+			}
+
+			Fail();
+
+			return false;
+		}
+
+		void SkipValue()
+		{
+			char ch = Peek();
+
+			if ( ch == '{' ) {
+				std::string key;
+				BeginObject();
+
+				while ( NextKey( key ) ) {
+					SkipValue();
+				}
+			}
+			else if ( ch == '[' ) {
+				BeginArray();
+
+				while ( NextElement() ) {
+					SkipValue();
+				}
+			}
+			else if ( ch == '"' ) {
+				std::string ignored;
+				Quoted( ignored );
+			}
+			else if ( ch == 't' || ch == 'f' ) {
+				Bool();
+			}
+			else if ( ch == 'n' ) {
+				if ( !Literal( "null" ) ) {
+					Fail();
+				}
+			}
+			else {
+				Number();
+			}
+		}
+	};
+
+} // namespace awsx
+
+
+#endif
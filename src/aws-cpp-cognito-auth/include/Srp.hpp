@@ -26,22 +26,76 @@
 #define __AWS_CPP_COGNITO_AUTH_SRP_H
 
 
+#include <cstdint>
+#include <functional>
+
 #include "BigNumber.hpp"
 
 
 namespace awsx {
 
-	class Srp {
+	// AWS SRP group parameters, parsed once per process and shared read-only
+	// by every Srp instance.
+	class SrpGroup {
 	protected:
-		BigNumber m_k;
-		BigNumber m_random;
 		BigNumber m_N;
 		BigNumber m_g;
+		BigNumber m_k;
+		BigNumberMontContext m_mont;
+
+	protected:
+		SrpGroup();
+
+	public:
+		SrpGroup( const SrpGroup & ) = delete;
+
+		static const SrpGroup & Instance();
+
+		const BigNumber & N() const
+		{
+			return m_N;
+		}
+		const BigNumber & g() const
+		{
+			return m_g;
+		}
+		const BigNumber & k() const
+		{
+			return m_k;
+		}
+		const BigNumberMontContext & Mont() const
+		{
+			return m_mont;
+		}
+	};
+
+	class Srp {
+	public:
+		// Fills the buffer with random bytes; used for the private value a.
+		typedef std::function<void( uint8_t * data, size_t size )> Random;
+
+	protected:
+		const SrpGroup & m_group;
+
+		BigNumber m_random;
 
 		BigNumberString m_A;
 
 	protected:
-		void GenerateSrpA();
+		void GenerateSrpA( const Random & random );
+
+		// u = H( PAD( A ) | PAD( B ) )
+		void ComputeU( BigNumber & u, const std::string & sB ) const;
+
+		// S = ( B - k * g ^ x ) ^ ( a + u * x ) mod N, with
+		// x = H( PAD( salt ) | H( id ) ); throws when B mod N is zero.
+		void ComputeS( BigNumber & S,
+			const BigNumber & u,
+			const std::string & id,
+			const std::string & salt,
+			const std::string & sB ) const;
+
+		// HKDF( PAD( u ), PAD( S ), "Caldera Derived Key" )
 		void GenerateKey( std::vector<uint8_t> & out,
 			const std::string & id,
 			const std::string & salt,
@@ -49,10 +103,32 @@ namespace awsx {
 
 	public:
 		Srp()
+			: m_group( SrpGroup::Instance() )
 		{
-			GenerateSrpA();
+			GenerateSrpA( Random() );
 		}
 
+		// Draws a from the given source instead of OpenSSL's generator, e.g.
+		// to replay known answers.
+		explicit Srp( const Random & random )
+			: m_group( SrpGroup::Instance() )
+		{
+			GenerateSrpA( random );
+		}
+
+		// Parses the group and makes OpenSSL fetch the digest and KDF
+		// implementations, so the first login doesn't pay for it.
+		static void Prepare();
+
+		// Creates the secrets ConfirmDevice expects for a new device: a
+		// random device password, and the base64 salt and password verifier
+		// derived from it.
+		static void GenerateDeviceVerifier( const std::string & deviceGroupKey,
+			const std::string & deviceKey,
+			std::string & password,
+			std::string & salt,
+			std::string & verifier );
+
 		std::string GeneratePasswordClaim( const std::string & userPoolId,
 			const std::string & username,
 			const std::string & password,
@@ -0,0 +1,241 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __AWS_CPP_COGNITO_AUTH_TIMER_WHEEL_H
+#define __AWS_CPP_COGNITO_AUTH_TIMER_WHEEL_H
+
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+
+namespace awsx {
+
+	// Hierarchical timing wheel over integer ticks: four levels of 256
+	// slots, each slot a tick of the level above, for 2^32 ticks in all.
+	// Timers sit in doubly linked lists threaded through one node array, so
+	// Insert() and Cancel() are O(1); a timer moves down a level each time
+	// its slot comes up, at most three times before it expires.
+	class TimerWheel {
+	public:
+		typedef uint32_t Timer;
+
+		static const Timer s_none = UINT32_MAX;
+
+	protected:
+		static const int s_levels = 4;
+		static const int s_slotBits = 8;
+		static const uint32_t s_slots = 1 << s_slotBits;
+
+		struct Node {
+			uint64_t expires;
+			uint64_t value;
+			Timer prev;
+			Timer next;
+			// level * s_slots + index, s_none when free
+			uint32_t slot;
+		};
+
+		std::vector<Node> m_nodes;
+		std::vector<Timer> m_heads;
+		Timer m_free;
+		size_t m_size;
+
+		// last tick Advance() reached
+		uint64_t m_now;
+
+	protected:
+		void Link( Timer timer )
+		{
+			Node & node = m_nodes[timer];
+			uint64_t delta = node.expires - m_now;
+			int level = 0;
+
+			while ( level < s_levels - 1
+				&& delta >= uint64_t( 1 ) << ( s_slotBits * ( level + 1 ) ) ) {
+				++level;
+			}
+
+			uint32_t index = static_cast<uint32_t>(
+				( node.expires >> ( s_slotBits * level ) ) & ( s_slots - 1 ) );
+
+			node.slot = level * s_slots + index;
+			node.prev = s_none;
+			node.next = m_heads[node.slot];
+
+			if ( node.next != s_none ) {
+				m_nodes[node.next].prev = timer;
+			}
+
+			m_heads[node.slot] = timer;
+		}
+
+		void Unlink( Timer timer )
+		{
+			Node & node = m_nodes[timer];
+
+			if ( node.prev != s_none ) {
+				m_nodes[node.prev].next = node.next;
+			}
+			else {
+				m_heads[node.slot] = node.next;
+			}
+
+			if ( node.next != s_none ) {
+				m_nodes[node.next].prev = node.prev;
+			}
+		}
+
+		void Release( Timer timer )
+		{
+			m_nodes[timer].slot = s_none;
+			m_nodes[timer].next = m_free;
+			m_free = timer;
+			--m_size;
+		}
+
+		// Moves the timers of a slot to the levels below.
+		void Cascade( int level, uint32_t index )
+		{
+			Timer timer = m_heads[level * s_slots + index];
+			m_heads[level * s_slots + index] = s_none;
+
+			while ( timer != s_none ) {
+				Timer next = m_nodes[timer].next;
+				Link( timer );
+				timer = next;
+			}
+		}
+
+	public:
+		explicit TimerWheel( uint64_t now = 0 )
+			: m_heads( s_levels * s_slots, Timer( s_none ) )
+			, m_free( s_none )
+			, m_size( 0 )
+			, m_now( now )
+		{
+		}
+
+		uint64_t Now() const
+		{
+			return m_now;
+		}
+
+		size_t Size() const
+		{
+			return m_size;
+		}
+
+		// Timers due by now expire on the next Advance(), those further
+		// out than the wheel reaches at its end.
+		Timer Insert( uint64_t expires, uint64_t value )
+		{
+			Timer timer = m_free;
+
+			if ( timer != s_none ) {
+				m_free = m_nodes[timer].next;
+			}
+			else {
+				timer = static_cast<Timer>( m_nodes.size() );
+				m_nodes.push_back( Node() );
+			}
+
+			uint64_t horizon
+				= ( uint64_t( 1 ) << ( s_slotBits * s_levels ) ) - 1;
+
+			Node & node = m_nodes[timer];
+			node.expires = expires <= m_now
+				? m_now + 1
+				: std::min( expires, m_now + horizon );
+			node.value = value;
+
+			Link( timer );
+			++m_size;
+
+			return timer;
+		}
+
+		void Cancel( Timer timer )
+		{
+			if ( timer < m_nodes.size() && m_nodes[timer].slot != s_none ) {
+				Unlink( timer );
+				Release( timer );
+			}
+		}
+
+		// Moves the wheel on to now, appending the values of the timers that
+		// expire on the way.
+		void Advance( uint64_t now, std::vector<uint64_t> & expired )
+		{
+			while ( m_now < now ) {
+				++m_now;
+
+				uint32_t slot
+					= static_cast<uint32_t>( m_now & ( s_slots - 1 ) );
+				uint32_t index = slot;
+
+				// a full turn of a level, on to the next slot of the one
+				// above; its timers end in this slot or later
+				for ( int level = 1; index == 0 && level < s_levels; level++ ) {
+					index = static_cast<uint32_t>(
+						( m_now >> ( s_slotBits * level ) ) & ( s_slots - 1 ) );
+					Cascade( level, index );
+				}
+
+				Timer timer = m_heads[slot];
+				m_heads[slot] = s_none;
+
+				while ( timer != s_none ) {
+					Timer next = m_nodes[timer].next;
+
+					expired.push_back( m_nodes[timer].value );
+					Release( timer );
+
+					timer = next;
+				}
+			}
+		}
+
+		// First tick with a timer in the lowest level, or the next tick the
+		// wheel moves timers down from the levels above; nothing expires
+		// before it.
+		uint64_t NextTick() const
+		{
+			uint64_t end = ( m_now | ( s_slots - 1 ) ) + 1;
+
+			for ( uint64_t tick = m_now + 1; tick < end; tick++ ) {
+				if ( m_heads[tick & ( s_slots - 1 )] != s_none ) {
+					return tick;
+				}
+			}
+
+			return end;
+		}
+	};
+
+} // namespace awsx
+
+
+#endif
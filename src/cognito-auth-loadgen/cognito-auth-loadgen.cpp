@@ -0,0 +1,1063 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "stdafx.h"
+
+
+// as close to the process start as the program gets, after the loader
+static const auto s_processStart = std::chrono::steady_clock::now();
+
+// Latency histogram in microseconds with log-linear buckets: every power of
+// two is split into 64 linear sub-buckets, so percentiles are within ~1.6%
+// like an HdrHistogram with two significant digits, at a fixed 30 KB.
+class LatencyHistogram {
+protected:
+	static const int s_subBits = 6;
+	static const uint64_t s_subCount = 1 << s_subBits;
+
+	std::vector<uint64_t> m_counts;
+	uint64_t m_total;
+	uint64_t m_max;
+
+protected:
+	static size_t Index( uint64_t value )
+	{
+		if ( value < 2 * s_subCount ) {
+			return static_cast<size_t>( value );
+		}
+
+		int msb = 0;
+
+		while ( ( value >> ( msb + 1 ) ) != 0 ) {
+			msb++;
+		}
+
+		int shift = msb - s_subBits;
+
+		return static_cast<size_t>( 2 * s_subCount
+			+ ( shift - 1 ) * s_subCount + ( value >> shift ) - s_subCount );
+	}
+
+	// highest value counted in the bucket
+	static uint64_t ValueAt( size_t index )
+	{
+		if ( index < 2 * s_subCount ) {
+			return index;
+		}
+
+		int shift = static_cast<int>( ( index - 2 * s_subCount ) / s_subCount )
+			+ 1;
+		uint64_t mantissa = ( index - 2 * s_subCount ) % s_subCount
+			+ s_subCount;
+
+		return ( ( mantissa + 1 ) << shift ) - 1;
+	}
+
+public:
+	LatencyHistogram()
+		: m_counts( Index( UINT64_MAX ) + 1 )
+		, m_total( 0 )
+		, m_max( 0 )
+	{
+	}
+
+	void Add( std::chrono::microseconds latency )
+	{
+		uint64_t value
+			= static_cast<uint64_t>( std::max<int64_t>( latency.count(), 0 ) );
+
+		m_counts[Index( value )]++;
+		m_total++;
+		m_max = std::max( m_max, value );
+	}
+
+	void Merge( const LatencyHistogram & other )
+	{
+		for ( size_t i = 0; i < m_counts.size(); i++ ) {
+			m_counts[i] += other.m_counts[i];
+		}
+
+		m_total += other.m_total;
+		m_max = std::max( m_max, other.m_max );
+	}
+
+	uint64_t Count() const
+	{
+		return m_total;
+	}
+
+	uint64_t Max() const
+	{
+		return m_max;
+	}
+
+	uint64_t Percentile( double percentile ) const
+	{
+		uint64_t rank = static_cast<uint64_t>( m_total * percentile / 100.0 );
+		uint64_t seen = 0;
+
+		for ( size_t i = 0; i < m_counts.size(); i++ ) {
+			seen += m_counts[i];
+
+			if ( seen > rank ) {
+				return std::min( ValueAt( i ), m_max );
+			}
+		}
+
+		return m_max;
+	}
+};
+
+// Phases reported separately. Srp is the client side CPU time of the SRP
+// math, Login the whole login as seen by the caller.
+enum Phase {
+	PhaseSrp,
+	PhaseInitiateAuth,
+	PhaseRespondToAuthChallenge,
+	PhaseGetId,
+	PhaseGetCredentials,
+	PhaseLogin,
+	PhaseCount
+};
+
+static const char * s_phaseNames[PhaseCount] = { "Srp",
+	"InitiateAuth",
+	"RespondToAuthChallenge",
+	"GetId",
+	"GetCredentialsForIdentity",
+	"Login" };
+
+struct LoadUser {
+	std::string username;
+	std::string password;
+};
+
+struct LoadConfig {
+	std::string regionId;
+	std::string clientId;
+	std::string userPoolId;
+	std::string identityPoolId;
+	std::string usersFile;
+
+	size_t threads;
+	double rate;
+	size_t count;
+	std::chrono::seconds duration;
+
+	// sessions of the SessionStore benchmark, which replaces the load test
+	size_t storeSessions;
+
+	// threads of the allocator benchmark, which replaces the load test
+	size_t memoryThreads;
+
+	// runs the SDK on a PooledMemorySystem
+	bool pooledMemory;
+
+	// times a single login from the process start instead of the load test
+	bool coldStart;
+
+	// reports the SDK's per call HTTP metrics after the load test
+	bool httpMetrics;
+
+	awsx::CognitoAuthOptions authOptions;
+
+	LoadConfig()
+		: regionId( "us-west-2" )
+		, threads( 8 )
+		, rate( 0.0 )
+		, count( 0 )
+		, duration( 0 )
+		, storeSessions( 0 )
+		, memoryThreads( 0 )
+		, pooledMemory( false )
+		, coldStart( false )
+		, httpMetrics( false )
+	{
+	}
+};
+
+struct WorkerStats {
+	LatencyHistogram phases[PhaseCount];
+	std::map<std::string, uint64_t> errors;
+	uint64_t succeeded;
+	uint64_t failed;
+	uint64_t roundTrips;
+
+	WorkerStats()
+		: succeeded( 0 )
+		, failed( 0 )
+		, roundTrips( 0 )
+	{
+	}
+
+	void Merge( const WorkerStats & other )
+	{
+		for ( int i = 0; i < PhaseCount; i++ ) {
+			phases[i].Merge( other.phases[i] );
+		}
+
+		for ( auto & error : other.errors ) {
+			errors[error.first] += error.second;
+		}
+
+		succeeded += other.succeeded;
+		failed += other.failed;
+		roundTrips += other.roundTrips;
+	}
+};
+
+static std::chrono::microseconds Since(
+	std::chrono::steady_clock::time_point started )
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - started );
+}
+
+// Runs one SDK call, adding its latency to the phase when it succeeds and
+// the error name to the breakdown when it doesn't.
+template <typename TCall>
+static auto TimedCall( WorkerStats & stats, Phase phase, TCall call )
+	-> decltype( call() )
+{
+	auto started = std::chrono::steady_clock::now();
+	auto outcome = call();
+
+	stats.roundTrips++;
+
+	if ( outcome.IsSuccess() ) {
+		stats.phases[phase].Add( Since( started ) );
+	}
+	else {
+		stats.errors[std::string( s_phaseNames[phase] ) + ": "
+			+ outcome.GetError().GetExceptionName().c_str()]++;
+	}
+
+	return outcome;
+}
+
+static bool UserPoolLogin( awsx::CognitoAuth & auth,
+	const LoadConfig & config,
+	const LoadUser & user,
+	WorkerStats & stats,
+	awsx::CognitoTokens & tokens )
+{
+	auto transport = auth.GetTransport();
+
+	if ( auth.GetStrategy() == awsx::AuthStrategy::UserPassword ) {
+		auto outcome = TimedCall( stats, PhaseInitiateAuth, [&]() {
+			return transport->InitiateAuth(
+				auth.MakePasswordAuthRequest( user.username, user.password ) );
+		} );
+
+		if ( outcome.IsSuccess() ) {
+			tokens = auth.MakeTokens( outcome.GetResult() );
+		}
+
+		return outcome.IsSuccess();
+	}
+
+	if ( auth.GetStrategy() == awsx::AuthStrategy::AdminUserPassword ) {
+		auto outcome = TimedCall( stats, PhaseInitiateAuth, [&]() {
+			return transport->AdminInitiateAuth(
+				auth.MakeAdminPasswordAuthRequest(
+					user.username, config.userPoolId, user.password ) );
+		} );
+
+		if ( outcome.IsSuccess() ) {
+			tokens = auth.MakeTokens( outcome.GetResult() );
+		}
+
+		return outcome.IsSuccess();
+	}
+
+	auto srpStarted = std::chrono::steady_clock::now();
+	auto srp = auth.BeginSrp();
+	auto srpTime = Since( srpStarted );
+
+	auto authOutcome = TimedCall( stats, PhaseInitiateAuth, [&]() {
+		return transport->InitiateAuth(
+			auth.MakeInitiateAuthRequest( *srp, user.username ) );
+	} );
+
+	if ( !authOutcome.IsSuccess() ) {
+		return false;
+	}
+
+	srpStarted = std::chrono::steady_clock::now();
+	auto challengeRequest = auth.MakePasswordVerifierRequest( *srp,
+		user.username,
+		config.userPoolId,
+		user.password,
+		authOutcome.GetResult() );
+	stats.phases[PhaseSrp].Add( srpTime + Since( srpStarted ) );
+
+	auto challengeOutcome
+		= TimedCall( stats, PhaseRespondToAuthChallenge, [&]() {
+			  return transport->RespondToAuthChallenge( challengeRequest );
+		  } );
+
+	if ( challengeOutcome.IsSuccess() ) {
+		tokens = auth.MakeTokens( challengeOutcome.GetResult() );
+	}
+
+	return challengeOutcome.IsSuccess();
+}
+
+static bool Login( awsx::CognitoAuth & auth,
+	const LoadConfig & config,
+	const LoadUser & user,
+	WorkerStats & stats )
+{
+	awsx::CognitoTokens tokens;
+
+	if ( !UserPoolLogin( auth, config, user, stats, tokens ) ) {
+		return false;
+	}
+
+	if ( config.identityPoolId.empty() ) {
+		return true;
+	}
+
+	auto transport = auth.GetTransport();
+
+	auto idOutcome = TimedCall( stats, PhaseGetId, [&]() {
+		return transport->GetId( auth.MakeGetIdRequest(
+			tokens.GetIdToken(), config.userPoolId, config.identityPoolId ) );
+	} );
+
+	if ( !idOutcome.IsSuccess() ) {
+		return false;
+	}
+
+	auto credentialsOutcome = TimedCall( stats, PhaseGetCredentials, [&]() {
+		return transport->GetCredentialsForIdentity(
+			auth.MakeGetCredentialsRequest(
+				idOutcome.GetResult().GetIdentityId().c_str(),
+				tokens.GetIdToken(),
+				config.userPoolId ) );
+	} );
+
+	return credentialsOutcome.IsSuccess();
+}
+
+// Logins are numbered; with a target rate login n is due at start + n / rate
+// whether or not earlier ones have finished, and its latency is measured
+// from that due time, so a stalled service shows up in the percentiles
+// instead of silently lowering the offered load.
+static void Worker( awsx::CognitoAuth & auth,
+	const LoadConfig & config,
+	const std::vector<LoadUser> & users,
+	std::atomic<size_t> & next,
+	std::chrono::steady_clock::time_point started,
+	std::chrono::steady_clock::time_point stopAt,
+	WorkerStats & stats )
+{
+	for ( ;; ) {
+		size_t n = next++;
+
+		if ( config.count > 0 && n >= config.count ) {
+			break;
+		}
+
+		auto due = std::chrono::steady_clock::now();
+
+		if ( config.rate > 0.0 ) {
+			due = started
+				+ std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+					std::chrono::duration<double>( n / config.rate ) );
+
+			std::this_thread::sleep_until( due );
+		}
+
+		if ( std::chrono::steady_clock::now() >= stopAt ) {
+			break;
+		}
+
+		bool success = false;
+
+		try {
+			success = Login( auth, config, users[n % users.size()], stats );
+		}
+		catch ( const std::exception & x ) {
+			stats.errors[x.what()]++;
+		}
+
+		if ( success ) {
+			stats.succeeded++;
+			stats.phases[PhaseLogin].Add( Since( due ) );
+		}
+		else {
+			stats.failed++;
+		}
+	}
+}
+
+static bool LoadUsers( const std::string & path, std::vector<LoadUser> & users )
+{
+	std::ifstream in( path );
+
+	if ( !in ) {
+		return false;
+	}
+
+	std::string line;
+
+	while ( std::getline( in, line ) ) {
+		if ( !line.empty() && line.back() == '\r' ) {
+			line.pop_back();
+		}
+
+		if ( line.empty() || line[0] == '#' ) {
+			continue;
+		}
+
+		std::istringstream fields( line );
+		LoadUser user;
+
+		if ( fields >> user.username >> user.password ) {
+			users.push_back( user );
+		}
+	}
+
+	return true;
+}
+
+static void Report( const WorkerStats & stats, std::chrono::microseconds elapsed )
+{
+	double seconds = elapsed.count() / 1e6;
+	uint64_t logins = stats.succeeded + stats.failed;
+
+	std::cout << std::fixed << std::setprecision( 1 );
+	std::cout << "logins: " << stats.succeeded << " ok, " << stats.failed
+			  << " failed in " << seconds << " s, "
+			  << ( seconds > 0 ? stats.succeeded / seconds : 0.0 )
+			  << " logins/s, "
+			  << ( logins > 0 ? double( stats.roundTrips ) / logins : 0.0 )
+			  << " round trips/login" << std::endl
+			  << std::endl;
+
+	std::cout << std::left << std::setw( 28 ) << "phase (ms)" << std::right
+			  << std::setw( 10 ) << "count" << std::setw( 10 ) << "p50"
+			  << std::setw( 10 ) << "p90" << std::setw( 10 ) << "p99"
+			  << std::setw( 10 ) << "p99.9" << std::setw( 10 ) << "max"
+			  << std::endl;
+
+	std::cout << std::setprecision( 2 );
+
+	for ( int i = 0; i < PhaseCount; i++ ) {
+		const LatencyHistogram & h = stats.phases[i];
+
+		if ( h.Count() == 0 ) {
+			continue;
+		}
+
+		std::cout << std::left << std::setw( 28 ) << s_phaseNames[i]
+				  << std::right << std::setw( 10 ) << h.Count()
+				  << std::setw( 10 ) << h.Percentile( 50 ) / 1e3
+				  << std::setw( 10 ) << h.Percentile( 90 ) / 1e3
+				  << std::setw( 10 ) << h.Percentile( 99 ) / 1e3
+				  << std::setw( 10 ) << h.Percentile( 99.9 ) / 1e3
+				  << std::setw( 10 ) << h.Max() / 1e3 << std::endl;
+	}
+
+	if ( !stats.errors.empty() ) {
+		std::cout << std::endl << "errors:" << std::endl;
+
+		for ( auto & error : stats.errors ) {
+			std::cout << "  " << error.second << "\t" << error.first
+					  << std::endl;
+		}
+	}
+}
+
+// Per API breakdown of the SDK calls: where the time of an attempt went,
+// and how often attempts were retried or had to open a connection.
+static void ReportHttp( const awsx::CognitoMetrics & metrics )
+{
+	auto snapshot = metrics.Snapshot();
+
+	if ( snapshot.empty() ) {
+		return;
+	}
+
+	std::cout << std::endl
+			  << std::left << std::setw( 28 ) << "http (ms)" << std::right
+			  << std::setw( 10 ) << "count" << std::setw( 10 ) << "mean"
+			  << std::setw( 10 ) << "p50" << std::setw( 10 ) << "p99"
+			  << std::setw( 10 ) << "max" << std::endl;
+
+	std::cout << std::setprecision( 2 );
+
+	for ( auto & api : snapshot ) {
+		const awsx::ApiMetrics & m = api.second;
+
+		std::cout << std::left << api.first << ": " << m.requests
+				  << " requests, " << m.retries << " retries, " << m.failures
+				  << " failed attempts, " << m.reusedConnections
+				  << " on reused connections" << std::endl;
+
+		const std::pair<const char *, const awsx::LatencySnapshot *>
+			latencies[] = { { "  attempt", &m.attempt },
+				{ "  dns", &m.dns },
+				{ "  connect", &m.connect },
+				{ "  tls", &m.tls },
+				{ "  first byte", &m.firstByte } };
+
+		for ( auto & latency : latencies ) {
+			const awsx::LatencySnapshot & l = *latency.second;
+
+			if ( l.count == 0 ) {
+				continue;
+			}
+
+			std::cout << std::left << std::setw( 28 ) << latency.first
+					  << std::right << std::setw( 10 ) << l.count
+					  << std::setw( 10 ) << l.Mean().count() / 1e3
+					  << std::setw( 10 ) << l.Percentile( 50 ).count() / 1e3
+					  << std::setw( 10 ) << l.Percentile( 99 ).count() / 1e3
+					  << std::setw( 10 ) << l.max.count() / 1e3 << std::endl;
+		}
+	}
+}
+
+// Fills a SessionStore with sessions the size of real Cognito ones and
+// reports its memory per session and the time of its operations.
+static void SessionStoreBench( size_t count )
+{
+	// typical lengths for a pool without custom claims
+	std::string accessToken( 1080, 'a' );
+	std::string idToken( 1240, 'i' );
+	std::string refreshToken( 1780, 'r' );
+	std::string accessKeyId( 20, 'K' );
+	std::string secretKey( 40, 's' );
+	std::string sessionToken( 1100, 't' );
+
+	size_t payload = accessToken.size() + idToken.size()
+		+ refreshToken.size() + accessKeyId.size() + secretKey.size()
+		+ sessionToken.size();
+
+	awsx::SessionStore store( count );
+	std::vector<std::string> usernames( count );
+
+	auto now = std::chrono::system_clock::now();
+	auto soon = now + std::chrono::minutes( 5 );
+	auto later = now + std::chrono::hours( 1 );
+
+	for ( size_t i = 0; i < count; i++ ) {
+		usernames[i] = "user" + std::to_string( i );
+	}
+
+	auto credentials = Aws::Auth::AWSCredentials( accessKeyId.c_str(),
+		secretKey.c_str(),
+		sessionToken.c_str() );
+
+	auto started = std::chrono::steady_clock::now();
+
+	for ( size_t i = 0; i < count; i++ ) {
+		store.Put( "pool",
+			usernames[i],
+			awsx::CognitoTokens( accessToken, idToken, refreshToken, 3600 ),
+			credentials,
+			i % 2 == 0 ? soon : later );
+	}
+
+	auto putTime = Since( started );
+	auto filled = store.GetStats();
+
+	// a refresh, with tokens a little longer than before
+	accessToken += "1234";
+	idToken += "1234";
+	started = std::chrono::steady_clock::now();
+
+	for ( size_t i = 0; i < count; i++ ) {
+		store.Put( "pool",
+			usernames[i],
+			awsx::CognitoTokens( accessToken, idToken, refreshToken, 3600 ),
+			credentials,
+			i % 2 == 0 ? soon : later );
+	}
+
+	auto replaceTime = Since( started );
+
+	awsx::CognitoTokens tokens;
+	size_t found = 0;
+	started = std::chrono::steady_clock::now();
+
+	for ( size_t i = 0; i < count; i++ ) {
+		found += store.Get( "pool", usernames[i], tokens, credentials );
+	}
+
+	auto getTime = Since( started );
+
+	started = std::chrono::steady_clock::now();
+	size_t expired = store.Expire( soon );
+	auto expireTime = Since( started );
+
+	double sessions = static_cast<double>( std::max<size_t>( count, 1 ) );
+	double stored
+		= static_cast<double>( filled.arenaBytes + filled.indexBytes );
+
+	std::cout << std::fixed << std::setprecision( 1 );
+	std::cout << "sessions: " << count << ", " << payload
+			  << " bytes of tokens and credentials each" << std::endl
+			  << "memory: " << stored / sessions << " bytes/session ("
+			  << ( stored / sessions - payload ) << " overhead), "
+			  << stored / ( 1 << 20 ) << " MB total" << std::endl
+			  << std::setprecision( 3 )
+			  << "put: " << putTime.count() / sessions << " us, "
+			  << "refresh: " << replaceTime.count() / sessions << " us ("
+			  << store.GetStats().replacedInPlace << " in place), "
+			  << "get: " << getTime.count() / sessions << " us ("
+			  << found << " found)" << std::endl
+			  << std::setprecision( 1 ) << "expiry sweep: " << expired
+			  << " sessions in " << expireTime.count() / 1e3 << " ms"
+			  << std::endl;
+}
+
+// Replays the allocations of a login on each thread: request and response
+// strings, headers and map nodes of a few dozen bytes, JWTs, and the HTTP
+// buffers, freed in no particular order.
+template <typename TAllocate, typename TDeallocate>
+static std::chrono::microseconds ReplayLogins(
+	size_t threads, size_t logins, TAllocate allocate, TDeallocate deallocate )
+{
+	static const size_t sizes[] = { 24, 32, 32, 48, 48, 64, 64, 64, 80, 96,
+		96, 128, 128, 160, 200, 256, 256, 320, 400, 400, 24, 32, 48, 64, 1080,
+		1240, 1780, 1100, 1080, 1240, 1780, 4096, 8192, 16384 };
+	static const size_t count = sizeof( sizes ) / sizeof( sizes[0] );
+
+	std::vector<std::thread> workers;
+	auto started = std::chrono::steady_clock::now();
+
+	for ( size_t t = 0; t < threads; t++ ) {
+		workers.emplace_back( [&, t]() {
+			std::vector<size_t> order( count );
+			std::vector<void *> blocks( count );
+			std::mt19937 random( static_cast<unsigned>( t ) );
+
+			for ( size_t i = 0; i < count; i++ ) {
+				order[i] = i;
+			}
+
+			std::shuffle( order.begin(), order.end(), random );
+
+			for ( size_t login = 0; login < logins; login++ ) {
+				for ( size_t i = 0; i < count; i++ ) {
+					blocks[i] = allocate( sizes[i] );
+					static_cast<char *>( blocks[i] )[0] = 1;
+				}
+
+				for ( size_t i = 0; i < count; i++ ) {
+					deallocate( blocks[order[i]] );
+				}
+			}
+		} );
+	}
+
+	for ( auto & worker : workers ) {
+		worker.join();
+	}
+
+	return Since( started );
+}
+
+// Compares the PooledMemorySystem to malloc on the allocations of
+// concurrent logins.
+static void MemoryBench( size_t threads )
+{
+	const size_t logins = 200000;
+
+	awsx::PooledMemorySystem pool;
+
+	auto mallocTime = ReplayLogins( threads,
+		logins,
+		[]( size_t size ) { return malloc( size ); },
+		[]( void * block ) { free( block ); } );
+
+	auto pooledTime = ReplayLogins( threads,
+		logins,
+		[&pool]( size_t size ) { return pool.AllocateMemory( size, 16 ); },
+		[&pool]( void * block ) { pool.FreeMemory( block ); } );
+
+	auto stats = pool.GetStats();
+	double total = static_cast<double>( threads * logins );
+
+	std::cout << std::fixed << std::setprecision( 3 );
+	std::cout << "threads: " << threads << ", logins: " << threads * logins
+			  << std::endl
+			  << "malloc: " << mallocTime.count() / total << " us/login"
+			  << std::endl
+			  << "pooled: " << pooledTime.count() / total << " us/login ("
+			  << stats.slabBytes / 1024 << " KB of slabs, "
+			  << stats.refills << " refills)" << std::endl;
+}
+
+// Logs the first user in once and times the steps up to the tokens from
+// the process start; compare runs with and without --lazy-start.
+static int ColdStart( LoadConfig & config )
+{
+	Aws::SDKOptions options;
+	std::shared_ptr<awsx::SdkStartup> startup;
+
+	if ( config.authOptions.lazyStart ) {
+		startup = std::make_shared<awsx::SdkStartup>( options );
+		config.authOptions.sdkStartup = startup;
+	}
+	else {
+		Aws::InitAPI( options );
+	}
+
+	std::vector<std::pair<std::string, std::chrono::microseconds>> steps;
+	steps.emplace_back( startup ? "InitAPI started" : "InitAPI",
+		Since( s_processStart ) );
+
+	int result = 2;
+
+	try {
+		std::vector<LoadUser> users;
+
+		if ( !LoadUsers( config.usersFile, users ) || users.empty() ) {
+			throw std::runtime_error( "no users in " + config.usersFile );
+		}
+
+		steps.emplace_back( "users loaded", Since( s_processStart ) );
+
+		awsx::CognitoAuth auth(
+			config.regionId, config.clientId, config.authOptions );
+
+		steps.emplace_back( "CognitoAuth", Since( s_processStart ) );
+
+		WorkerStats stats;
+		awsx::CognitoTokens tokens;
+
+		result = UserPoolLogin( auth, config, users[0], stats, tokens ) ? 0 : 1;
+
+		steps.emplace_back( "first token", Since( s_processStart ) );
+
+		for ( auto & error : stats.errors ) {
+			std::cerr << error.first << std::endl;
+		}
+	}
+	catch ( const std::exception & x ) {
+		std::cerr << x.what() << std::endl;
+	}
+
+	std::cout << std::fixed << std::setprecision( 1 );
+
+	for ( auto & step : steps ) {
+		std::cout << std::setw( 16 ) << std::left << step.first
+				  << std::setw( 10 ) << std::right
+				  << step.second.count() / 1e3 << " ms" << std::endl;
+	}
+
+	// the transport is gone, the SDK can shut down
+	config.authOptions.sdkStartup.reset();
+
+	if ( startup ) {
+		startup.reset();
+	}
+	else {
+		Aws::ShutdownAPI( options );
+	}
+
+	return result;
+}
+
+static void Usage()
+{
+	std::cerr
+		<< "usage: cognito-auth-loadgen --client-id ID --user-pool ID "
+		   "--users FILE [options]\n"
+		   "\n"
+		   "  --users FILE          one \"username password\" per line\n"
+		   "  --region ID           default us-west-2\n"
+		   "  --identity-pool ID    also fetch AWS credentials\n"
+		   "  --client-secret S     app client secret\n"
+		   "  --strategy NAME       srp (default), password or admin\n"
+		   "  --endpoint URL        scheme://host:port instead of AWS\n"
+		   "  --transport NAME      sdk (default), http or http2\n"
+		   "  --threads N           concurrent logins, default 8\n"
+		   "  --rate N              target logins per second, default "
+		   "unlimited\n"
+		   "  --count N             total logins, default one per user\n"
+		   "  --duration S          stop after S seconds\n"
+		   "  --timeout MS          per login deadline\n"
+		   "  --no-warmup           skip connection warm-up\n"
+		   "  --pooled-memory       run the SDK on a PooledMemorySystem\n"
+		   "  --lazy-start          set up SDK, transport and SRP in the "
+		   "background\n"
+		   "  --cold-start          time one login from the process start\n"
+		   "  --http-metrics        report DNS, connect, TLS and first byte "
+		   "times per API\n"
+		   "\n"
+		   "   or: cognito-auth-loadgen --session-store N\n"
+		   "   or: cognito-auth-loadgen --memory-bench THREADS\n"
+		   "\n"
+		   "  --session-store N     benchmark a SessionStore of N sessions\n"
+		   "  --memory-bench N      compare the pooled allocator to malloc\n";
+}
+
+static bool ParseArgs( int argc, char ** argv, LoadConfig & config )
+{
+	config.authOptions.warmup = true;
+
+	for ( int i = 1; i < argc; i++ ) {
+		std::string name = argv[i];
+
+		if ( name == "--no-warmup" ) {
+			config.authOptions.warmup = false;
+			continue;
+		}
+
+		if ( name == "--pooled-memory" ) {
+			config.pooledMemory = true;
+			continue;
+		}
+
+		if ( name == "--lazy-start" ) {
+			config.authOptions.lazyStart = true;
+			continue;
+		}
+
+		if ( name == "--cold-start" ) {
+			config.coldStart = true;
+			continue;
+		}
+
+		if ( name == "--http-metrics" ) {
+			config.httpMetrics = true;
+			continue;
+		}
+
+		if ( i + 1 >= argc ) {
+			return false;
+		}
+
+		std::string value = argv[++i];
+
+		if ( name == "--users" ) {
+			config.usersFile = value;
+		}
+		else if ( name == "--region" ) {
+			config.regionId = value;
+		}
+		else if ( name == "--client-id" ) {
+			config.clientId = value;
+		}
+		else if ( name == "--user-pool" ) {
+			config.userPoolId = value;
+		}
+		else if ( name == "--identity-pool" ) {
+			config.identityPoolId = value;
+		}
+		else if ( name == "--client-secret" ) {
+			config.authOptions.clientSecret = value;
+		}
+		else if ( name == "--strategy" ) {
+			if ( value == "srp" ) {
+				config.authOptions.strategy = awsx::AuthStrategy::Srp;
+			}
+			else if ( value == "password" ) {
+				config.authOptions.strategy = awsx::AuthStrategy::UserPassword;
+			}
+			else if ( value == "admin" ) {
+				config.authOptions.strategy
+					= awsx::AuthStrategy::AdminUserPassword;
+			}
+			else {
+				return false;
+			}
+		}
+		else if ( name == "--transport" ) {
+			if ( value == "sdk" ) {
+				config.authOptions.transport = awsx::TransportKind::Sdk;
+			}
+			else if ( value == "http" ) {
+				config.authOptions.transport = awsx::TransportKind::Http;
+			}
+			else if ( value == "http2" ) {
+				config.authOptions.transport = awsx::TransportKind::Http2;
+			}
+			else {
+				return false;
+			}
+		}
+		else if ( name == "--endpoint" ) {
+			config.authOptions.endpointOverride = value;
+		}
+		else if ( name == "--threads" ) {
+			config.threads = std::stoul( value );
+		}
+		else if ( name == "--rate" ) {
+			config.rate = std::stod( value );
+		}
+		else if ( name == "--count" ) {
+			config.count = std::stoul( value );
+		}
+		else if ( name == "--duration" ) {
+			config.duration = std::chrono::seconds( std::stol( value ) );
+		}
+		else if ( name == "--timeout" ) {
+			config.authOptions.loginTimeout
+				= std::chrono::milliseconds( std::stol( value ) );
+		}
+		else if ( name == "--session-store" ) {
+			config.storeSessions = std::stoul( value );
+		}
+		else if ( name == "--memory-bench" ) {
+			config.memoryThreads = std::stoul( value );
+		}
+		else {
+			return false;
+		}
+	}
+
+	if ( config.storeSessions > 0 || config.memoryThreads > 0 ) {
+		return true;
+	}
+
+	return !config.clientId.empty() && !config.userPoolId.empty()
+		&& !config.usersFile.empty() && config.threads > 0;
+}
+
+int main( int argc, char ** argv )
+{
+	LoadConfig config;
+
+	try {
+		if ( !ParseArgs( argc, argv, config ) ) {
+			Usage();
+			return 2;
+		}
+	}
+	catch ( const std::exception & ) {
+		Usage();
+		return 2;
+	}
+
+	if ( config.storeSessions > 0 ) {
+		Aws::SDKOptions options;
+		Aws::InitAPI( options );
+
+		SessionStoreBench( config.storeSessions );
+
+		Aws::ShutdownAPI( options );
+
+		return 0;
+	}
+
+	if ( config.memoryThreads > 0 ) {
+		MemoryBench( config.memoryThreads );
+
+		return 0;
+	}
+
+	if ( config.coldStart ) {
+		return ColdStart( config );
+	}
+
+	std::vector<LoadUser> users;
+
+	if ( !LoadUsers( config.usersFile, users ) || users.empty() ) {
+		std::cerr << "no users in " << config.usersFile << std::endl;
+		return 2;
+	}
+
+	if ( config.count == 0 && config.duration.count() == 0 ) {
+		config.count = users.size();
+	}
+
+	// one pooled connection per worker and service
+	config.authOptions.maxConnections
+		= static_cast<unsigned>( config.threads );
+
+	// outlives ShutdownAPI
+	awsx::PooledMemorySystem memory;
+
+	Aws::SDKOptions options;
+
+	if ( config.pooledMemory ) {
+		memory.Install( options );
+	}
+
+	auto metrics = std::make_shared<awsx::CognitoMetrics>();
+
+	if ( config.httpMetrics ) {
+		awsx::CognitoMetrics::Install( metrics, options );
+	}
+
+	Aws::InitAPI( options );
+
+	int result = 0;
+
+	try {
+		awsx::CognitoAuth auth(
+			config.regionId, config.clientId, config.authOptions );
+
+		std::vector<WorkerStats> stats( config.threads );
+		std::vector<std::thread> workers;
+		std::atomic<size_t> next( 0 );
+
+		auto started = std::chrono::steady_clock::now();
+		auto stopAt = config.duration.count() > 0
+			? started + config.duration
+			: std::chrono::steady_clock::time_point::max();
+
+		for ( size_t i = 0; i < config.threads; i++ ) {
+			workers.emplace_back( Worker,
+				std::ref( auth ),
+				std::cref( config ),
+				std::cref( users ),
+				std::ref( next ),
+				started,
+				stopAt,
+				std::ref( stats[i] ) );
+		}
+
+		for ( auto & worker : workers ) {
+			worker.join();
+		}
+
+		auto elapsed = Since( started );
+
+		WorkerStats total;
+
+		for ( auto & s : stats ) {
+			total.Merge( s );
+		}
+
+		Report( total, elapsed );
+		ReportHttp( *metrics );
+
+		result = total.failed > 0 ? 1 : 0;
+	}
+	catch ( const std::exception & x ) {
+		std::cerr << x.what() << std::endl;
+		result = 2;
+	}
+
+	Aws::ShutdownAPI( options );
+
+	return result;
+}
@@ -0,0 +1,45 @@
+// stdafx.h : include file for standard system include files,
+// or project specific include files that are used frequently, but
+// are changed infrequently
+//
+
+#pragma once
+
+#ifdef WINDOWS
+#include "targetver.h"
+
+#include <stdio.h>
+#include <tchar.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aws/core/Aws.h"
+
+#include "aws/cognito-idp/CognitoIdentityProviderClient.h"
+#include "aws/cognito-idp/model/AdminInitiateAuthRequest.h"
+#include "aws/cognito-idp/model/InitiateAuthRequest.h"
+#include "aws/cognito-idp/model/RespondToAuthChallengeRequest.h"
+
+#include "aws/cognito-identity/CognitoIdentityClient.h"
+#include "aws/cognito-identity/model/GetCredentialsForIdentityRequest.h"
+#include "aws/cognito-identity/model/GetIdRequest.h"
+
+#include "../../include/aws-cpp-cognito-auth/Auth.hpp"
+#include "../../include/aws-cpp-cognito-auth/MemorySystem.hpp"
+#include "../../include/aws-cpp-cognito-auth/Metrics.hpp"
+#include "../../include/aws-cpp-cognito-auth/SessionStore.hpp"
+#include "../../include/aws-cpp-cognito-auth/Startup.hpp"
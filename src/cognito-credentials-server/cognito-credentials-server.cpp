@@ -0,0 +1,757 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Denis Rozhkov <denis@rozhkoff.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "stdafx.h"
+
+
+#ifdef _WIN32
+typedef SOCKET NativeSocket;
+static const NativeSocket s_invalidSocket = INVALID_SOCKET;
+#define poll WSAPoll
+#else
+typedef int NativeSocket;
+static const NativeSocket s_invalidSocket = -1;
+#endif
+
+#ifdef MSG_NOSIGNAL
+static const int s_sendFlags = MSG_NOSIGNAL;
+#else
+static const int s_sendFlags = 0;
+#endif
+
+// requests larger than this are not credential requests
+static const size_t s_maxRequest = 16 * 1024;
+
+static const size_t s_maxClients = 1024;
+
+static const std::chrono::seconds s_idleTimeout( 60 );
+
+
+static std::atomic<bool> s_stop( false );
+
+static void OnSignal( int )
+{
+	s_stop = true;
+}
+
+static void CloseSocket( NativeSocket socket )
+{
+#ifdef _WIN32
+	closesocket( socket );
+#else
+	close( socket );
+#endif
+}
+
+
+struct ServerConfig {
+	std::string regionId;
+	std::string clientId;
+	std::string userPoolId;
+	std::string identityPoolId;
+	std::string username;
+	std::string password;
+
+	// 127.0.0.1 only, zero picks a free port
+	unsigned short port;
+	std::string path;
+
+	// expected Authorization header, empty accepts any request
+	std::string authToken;
+
+	std::chrono::seconds refreshAhead;
+
+	awsx::CognitoAuthOptions authOptions;
+
+	ServerConfig()
+		: regionId( "us-west-2" )
+		, port( 0 )
+		, path( "/credentials" )
+		, refreshAhead( 300 )
+	{
+	}
+};
+
+
+static std::string JsonString( const std::string & value )
+{
+	static const char * s_digits = "0123456789abcdef";
+
+	std::string out = "\"";
+
+	for ( char ch : value ) {
+		unsigned char c = static_cast<unsigned char>( ch );
+
+		if ( c == '"' || c == '\\' ) {
+			out += '\\';
+			out += ch;
+		}
+		else if ( c < 0x20 ) {
+			out += "\\u00";
+			out += s_digits[c >> 4];
+			out += s_digits[c & 0xf];
+		}
+		else {
+			out += ch;
+		}
+	}
+
+	return out + "\"";
+}
+
+static std::string Iso8601( std::chrono::system_clock::time_point time )
+{
+	std::time_t seconds = std::chrono::system_clock::to_time_t( time );
+	std::tm utc;
+
+#ifdef _WIN32
+	gmtime_s( &utc, &seconds );
+#else
+	gmtime_r( &seconds, &utc );
+#endif
+
+	char text[32];
+	std::strftime( text, sizeof( text ), "%Y-%m-%dT%H:%M:%SZ", &utc );
+
+	return text;
+}
+
+static std::string HttpResponse( const std::string & status,
+	const std::string & contentType,
+	const std::string & body )
+{
+	return "HTTP/1.1 " + status + "\r\nContent-Type: " + contentType
+		+ "\r\nContent-Length: " + std::to_string( body.size() )
+		+ "\r\nCache-Control: no-store\r\n\r\n" + body;
+}
+
+static std::string ErrorResponse( const std::string & status )
+{
+	return HttpResponse( status, "text/plain", status + "\n" );
+}
+
+// Compares in constant time for a given expected token.
+static bool SameToken( const std::string & value, const std::string & expected )
+{
+	unsigned char diff = value.size() == expected.size() ? 0 : 1;
+
+	for ( size_t i = 0; i < expected.size(); i++ ) {
+		diff |= static_cast<unsigned char>(
+			expected[i] ^ ( i < value.size() ? value[i] : 0 ) );
+	}
+
+	return diff == 0;
+}
+
+
+// The credentials response in the format of the SDKs' container
+// credentials provider, serialized once per login so a request only
+// copies it to the socket.
+class CredentialsResponse {
+protected:
+	struct Prepared {
+		std::chrono::system_clock::time_point expiration;
+		std::string response;
+	};
+
+	std::mutex m_mutex;
+	std::shared_ptr<const Prepared> m_prepared;
+
+public:
+	void Update( const awsx::CredentialsCache::Login & login )
+	{
+		auto & credentials = login.credentials;
+
+		std::string body = "{\"AccessKeyId\":"
+			+ JsonString( credentials.GetAWSAccessKeyId().c_str() )
+			+ ",\"SecretAccessKey\":"
+			+ JsonString( credentials.GetAWSSecretKey().c_str() )
+			+ ",\"Token\":"
+			+ JsonString( credentials.GetSessionToken().c_str() )
+			+ ",\"Expiration\":" + JsonString( Iso8601( login.expiration ) )
+			+ "}";
+
+		auto prepared = std::make_shared<Prepared>();
+		prepared->expiration = login.expiration;
+		prepared->response
+			= HttpResponse( "200 OK", "application/json", body );
+
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_prepared = prepared;
+	}
+
+	// Null before the first login and once the last one expired.
+	std::shared_ptr<const Prepared> Get()
+	{
+		std::shared_ptr<const Prepared> prepared;
+
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			prepared = m_prepared;
+		}
+
+		if ( prepared
+			&& prepared->expiration <= std::chrono::system_clock::now() ) {
+			prepared.reset();
+		}
+
+		return prepared;
+	}
+};
+
+
+// Single threaded keep-alive HTTP/1.1 server on the loopback interface.
+// Pipelined requests are answered in order; a connection closes on
+// "Connection: close", malformed requests and after a minute idle.
+class CredentialsServer {
+protected:
+	struct Client {
+		NativeSocket socket;
+		std::string in;
+		std::string out;
+		bool closing;
+		std::chrono::steady_clock::time_point lastActive;
+	};
+
+	const ServerConfig & m_config;
+	CredentialsResponse & m_response;
+
+	NativeSocket m_listener;
+	std::vector<Client> m_clients;
+
+	const std::string m_notFound;
+	const std::string m_unauthorized;
+	const std::string m_unavailable;
+	const std::string m_badRequest;
+
+protected:
+	static std::string Header(
+		const std::string & headers, const std::string & name )
+	{
+		size_t at = 0;
+
+		while ( ( at = headers.find( "\r\n", at ) ) != std::string::npos ) {
+			at += 2;
+
+			auto colon = headers.find( ':', at );
+			auto end = headers.find( "\r\n", at );
+
+			if ( colon == std::string::npos || colon > end
+				|| colon - at != name.size() ) {
+				continue;
+			}
+
+			bool match = std::equal( name.begin(),
+				name.end(),
+				headers.begin() + at,
+				[]( char a, char b ) {
+					return std::tolower( static_cast<unsigned char>( a ) )
+						== std::tolower( static_cast<unsigned char>( b ) );
+				} );
+
+			if ( match ) {
+				auto value = headers.find_first_not_of( " \t", colon + 1 );
+
+				return value < end ? headers.substr( value, end - value )
+								   : std::string();
+			}
+		}
+
+		return std::string();
+	}
+
+	// Answers the complete requests in the buffer.
+	void Answer( Client & client )
+	{
+		size_t end;
+
+		while ( !client.closing
+			&& ( end = client.in.find( "\r\n\r\n" ) ) != std::string::npos ) {
+			std::string headers = client.in.substr( 0, end + 2 );
+			client.in.erase( 0, end + 4 );
+
+			auto space = headers.find( ' ' );
+			auto space2 = headers.find( ' ', space + 1 );
+
+			if ( space == std::string::npos || space2 == std::string::npos
+				|| !Header( headers, "Content-Length" ).empty()
+				|| !Header( headers, "Transfer-Encoding" ).empty() ) {
+				client.out += m_badRequest;
+				client.closing = true;
+				break;
+			}
+
+			std::string method = headers.substr( 0, space );
+			std::string target
+				= headers.substr( space + 1, space2 - space - 1 );
+
+			if ( method != "GET" || target != m_config.path ) {
+				client.out += m_notFound;
+			}
+			else if ( !m_config.authToken.empty()
+				&& !SameToken(
+					Header( headers, "Authorization" ), m_config.authToken ) ) {
+				client.out += m_unauthorized;
+			}
+			else {
+				auto prepared = m_response.Get();
+				client.out
+					+= prepared ? prepared->response : m_unavailable;
+			}
+
+			if ( Header( headers, "Connection" ) == "close"
+				|| headers.compare( space2 + 1, 8, "HTTP/1.0" ) == 0 ) {
+				client.closing = true;
+			}
+		}
+
+		if ( client.in.size() > s_maxRequest ) {
+			client.out += m_badRequest;
+			client.closing = true;
+		}
+	}
+
+	// False when the connection is done.
+	bool Read( Client & client )
+	{
+		char buffer[4096];
+
+		int received = static_cast<int>(
+			recv( client.socket, buffer, sizeof( buffer ), 0 ) );
+
+		if ( received <= 0 ) {
+			return false;
+		}
+
+		client.in.append( buffer, received );
+		client.lastActive = std::chrono::steady_clock::now();
+
+		Answer( client );
+
+		return Write( client );
+	}
+
+	bool Write( Client & client )
+	{
+		while ( !client.out.empty() ) {
+			int sent = static_cast<int>( send( client.socket,
+				client.out.data(),
+				static_cast<int>( client.out.size() ),
+				s_sendFlags ) );
+
+			if ( sent <= 0 ) {
+				// the rest goes out when the socket is writable again
+				return sent < 0 && IsWouldBlock();
+			}
+
+			client.out.erase( 0, sent );
+		}
+
+		return !client.closing;
+	}
+
+	static bool IsWouldBlock()
+	{
+#ifdef _WIN32
+		return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+		return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+	}
+
+	static void SetNonBlocking( NativeSocket socket )
+	{
+#ifdef _WIN32
+		u_long enable = 1;
+		ioctlsocket( socket, FIONBIO, &enable );
+#else
+		fcntl( socket, F_SETFL, fcntl( socket, F_GETFL ) | O_NONBLOCK );
+#endif
+	}
+
+	void Accept()
+	{
+		NativeSocket socket;
+
+		while ( ( socket = accept( m_listener, nullptr, nullptr ) )
+			!= s_invalidSocket ) {
+			if ( m_clients.size() >= s_maxClients ) {
+				CloseSocket( socket );
+				continue;
+			}
+
+			int enable = 1;
+			setsockopt( socket,
+				IPPROTO_TCP,
+				TCP_NODELAY,
+				reinterpret_cast<const char *>( &enable ),
+				sizeof( enable ) );
+
+			SetNonBlocking( socket );
+
+			Client client;
+			client.socket = socket;
+			client.closing = false;
+			client.lastActive = std::chrono::steady_clock::now();
+			m_clients.push_back( client );
+		}
+	}
+
+public:
+	CredentialsServer(
+		const ServerConfig & config, CredentialsResponse & response )
+		: m_config( config )
+		, m_response( response )
+		, m_listener( s_invalidSocket )
+		, m_notFound( ErrorResponse( "404 Not Found" ) )
+		, m_unauthorized( ErrorResponse( "401 Unauthorized" ) )
+		, m_unavailable( ErrorResponse( "503 Service Unavailable" ) )
+		, m_badRequest( ErrorResponse( "400 Bad Request" ) )
+	{
+	}
+
+	~CredentialsServer()
+	{
+		for ( auto & client : m_clients ) {
+			CloseSocket( client.socket );
+		}
+
+		if ( m_listener != s_invalidSocket ) {
+			CloseSocket( m_listener );
+		}
+	}
+
+	// Returns the bound port.
+	unsigned short Listen()
+	{
+		m_listener = socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+
+		if ( m_listener == s_invalidSocket ) {
+			throw awsx::Exception( "socket() failed" );
+		}
+
+		int enable = 1;
+		setsockopt( m_listener,
+			SOL_SOCKET,
+			SO_REUSEADDR,
+			reinterpret_cast<const char *>( &enable ),
+			sizeof( enable ) );
+
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+		address.sin_port = htons( m_config.port );
+
+		socklen_t size = sizeof( address );
+
+		if ( bind( m_listener,
+				 reinterpret_cast<const sockaddr *>( &address ),
+				 size )
+				!= 0
+			|| listen( m_listener, 128 ) != 0
+			|| getsockname( m_listener,
+				   reinterpret_cast<sockaddr *>( &address ),
+				   &size )
+				!= 0 ) {
+			throw awsx::Exception( "cannot listen on 127.0.0.1:"
+				+ std::to_string( m_config.port ) );
+		}
+
+		SetNonBlocking( m_listener );
+
+		return ntohs( address.sin_port );
+	}
+
+	void Run()
+	{
+		std::vector<pollfd> fds;
+
+		while ( !s_stop ) {
+			fds.resize( m_clients.size() + 1 );
+			fds[0].fd = m_listener;
+			fds[0].events = POLLIN;
+			fds[0].revents = 0;
+
+			for ( size_t i = 0; i < m_clients.size(); i++ ) {
+				fds[i + 1].fd = m_clients[i].socket;
+				fds[i + 1].events = static_cast<short>(
+					m_clients[i].out.empty() ? POLLIN : POLLIN | POLLOUT );
+				fds[i + 1].revents = 0;
+			}
+
+			// wakes up every second for the stop flag and idle connections
+			if ( poll( fds.data(), static_cast<unsigned long>( fds.size() ),
+					 1000 )
+				< 0 ) {
+				continue;
+			}
+
+			auto now = std::chrono::steady_clock::now();
+			std::vector<Client> open;
+			open.reserve( m_clients.size() );
+
+			for ( size_t i = 0; i < m_clients.size(); i++ ) {
+				Client & client = m_clients[i];
+				short events = fds[i + 1].revents;
+				bool keep = true;
+
+				if ( events & ( POLLERR | POLLHUP | POLLNVAL ) ) {
+					keep = false;
+				}
+				else if ( events & POLLOUT ) {
+					keep = Write( client );
+				}
+
+				if ( keep && ( events & POLLIN ) ) {
+					keep = Read( client );
+				}
+
+				if ( keep && client.out.empty()
+					&& now - client.lastActive > s_idleTimeout ) {
+					keep = false;
+				}
+
+				if ( keep ) {
+					open.push_back( client );
+				}
+				else {
+					CloseSocket( client.socket );
+				}
+			}
+
+			m_clients.swap( open );
+
+			if ( fds[0].revents & POLLIN ) {
+				Accept();
+			}
+		}
+	}
+};
+
+
+static void Usage()
+{
+	std::cerr
+		<< "usage: cognito-credentials-server --client-id ID --user-pool ID "
+		   "--identity-pool ID --username NAME [options]\n"
+		   "\n"
+		   "Serves the credentials of one Cognito identity on\n"
+		   "http://127.0.0.1:PORT/credentials for the AWS SDKs' container\n"
+		   "credentials provider (AWS_CONTAINER_CREDENTIALS_FULL_URI).\n"
+		   "The password is read from COGNITO_PASSWORD, or --password-file.\n"
+		   "\n"
+		   "  --region ID           default us-west-2\n"
+		   "  --password-file FILE  first line is the password\n"
+		   "  --port N              default a free port, printed on start\n"
+		   "  --path PATH           default /credentials\n"
+		   "  --auth-token-file F   require this Authorization header\n"
+		   "                        (AWS_CONTAINER_AUTHORIZATION_TOKEN)\n"
+		   "  --refresh-ahead S     log in again S seconds before expiry,\n"
+		   "                        default 300\n"
+		   "  --client-secret S     app client secret\n"
+		   "  --strategy NAME       srp (default) or password\n"
+		   "  --endpoint URL        scheme://host:port instead of AWS\n"
+		   "  --transport NAME      sdk (default), http or http2\n";
+}
+
+static bool ReadFirstLine( const std::string & file, std::string & line )
+{
+	std::ifstream in( file );
+
+	if ( !std::getline( in, line ) ) {
+		return false;
+	}
+
+	if ( !line.empty() && line.back() == '\r' ) {
+		line.pop_back();
+	}
+
+	return true;
+}
+
+static bool ParseArgs( int argc, char ** argv, ServerConfig & config )
+{
+	config.authOptions.warmup = true;
+
+	if ( const char * password = std::getenv( "COGNITO_PASSWORD" ) ) {
+		config.password = password;
+	}
+
+	for ( int i = 1; i + 1 < argc; i += 2 ) {
+		std::string name = argv[i];
+		std::string value = argv[i + 1];
+
+		if ( name == "--region" ) {
+			config.regionId = value;
+		}
+		else if ( name == "--client-id" ) {
+			config.clientId = value;
+		}
+		else if ( name == "--user-pool" ) {
+			config.userPoolId = value;
+		}
+		else if ( name == "--identity-pool" ) {
+			config.identityPoolId = value;
+		}
+		else if ( name == "--username" ) {
+			config.username = value;
+		}
+		else if ( name == "--password-file" ) {
+			if ( !ReadFirstLine( value, config.password ) ) {
+				return false;
+			}
+		}
+		else if ( name == "--port" ) {
+			config.port = static_cast<unsigned short>( std::stoul( value ) );
+		}
+		else if ( name == "--path" ) {
+			config.path = value;
+		}
+		else if ( name == "--auth-token-file" ) {
+			if ( !ReadFirstLine( value, config.authToken ) ) {
+				return false;
+			}
+		}
+		else if ( name == "--refresh-ahead" ) {
+			config.refreshAhead = std::chrono::seconds( std::stol( value ) );
+		}
+		else if ( name == "--client-secret" ) {
+			config.authOptions.clientSecret = value;
+		}
+		else if ( name == "--strategy" ) {
+			if ( value == "srp" ) {
+				config.authOptions.strategy = awsx::AuthStrategy::Srp;
+			}
+			else if ( value == "password" ) {
+				config.authOptions.strategy = awsx::AuthStrategy::UserPassword;
+			}
+			else {
+				return false;
+			}
+		}
+		else if ( name == "--transport" ) {
+			if ( value == "sdk" ) {
+				config.authOptions.transport = awsx::TransportKind::Sdk;
+			}
+			else if ( value == "http" ) {
+				config.authOptions.transport = awsx::TransportKind::Http;
+			}
+			else if ( value == "http2" ) {
+				config.authOptions.transport = awsx::TransportKind::Http2;
+			}
+			else {
+				return false;
+			}
+		}
+		else if ( name == "--endpoint" ) {
+			config.authOptions.endpointOverride = value;
+		}
+		else {
+			return false;
+		}
+	}
+
+	return argc % 2 == 1 && !config.clientId.empty()
+		&& !config.userPoolId.empty() && !config.identityPoolId.empty()
+		&& !config.username.empty() && !config.password.empty()
+		&& !config.path.empty() && config.path[0] == '/';
+}
+
+int main( int argc, char ** argv )
+{
+	ServerConfig config;
+
+	try {
+		if ( !ParseArgs( argc, argv, config ) ) {
+			Usage();
+			return 2;
+		}
+	}
+	catch ( const std::exception & ) {
+		Usage();
+		return 2;
+	}
+
+#ifdef _WIN32
+	WSADATA wsaData;
+	WSAStartup( MAKEWORD( 2, 2 ), &wsaData );
+#endif
+
+	std::signal( SIGINT, OnSignal );
+	std::signal( SIGTERM, OnSignal );
+#ifdef SIGPIPE
+	std::signal( SIGPIPE, SIG_IGN );
+#endif
+
+	Aws::SDKOptions options;
+	Aws::InitAPI( options );
+
+	int result = 0;
+
+	try {
+		awsx::CognitoAuth auth(
+			config.regionId, config.clientId, config.authOptions );
+
+		CredentialsResponse response;
+		CredentialsServer server( config, response );
+
+		auto port = server.Listen();
+
+		awsx::CredentialsCache cache( auth,
+			config.username,
+			config.password,
+			config.userPoolId,
+			config.identityPoolId,
+			config.refreshAhead );
+
+		cache.Start(
+			[&response]( const awsx::CredentialsCache::Login & login ) {
+				response.Update( login );
+			} );
+
+		// serves 503 until a login succeeds, the cache keeps retrying
+		if ( !cache.WaitReady( std::chrono::seconds( 30 ) ) ) {
+			std::cerr << "no credentials yet: " << cache.GetLastError()
+					  << std::endl;
+		}
+
+		std::cout << "AWS_CONTAINER_CREDENTIALS_FULL_URI=http://127.0.0.1:"
+				  << port << config.path << std::endl;
+
+		server.Run();
+
+		cache.Stop();
+	}
+	catch ( const std::exception & x ) {
+		std::cerr << x.what() << std::endl;
+		result = 1;
+	}
+
+	Aws::ShutdownAPI( options );
+
+#ifdef _WIN32
+	WSACleanup();
+#endif
+
+	return result;
+}